@@ -50,7 +50,7 @@
 #define configSUPPORT_STATIC_ALLOCATION          1
 #define configSUPPORT_DYNAMIC_ALLOCATION         1
 #define configUSE_IDLE_HOOK                      0
-#define configUSE_TICK_HOOK                      0
+#define configUSE_TICK_HOOK                      1
 #define configCPU_CLOCK_HZ                       ( SystemCoreClock )
 #define configTICK_RATE_HZ                       ((TickType_t)1000)
 #define configMAX_PRIORITIES                     ( 56 )
@@ -140,6 +140,31 @@ standard names. */
 
 /* USER CODE BEGIN Defines */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
+
+/* Binary trace recorder (src/rtos/trace_recorder.h). Set to 0 to compile the
+kernel trace hooks out entirely. */
+#define configUSE_TRACE_RECORDER                 1
+
+/* Per-object contention counters (src/rtos/kernel_stats.h). Cheap enough to
+leave enabled in production builds. */
+#define configUSE_KERNEL_STATS                   1
+
+/* Give every task its own newlib reent structure (errno, stdio state). The
+C library allocates from the FreeRTOS heap (src/mem/newlib_heap.c). */
+#define configUSE_NEWLIB_REENTRANT               1
+
+/* Thread-local slot 0 holds each task's scratch arena (src/mem/arena.h). */
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS  1
+
+/* Stack overflow is caught by an MPU guard region below the running task's
+stack (src/rtos/stack_guard.h) on the faulting push, so the kernel's
+per-switch pattern checks stay off. */
+#define configUSE_MPU_STACK_GUARD                1
+#define configCHECK_FOR_STACK_OVERFLOW           0
+
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+  #include "trace_hooks.h"
+#endif
 /* USER CODE END Defines */
 
 #endif /* FREERTOS_CONFIG_H */
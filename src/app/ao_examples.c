@@ -0,0 +1,171 @@
+/**
+ * @file ao_examples.c
+ * @brief LED blinker and heartbeat written as active objects
+ *
+ * State hierarchy of Blinky:
+ *
+ *   top
+ *   +-- active   (periodic timeout armed on entry, disarmed on exit)
+ *   |   +-- off
+ *   |   +-- on
+ *   +-- paused   (LED off)
+ */
+
+#include "ao_examples.h"
+#include <stddef.h>
+
+#define BLINKY_QUEUE_LEN        4
+#define HEARTBEAT_QUEUE_LEN     2
+#define HEARTBEAT_POOL_EVENTS   4
+
+blinky_t g_blinky;
+heartbeat_t g_heartbeat;
+
+static ao_examples_config_t cfg;
+static const ao_event_t* blinky_queue[BLINKY_QUEUE_LEN];
+static const ao_event_t* heartbeat_queue[HEARTBEAT_QUEUE_LEN];
+static heartbeat_evt_t heartbeat_pool[HEARTBEAT_POOL_EVENTS];
+
+// =============================================================================
+// Blinky
+// =============================================================================
+
+static hsm_ret_t blinky_active(blinky_t* me, const ao_event_t* e);
+static hsm_ret_t blinky_off(blinky_t* me, const ao_event_t* e);
+static hsm_ret_t blinky_on(blinky_t* me, const ao_event_t* e);
+static hsm_ret_t blinky_paused(blinky_t* me, const ao_event_t* e);
+
+static void blinky_set(blinky_t* me, bool on) {
+    me->led_on = on;
+    if (cfg.set_led) {
+        cfg.set_led(on);
+    }
+}
+
+static hsm_ret_t blinky_initial(blinky_t* me, const ao_event_t* e) {
+    (void)e;
+    return HSM_TRAN(blinky_off);
+}
+
+static hsm_ret_t blinky_active(blinky_t* me, const ao_event_t* e) {
+    switch (e->sig) {
+    case HSM_SIG_ENTRY:
+        ao_time_event_arm(&me->timeout, cfg.blink_ticks, cfg.blink_ticks);
+        return HSM_HANDLED();
+    case HSM_SIG_EXIT:
+        ao_time_event_disarm(&me->timeout);
+        return HSM_HANDLED();
+    case HSM_SIG_INIT:
+        return HSM_TRAN(blinky_off);
+    case SIG_BLINK_PAUSE:
+        return HSM_TRAN(blinky_paused);
+    case SIG_HEARTBEAT:
+        me->last_beat = ((const heartbeat_evt_t*)e)->count;
+        if (cfg.on_heartbeat) {
+            cfg.on_heartbeat(me->last_beat);
+        }
+        return HSM_HANDLED();
+    default:
+        return HSM_SUPER(hsm_top);
+    }
+}
+
+static hsm_ret_t blinky_off(blinky_t* me, const ao_event_t* e) {
+    switch (e->sig) {
+    case HSM_SIG_ENTRY:
+        blinky_set(me, false);
+        return HSM_HANDLED();
+    case SIG_BLINK_TIMEOUT:
+        me->toggles++;
+        return HSM_TRAN(blinky_on);
+    default:
+        return HSM_SUPER(blinky_active);
+    }
+}
+
+static hsm_ret_t blinky_on(blinky_t* me, const ao_event_t* e) {
+    switch (e->sig) {
+    case HSM_SIG_ENTRY:
+        blinky_set(me, true);
+        return HSM_HANDLED();
+    case SIG_BLINK_TIMEOUT:
+        me->toggles++;
+        return HSM_TRAN(blinky_off);
+    default:
+        return HSM_SUPER(blinky_active);
+    }
+}
+
+static hsm_ret_t blinky_paused(blinky_t* me, const ao_event_t* e) {
+    switch (e->sig) {
+    case HSM_SIG_ENTRY:
+        blinky_set(me, false);
+        return HSM_HANDLED();
+    case SIG_BLINK_RESUME:
+        return HSM_TRAN(blinky_active);
+    case SIG_HEARTBEAT:
+        return HSM_HANDLED();  // Beats are dropped while paused
+    default:
+        return HSM_SUPER(hsm_top);
+    }
+}
+
+// =============================================================================
+// Heartbeat
+// =============================================================================
+
+static hsm_ret_t heartbeat_running(heartbeat_t* me, const ao_event_t* e);
+
+static hsm_ret_t heartbeat_initial(heartbeat_t* me, const ao_event_t* e) {
+    (void)e;
+    ao_time_event_arm(&me->tick, cfg.heartbeat_ticks, cfg.heartbeat_ticks);
+    return HSM_TRAN(heartbeat_running);
+}
+
+static hsm_ret_t heartbeat_running(heartbeat_t* me, const ao_event_t* e) {
+    switch (e->sig) {
+    case SIG_HEARTBEAT_TICK: {
+        me->count++;
+        heartbeat_evt_t* beat = AO_EVENT_NEW(heartbeat_evt_t, SIG_HEARTBEAT);
+        if (beat) {
+            beat->count = me->count;
+            ao_post(&g_blinky.super, &beat->super);
+        }
+        return HSM_HANDLED();
+    }
+    default:
+        return HSM_SUPER(hsm_top);
+    }
+}
+
+// Public API implementations
+
+int ao_examples_start(const ao_examples_config_t* config) {
+    if (!config || config->blink_ticks == 0 || config->heartbeat_ticks == 0) {
+        return -1;
+    }
+    cfg = *config;
+
+    if (ao_pool_init(heartbeat_pool, sizeof(heartbeat_evt_t), HEARTBEAT_POOL_EVENTS) < 0) {
+        return -2;
+    }
+
+    ao_ctor(&g_blinky.super, HSM_STATE(blinky_initial));
+    ao_time_event_ctor(&g_blinky.timeout, SIG_BLINK_TIMEOUT, &g_blinky.super);
+    g_blinky.led_on = false;
+    g_blinky.toggles = 0;
+    g_blinky.last_beat = 0;
+
+    ao_ctor(&g_heartbeat.super, HSM_STATE(heartbeat_initial));
+    ao_time_event_ctor(&g_heartbeat.tick, SIG_HEARTBEAT_TICK, &g_heartbeat.super);
+    g_heartbeat.count = 0;
+
+    // Blinky consumes the heartbeat events, so it gets the higher priority
+    if (ao_start(&g_blinky.super, cfg.level, 1, blinky_queue, BLINKY_QUEUE_LEN, NULL) != 0) {
+        return -3;
+    }
+    if (ao_start(&g_heartbeat.super, cfg.level, 0, heartbeat_queue, HEARTBEAT_QUEUE_LEN, NULL) != 0) {
+        return -3;
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+/**
+ * @file ao_examples.h
+ * @brief LED blinker and heartbeat written as active objects
+ *
+ * Blinky toggles the LED from a periodic time event and can be paused and
+ * resumed. Heartbeat counts beats and sends each one to Blinky as a pool
+ * event carrying the beat number. Hardware access goes through the
+ * callbacks in ao_examples_config_t, so the state machines also run on the
+ * host.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "active_object.h"
+
+/**
+ * @brief Example Signals
+ */
+enum {
+    SIG_BLINK_TIMEOUT = HSM_SIG_USER,
+    SIG_BLINK_PAUSE,
+    SIG_BLINK_RESUME,
+    SIG_HEARTBEAT_TICK,
+    SIG_HEARTBEAT
+};
+
+/**
+ * @brief Heartbeat Event (pool allocated)
+ */
+typedef struct {
+    ao_event_t super;
+    uint32_t count;
+} heartbeat_evt_t;
+
+/**
+ * @brief Example Configuration
+ */
+typedef struct {
+    void (*set_led)(bool on);           // Drive the LED
+    void (*on_heartbeat)(uint32_t count); // Called by Blinky for every beat
+    uint32_t blink_ticks;               // Half period of the blink
+    uint32_t heartbeat_ticks;           // Heartbeat period
+    uint8_t level;                      // Level shared by both objects
+} ao_examples_config_t;
+
+/**
+ * @brief Blinky Active Object
+ */
+typedef struct {
+    ao_active_t super;
+    ao_time_event_t timeout;
+    bool led_on;
+    uint32_t toggles;
+    uint32_t last_beat;
+} blinky_t;
+
+/**
+ * @brief Heartbeat Active Object
+ */
+typedef struct {
+    ao_active_t super;
+    ao_time_event_t tick;
+    uint32_t count;
+} heartbeat_t;
+
+extern blinky_t g_blinky;
+extern heartbeat_t g_heartbeat;
+
+/**
+ * @brief Create the event pool and start both objects on one level
+ * @param config Callbacks and timing
+ * @return 0 on success, negative error code on failure
+ */
+int ao_examples_start(const ao_examples_config_t* config);
+
+#ifdef __cplusplus
+}
+#endif
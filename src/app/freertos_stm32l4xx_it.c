@@ -7,6 +7,7 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "portmacro.h"
+#include "trace_recorder.h"
 
 /* Include the port layer specific header for ARM_CM4F */
 extern void xPortSysTickHandler(void);
@@ -21,7 +22,7 @@ extern HAL_TickFreqTypeDef uwTickFreq;
 void SysTick_Handler(void)
 {
   /* USER CODE BEGIN SysTick_IRQn 0 */
-
+  TRACE_ISR_ENTER();
   /* USER CODE END SysTick_IRQn 0 */
   if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) {
     xPortSysTickHandler();
@@ -30,7 +31,7 @@ void SysTick_Handler(void)
   HAL_IncTick();
 
   /* USER CODE BEGIN SysTick_IRQn 1 */
-
+  TRACE_ISR_EXIT();
   /* USER CODE END SysTick_IRQn 1 */
 }
 
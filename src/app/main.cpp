@@ -6,38 +6,71 @@ extern "C" {
 #include "version.h"
 #include "FreeRTOS.h"
 #include "task.h"
+#include "trace_recorder.h"
+#include "kernel_stats.h"
+#include "irq_profiler.h"
+#include "supervisor.h"
+#include "stack_guard.h"
+#include "job_scheduler.h"
+#include "active_object.h"
+#include "ao_examples.h"
+#include "ramfunc_bench.h"
+#include "hal_irq.h"
+#include "debug_uart.h"
 }
 
+// 1: run the LED and heartbeat as active objects instead of scheduler jobs
+#ifndef APP_USE_ACTIVE_OBJECTS
+#define APP_USE_ACTIVE_OBJECTS 0
+#endif
+
+// 1: time flash vs. SRAM2 execution at startup (results in ramfunc_bench_result)
+#ifndef APP_RAMFUNC_BENCH
+#define APP_RAMFUNC_BENCH 0
+#endif
+
 // the function SystemClock_Config is usually auto-generated by STM32CubeMX
 // Here we provide a dummy implementation for completeness
 void SystemClock_Config(){};
 
-// Task handles
-TaskHandle_t ledTaskHandle = NULL;
-TaskHandle_t heartbeatTaskHandle = NULL;
+// Supervisor check-in ids
+static int jobsCheckin = -1;
 
-// LED Task - Blinks LED on PB3
-void ledTask(void *pvParameters) {
-    (void)pvParameters;
+static uint32_t heartbeatCounter = 0;
 
-    while (1) {
-        HAL_GPIO_TogglePin(GPIOB, GPIO_PIN_3);
-        vTaskDelay(pdMS_TO_TICKS(500));  // 500ms delay
-    }
+#if APP_USE_ACTIVE_OBJECTS
+
+// Hardware callbacks for the Blinky/Heartbeat active objects (ao_examples.c)
+static void aoSetLed(bool on) {
+    HAL_GPIO_WritePin(GPIOB, GPIO_PIN_3, on ? GPIO_PIN_SET : GPIO_PIN_RESET);
 }
 
-// Heartbeat Task - Demonstrates multiple tasks
-void heartbeatTask(void *pvParameters) {
-    (void)pvParameters;
-    uint32_t counter = 0;
+static void aoHeartbeat(uint32_t count) {
+    heartbeatCounter = count;
+    supervisor_checkin(jobsCheckin);
+}
 
-    while (1) {
-        counter++;
-        // This task runs every 1 second
-        vTaskDelay(pdMS_TO_TICKS(1000));
-    }
+#else
+
+// Periodic jobs, all run by the job scheduler's worker task
+static job_t ledJob;
+static job_t heartbeatJob;
+
+// LED Job - Blinks LED on PB3
+static void ledJobRun(void *arg) {
+    (void)arg;
+    HAL_GPIO_TogglePin(GPIOB, GPIO_PIN_3);
+    supervisor_checkin(jobsCheckin);
+}
+
+// Heartbeat Job - Demonstrates multiple jobs sharing one stack
+static void heartbeatJobRun(void *arg) {
+    (void)arg;
+    heartbeatCounter++;
 }
 
+#endif
+
 // Initialize GPIO for LED
 void GPIO_Init(void) {
     __HAL_RCC_GPIOB_CLK_ENABLE();
@@ -54,12 +87,51 @@ extern "C" int main() {
     HAL_Init();
     SystemClock_Config();
 
+    // Run from the RAM vector table so drivers can bind ISRs at runtime
+    hal_irq_vectors_init();
+
+    // Console output (printf) through USART2 TX DMA
+    debug_uart_init(DEBUG_UART_BAUD);
+
     // Initialize GPIO
     GPIO_Init();
 
-    // Create tasks
-    xTaskCreate(ledTask, "LED_Task", 256, NULL, 1, &ledTaskHandle);
-    xTaskCreate(heartbeatTask, "Heartbeat_Task", 256, NULL, 1, &heartbeatTaskHandle);
+    // Start the kernel trace recorder (DWT timestamps)
+    trace_init(SystemCoreClock);
+    kstats_init(SystemCoreClock);
+#if defined(IRQ_PROFILER_ENABLED)
+    irqprof_init();
+#endif
+#if APP_RAMFUNC_BENCH
+    ramfunc_bench_run();
+#endif
+
+    // Stack overflows fault on the MPU guard (configUSE_MPU_STACK_GUARD)
+    stack_guard_init();
+
+    // Register monitored tasks; the supervisor feeds the watchdog only
+    // while all of them keep checking in
+    supervisor_init();
+    jobsCheckin = supervisor_register("Jobs", 1000);
+
+#if APP_USE_ACTIVE_OBJECTS
+    // Both objects share one level task; Blinky checks in on every heartbeat
+    ao_framework_init();
+    const ao_examples_config_t aoConfig = {
+        aoSetLed, aoHeartbeat, pdMS_TO_TICKS(500), pdMS_TO_TICKS(1000), 0
+    };
+    ao_examples_start(&aoConfig);
+    ao_level_start(0, 1);
+#else
+    // Schedule periodic jobs
+    job_scheduler_init();
+    job_init(&ledJob, "LED", ledJobRun, NULL);
+    job_init(&heartbeatJob, "Heartbeat", heartbeatJobRun, NULL);
+    job_start(&ledJob, 0, 0, pdMS_TO_TICKS(500));           // 500ms period
+    job_start(&heartbeatJob, 0, 0, pdMS_TO_TICKS(1000));    // 1s period
+    job_scheduler_start(1);
+#endif
+    supervisor_start(configMAX_PRIORITIES - 1);
 
     // Start the scheduler
     vTaskStartScheduler();
@@ -82,14 +154,9 @@ extern "C" void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffe
     *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
 }
 
-extern "C" void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName) {
-    (void)xTask;
-    (void)pcTaskName;
-
-    // Stack overflow detected - handle error
-    while (1) {
-        // Infinite loop for debugging
-    }
+// Drives active object time events (configUSE_TICK_HOOK)
+extern "C" void vApplicationTickHook(void) {
+    ao_tick();
 }
 
 // Required for FreeRTOS Timer Task when using static allocation
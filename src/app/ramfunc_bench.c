@@ -0,0 +1,91 @@
+/**
+ * @file ramfunc_bench.c
+ * @brief On-target comparison of flash and SRAM2 execution
+ */
+
+#include "ramfunc_bench.h"
+#include "sections.h"
+#include "hal_dwt.h"
+#include "stm32l4xx.h"
+
+#define BENCH_TAPS      16
+#define BENCH_SAMPLES   64
+
+volatile ramfunc_bench_result_t ramfunc_bench_result;
+
+static const int16_t taps[BENCH_TAPS] = {
+    -12, -31, 18, 142, 391, 722, 1010, 1150,
+    1150, 1010, 722, 391, 142, 18, -31, -12
+};
+
+static int16_t samples[BENCH_SAMPLES + BENCH_TAPS];
+
+// =============================================================================
+// Kernel, instantiated once in flash and once in SRAM2
+// =============================================================================
+
+static inline __attribute__((always_inline)) int32_t fir_block(const int16_t* x) {
+    int32_t checksum = 0;
+    for (int n = 0; n < BENCH_SAMPLES; n++) {
+        int32_t acc = 0;
+        for (int k = 0; k < BENCH_TAPS; k++) {
+            acc += (int32_t)taps[k] * x[n + k];
+        }
+        checksum += acc >> 12;
+    }
+    return checksum;
+}
+
+static __attribute__((noinline)) int32_t fir_flash(const int16_t* x) {
+    return fir_block(x);
+}
+
+static RAMFUNC int32_t fir_sram2(const int16_t* x) {
+    return fir_block(x);
+}
+
+static uint32_t time_best(int32_t (*fn)(const int16_t*), int32_t* checksum) {
+    uint32_t best = UINT32_MAX;
+    for (int round = 0; round < RAMFUNC_BENCH_ROUNDS; round++) {
+        const uint32_t start = hal_dwt_get_cycles();
+        *checksum = fn(samples);
+        const uint32_t cycles = hal_dwt_get_cycles() - start;
+        if (cycles < best) {
+            best = cycles;
+        }
+    }
+    return best;
+}
+
+// Public API implementations
+
+int ramfunc_bench_run(void) {
+    if (!hal_dwt_is_enabled() && hal_dwt_init() != 0) {
+        return -1;
+    }
+
+    for (int i = 0; i < BENCH_SAMPLES + BENCH_TAPS; i++) {
+        samples[i] = (int16_t)((i * 2654435761u) >> 20);
+    }
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    int32_t sum_flash, sum_uncached, sum_sram2;
+    ramfunc_bench_result.flash_cached = time_best(fir_flash, &sum_flash);
+
+    // The cache must be off while it is reset; restore its state afterwards
+    const uint32_t acr = FLASH->ACR;
+    FLASH->ACR = acr & ~FLASH_ACR_ICEN;
+    FLASH->ACR = (acr & ~FLASH_ACR_ICEN) | FLASH_ACR_ICRST;
+    FLASH->ACR = acr & ~(FLASH_ACR_ICEN | FLASH_ACR_ICRST);
+    ramfunc_bench_result.flash_uncached = time_best(fir_flash, &sum_uncached);
+    FLASH->ACR = acr;
+
+    ramfunc_bench_result.sram2 = time_best(fir_sram2, &sum_sram2);
+    ramfunc_bench_result.checksum = sum_sram2;
+
+    __set_PRIMASK(primask);
+
+    return (sum_flash == sum_sram2 && sum_uncached == sum_sram2) ? 0 : -2;
+}
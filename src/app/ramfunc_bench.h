@@ -0,0 +1,43 @@
+#pragma once
+
+/**
+ * @file ramfunc_bench.h
+ * @brief On-target comparison of flash and SRAM2 execution
+ *
+ * Runs the same ISR-sized kernel (a 16-tap integer FIR over a block of
+ * samples) once from flash and once as a RAMFUNC copy in SRAM2, timing
+ * each with the DWT cycle counter. The flash copy is measured twice: with
+ * the ART instruction cache enabled (steady state) and with it disabled,
+ * which approximates the first run after a cache miss or eviction by other
+ * code. Results are left in a global for inspection with the debugger.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/**
+ * @brief Cycle counts for one benchmark run (best of RAMFUNC_BENCH_ROUNDS)
+ */
+typedef struct {
+    uint32_t flash_cached;      // Flash, ART instruction cache on
+    uint32_t flash_uncached;    // Flash, ART instruction cache off
+    uint32_t sram2;             // RAMFUNC copy in SRAM2
+    int32_t checksum;           // Identical for all variants when correct
+} ramfunc_bench_result_t;
+
+#define RAMFUNC_BENCH_ROUNDS    8
+
+extern volatile ramfunc_bench_result_t ramfunc_bench_result;
+
+/**
+ * @brief Run the benchmark with interrupts masked
+ * @return 0 on success, negative if the two copies disagree or DWT is off
+ */
+int ramfunc_bench_run(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -9,6 +9,7 @@
 #include "../common/bsp.h"
 #include "../../hal/interfaces/hal_gpio.h"
 #include "../../hal/interfaces/hal_rcc.h"
+#include "../../drivers/debug_uart.h"
 
 #include <cstring>
 
@@ -197,19 +198,8 @@ int bsp_init_system_clock(void) {
 }
 
 int bsp_init_debug_uart(void) {
-    // Enable USART2 clock for debug output
-    __HAL_RCC_USART2_CLK_ENABLE();
-    
-    // Configure GPIO pins for USART2
-    const bsp_pin_config_t* tx_pin = bsp_get_pin_config("DEBUG_TX");
-    const bsp_pin_config_t* rx_pin = bsp_get_pin_config("DEBUG_RX");
-    
-    if (tx_pin && rx_pin) {
-        bsp_configure_pin(tx_pin);
-        bsp_configure_pin(rx_pin);
-    }
-    
-    return 0;
+    // USART2 with DMA transmit; configures the DEBUG_TX/DEBUG_RX pins itself
+    return debug_uart_init(DEBUG_UART_BAUD);
 }
 
 const bsp_pin_config_t* bsp_get_pin_config(const char* pin_name) {
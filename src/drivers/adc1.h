@@ -0,0 +1,76 @@
+#pragma once
+
+/**
+ * @file adc1.h
+ * @brief Timer-triggered ADC1 acquisition with ping-pong DMA buffers
+ *
+ * TIM6 TRGO starts one scan of the configured channel sequence per sample
+ * period, DMA1 channel 1 stores the results in a circular buffer, and a
+ * consumer task delivers each half buffer through adc_stream (one
+ * interrupt per half buffer, none per conversion).
+ *
+ * The L4 regular oversampler can accumulate 2..256 conversions per result
+ * and shift the sum right, trading sample rate for resolution: 16x with a
+ * shift of 2 gives 14-bit results. Every scan then takes
+ * channels * ratio * (sample time + 12.5) ADC clock cycles, which must fit
+ * in the sample period.
+ *
+ * The channel pins must be set to analog mode by the caller.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "adc_stream.h"
+
+#define ADC1_IRQ_PRIORITY       6       // Below configMAX_SYSCALL_INTERRUPT_PRIORITY
+#define ADC1_TASK_STACK_WORDS   256     // Consumer task; runs the block callback
+
+/**
+ * @brief Acquisition Configuration
+ */
+typedef struct {
+    const uint8_t* channels;    // ADC1 input numbers (e.g. 5 = PA0), in scan order
+    uint8_t count;
+    uint8_t sample_time;        // SMPx code 0..7 (2.5 to 640.5 ADC cycles)
+    uint8_t oversample_log2;    // 0: off; n: 2^n conversions per result
+    uint8_t oversample_shift;   // Right shift of the sum, 0..8
+    uint16_t frames;            // Scans per half buffer
+    adc_block_ready_t ready;
+    void* arg;
+    uint32_t task_priority;
+} adc1_config_t;
+
+/**
+ * @brief Calibrate and configure ADC1, TIM6 and DMA1 channel 1, bind the
+ *        interrupt and create the consumer task
+ *
+ * Requires the RAM vector table (hal_irq_vectors_init()).
+ *
+ * @return 0 on success, -1 on an invalid configuration, -2 if the stream
+ *         could not be set up, -3 if the interrupt or task could not be created
+ */
+int adc1_init(const adc1_config_t* cfg);
+
+/**
+ * @brief Start sampling
+ * @param rate_hz Scans per second
+ * @return 0 on success, -1 if the rate cannot be produced by TIM6
+ */
+int adc1_start(uint32_t rate_hz);
+
+/**
+ * @brief Stop sampling
+ */
+void adc1_stop(void);
+
+/**
+ * @brief The ADC1 stream (statistics; valid after adc1_init())
+ */
+adc_stream_t* adc1_stream(void);
+
+#ifdef __cplusplus
+}
+#endif
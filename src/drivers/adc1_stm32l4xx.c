@@ -0,0 +1,214 @@
+/**
+ * @file adc1_stm32l4xx.c
+ * @brief Timer-triggered ADC1 acquisition with ping-pong DMA buffers for STM32L4xx
+ */
+
+#include "adc1.h"
+#include "basic_timer_stm32l4xx.h"
+#include "hal_irq.h"
+#include "stm32l4xx_hal.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+// ADC1 is request 0 on DMA1 channel 1; TIM6_TRGO is external trigger 13
+#define DMA_CHANNEL         DMA1_Channel1
+#define DMA_IRQn            DMA1_Channel1_IRQn
+#define ADC_EXTSEL_TIM6     (13UL << ADC_CFGR_EXTSEL_Pos)
+
+#define ADC_MAX_CHANNEL     18
+#define ADC_MAX_RANKS       16
+
+static adc_stream_t stream;
+static uint16_t dma_buffer[2 * ADC_STREAM_MAX_FRAMES * ADC_STREAM_MAX_CHANNELS];
+static uint32_t dma_len;
+
+static TaskHandle_t consumer;
+static StaticTask_t consumer_tcb;
+static StackType_t consumer_stack[ADC1_TASK_STACK_WORDS];
+
+// =============================================================================
+// ADC setup
+// =============================================================================
+
+static bool config_valid(const adc1_config_t* cfg) {
+    if (!cfg || !cfg->channels || cfg->count == 0 || cfg->count > ADC_STREAM_MAX_CHANNELS ||
+        cfg->count > ADC_MAX_RANKS || cfg->sample_time > 7U || cfg->oversample_log2 > 8U ||
+        cfg->oversample_shift > 8U) {
+        return false;
+    }
+    // Results are 16-bit: 12 bits plus the oversampling gain less the shift
+    if (12U + cfg->oversample_log2 - cfg->oversample_shift > 16U) {
+        return false;
+    }
+    for (uint8_t i = 0; i < cfg->count; i++) {
+        if (cfg->channels[i] == 0 || cfg->channels[i] > ADC_MAX_CHANNEL) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void busy_wait_us(uint32_t us) {
+    // At least 4 cycles per iteration
+    for (volatile uint32_t i = (SystemCoreClock / 4000000U) * us; i > 0; i--) {
+    }
+}
+
+static void power_up_and_calibrate(void) {
+    ADC1->CR &= ~ADC_CR_DEEPPWD;
+    ADC1->CR |= ADC_CR_ADVREGEN;
+    busy_wait_us(20);  // tADCVREG_STUP
+
+    ADC1->CR &= ~ADC_CR_ADCALDIF;
+    ADC1->CR |= ADC_CR_ADCAL;
+    while (ADC1->CR & ADC_CR_ADCAL) {
+    }
+
+    ADC1->ISR = ADC_ISR_ADRDY;
+    ADC1->CR |= ADC_CR_ADEN;
+    while ((ADC1->ISR & ADC_ISR_ADRDY) == 0) {
+    }
+}
+
+static void program_sequence(const adc1_config_t* cfg) {
+    volatile uint32_t* const sqr[] = {&ADC1->SQR1, &ADC1->SQR2, &ADC1->SQR3, &ADC1->SQR4};
+    uint32_t seq[4] = {(uint32_t)(cfg->count - 1U) << ADC_SQR1_L_Pos, 0, 0, 0};
+    uint32_t smpr1 = 0;
+    uint32_t smpr2 = 0;
+
+    for (uint32_t rank = 1; rank <= cfg->count; rank++) {
+        const uint32_t ch = cfg->channels[rank - 1U];
+        // SQR1 holds ranks 1-4 after the length field, the others 5 each
+        const uint32_t reg = (rank <= 4U) ? 0U : 1U + (rank - 5U) / 5U;
+        const uint32_t pos = (rank <= 4U) ? 6U * rank : 6U * ((rank - 5U) % 5U);
+        seq[reg] |= ch << pos;
+
+        if (ch < 10U) {
+            smpr1 |= (uint32_t)cfg->sample_time << (3U * ch);
+        } else {
+            smpr2 |= (uint32_t)cfg->sample_time << (3U * (ch - 10U));
+        }
+    }
+    for (uint32_t i = 0; i < 4U; i++) {
+        *sqr[i] = seq[i];
+    }
+    ADC1->SMPR1 = smpr1;
+    ADC1->SMPR2 = smpr2;
+}
+
+// =============================================================================
+// Interrupt and consumer task
+// =============================================================================
+
+static void dma_irq(void) {
+    const uint32_t isr = DMA1->ISR;
+    bool ready = false;
+
+    if (isr & DMA_ISR_HTIF1) {
+        DMA1->IFCR = DMA_IFCR_CHTIF1;
+        adc_stream_half_done(&stream, 0);
+        ready = true;
+    }
+    if (isr & DMA_ISR_TCIF1) {
+        DMA1->IFCR = DMA_IFCR_CTCIF1;
+        adc_stream_half_done(&stream, 1);
+        ready = true;
+    }
+    if (isr & DMA_ISR_TEIF1) {
+        // The channel disables itself on a transfer error; stop the trigger too
+        DMA1->IFCR = DMA_IFCR_CGIF1;
+        TIM6->CR1 &= ~TIM_CR1_CEN;
+    }
+
+    if (ready) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(consumer, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
+static void consumer_task(void* pvParameters) {
+    (void)pvParameters;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        (void)adc_stream_service(&stream);
+    }
+}
+
+// Public API implementations
+
+int adc1_init(const adc1_config_t* cfg) {
+    if (!config_valid(cfg)) {
+        return -1;
+    }
+    if (adc_stream_init(&stream, dma_buffer, cfg->count, cfg->frames, cfg->ready, cfg->arg) != 0) {
+        return -2;
+    }
+    dma_len = 2U * cfg->frames * cfg->count;
+
+    __HAL_RCC_ADC_CLK_ENABLE();
+    __HAL_RCC_TIM6_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    // Synchronous ADC clock, HCLK / 1
+    ADC1_COMMON->CCR = (ADC1_COMMON->CCR & ~ADC_CCR_CKMODE) | ADC_CCR_CKMODE_0;
+    power_up_and_calibrate();
+
+    // Circular DMA requests, conversion on each rising TIM6 TRGO edge
+    ADC1->CFGR = ADC_CFGR_DMAEN | ADC_CFGR_DMACFG | ADC_CFGR_OVRMOD | ADC_CFGR_EXTEN_0 | ADC_EXTSEL_TIM6;
+    ADC1->CFGR2 = cfg->oversample_log2
+                      ? ADC_CFGR2_ROVSE | ((uint32_t)(cfg->oversample_log2 - 1U) << ADC_CFGR2_OVSR_Pos) |
+                            ((uint32_t)cfg->oversample_shift << ADC_CFGR2_OVSS_Pos)
+                      : 0U;
+    program_sequence(cfg);
+
+    DMA_CHANNEL->CCR = 0;
+    DMA_CHANNEL->CPAR = (uint32_t)&ADC1->DR;
+    DMA1_CSELR->CSELR &= ~DMA_CSELR_C1S;
+
+    // TRGO on update
+    TIM6->CR1 = 0;
+    TIM6->CR2 = TIM_CR2_MMS_1;
+
+    consumer = xTaskCreateStatic(consumer_task, "ADC", ADC1_TASK_STACK_WORDS, NULL, cfg->task_priority,
+                                 consumer_stack, &consumer_tcb);
+    if (!consumer || hal_irq_bind(DMA_IRQn, dma_irq) != 0) {
+        return -3;
+    }
+    HAL_NVIC_SetPriority(DMA_IRQn, ADC1_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(DMA_IRQn);
+    return 0;
+}
+
+int adc1_start(uint32_t rate_hz) {
+    adc1_stop();
+    if (basic_timer_set_rate(TIM6, rate_hz) != 0) {
+        return -1;
+    }
+
+    DMA1->IFCR = DMA_IFCR_CGIF1;
+    DMA_CHANNEL->CMAR = (uint32_t)dma_buffer;
+    DMA_CHANNEL->CNDTR = dma_len;
+    DMA_CHANNEL->CCR = DMA_CCR_PL_1 | DMA_CCR_MSIZE_0 | DMA_CCR_PSIZE_0 | DMA_CCR_MINC | DMA_CCR_CIRC |
+                       DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_TEIE | DMA_CCR_EN;
+
+    ADC1->ISR = ADC_ISR_OVR | ADC_ISR_EOC | ADC_ISR_EOS;
+    ADC1->CR |= ADC_CR_ADSTART;     // Armed; converts on the next trigger
+    TIM6->CR1 = TIM_CR1_CEN;
+    return 0;
+}
+
+void adc1_stop(void) {
+    TIM6->CR1 &= ~TIM_CR1_CEN;
+    if (ADC1->CR & ADC_CR_ADSTART) {
+        ADC1->CR |= ADC_CR_ADSTP;
+        while (ADC1->CR & ADC_CR_ADSTP) {
+        }
+    }
+    DMA_CHANNEL->CCR = 0;
+}
+
+adc_stream_t* adc1_stream(void) {
+    return &stream;
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+/**
+ * @file adc_stream.h
+ * @brief Continuous multi-channel ADC acquisition into ping-pong buffers
+ *
+ * A timer triggers one scan of the channel sequence per sample period and
+ * a circular DMA channel stores the results, interleaved, in a buffer of
+ * two halves. The DMA half-transfer and transfer-complete interrupts are
+ * the only interrupts taken: one per `frames` scans, not one per
+ * conversion. Each interrupt just records which half is ready; the
+ * consumer task then deinterleaves it into per-channel arrays and hands
+ * the block to the application callback.
+ *
+ * The consumer has one half-buffer period to copy a half out before the
+ * DMA writes it again. A half overwritten during the copy is discarded
+ * and counted as an overrun; halves completed while the consumer was
+ * behind are skipped (only the newest is delivered) and counted as missed.
+ *
+ * adc1_stm32l4xx.c runs this over ADC1, TIM6 and DMA1 channel 1.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef ADC_STREAM_MAX_CHANNELS
+#define ADC_STREAM_MAX_CHANNELS     8
+#endif
+
+#ifndef ADC_STREAM_MAX_FRAMES
+#define ADC_STREAM_MAX_FRAMES       64      // Scans per half buffer
+#endif
+
+/**
+ * @brief Deinterleaved Half Buffer
+ */
+typedef struct {
+    uint32_t seq;               // Half buffers completed before and including this one
+    uint16_t frames;
+    uint8_t channels;
+    uint16_t ch[ADC_STREAM_MAX_CHANNELS][ADC_STREAM_MAX_FRAMES];
+} adc_block_t;
+
+/**
+ * @brief Block callback (runs on the consumer task)
+ */
+typedef void (*adc_block_ready_t)(void* arg, const adc_block_t* block);
+
+/**
+ * @brief Stream Statistics
+ */
+typedef struct {
+    uint32_t halves;            // Half buffers completed by the DMA
+    uint32_t blocks;            // Delivered to the callback
+    uint32_t missed;            // Completed while the consumer was behind
+    uint32_t overruns;          // Overwritten while being copied
+} adc_stream_stats_t;
+
+/**
+ * @brief Stream State
+ */
+typedef struct {
+    const uint16_t* dma_buffer; // 2 * frames * channels results
+    uint16_t frames;
+    uint8_t channels;
+    adc_block_ready_t ready;
+    void* arg;
+    volatile uint32_t completed;    // Halves completed (DMA interrupt)
+    volatile uint8_t latest;        // Half written last
+    uint32_t consumed;              // Value of completed at the last service
+    adc_block_t block;
+    adc_stream_stats_t stats;
+} adc_stream_t;
+
+// =============================================================================
+// Stream API
+// =============================================================================
+
+/**
+ * @brief Initialize a stream
+ * @param stream Stream state
+ * @param dma_buffer Circular DMA target of 2 * frames * channels results
+ * @param channels Channels per scan
+ * @param frames Scans per half buffer
+ * @param ready Called with each block on the consumer task
+ * @param arg Passed to ready
+ * @return 0 on success, -1 on invalid arguments
+ */
+int adc_stream_init(adc_stream_t* stream, const uint16_t* dma_buffer, uint8_t channels, uint16_t frames,
+                    adc_block_ready_t ready, void* arg);
+
+/**
+ * @brief Record a finished half buffer (DMA interrupt)
+ * @param stream Stream
+ * @param half 0 after half transfer, 1 after transfer complete
+ */
+void adc_stream_half_done(adc_stream_t* stream, uint8_t half);
+
+/**
+ * @brief Deliver the newest finished half buffer, if any (consumer task)
+ * @return true if a block was delivered
+ */
+bool adc_stream_service(adc_stream_t* stream);
+
+/**
+ * @brief Split interleaved scans into per-channel arrays
+ * @param src frames * channels results, one scan after another
+ * @param out Receives frames and channels as well
+ */
+void adc_stream_deinterleave(const uint16_t* src, uint8_t channels, uint16_t frames, adc_block_t* out);
+
+/**
+ * @brief Read the stream statistics
+ */
+void adc_stream_get_stats(const adc_stream_t* stream, adc_stream_stats_t* out);
+
+#ifdef __cplusplus
+}
+#endif
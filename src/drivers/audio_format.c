@@ -0,0 +1,98 @@
+/**
+ * @file audio_format.c
+ * @brief Audio sample format conversion
+ */
+
+#include "audio_format.h"
+#include "sections.h"
+#include <string.h>
+
+#if defined(__ARM_FEATURE_DSP) && !defined(UNIT_TESTING)
+#include "stm32l4xx.h"
+#define QADD(a, b)          __QADD((a), (b))
+#define PKHTB(hi, lo, s)    __PKHTB((hi), (lo), (s))
+#else
+static inline int32_t QADD(int32_t a, int32_t b) {
+    const int64_t sum = (int64_t)a + b;
+    return (int32_t)(sum > INT32_MAX ? INT32_MAX : (sum < INT32_MIN ? INT32_MIN : sum));
+}
+
+// Top half of hi, (lo >> s) in the bottom half
+static inline uint32_t PKHTB(int32_t hi, int32_t lo, uint32_t s) {
+    return ((uint32_t)hi & 0xFFFF0000U) | (((uint32_t)(lo >> s)) & 0x0000FFFFU);
+}
+#endif
+
+// Public API implementations
+
+// The per-sample converters run on every DMA half-transfer, twice per
+// block; they make no calls, so they run from SRAM2 (RAMFUNC)
+
+RAMFUNC void audio_s16_to_q31(const int16_t* in, int32_t* out, size_t n) {
+    // Two samples per word: the first in the low half (little endian)
+    for (; n >= 2; n -= 2, in += 2, out += 2) {
+        uint32_t pair;
+        memcpy(&pair, in, sizeof(pair));
+        out[0] = (int32_t)(pair << 16);
+        out[1] = (int32_t)(pair & 0xFFFF0000U);
+    }
+    if (n) {
+        out[0] = (int32_t)((uint32_t)(uint16_t)in[0] << 16);
+    }
+}
+
+RAMFUNC void audio_q31_to_s16(const int32_t* in, int16_t* out, size_t n) {
+    for (; n >= 2; n -= 2, in += 2, out += 2) {
+        const int32_t a = QADD(in[0], 0x8000);
+        const int32_t b = QADD(in[1], 0x8000);
+        const uint32_t pair = PKHTB(b, a, 16);
+        memcpy(out, &pair, sizeof(pair));
+    }
+    if (n) {
+        out[0] = (int16_t)(QADD(in[0], 0x8000) >> 16);
+    }
+}
+
+RAMFUNC void audio_s24_to_q31(const int32_t* in, int32_t* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (int32_t)((uint32_t)in[i] << 8);
+    }
+}
+
+RAMFUNC void audio_q31_to_s24(const int32_t* in, int32_t* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = QADD(in[i], 0x80) >> 8;
+    }
+}
+
+size_t audio_format_bytes(audio_format_t format) {
+    return (format == AUDIO_FMT_S16) ? sizeof(int16_t) : sizeof(int32_t);
+}
+
+void audio_to_q31(audio_format_t format, const void* in, int32_t* out, size_t n) {
+    switch (format) {
+    case AUDIO_FMT_S16:
+        audio_s16_to_q31((const int16_t*)in, out, n);
+        break;
+    case AUDIO_FMT_S24:
+        audio_s24_to_q31((const int32_t*)in, out, n);
+        break;
+    case AUDIO_FMT_Q31:
+        memmove(out, in, n * sizeof(int32_t));
+        break;
+    }
+}
+
+void audio_from_q31(audio_format_t format, const int32_t* in, void* out, size_t n) {
+    switch (format) {
+    case AUDIO_FMT_S16:
+        audio_q31_to_s16(in, (int16_t*)out, n);
+        break;
+    case AUDIO_FMT_S24:
+        audio_q31_to_s24(in, (int32_t*)out, n);
+        break;
+    case AUDIO_FMT_Q31:
+        memmove(out, in, n * sizeof(int32_t));
+        break;
+    }
+}
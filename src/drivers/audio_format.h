@@ -0,0 +1,56 @@
+#pragma once
+
+/**
+ * @file audio_format.h
+ * @brief Audio sample format conversion
+ *
+ * Formats as they appear in SAI slots and DMA buffers:
+ * - S16: int16_t samples
+ * - S24: 24-bit samples right aligned in int32_t words (bits above 23 ignored)
+ * - Q31: int32_t full-scale fractions, the processing format
+ *
+ * Narrowing conversions round to nearest and saturate. On the Cortex-M4 the
+ * 16-bit paths move two samples per 32-bit load or store, with QADD for
+ * the saturating rounding and PKHTB to pack two results into one word;
+ * host builds use equivalent C.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Slot Data Formats
+ */
+typedef enum {
+    AUDIO_FMT_S16,
+    AUDIO_FMT_S24,
+    AUDIO_FMT_Q31
+} audio_format_t;
+
+void audio_s16_to_q31(const int16_t* in, int32_t* out, size_t n);
+void audio_q31_to_s16(const int32_t* in, int16_t* out, size_t n);
+void audio_s24_to_q31(const int32_t* in, int32_t* out, size_t n);
+void audio_q31_to_s24(const int32_t* in, int32_t* out, size_t n);
+
+/**
+ * @brief Bytes per sample of a format
+ */
+size_t audio_format_bytes(audio_format_t format);
+
+/**
+ * @brief Convert n samples from a slot format to Q31
+ */
+void audio_to_q31(audio_format_t format, const void* in, int32_t* out, size_t n);
+
+/**
+ * @brief Convert n Q31 samples to a slot format
+ */
+void audio_from_q31(audio_format_t format, const int32_t* in, void* out, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,63 @@
+/**
+ * @file audio_stream.c
+ * @brief Block-based full-duplex audio over circular DMA buffers
+ */
+
+#include "audio_stream.h"
+#include <string.h>
+
+// Public API implementations
+
+size_t audio_stream_dma_bytes(const audio_stream_config_t* cfg) {
+    return 2U * cfg->block_frames * cfg->channels * audio_format_bytes(cfg->format);
+}
+
+int audio_stream_init(audio_stream_t* stream, const audio_stream_config_t* cfg, void* rx_dma, void* tx_dma) {
+    if (!stream || !cfg || cfg->channels == 0 || cfg->channels > AUDIO_STREAM_MAX_CHANNELS ||
+        cfg->block_frames == 0 || (size_t)cfg->block_frames * cfg->channels > AUDIO_STREAM_MAX_SAMPLES ||
+        cfg->format > AUDIO_FMT_Q31 || (!rx_dma && !tx_dma)) {
+        return -1;
+    }
+
+    memset(stream, 0, sizeof(*stream));
+    stream->cfg = *cfg;
+    stream->rx_dma = (uint8_t*)rx_dma;
+    stream->tx_dma = (uint8_t*)tx_dma;
+    stream->block_bytes = audio_stream_dma_bytes(cfg) / 2U;
+    if (tx_dma) {
+        memset(tx_dma, 0, audio_stream_dma_bytes(cfg));
+    }
+    return 0;
+}
+
+void audio_stream_half_done(audio_stream_t* stream, uint8_t half) {
+    const audio_stream_config_t* cfg = &stream->cfg;
+    const size_t samples = (size_t)cfg->block_frames * cfg->channels;
+    const size_t offset = (half & 1U) * stream->block_bytes;
+
+    if (half != stream->next_half) {
+        stream->stats.slips++;
+    }
+    stream->next_half = (half & 1U) ^ 1U;
+
+    if (stream->rx_dma) {
+        audio_to_q31(cfg->format, stream->rx_dma + offset, stream->work, samples);
+    } else {
+        memset(stream->work, 0, samples * sizeof(int32_t));
+    }
+
+    if (cfg->process) {
+        cfg->process(cfg->arg, stream->work, cfg->block_frames, cfg->channels);
+    }
+
+    if (stream->tx_dma) {
+        audio_from_q31(cfg->format, stream->work, stream->tx_dma + offset, samples);
+    }
+    stream->stats.blocks++;
+}
+
+void audio_stream_get_stats(const audio_stream_t* stream, audio_stream_stats_t* out) {
+    if (out) {
+        *out = stream->stats;
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+/**
+ * @file audio_stream.h
+ * @brief Block-based full-duplex audio over circular DMA buffers
+ *
+ * Receive and transmit each use a circular DMA buffer of two blocks. When
+ * the receiver finishes a block (half-transfer or transfer-complete
+ * interrupt) the stream converts it to Q31, passes it to the process
+ * callback to be modified in place, and converts the result into the same
+ * half of the transmit buffer, which the transmitter has just finished
+ * playing. One interrupt per block, none per sample; input to output
+ * latency is two blocks.
+ *
+ * Samples are interleaved by frame: block[frame * channels + slot].
+ * Either direction may be left out (capture or playback only): a missing
+ * input reads as silence and a missing output is dropped.
+ *
+ * sai1_stm32l4xx.c runs this over SAI1; the host tests feed it from WAV
+ * files.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include "audio_format.h"
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef AUDIO_STREAM_MAX_SAMPLES
+#define AUDIO_STREAM_MAX_SAMPLES    256     // frames * channels per block
+#endif
+
+#define AUDIO_STREAM_MAX_CHANNELS   8       // TDM slots
+
+/**
+ * @brief Block callback (runs in the receive DMA interrupt)
+ * @param arg Context from the configuration
+ * @param block frames * channels Q31 samples, input on entry, output on return
+ * @param frames Frames in the block
+ * @param channels Samples per frame
+ */
+typedef void (*audio_process_t)(void* arg, int32_t* block, uint16_t frames, uint8_t channels);
+
+/**
+ * @brief Stream Configuration
+ */
+typedef struct {
+    audio_format_t format;      // Slot data as moved by the DMA
+    uint8_t channels;
+    uint16_t block_frames;
+    audio_process_t process;
+    void* arg;
+} audio_stream_config_t;
+
+/**
+ * @brief Stream Statistics
+ */
+typedef struct {
+    uint32_t blocks;
+    uint32_t slips;             // Blocks that did not alternate halves (lost interrupt)
+} audio_stream_stats_t;
+
+/**
+ * @brief Stream State
+ */
+typedef struct {
+    audio_stream_config_t cfg;
+    uint8_t* rx_dma;            // Two blocks, or NULL
+    uint8_t* tx_dma;            // Two blocks, or NULL
+    size_t block_bytes;
+    uint8_t next_half;
+    int32_t work[AUDIO_STREAM_MAX_SAMPLES];
+    audio_stream_stats_t stats;
+} audio_stream_t;
+
+// =============================================================================
+// Stream API
+// =============================================================================
+
+/**
+ * @brief Bytes of one DMA buffer (both blocks) for a configuration
+ */
+size_t audio_stream_dma_bytes(const audio_stream_config_t* cfg);
+
+/**
+ * @brief Initialize a stream
+ * @param stream Stream state
+ * @param cfg Format, geometry and callback
+ * @param rx_dma Receive DMA buffer of audio_stream_dma_bytes(), or NULL
+ * @param tx_dma Transmit DMA buffer of audio_stream_dma_bytes(), or NULL;
+ *        cleared to silence
+ * @return 0 on success, -1 on invalid arguments
+ */
+int audio_stream_init(audio_stream_t* stream, const audio_stream_config_t* cfg, void* rx_dma, void* tx_dma);
+
+/**
+ * @brief Process the block the DMA has just finished (DMA interrupt)
+ * @param stream Stream
+ * @param half 0 after half transfer, 1 after transfer complete
+ */
+void audio_stream_half_done(audio_stream_t* stream, uint8_t half);
+
+/**
+ * @brief Read the stream statistics
+ */
+void audio_stream_get_stats(const audio_stream_t* stream, audio_stream_stats_t* out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,29 @@
+/**
+ * @file basic_timer_stm32l4xx.c
+ * @brief Update rate of the TIM6/TIM7 basic timers for STM32L4xx
+ */
+
+#include "basic_timer_stm32l4xx.h"
+
+// Public API implementations
+
+int basic_timer_set_rate(TIM_TypeDef* tim, uint32_t rate_hz) {
+    // APB1 timers run at twice PCLK1 when APB1 is divided
+    uint32_t clk = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+        clk *= 2U;
+    }
+    if (rate_hz == 0 || rate_hz > clk / 2U) {
+        return -1;
+    }
+    const uint32_t ticks = clk / rate_hz;
+    const uint32_t psc = (ticks - 1U) / 65536U;
+    if (psc > 0xFFFFU) {
+        return -1;
+    }
+
+    tim->PSC = psc;
+    tim->ARR = ticks / (psc + 1U) - 1U;
+    tim->EGR = TIM_EGR_UG;
+    return 0;  // Success
+}
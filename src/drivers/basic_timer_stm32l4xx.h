@@ -0,0 +1,30 @@
+#pragma once
+
+/**
+ * @file basic_timer_stm32l4xx.h
+ * @brief Update rate of the TIM6/TIM7 basic timers that pace ADC1 and DAC1
+ *
+ * Family-private: shared by adc1_stm32l4xx.c and dac1_stm32l4xx.c.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "stm32l4xx_hal.h"
+
+/**
+ * @brief Program the prescaler and auto-reload for rate_hz updates per second
+ *
+ * The timer must be stopped. The new values are loaded at once (UG) and the
+ * rate is rounded down to the nearest one the APB1 timer clock divides to.
+ *
+ * @return 0 on success, -1 if rate_hz is 0, above half the timer clock or
+ *         too low for the 16-bit prescaler
+ */
+int basic_timer_set_rate(TIM_TypeDef* tim, uint32_t rate_hz);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,80 @@
+#pragma once
+
+/**
+ * @file dac1.h
+ * @brief DAC1 channel 1 (PA4) output streamed by DMA on a timer trigger
+ *
+ * TIM7 TRGO latches one sample per period from DMA2 channel 4, so the
+ * output timing is set by the timer alone, never by software.
+ *
+ * - dac1_start_loop() replays a buffer forever (circular DMA, no
+ *   interrupts): periodic waveforms at zero CPU cost.
+ * - dac1_start_stream() plays a double buffer and calls the refill
+ *   function from the DMA interrupt for each half that has just played,
+ *   for streams that do not repeat within a buffer.
+ *
+ * Samples are 12-bit right-aligned codes (waveform.h renders them).
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define DAC1_IRQ_PRIORITY       6       // Below configMAX_SYSCALL_INTERRUPT_PRIORITY
+
+/**
+ * @brief Refill callback (runs in the DMA interrupt)
+ * @param arg Context given to dac1_start_stream()
+ * @param half The half buffer to write
+ * @param n Samples in the half
+ */
+typedef void (*dac1_refill_t)(void* arg, uint16_t* half, uint16_t n);
+
+/**
+ * @brief Configure PA4, DAC1 and DMA2 channel 4, and bind the interrupt
+ *
+ * Requires the RAM vector table (hal_irq_vectors_init()).
+ *
+ * @return 0 on success, negative error code on failure
+ */
+int dac1_init(void);
+
+/**
+ * @brief Replay a buffer continuously
+ * @param rate_hz Samples per second
+ * @param samples Buffer (must stay valid until dac1_stop())
+ * @param n Samples in the buffer
+ * @return 0 on success, -1 on invalid arguments or an unreachable rate
+ */
+int dac1_start_loop(uint32_t rate_hz, const uint16_t* samples, uint16_t n);
+
+/**
+ * @brief Play a double buffer, refilling each half after it has played
+ *
+ * Both halves are filled before the output starts.
+ *
+ * @param rate_hz Samples per second
+ * @param buffer Double buffer of n samples (n even)
+ * @param n Samples in the whole buffer
+ * @param refill Writes the next n / 2 samples
+ * @param arg Passed to refill (e.g. a waveform_t* with waveform_refill())
+ * @return 0 on success, -1 on invalid arguments or an unreachable rate
+ */
+int dac1_start_stream(uint32_t rate_hz, uint16_t* buffer, uint16_t n, dac1_refill_t refill, void* arg);
+
+/**
+ * @brief Stop the output (the last code stays on the pin)
+ */
+void dac1_stop(void);
+
+/**
+ * @brief Refills that started after the DMA had already moved into their
+ *        half (the stream glitched)
+ */
+uint32_t dac1_underruns(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,149 @@
+/**
+ * @file dac1_stm32l4xx.c
+ * @brief DAC1 channel 1 output streamed by DMA on a timer trigger for STM32L4xx
+ */
+
+#include "dac1.h"
+#include "basic_timer_stm32l4xx.h"
+#include "hal_irq.h"
+#include "stm32l4xx_hal.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+// DAC_CH1 is request 3 on DMA2 channel 4 (DMA1 channel 3 belongs to SPI1
+// TX); TIM7_TRGO is DAC trigger 2
+#define DMA_CHANNEL         DMA2_Channel4
+#define DMA_IRQn            DMA2_Channel4_IRQn
+#define DMA_REQUEST         (3UL << DMA_CSELR_C4S_Pos)
+#define DAC_TSEL_TIM7       DAC_CR_TSEL1_1
+
+static uint16_t* stream_buffer;
+static uint16_t stream_half;
+static dac1_refill_t stream_refill;
+static void* stream_arg;
+static volatile uint32_t underruns;
+
+// =============================================================================
+// Timer and DMA
+// =============================================================================
+
+static void start(const uint16_t* samples, uint16_t n, uint32_t irqs) {
+    DMA2->IFCR = DMA_IFCR_CGIF4;
+    DMA_CHANNEL->CMAR = (uint32_t)samples;
+    DMA_CHANNEL->CNDTR = n;
+    DMA_CHANNEL->CCR = DMA_CCR_PL_1 | DMA_CCR_MSIZE_0 | DMA_CCR_PSIZE_0 | DMA_CCR_MINC | DMA_CCR_CIRC |
+                       DMA_CCR_DIR | irqs | DMA_CCR_EN;
+
+    // Each trigger moves DHR to the output, then the DMA reloads DHR: preload
+    // the first sample so the output does not start on a stale code
+    DAC1->DHR12R1 = samples[0];
+    DAC1->CR = DAC_TSEL_TIM7 | DAC_CR_TEN1 | DAC_CR_DMAEN1 | DAC_CR_EN1;
+    TIM7->CR1 = TIM_CR1_CEN;
+}
+
+// =============================================================================
+// Interrupt
+// =============================================================================
+
+static void refill(uint16_t* half, bool first) {
+    // CNDTR counts down: the DMA is in the first half while it is above n / 2
+    const bool dma_in_first = DMA_CHANNEL->CNDTR > stream_half;
+    if (dma_in_first == first) {
+        underruns++;
+    }
+    stream_refill(stream_arg, half, stream_half);
+}
+
+static void dma_irq(void) {
+    const uint32_t isr = DMA2->ISR;
+
+    if (isr & DMA_ISR_HTIF4) {
+        DMA2->IFCR = DMA_IFCR_CHTIF4;
+        refill(stream_buffer, true);
+    }
+    if (isr & DMA_ISR_TCIF4) {
+        DMA2->IFCR = DMA_IFCR_CTCIF4;
+        refill(stream_buffer + stream_half, false);
+    }
+    if (isr & DMA_ISR_TEIF4) {
+        DMA2->IFCR = DMA_IFCR_CGIF4;
+        TIM7->CR1 &= ~TIM_CR1_CEN;
+    }
+}
+
+// Public API implementations
+
+int dac1_init(void) {
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_DAC1_CLK_ENABLE();
+    __HAL_RCC_TIM7_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    GPIO_InitTypeDef gpio = {0};
+    gpio.Pin = GPIO_PIN_4;
+    gpio.Mode = GPIO_MODE_ANALOG;
+    gpio.Pull = GPIO_NOPULL;
+    HAL_GPIO_Init(GPIOA, &gpio);
+
+    // Normal mode, output buffer on, connected to the pin
+    DAC1->CR = 0;
+    DAC1->MCR &= ~DAC_MCR_MODE1;
+
+    DMA_CHANNEL->CCR = 0;
+    DMA_CHANNEL->CPAR = (uint32_t)&DAC1->DHR12R1;
+    DMA2_CSELR->CSELR = (DMA2_CSELR->CSELR & ~DMA_CSELR_C4S) | DMA_REQUEST;
+
+    // TRGO on update
+    TIM7->CR1 = 0;
+    TIM7->CR2 = TIM_CR2_MMS_1;
+
+    if (hal_irq_bind(DMA_IRQn, dma_irq) != 0) {
+        return -1;
+    }
+    HAL_NVIC_SetPriority(DMA_IRQn, DAC1_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(DMA_IRQn);
+    return 0;
+}
+
+int dac1_start_loop(uint32_t rate_hz, const uint16_t* samples, uint16_t n) {
+    if (!samples || n == 0) {
+        return -1;
+    }
+
+    dac1_stop();
+    if (basic_timer_set_rate(TIM7, rate_hz) != 0) {
+        return -1;
+    }
+    start(samples, n, DMA_CCR_TEIE);
+    return 0;
+}
+
+int dac1_start_stream(uint32_t rate_hz, uint16_t* buffer, uint16_t n, dac1_refill_t refill_fn, void* arg) {
+    if (!buffer || !refill_fn || n < 2U || (n & 1U)) {
+        return -1;
+    }
+
+    dac1_stop();
+    if (basic_timer_set_rate(TIM7, rate_hz) != 0) {
+        return -1;
+    }
+
+    stream_buffer = buffer;
+    stream_half = n / 2U;
+    stream_refill = refill_fn;
+    stream_arg = arg;
+    refill_fn(arg, buffer, n / 2U);
+    refill_fn(arg, buffer + n / 2U, n / 2U);
+    start(buffer, n, DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_TEIE);
+    return 0;
+}
+
+void dac1_stop(void) {
+    TIM7->CR1 &= ~TIM_CR1_CEN;
+    DAC1->CR &= ~(DAC_CR_DMAEN1 | DAC_CR_TEN1);
+    DMA_CHANNEL->CCR = 0;
+}
+
+uint32_t dac1_underruns(void) {
+    return underruns;
+}
@@ -0,0 +1,265 @@
+/**
+ * @file debug_uart.cpp
+ * @brief Debug console on USART2 with DMA transmit and receive
+ */
+
+#include "debug_uart.h"
+#include "uart_tx.hpp"
+#include "uart_rx.hpp"
+
+extern "C" {
+#include "stm32l4xx_hal.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "stream_buffer.h"
+#include "hal_irq.h"
+}
+
+// USART2_TX is request 2 on DMA1 channel 7
+#define TX_DMA_CHANNEL      DMA1_Channel7
+#define TX_DMA_IRQn         DMA1_Channel7_IRQn
+#define TX_DMA_REQUEST      (2UL << DMA_CSELR_C7S_Pos)
+
+// USART2_RX is request 2 on DMA1 channel 6
+#define RX_DMA_CHANNEL      DMA1_Channel6
+#define RX_DMA_IRQn         DMA1_Channel6_IRQn
+#define RX_DMA_REQUEST      (2UL << DMA_CSELR_C6S_Pos)
+
+#define USART_ERRORS        (USART_ISR_ORE | USART_ISR_FE | USART_ISR_NE)
+
+namespace {
+
+SemaphoreHandle_t write_mutex;
+SemaphoreHandle_t space_sem;
+StaticSemaphore_t write_mutex_storage;
+StaticSemaphore_t space_sem_storage;
+StreamBufferHandle_t rx_stream;
+StaticStreamBuffer_t rx_stream_storage;
+uint8_t rx_stream_buffer[DEBUG_UART_RX_STREAM + 1];
+UBaseType_t critical_mask;
+BaseType_t isr_woken;
+BaseType_t rx_woken;
+
+bool scheduler_running() {
+    return xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED;
+}
+
+struct DebugUartPort {
+    static bool lock() {
+        if (xPortIsInsideInterrupt()) {
+            return false;
+        }
+        return !scheduler_running() || xSemaphoreTake(write_mutex, portMAX_DELAY) == pdTRUE;
+    }
+
+    static void unlock() {
+        if (scheduler_running()) {
+            xSemaphoreGive(write_mutex);
+        }
+    }
+
+    static bool wait_space(uint32_t timeout_ms) {
+        // Before the scheduler starts the DMA interrupt is still masked
+        return scheduler_running() && xSemaphoreTake(space_sem, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+    }
+
+    static void signal_space() {
+        xSemaphoreGiveFromISR(space_sem, &isr_woken);
+    }
+
+    static void enter_critical() {
+        critical_mask = taskENTER_CRITICAL_FROM_ISR();
+    }
+
+    static void exit_critical() {
+        taskEXIT_CRITICAL_FROM_ISR(critical_mask);
+    }
+
+    static void start_dma(const uint8_t* data, std::size_t len) {
+        TX_DMA_CHANNEL->CCR &= ~DMA_CCR_EN;
+        TX_DMA_CHANNEL->CMAR = reinterpret_cast<uint32_t>(data);
+        TX_DMA_CHANNEL->CNDTR = static_cast<uint32_t>(len);
+        TX_DMA_CHANNEL->CCR |= DMA_CCR_EN;
+    }
+};
+
+struct DebugUartRxPort {
+    static std::size_t deliver(const uint8_t* data, std::size_t len) {
+        return xStreamBufferSendFromISR(rx_stream, data, len, &rx_woken);
+    }
+};
+
+UartTx<DEBUG_UART_TX_BUFFER, DebugUartPort> tx;
+UartRx<DEBUG_UART_RX_DMA_BUFFER, DebugUartRxPort> rx;
+bool initialized = false;
+
+void tx_dma_irq() {
+    const uint32_t isr = DMA1->ISR;
+    if ((isr & (DMA_ISR_TCIF7 | DMA_ISR_TEIF7)) == 0) {
+        return;
+    }
+
+    // A transfer error also ends the transfer; release the span either way
+    // so the ring cannot stall
+    DMA1->IFCR = DMA_IFCR_CGIF7;
+    isr_woken = pdFALSE;
+    tx.on_dma_complete();
+    portYIELD_FROM_ISR(isr_woken);
+}
+
+// Half-transfer and transfer-complete of the circular receive channel
+void rx_dma_irq() {
+    const uint32_t isr = DMA1->ISR;
+    if ((isr & (DMA_ISR_HTIF6 | DMA_ISR_TCIF6)) == 0) {
+        return;
+    }
+
+    DMA1->IFCR = DMA_IFCR_CHTIF6 | DMA_IFCR_CTCIF6;
+    rx_woken = pdFALSE;
+    rx.on_dma_event(RX_DMA_CHANNEL->CNDTR);
+    portYIELD_FROM_ISR(rx_woken);
+}
+
+// Idle line (end of a burst) and receive errors
+void usart_irq() {
+    const uint32_t isr = USART2->ISR;
+    rx_woken = pdFALSE;
+
+    if (isr & USART_ERRORS) {
+        USART2->ICR = USART_ICR_ORECF | USART_ICR_FECF | USART_ICR_NECF;
+        rx.on_line_errors(((isr & USART_ISR_ORE) ? UART_RX_ERR_OVERRUN : 0U) |
+                          ((isr & USART_ISR_FE) ? UART_RX_ERR_FRAMING : 0U) |
+                          ((isr & USART_ISR_NE) ? UART_RX_ERR_NOISE : 0U));
+    }
+    if (isr & USART_ISR_IDLE) {
+        USART2->ICR = USART_ICR_IDLECF;
+        rx.on_dma_event(RX_DMA_CHANNEL->CNDTR);
+    }
+
+    portYIELD_FROM_ISR(rx_woken);
+}
+
+void configure_pins() {
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+
+    GPIO_InitTypeDef gpio = {};
+    gpio.Mode = GPIO_MODE_AF_PP;
+    gpio.Pull = GPIO_PULLUP;
+    gpio.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+
+    gpio.Pin = GPIO_PIN_2;
+    gpio.Alternate = GPIO_AF7_USART2;   // PA2: USART2_TX
+    HAL_GPIO_Init(GPIOA, &gpio);
+
+    gpio.Pin = GPIO_PIN_15;
+    gpio.Alternate = GPIO_AF3_USART2;   // PA15: USART2_RX
+    HAL_GPIO_Init(GPIOA, &gpio);
+}
+
+}  // namespace
+
+static_assert((DEBUG_UART_TX_BUFFER & (DEBUG_UART_TX_BUFFER - 1)) == 0,
+              "DEBUG_UART_TX_BUFFER must be a power of two");
+
+// Public API implementations
+
+extern "C" int debug_uart_init(uint32_t baud) {
+    if (initialized) {
+        return 0;
+    }
+    if (baud == 0) {
+        return -1;
+    }
+
+    write_mutex = xSemaphoreCreateMutexStatic(&write_mutex_storage);
+    space_sem = xSemaphoreCreateBinaryStatic(&space_sem_storage);
+    rx_stream = xStreamBufferCreateStatic(sizeof(rx_stream_buffer), 1, rx_stream_buffer,
+                                          &rx_stream_storage);
+
+    configure_pins();
+    __HAL_RCC_USART2_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    // 8N1, oversampling by 16; DMA feeds TDR and drains RDR. EIE reports
+    // overrun, framing and noise errors while DMA receives
+    USART2->CR1 = 0;
+    USART2->BRR = (HAL_RCC_GetPCLK1Freq() + baud / 2U) / baud;
+    USART2->CR3 = USART_CR3_DMAT | USART_CR3_DMAR | USART_CR3_EIE;
+
+    // Memory to peripheral, byte-wide, memory increment, complete and error interrupts
+    TX_DMA_CHANNEL->CCR = 0;
+    TX_DMA_CHANNEL->CPAR = reinterpret_cast<uint32_t>(&USART2->TDR);
+    DMA1_CSELR->CSELR = (DMA1_CSELR->CSELR & ~DMA_CSELR_C7S) | TX_DMA_REQUEST;
+    TX_DMA_CHANNEL->CCR = DMA_CCR_DIR | DMA_CCR_MINC | DMA_CCR_TCIE | DMA_CCR_TEIE;
+
+    // Peripheral to memory, circular over the whole buffer, half and complete interrupts
+    rx.reset();
+    RX_DMA_CHANNEL->CCR = 0;
+    RX_DMA_CHANNEL->CPAR = reinterpret_cast<uint32_t>(&USART2->RDR);
+    RX_DMA_CHANNEL->CMAR = reinterpret_cast<uint32_t>(rx.dma_buffer());
+    RX_DMA_CHANNEL->CNDTR = DEBUG_UART_RX_DMA_BUFFER;
+    DMA1_CSELR->CSELR = (DMA1_CSELR->CSELR & ~DMA_CSELR_C6S) | RX_DMA_REQUEST;
+    RX_DMA_CHANNEL->CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_EN;
+
+    if (hal_irq_bind(TX_DMA_IRQn, tx_dma_irq) != 0 ||
+        hal_irq_bind(RX_DMA_IRQn, rx_dma_irq) != 0 ||
+        hal_irq_bind(USART2_IRQn, usart_irq) != 0) {
+        return -2;
+    }
+
+    // Equal priorities: the receive events must not preempt each other
+    HAL_NVIC_SetPriority(TX_DMA_IRQn, DEBUG_UART_IRQ_PRIORITY, 0);
+    HAL_NVIC_SetPriority(RX_DMA_IRQn, DEBUG_UART_IRQ_PRIORITY, 0);
+    HAL_NVIC_SetPriority(USART2_IRQn, DEBUG_UART_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(TX_DMA_IRQn);
+    HAL_NVIC_EnableIRQ(RX_DMA_IRQn);
+    HAL_NVIC_EnableIRQ(USART2_IRQn);
+
+    USART2->CR1 = USART_CR1_TE | USART_CR1_RE | USART_CR1_IDLEIE | USART_CR1_UE;
+
+    initialized = true;
+    return 0;
+}
+
+extern "C" void debug_uart_set_policy(debug_uart_policy_t policy, uint32_t timeout_ms) {
+    tx.set_policy(policy == DEBUG_UART_BLOCK ? UartTxPolicy::Block : UartTxPolicy::DropNewest,
+                  timeout_ms);
+}
+
+extern "C" int debug_uart_write(const void* data, size_t len) {
+    if (!initialized) {
+        return -1;
+    }
+    return static_cast<int>(tx.write(static_cast<const uint8_t*>(data), len));
+}
+
+extern "C" void debug_uart_get_tx_stats(debug_uart_tx_stats_t* out) {
+    if (out) {
+        const UartTxStats& stats = tx.stats();
+        out->bytes_queued = stats.bytes_queued;
+        out->bytes_dropped = stats.bytes_dropped;
+        out->overflows = stats.overflows;
+        out->dma_transfers = stats.dma_transfers;
+        out->peak_used = stats.peak_used;
+    }
+}
+
+extern "C" int debug_uart_read(void* buf, size_t len, uint32_t timeout_ms) {
+    if (!initialized) {
+        return -1;
+    }
+    return static_cast<int>(xStreamBufferReceive(rx_stream, buf, len, pdMS_TO_TICKS(timeout_ms)));
+}
+
+extern "C" void debug_uart_get_rx_stats(debug_uart_rx_stats_t* out) {
+    if (out) {
+        const UartRxStats& stats = rx.stats();
+        out->bytes_received = stats.bytes_received;
+        out->bytes_dropped = stats.bytes_dropped;
+        out->events = stats.events;
+        out->overruns = stats.overruns;
+        out->framing_errors = stats.framing_errors;
+        out->noise_errors = stats.noise_errors;
+    }
+}
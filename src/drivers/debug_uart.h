@@ -0,0 +1,130 @@
+#pragma once
+
+/**
+ * @file debug_uart.h
+ * @brief Debug console on USART2 (ST-Link virtual COM port)
+ *
+ * Transmission is non-blocking: debug_uart_write() copies into a
+ * DEBUG_UART_TX_BUFFER byte ring that DMA1 channel 7 drains in the largest
+ * contiguous chunks (uart_tx.hpp). _write() in syscalls.c routes stdout
+ * and stderr here, so printf() from a task costs a copy rather than ~87 us
+ * per character at 115200 baud.
+ *
+ * Writers are serialized by a mutex once the scheduler runs. Writes from
+ * an ISR are dropped and counted, since they could not take the mutex.
+ * Before the scheduler starts, only what fits the ring is sent.
+ *
+ * Reception runs DMA1 channel 6 in circular mode over a
+ * DEBUG_UART_RX_DMA_BUFFER byte buffer (uart_rx.hpp). Half-transfer,
+ * transfer-complete and idle-line interrupts move each burst into a
+ * DEBUG_UART_RX_STREAM byte stream buffer read by debug_uart_read(), so a
+ * burst costs one interrupt rather than one per byte. A single task may
+ * read.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef DEBUG_UART_BAUD
+#define DEBUG_UART_BAUD             115200U
+#endif
+
+#ifndef DEBUG_UART_TX_BUFFER
+#define DEBUG_UART_TX_BUFFER        1024U   // Power of two
+#endif
+
+#ifndef DEBUG_UART_RX_DMA_BUFFER
+#define DEBUG_UART_RX_DMA_BUFFER    256U    // Circular DMA buffer
+#endif
+
+#ifndef DEBUG_UART_RX_STREAM
+#define DEBUG_UART_RX_STREAM        512U    // Stream buffer for the reader
+#endif
+
+#define DEBUG_UART_IRQ_PRIORITY     6       // Below configMAX_SYSCALL_INTERRUPT_PRIORITY
+
+/**
+ * @brief Behaviour when the transmit ring is full
+ */
+typedef enum {
+    DEBUG_UART_DROP_NEWEST,     // Drop what does not fit (default)
+    DEBUG_UART_BLOCK            // Wait for space, up to a timeout per stall
+} debug_uart_policy_t;
+
+/**
+ * @brief Transmit Statistics
+ */
+typedef struct {
+    uint32_t bytes_queued;
+    uint32_t bytes_dropped;
+    uint32_t overflows;         // Writes that dropped data
+    uint32_t dma_transfers;
+    uint32_t peak_used;         // Highest ring occupancy in bytes
+} debug_uart_tx_stats_t;
+
+/**
+ * @brief Receive Statistics
+ */
+typedef struct {
+    uint32_t bytes_received;
+    uint32_t bytes_dropped;     // Stream buffer full
+    uint32_t events;            // Interrupts that delivered data
+    uint32_t overruns;
+    uint32_t framing_errors;
+    uint32_t noise_errors;
+} debug_uart_rx_stats_t;
+
+/**
+ * @brief Configure USART2, its pins and both DMA channels, start
+ *        reception and bind the interrupts
+ *
+ * Requires the RAM vector table (hal_irq_vectors_init()).
+ *
+ * @param baud Line rate
+ * @return 0 on success, negative error code on failure
+ */
+int debug_uart_init(uint32_t baud);
+
+/**
+ * @brief Select the overflow policy
+ * @param policy Drop or block
+ * @param timeout_ms Longest wait for the line to make progress (DEBUG_UART_BLOCK)
+ */
+void debug_uart_set_policy(debug_uart_policy_t policy, uint32_t timeout_ms);
+
+/**
+ * @brief Queue bytes for transmission without waiting for the line
+ * @return Number of bytes accepted, or negative if not initialized
+ */
+int debug_uart_write(const void* data, size_t len);
+
+/**
+ * @brief Read the transmit statistics
+ */
+void debug_uart_get_tx_stats(debug_uart_tx_stats_t* out);
+
+/**
+ * @brief Read received bytes, waiting for at least one
+ * @param buf Destination
+ * @param len Capacity of buf
+ * @param timeout_ms Longest wait for data
+ * @return Number of bytes read (0 on timeout), or negative if not initialized
+ */
+int debug_uart_read(void* buf, size_t len, uint32_t timeout_ms);
+
+/**
+ * @brief Read the receive statistics
+ */
+void debug_uart_get_rx_stats(debug_uart_rx_stats_t* out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+/**
+ * @file i2c1.h
+ * @brief I2C1 bus on the Nucleo-L432KC pins (PB6 SCL, PB7 SDA)
+ *
+ * Runs the i2c_bus engine over I2C1. The short write phase (register
+ * address and data) is fed from the TXIS interrupt; the read phase goes
+ * through DMA2 channel 6 (DMA1 channels 6 and 7 are taken by the debug
+ * UART). A software timer polls for timeouts every I2C1_POLL_MS.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "i2c_bus.h"
+
+#define I2C1_IRQ_PRIORITY       6       // Below configMAX_SYSCALL_INTERRUPT_PRIORITY
+#define I2C1_POLL_MS            10
+
+/**
+ * @brief Configure the pins, I2C1 and its DMA channel, bind the interrupts
+ *        and start the timeout timer
+ *
+ * Requires the RAM vector table (hal_irq_vectors_init()).
+ *
+ * @return 0 on success, negative error code on failure
+ */
+int i2c1_init(void);
+
+/**
+ * @brief The I2C1 bus (valid after i2c1_init())
+ */
+i2c_bus_t* i2c1_bus(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,260 @@
+/**
+ * @file i2c1_stm32l4xx.c
+ * @brief I2C1 bus with interrupt-driven writes and DMA reads for STM32L4xx
+ */
+
+#include "i2c1.h"
+#include "hal_irq.h"
+#include "hal_dwt.h"
+#include "stm32l4xx_hal.h"
+#include "FreeRTOS.h"
+#include "timers.h"
+
+// I2C1_RX is request 5 on DMA2 channel 6
+#define RX_DMA_CHANNEL      DMA2_Channel6
+#define RX_DMA_IRQn         DMA2_Channel6_IRQn
+#define RX_DMA_REQUEST      (5UL << DMA_CSELR_C6S_Pos)
+
+#define SCL_PIN             GPIO_PIN_6
+#define SDA_PIN             GPIO_PIN_7
+
+#define I2C_EVENT_IRQS      (I2C_CR1_TXIE | I2C_CR1_TCIE | I2C_CR1_STOPIE | I2C_CR1_NACKIE | I2C_CR1_ERRIE)
+
+static i2c_bus_t bus;
+static const uint8_t* tx_data;
+static uint16_t tx_left;
+static bool nacked;
+
+static StaticTimer_t poll_timer_storage;
+static TimerHandle_t poll_timer;
+
+// =============================================================================
+// Timing
+// =============================================================================
+
+// TIMINGR for the I2C kernel clock (PCLK1): prescale so SCLL/SCLH fit 8
+// bits, split the period 50/50 in standard mode and 2:1 in fast modes, and
+// hold the data setup time (250 ns / 100 ns / 50 ns) with SCLDEL
+static uint32_t compute_timing(uint32_t i2cclk, uint32_t speed_hz) {
+    const uint32_t setup_ns = (speed_hz <= 100000U) ? 250U : (speed_hz <= 400000U) ? 100U : 50U;
+
+    for (uint32_t presc = 0; presc < 16U; presc++) {
+        const uint32_t f = i2cclk / (presc + 1U);
+        const uint32_t period = f / speed_hz;
+        if (period < 8U) {
+            break;  // Clock too slow for this speed
+        }
+        // About 4 cycles are lost to SCL synchronization
+        const uint32_t cycles = period - 4U;
+        const uint32_t low = (speed_hz <= 100000U) ? cycles / 2U : (cycles * 2U) / 3U;
+        const uint32_t high = cycles - low;
+        if (low > 256U || high > 256U) {
+            continue;
+        }
+        uint32_t scldel = (uint32_t)(((uint64_t)f * setup_ns + 999999999ULL) / 1000000000ULL);
+        scldel = (scldel > 16U) ? 15U : (scldel ? scldel - 1U : 0U);
+
+        return (presc << I2C_TIMINGR_PRESC_Pos) | (scldel << I2C_TIMINGR_SCLDEL_Pos) |
+               (1U << I2C_TIMINGR_SDADEL_Pos) | ((high - 1U) << I2C_TIMINGR_SCLH_Pos) |
+               ((low - 1U) << I2C_TIMINGR_SCLL_Pos);
+    }
+    return 0;
+}
+
+// =============================================================================
+// Pins and bus recovery
+// =============================================================================
+
+static void pins_as_i2c(void) {
+    GPIO_InitTypeDef gpio = {0};
+    gpio.Pin = SCL_PIN | SDA_PIN;
+    gpio.Mode = GPIO_MODE_AF_OD;
+    gpio.Pull = GPIO_PULLUP;
+    gpio.Speed = GPIO_SPEED_FREQ_HIGH;
+    gpio.Alternate = GPIO_AF4_I2C1;
+    HAL_GPIO_Init(GPIOB, &gpio);
+}
+
+static void half_bit_delay(void) {
+    // ~5 us: a 100 kHz half period at any core clock
+    const uint32_t start = hal_dwt_get_cycles();
+    const uint32_t cycles = SystemCoreClock / 200000U;
+    while (hal_dwt_get_cycles() - start < cycles) {
+    }
+}
+
+// A slave stuck mid-byte holds SDA low until it has clocked out its bits:
+// pulse SCL (at most 9 times) until SDA is released, then send a STOP
+static void bus_recover(void) {
+    if (!hal_dwt_is_enabled()) {
+        hal_dwt_init();
+    }
+
+    GPIOB->BSRR = SCL_PIN | SDA_PIN;
+    GPIO_InitTypeDef gpio = {0};
+    gpio.Pin = SCL_PIN | SDA_PIN;
+    gpio.Mode = GPIO_MODE_OUTPUT_OD;
+    gpio.Pull = GPIO_PULLUP;
+    gpio.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(GPIOB, &gpio);
+    half_bit_delay();
+
+    for (int i = 0; i < 9 && (GPIOB->IDR & SDA_PIN) == 0; i++) {
+        GPIOB->BRR = SCL_PIN;
+        half_bit_delay();
+        GPIOB->BSRR = SCL_PIN;
+        half_bit_delay();
+    }
+
+    // STOP: SDA rises while SCL is high
+    GPIOB->BRR = SDA_PIN;
+    half_bit_delay();
+    GPIOB->BSRR = SDA_PIN;
+    half_bit_delay();
+
+    pins_as_i2c();
+}
+
+// =============================================================================
+// Hardware operations
+// =============================================================================
+
+static void peripheral_reset(void) {
+    I2C1->CR1 &= ~I2C_CR1_PE;
+    RX_DMA_CHANNEL->CCR = 0;
+    tx_left = 0;
+    nacked = false;
+}
+
+static void i2c1_set_speed(void* hw, uint32_t speed_hz) {
+    (void)hw;
+    I2C1->CR1 &= ~I2C_CR1_PE;
+    I2C1->TIMINGR = compute_timing(HAL_RCC_GetPCLK1Freq(), speed_hz);
+    I2C1->CR1 = I2C_EVENT_IRQS | I2C_CR1_PE;
+}
+
+static void i2c1_start_write(void* hw, uint8_t address, const uint8_t* data, uint16_t len, bool stop) {
+    (void)hw;
+    tx_data = data;
+    tx_left = len;
+    nacked = false;
+    I2C1->CR2 = ((uint32_t)address << 1) | ((uint32_t)len << I2C_CR2_NBYTES_Pos) |
+                (stop ? I2C_CR2_AUTOEND : 0U) | I2C_CR2_START;
+}
+
+static void i2c1_start_read(void* hw, uint8_t address, uint8_t* data, uint16_t len) {
+    (void)hw;
+    nacked = false;
+    RX_DMA_CHANNEL->CCR = 0;
+    RX_DMA_CHANNEL->CMAR = (uint32_t)data;
+    RX_DMA_CHANNEL->CNDTR = len;
+    RX_DMA_CHANNEL->CCR = DMA_CCR_MINC | DMA_CCR_EN;
+    I2C1->CR1 |= I2C_CR1_RXDMAEN;
+
+    // START here is a repeated start when it follows a write phase
+    I2C1->CR2 = ((uint32_t)address << 1) | I2C_CR2_RD_WRN | ((uint32_t)len << I2C_CR2_NBYTES_Pos) |
+                I2C_CR2_AUTOEND | I2C_CR2_START;
+}
+
+static void i2c1_abort(void* hw) {
+    (void)hw;
+    peripheral_reset();
+    I2C1->CR1 &= ~I2C_CR1_RXDMAEN;
+}
+
+static void i2c1_recover(void* hw) {
+    (void)hw;
+    __HAL_RCC_I2C1_FORCE_RESET();
+    bus_recover();
+    __HAL_RCC_I2C1_RELEASE_RESET();
+}
+
+static const i2c_bus_ops_t i2c1_ops = {
+    i2c1_set_speed,
+    i2c1_start_write,
+    i2c1_start_read,
+    i2c1_abort,
+    i2c1_recover
+};
+
+// =============================================================================
+// Interrupts and timeout timer
+// =============================================================================
+
+static void i2c1_ev_irq(void) {
+    const uint32_t isr = I2C1->ISR;
+
+    if ((isr & I2C_ISR_TXIS) && tx_left > 0) {
+        I2C1->TXDR = *tx_data++;
+        tx_left--;
+    }
+    if (isr & I2C_ISR_NACKF) {
+        I2C1->ICR = I2C_ICR_NACKCF;
+        nacked = true;
+        // Without AUTOEND the STOP after a NACK is ours to send
+        if ((I2C1->CR2 & I2C_CR2_AUTOEND) == 0) {
+            I2C1->CR2 |= I2C_CR2_STOP;
+        }
+    }
+    if ((isr & I2C_ISR_TC) && !nacked) {
+        // Write phase without STOP: TC holds SCL low until the repeated start
+        i2c_bus_event(&bus, I2C_EVT_PHASE_DONE);
+    }
+    if (isr & I2C_ISR_STOPF) {
+        I2C1->ICR = I2C_ICR_STOPCF;
+        I2C1->CR1 &= ~I2C_CR1_RXDMAEN;
+        RX_DMA_CHANNEL->CCR = 0;
+        i2c_bus_event(&bus, nacked ? I2C_EVT_NACK : I2C_EVT_PHASE_DONE);
+    }
+}
+
+static void i2c1_er_irq(void) {
+    const uint32_t isr = I2C1->ISR;
+    if (isr & (I2C_ISR_BERR | I2C_ISR_ARLO | I2C_ISR_OVR)) {
+        I2C1->ICR = I2C_ICR_BERRCF | I2C_ICR_ARLOCF | I2C_ICR_OVRCF;
+        i2c_bus_event(&bus, I2C_EVT_ERROR);
+    }
+}
+
+static void poll_timer_callback(TimerHandle_t timer) {
+    (void)timer;
+    i2c_bus_poll(&bus, (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS));
+}
+
+// Public API implementations
+
+int i2c1_init(void) {
+    if (i2c_bus_init(&bus, &i2c1_ops, I2C1) != 0) {
+        return -1;
+    }
+
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_I2C1_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    // Free the bus in case a slave was left mid-transfer by a reset
+    i2c1_recover(I2C1);
+    peripheral_reset();
+
+    RX_DMA_CHANNEL->CPAR = (uint32_t)&I2C1->RXDR;
+    DMA2_CSELR->CSELR = (DMA2_CSELR->CSELR & ~DMA_CSELR_C6S) | RX_DMA_REQUEST;
+
+    if (hal_irq_bind(I2C1_EV_IRQn, i2c1_ev_irq) != 0 || hal_irq_bind(I2C1_ER_IRQn, i2c1_er_irq) != 0) {
+        return -2;
+    }
+    HAL_NVIC_SetPriority(I2C1_EV_IRQn, I2C1_IRQ_PRIORITY, 0);
+    HAL_NVIC_SetPriority(I2C1_ER_IRQn, I2C1_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(I2C1_EV_IRQn);
+    HAL_NVIC_EnableIRQ(I2C1_ER_IRQn);
+
+    poll_timer = xTimerCreateStatic("I2C1", pdMS_TO_TICKS(I2C1_POLL_MS), pdTRUE, NULL,
+                                    poll_timer_callback, &poll_timer_storage);
+    if (!poll_timer || xTimerStart(poll_timer, 0) != pdPASS) {
+        return -3;
+    }
+    return 0;
+}
+
+i2c_bus_t* i2c1_bus(void) {
+    return &bus;
+}
@@ -0,0 +1,227 @@
+/**
+ * @file i2c_bus.c
+ * @brief Asynchronous I2C transaction engine shared by several tasks
+ *
+ * As in spi_bus.c, whoever finds the bus idle inside the critical section
+ * claims the next transaction and programs the hardware after leaving it.
+ * A timeout detaches the active transaction first, so a late interrupt for
+ * it finds nothing to complete.
+ */
+
+#include "i2c_bus.h"
+#include "crit_section.h"
+#include <stddef.h>
+#include <string.h>
+
+// Caller holds the critical section
+static i2c_xfer_t* claim_next(i2c_bus_t* bus) {
+    if (bus->active || bus->recovering || !bus->head) {
+        return NULL;
+    }
+    i2c_xfer_t* xfer = bus->head;
+    bus->head = xfer->next;
+    if (!bus->head) {
+        bus->tail = NULL;
+    }
+    xfer->next = NULL;
+    bus->active = xfer;
+    bus->reading = false;
+    bus->started++;
+    return xfer;
+}
+
+static void begin(i2c_bus_t* bus, i2c_xfer_t* xfer) {
+    const i2c_device_t* device = xfer->device;
+    if (device->speed_hz != bus->speed_hz) {
+        bus->ops->set_speed(bus->hw, device->speed_hz);
+        bus->speed_hz = device->speed_hz;
+        bus->stats.speed_changes++;
+    }
+
+    if (xfer->tx_len > 0) {
+        bus->ops->start_write(bus->hw, device->address, xfer->tx, xfer->tx_len, xfer->rx_len == 0);
+    } else {
+        bus->reading = true;
+        bus->ops->start_read(bus->hw, device->address, xfer->rx, xfer->rx_len);
+    }
+}
+
+static void start_pending(i2c_bus_t* bus) {
+    CRIT_STAT;
+    CRIT_ENTER();
+    i2c_xfer_t* next = claim_next(bus);
+    CRIT_EXIT();
+
+    if (next) {
+        begin(bus, next);
+    }
+}
+
+static void finish(i2c_bus_t* bus, i2c_xfer_t* xfer, int status) {
+    bus->stats.transfers++;
+    xfer->status = status;
+    if (xfer->done) {
+        xfer->done(xfer, status);
+    }
+}
+
+// Public API implementations
+
+int i2c_bus_init(i2c_bus_t* bus, const i2c_bus_ops_t* ops, void* hw) {
+    if (!bus || !ops || !ops->set_speed || !ops->start_write || !ops->start_read ||
+        !ops->abort || !ops->recover) {
+        return -1;
+    }
+
+    memset(bus, 0, sizeof(*bus));
+    bus->ops = ops;
+    bus->hw = hw;
+    return 0;
+}
+
+int i2c_bus_submit(i2c_bus_t* bus, i2c_xfer_t* xfer) {
+    if (!bus || !xfer || !xfer->device || (xfer->tx_len == 0 && xfer->rx_len == 0)) {
+        return -1;
+    }
+    if (xfer->tx_len > I2C_MAX_PHASE_BYTES || xfer->rx_len > I2C_MAX_PHASE_BYTES ||
+        (xfer->tx_len && !xfer->tx) || (xfer->rx_len && !xfer->rx)) {
+        return -1;
+    }
+
+    CRIT_STAT;
+    CRIT_ENTER();
+    if (xfer->status == I2C_XFER_PENDING) {
+        CRIT_EXIT();
+        return -3;
+    }
+
+    xfer->status = I2C_XFER_PENDING;
+    xfer->next = NULL;
+    if (bus->tail) {
+        bus->tail->next = xfer;
+    } else {
+        bus->head = xfer;
+    }
+    bus->tail = xfer;
+    i2c_xfer_t* next = claim_next(bus);
+    CRIT_EXIT();
+
+    if (next) {
+        begin(bus, next);
+    }
+    return 0;
+}
+
+void i2c_bus_event(i2c_bus_t* bus, i2c_event_t event) {
+    i2c_xfer_t* xfer = bus->active;
+    if (!xfer) {
+        return;  // Late event for a transaction that timed out
+    }
+
+    // Write phase done: repeated start into the read phase
+    if (event == I2C_EVT_PHASE_DONE && !bus->reading && xfer->rx_len > 0) {
+        bus->reading = true;
+        bus->ops->start_read(bus->hw, xfer->device->address, xfer->rx, xfer->rx_len);
+        return;
+    }
+
+    int status = I2C_OK;
+    if (event == I2C_EVT_NACK) {
+        status = I2C_ERR_NACK;
+        bus->stats.nacks++;
+    } else if (event == I2C_EVT_ERROR) {
+        status = I2C_ERR_BUS;
+        bus->stats.bus_errors++;
+        bus->ops->abort(bus->hw);
+        bus->speed_hz = 0;  // abort() resets the peripheral
+    }
+
+    CRIT_STAT;
+    CRIT_ENTER();
+    bus->active = NULL;
+    CRIT_EXIT();
+
+    finish(bus, xfer, status);
+    start_pending(bus);
+}
+
+bool i2c_bus_poll(i2c_bus_t* bus, uint32_t now_ms) {
+    CRIT_STAT;
+    CRIT_ENTER();
+    i2c_xfer_t* xfer = bus->active;
+    if (!xfer || bus->started != bus->watched) {
+        // Idle, or a different transaction than last time: restart the clock
+        bus->watched = bus->started;
+        bus->watched_since_ms = now_ms;
+        CRIT_EXIT();
+        return false;
+    }
+    if (xfer->timeout_ms == 0 || now_ms - bus->watched_since_ms < xfer->timeout_ms) {
+        CRIT_EXIT();
+        return false;
+    }
+
+    // Detach it so a late interrupt cannot complete it twice
+    bus->active = NULL;
+    bus->recovering = true;
+    CRIT_EXIT();
+
+    bus->ops->abort(bus->hw);
+    bus->ops->recover(bus->hw);
+    bus->speed_hz = 0;
+    bus->stats.timeouts++;
+    bus->stats.recoveries++;
+    finish(bus, xfer, I2C_ERR_TIMEOUT);
+
+    CRIT_ENTER();
+    bus->recovering = false;
+    CRIT_EXIT();
+    start_pending(bus);
+    return true;
+}
+
+bool i2c_bus_busy(const i2c_bus_t* bus) {
+    return bus->active != NULL || bus->head != NULL;
+}
+
+void i2c_bus_get_stats(const i2c_bus_t* bus, i2c_bus_stats_t* out) {
+    if (out) {
+        *out = bus->stats;
+    }
+}
+
+// =============================================================================
+// Blocking wrapper
+// =============================================================================
+
+#if !defined(UNIT_TESTING)
+
+static void notify_caller(i2c_xfer_t* xfer, int status) {
+    (void)status;
+    if (xPortIsInsideInterrupt()) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR((TaskHandle_t)xfer->arg, &woken);
+        portYIELD_FROM_ISR(woken);
+    } else {
+        xTaskNotifyGive((TaskHandle_t)xfer->arg);
+    }
+}
+
+int i2c_bus_transfer_sync(i2c_bus_t* bus, i2c_xfer_t* xfer) {
+    if (!xfer) {
+        return -1;
+    }
+
+    xfer->done = notify_caller;
+    xfer->arg = xTaskGetCurrentTaskHandle();
+    (void)ulTaskNotifyTake(pdTRUE, 0);
+
+    const int rc = i2c_bus_submit(bus, xfer);
+    if (rc != 0) {
+        return rc;
+    }
+    (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    return xfer->status;
+}
+
+#endif
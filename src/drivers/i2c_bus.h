@@ -0,0 +1,187 @@
+#pragma once
+
+/**
+ * @file i2c_bus.h
+ * @brief Asynchronous I2C transaction engine shared by several tasks
+ *
+ * A transaction is an optional write phase followed by an optional read
+ * phase, which covers the usual device accesses:
+ * - register write: tx = {reg, data...}, no rx
+ * - register read: tx = {reg}, rx = buffer (repeated start, no STOP between)
+ * - burst read: no tx, rx = buffer
+ *
+ * Transactions from any task (or ISR) are queued FIFO and run one after
+ * another from the I2C interrupts; nothing spins while bytes move. Each
+ * device carries its own bus speed, and the timing is only reprogrammed
+ * when it changes.
+ *
+ * i2c_bus_poll() is called periodically (the SCL timeout of the hardware
+ * does not cover a slave holding SDA). A transaction running longer than
+ * its timeout is aborted with I2C_ERR_TIMEOUT and the bus is recovered by
+ * clocking SCL until the slave releases SDA, then issuing a STOP.
+ *
+ * Transactions are caller-owned and must stay untouched until their
+ * callback has run. Callbacks run in interrupt context (or in the poll
+ * context after a timeout) and must be short.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#define I2C_MAX_PHASE_BYTES     255     // NBYTES limit; no RELOAD chaining
+#define I2C_XFER_PENDING        1       // status while queued or running
+
+// Completion status codes
+#define I2C_OK                  0
+#define I2C_ERR_NACK            (-1)    // Address or data not acknowledged
+#define I2C_ERR_BUS             (-2)    // Bus error, arbitration loss or overrun
+#define I2C_ERR_TIMEOUT         (-3)    // Aborted by i2c_bus_poll()
+
+/**
+ * @brief Events reported by the hardware layer
+ */
+typedef enum {
+    I2C_EVT_PHASE_DONE,     // Write phase ended (TC) or STOP after the last phase
+    I2C_EVT_NACK,           // NACK, after the resulting STOP
+    I2C_EVT_ERROR           // BERR, ARLO or OVR
+} i2c_event_t;
+
+/**
+ * @brief Device on the Bus
+ */
+typedef struct {
+    uint8_t address;        // 7-bit address
+    uint32_t speed_hz;      // 100000, 400000 or 1000000
+} i2c_device_t;
+
+typedef struct i2c_xfer i2c_xfer_t;
+
+/**
+ * @brief Completion callback
+ * @param xfer The finished transaction
+ * @param status I2C_OK or an I2C_ERR_* code
+ */
+typedef void (*i2c_done_t)(i2c_xfer_t* xfer, int status);
+
+/**
+ * @brief Transaction
+ */
+struct i2c_xfer {
+    const i2c_device_t* device;
+    const uint8_t* tx;      // Write phase (register address, data)
+    uint16_t tx_len;        // 0: no write phase
+    uint8_t* rx;            // Read phase
+    uint16_t rx_len;        // 0: no read phase
+    uint32_t timeout_ms;    // 0: never times out
+    i2c_done_t done;        // Optional
+    void* arg;              // For the callback's use
+
+    // Owned by the bus
+    volatile int status;
+    i2c_xfer_t* next;
+};
+
+/**
+ * @brief Hardware Operations
+ */
+typedef struct {
+    void (*set_speed)(void* hw, uint32_t speed_hz);
+    void (*start_write)(void* hw, uint8_t address, const uint8_t* data, uint16_t len, bool stop);
+    void (*start_read)(void* hw, uint8_t address, uint8_t* data, uint16_t len);
+    void (*abort)(void* hw);
+    void (*recover)(void* hw);  // Free a stuck bus and reinitialize the peripheral
+} i2c_bus_ops_t;
+
+/**
+ * @brief Bus Statistics
+ */
+typedef struct {
+    uint32_t transfers;
+    uint32_t nacks;
+    uint32_t bus_errors;
+    uint32_t timeouts;
+    uint32_t recoveries;
+    uint32_t speed_changes;
+} i2c_bus_stats_t;
+
+/**
+ * @brief Bus State
+ */
+typedef struct {
+    const i2c_bus_ops_t* ops;
+    void* hw;
+    i2c_xfer_t* head;           // FIFO of pending transactions
+    i2c_xfer_t* tail;
+    i2c_xfer_t* active;
+    bool reading;               // Active transaction is in its read phase
+    bool recovering;
+    uint32_t speed_hz;          // 0: timing must be reprogrammed
+    uint32_t started;           // Transactions started so far
+    uint32_t watched;           // Value of started seen by the last poll
+    uint32_t watched_since_ms;
+    i2c_bus_stats_t stats;
+} i2c_bus_t;
+
+// =============================================================================
+// Bus API
+// =============================================================================
+
+/**
+ * @brief Initialize a bus
+ * @return 0 on success, negative error code on failure
+ */
+int i2c_bus_init(i2c_bus_t* bus, const i2c_bus_ops_t* ops, void* hw);
+
+/**
+ * @brief Queue a transaction, starting it at once if the bus is idle
+ * @return 0 on success, -1 on invalid arguments, -3 if already pending
+ */
+int i2c_bus_submit(i2c_bus_t* bus, i2c_xfer_t* xfer);
+
+/**
+ * @brief Report a hardware event (I2C interrupt)
+ */
+void i2c_bus_event(i2c_bus_t* bus, i2c_event_t event);
+
+/**
+ * @brief Enforce transaction timeouts (task context, periodically)
+ * @param now_ms Current time in milliseconds
+ * @return true if a transaction was aborted and the bus recovered
+ */
+bool i2c_bus_poll(i2c_bus_t* bus, uint32_t now_ms);
+
+/**
+ * @brief Check whether a transaction is running or queued
+ */
+bool i2c_bus_busy(const i2c_bus_t* bus);
+
+/**
+ * @brief Read the bus statistics
+ */
+void i2c_bus_get_stats(const i2c_bus_t* bus, i2c_bus_stats_t* out);
+
+#if !defined(UNIT_TESTING)
+
+/**
+ * @brief Submit a transaction and wait for it (task context)
+ *
+ * Uses the calling task's notification; xfer->done and xfer->arg are
+ * overwritten. The transaction's own timeout bounds the wait.
+ *
+ * @return Transaction status, or negative if it could not be queued
+ */
+int i2c_bus_transfer_sync(i2c_bus_t* bus, i2c_xfer_t* xfer);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,198 @@
+/**
+ * @file imu_fifo.c
+ * @brief Burst FIFO reader for I2C and SPI inertial sensors
+ *
+ * One watermark means exactly `watermark` frames are waiting, so every
+ * burst has a fixed length and the transactions are built once, at attach
+ * time. A watermark raised while a read is in flight (the read queued
+ * behind other bus traffic, with the sensor pulsing its interrupt at each
+ * watermark) is latched with its timestamp and served from the completion.
+ */
+
+#include "imu_fifo.h"
+#include "crit_section.h"
+#include <stddef.h>
+#include <string.h>
+
+static uint16_t burst_bytes(const imu_fifo_t* reader) {
+    return (uint16_t)(reader->frame_bytes * reader->fmt.watermark);
+}
+
+static int start_read(imu_fifo_t* reader) {
+    if (reader->i2c_bus) {
+        return i2c_bus_submit(reader->i2c_bus, &reader->i2c);
+    }
+    return spi_bus_submit(reader->spi_bus, &reader->spi_cmd);
+}
+
+// Spread the batch from the previous newest sample to this one, or step
+// back from this one by the nominal period when there is no usable anchor
+static void stamp(imu_fifo_t* reader, imu_batch_t* batch, uint32_t newest_us) {
+    const uint32_t n = batch->count;
+    const uint32_t expected = reader->fmt.period_us * n;
+    const uint32_t span = newest_us - reader->last_us;
+
+    if (reader->synced && span >= expected / 2 && span <= expected * 2) {
+        for (uint32_t i = 0; i < n; i++) {
+            batch->t_us[i] = reader->last_us + (uint32_t)(((uint64_t)span * (i + 1)) / n);
+        }
+    } else {
+        for (uint32_t i = 0; i < n; i++) {
+            batch->t_us[i] = newest_us - (n - 1 - i) * reader->fmt.period_us;
+        }
+        reader->stats.resyncs++;
+    }
+    reader->last_us = newest_us;
+    reader->synced = true;
+}
+
+static void read_done(imu_fifo_t* reader, int status) {
+    if (status == 0) {
+        imu_batch_t* batch = &reader->batch[reader->fill];
+        imu_fifo_decode(&reader->fmt, reader->raw, reader->fmt.watermark, batch);
+        stamp(reader, batch, reader->irq_us);
+        reader->fill ^= 1U;
+        reader->stats.batches++;
+        reader->stats.samples += batch->count;
+        if (reader->ready) {
+            reader->ready(reader->arg, batch);
+        }
+    } else {
+        // The FIFO position is unknown: the next batch starts a new time base
+        reader->stats.read_errors++;
+        reader->synced = false;
+    }
+
+    CRIT_STAT;
+    CRIT_ENTER();
+    const bool again = reader->deferred;
+    reader->deferred = false;
+    reader->irq_us = reader->deferred_us;
+    reader->reading = again;
+    CRIT_EXIT();
+
+    if (again && start_read(reader) != 0) {
+        reader->reading = false;
+        reader->synced = false;
+    }
+}
+
+static void i2c_done(i2c_xfer_t* xfer, int status) {
+    read_done((imu_fifo_t*)xfer->arg, status);
+}
+
+static void spi_done(spi_transfer_t* xfer, int status) {
+    read_done((imu_fifo_t*)xfer->arg, status);
+}
+
+// Public API implementations
+
+int imu_fifo_init(imu_fifo_t* reader, const imu_fifo_format_t* fmt, imu_batch_ready_t ready, void* arg) {
+    if (!reader || !fmt || fmt->channels == 0 || fmt->channels > IMU_FIFO_MAX_CHANNELS ||
+        fmt->header_bytes > IMU_FIFO_MAX_HEADER || fmt->watermark == 0 ||
+        fmt->watermark > IMU_FIFO_MAX_FRAMES || fmt->period_us == 0) {
+        return -1;
+    }
+
+    memset(reader, 0, sizeof(*reader));
+    reader->fmt = *fmt;
+    reader->frame_bytes = (uint16_t)(fmt->header_bytes + 2U * fmt->channels);
+    reader->ready = ready;
+    reader->arg = arg;
+    return 0;
+}
+
+int imu_fifo_attach_i2c(imu_fifo_t* reader, i2c_bus_t* bus, const i2c_device_t* device, uint8_t fifo_reg) {
+    if (!reader || !bus || !device || reader->frame_bytes == 0) {
+        return -1;
+    }
+    if (burst_bytes(reader) > I2C_MAX_PHASE_BYTES) {
+        return -2;
+    }
+
+    reader->reg = fifo_reg;
+    reader->i2c_bus = bus;
+    reader->spi_bus = NULL;
+    memset(&reader->i2c, 0, sizeof(reader->i2c));
+    reader->i2c.device = device;
+    reader->i2c.tx = &reader->reg;
+    reader->i2c.tx_len = 1;
+    reader->i2c.rx = reader->raw;
+    reader->i2c.rx_len = burst_bytes(reader);
+    reader->i2c.done = i2c_done;
+    reader->i2c.arg = reader;
+    return 0;
+}
+
+int imu_fifo_attach_spi(imu_fifo_t* reader, spi_bus_t* bus, const spi_device_t* device, uint8_t fifo_reg) {
+    if (!reader || !bus || !device || reader->frame_bytes == 0) {
+        return -1;
+    }
+
+    reader->reg = fifo_reg;
+    reader->spi_bus = bus;
+    reader->i2c_bus = NULL;
+    memset(&reader->spi_cmd, 0, sizeof(reader->spi_cmd));
+    memset(&reader->spi_data, 0, sizeof(reader->spi_data));
+    reader->spi_cmd.device = device;
+    reader->spi_cmd.tx = &reader->reg;
+    reader->spi_cmd.len = 1;
+    reader->spi_cmd.next = &reader->spi_data;
+    reader->spi_cmd.done = spi_done;
+    reader->spi_cmd.arg = reader;
+    reader->spi_data.device = device;
+    reader->spi_data.rx = reader->raw;
+    reader->spi_data.len = burst_bytes(reader);
+    return 0;
+}
+
+int imu_fifo_on_watermark(imu_fifo_t* reader, uint32_t now_us) {
+    if (!reader->i2c_bus && !reader->spi_bus) {
+        return -1;
+    }
+
+    CRIT_STAT;
+    CRIT_ENTER();
+    if (reader->reading) {
+        const bool overrun = reader->deferred;
+        reader->deferred = true;
+        reader->deferred_us = now_us;
+        if (overrun) {
+            reader->stats.overruns++;
+            reader->synced = false;
+        } else {
+            reader->stats.deferred++;
+        }
+        CRIT_EXIT();
+        return overrun ? -2 : 0;
+    }
+    reader->reading = true;
+    reader->irq_us = now_us;
+    CRIT_EXIT();
+
+    if (start_read(reader) != 0) {
+        reader->reading = false;
+        return -3;
+    }
+    return 0;
+}
+
+void imu_fifo_decode(const imu_fifo_format_t* fmt, const uint8_t* raw, uint16_t frames, imu_batch_t* out) {
+    const uint8_t hi = fmt->big_endian ? 0U : 1U;
+    const uint8_t lo = hi ^ 1U;
+
+    for (uint16_t f = 0; f < frames; f++) {
+        const uint8_t* word = raw + fmt->header_bytes;
+        for (uint8_t c = 0; c < fmt->channels; c++, word += 2) {
+            out->ch[c][f] = (int16_t)(uint16_t)(((uint16_t)word[hi] << 8) | word[lo]);
+        }
+        raw = word;
+    }
+    out->count = frames;
+}
+
+void imu_fifo_get_stats(const imu_fifo_t* reader, imu_fifo_stats_t* out) {
+    if (out) {
+        *out = reader->stats;
+    }
+}
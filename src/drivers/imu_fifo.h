@@ -0,0 +1,175 @@
+#pragma once
+
+/**
+ * @file imu_fifo.h
+ * @brief Burst FIFO reader for I2C and SPI inertial sensors
+ *
+ * IMUs buffer samples in an on-chip FIFO and raise an interrupt line when
+ * it reaches a watermark. Instead of one transaction per axis per sample,
+ * the reader drains a whole watermark of frames with one burst read of the
+ * FIFO data register, queued on the shared i2c_bus or spi_bus, and decodes
+ * the frames straight into a struct-of-arrays batch: one array per channel,
+ * ready for filters that walk a single axis.
+ *
+ * Each frame is an optional header (tag or status bytes, skipped) followed
+ * by `channels` 16-bit words in the device's byte order.
+ *
+ * Timestamps: the watermark interrupt marks the newest sample of the
+ * batch. The samples in between are spread evenly from the previous
+ * batch's newest sample to this one, so the per-sample times follow the
+ * sensor's real output rate rather than its nominal one. After a read
+ * error or a gap the first batch is stamped with the nominal period.
+ *
+ * Call imu_fifo_on_watermark() from the EXTI callback of the interrupt pin
+ * with a microsecond timestamp. The batch callback runs in the bus
+ * completion interrupt; a batch stays valid until the one after the next
+ * completes, so a task woken by the callback has one watermark period to
+ * consume it.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "i2c_bus.h"
+#include "spi_bus.h"
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef IMU_FIFO_MAX_FRAMES
+#define IMU_FIFO_MAX_FRAMES     32      // Largest watermark
+#endif
+
+#ifndef IMU_FIFO_MAX_CHANNELS
+#define IMU_FIFO_MAX_CHANNELS   8       // 16-bit words per frame
+#endif
+
+#define IMU_FIFO_MAX_HEADER     2       // Bytes skipped per frame
+
+#define IMU_FIFO_RAW_BYTES      (IMU_FIFO_MAX_FRAMES * (IMU_FIFO_MAX_HEADER + 2 * IMU_FIFO_MAX_CHANNELS))
+
+/**
+ * @brief FIFO Frame Layout and Rate
+ */
+typedef struct {
+    uint8_t channels;       // 16-bit words per frame (e.g. 6: accel xyz, gyro xyz)
+    uint8_t header_bytes;   // Skipped at the start of every frame
+    bool big_endian;        // Word byte order
+    uint8_t watermark;      // Frames per burst (the device FIFO threshold)
+    uint32_t period_us;     // Nominal sample period (1 / ODR)
+} imu_fifo_format_t;
+
+/**
+ * @brief Decoded Samples (struct of arrays)
+ */
+typedef struct {
+    uint16_t count;
+    uint32_t t_us[IMU_FIFO_MAX_FRAMES];
+    int16_t ch[IMU_FIFO_MAX_CHANNELS][IMU_FIFO_MAX_FRAMES];
+} imu_batch_t;
+
+/**
+ * @brief Batch callback (runs in the bus completion interrupt)
+ */
+typedef void (*imu_batch_ready_t)(void* arg, const imu_batch_t* batch);
+
+/**
+ * @brief Reader Statistics
+ */
+typedef struct {
+    uint32_t batches;
+    uint32_t samples;
+    uint32_t read_errors;
+    uint32_t deferred;          // Watermarks raised during a read, served after it
+    uint32_t overruns;          // Watermarks lost while one was already deferred
+    uint32_t resyncs;           // Batches stamped with the nominal period
+} imu_fifo_stats_t;
+
+/**
+ * @brief Reader State
+ */
+typedef struct {
+    imu_fifo_format_t fmt;
+    uint16_t frame_bytes;
+    imu_batch_ready_t ready;
+    void* arg;
+
+    // Transport: exactly one bus is attached
+    i2c_bus_t* i2c_bus;
+    i2c_xfer_t i2c;
+    spi_bus_t* spi_bus;
+    spi_transfer_t spi_cmd;
+    spi_transfer_t spi_data;
+    uint8_t reg;                // FIFO data register (with any read bit)
+
+    volatile bool reading;
+    volatile bool deferred;
+    uint32_t irq_us;            // Watermark time of the read in flight
+    uint32_t deferred_us;
+    uint32_t last_us;           // Newest sample of the previous batch
+    bool synced;                // last_us is valid
+
+    uint8_t raw[IMU_FIFO_RAW_BYTES];
+    imu_batch_t batch[2];
+    uint8_t fill;
+    imu_fifo_stats_t stats;
+} imu_fifo_t;
+
+// =============================================================================
+// Reader API
+// =============================================================================
+
+/**
+ * @brief Initialize a reader
+ * @param reader Reader state
+ * @param fmt Frame layout, watermark and rate
+ * @param ready Called with each decoded batch
+ * @param arg Passed to ready
+ * @return 0 on success, -1 on invalid arguments
+ */
+int imu_fifo_init(imu_fifo_t* reader, const imu_fifo_format_t* fmt, imu_batch_ready_t ready, void* arg);
+
+/**
+ * @brief Read the FIFO through an I2C bus (register address, repeated start, burst)
+ * @return 0 on success, -1 on invalid arguments, -2 if a burst exceeds
+ *         I2C_MAX_PHASE_BYTES
+ */
+int imu_fifo_attach_i2c(imu_fifo_t* reader, i2c_bus_t* bus, const i2c_device_t* device, uint8_t fifo_reg);
+
+/**
+ * @brief Read the FIFO through an SPI bus (register byte, then burst, under one CS)
+ * @param fifo_reg Register byte as sent, including the device's read bit
+ * @return 0 on success, -1 on invalid arguments
+ */
+int imu_fifo_attach_spi(imu_fifo_t* reader, spi_bus_t* bus, const spi_device_t* device, uint8_t fifo_reg);
+
+/**
+ * @brief Report the watermark interrupt (EXTI callback)
+ *
+ * Starts the burst read, or defers it until the read in flight completes.
+ *
+ * @param reader Reader
+ * @param now_us Time of the interrupt in microseconds
+ * @return 0 if a read was started or deferred, -1 if no bus is attached,
+ *         -2 if a deferred watermark was already waiting (overrun), -3 if
+ *         the bus refused the transaction
+ */
+int imu_fifo_on_watermark(imu_fifo_t* reader, uint32_t now_us);
+
+/**
+ * @brief Decode raw FIFO frames into a batch (no timestamps)
+ */
+void imu_fifo_decode(const imu_fifo_format_t* fmt, const uint8_t* raw, uint16_t frames, imu_batch_t* out);
+
+/**
+ * @brief Read the reader statistics
+ */
+void imu_fifo_get_stats(const imu_fifo_t* reader, imu_fifo_stats_t* out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,49 @@
+#pragma once
+
+/**
+ * @file qspi.h
+ * @brief External NOR flash on QUADSPI (PA3 CLK, PA2 NCS, PB1/PB0/PA7/PA6 IO0-3)
+ *
+ * Runs qspi_flash over the QUADSPI controller. Indirect transfers move
+ * their data through DMA1 channel 5 and the calling task sleeps until the
+ * controller interrupt reports completion; busy polling after a program or
+ * erase is done by the controller's automatic status polling, not by the
+ * CPU. Memory-mapped mode exposes the flash at 0x90000000.
+ *
+ * These are the only QUADSPI pins on the 32-pin package and they collide
+ * with the Nucleo board's other uses: PA2 is the debug UART TX, PA6/PA7
+ * are SPI1 MISO/MOSI and PA3 is the SAI1 master clock. A board using the
+ * external flash gives those up.
+ *
+ * Calls must come from one task at a time.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "qspi_flash.h"
+
+#define QSPI_IRQ_PRIORITY       6       // Below configMAX_SYSCALL_INTERRUPT_PRIORITY
+#define QSPI_XFER_TIMEOUT_MS    100
+
+/**
+ * @brief Configure the pins, QUADSPI and DMA1 channel 5, bind the interrupt
+ *        and initialize the flash
+ *
+ * Requires the RAM vector table (hal_irq_vectors_init()) and a running
+ * scheduler.
+ *
+ * @param part Flash part (e.g. QSPI_FLASH_PART_W25Q128)
+ * @return 0 on success, negative error code on failure
+ */
+int qspi_init(const qspi_flash_part_t* part);
+
+/**
+ * @brief The external flash (valid after qspi_init())
+ */
+qspi_flash_t* qspi_flash(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,190 @@
+/**
+ * @file qspi_flash.c
+ * @brief Serial NOR flash on the QUADSPI controller
+ */
+
+#include "qspi_flash.h"
+#include <stddef.h>
+
+static bool in_range(const qspi_flash_t* flash, uint32_t address, uint32_t len) {
+    return address < flash->part.size && len <= flash->part.size - address;
+}
+
+static qspi_command_t command(uint8_t instruction) {
+    qspi_command_t cmd = {instruction, false, 0, 1, 0, 0};
+    return cmd;
+}
+
+static qspi_command_t read_command(const qspi_flash_t* flash, uint32_t address) {
+    qspi_command_t cmd = {QSPI_CMD_FAST_READ_QUAD, true, address, 1, flash->part.read_dummy, 4};
+    return cmd;
+}
+
+static int write_enable(qspi_flash_t* flash) {
+    const qspi_command_t cmd = command(QSPI_CMD_WRITE_ENABLE);
+    return flash->ops->command(flash->hw, &cmd);
+}
+
+// Read-modify-write of the status register holding the quad enable bit
+static int set_quad_enable(qspi_flash_t* flash) {
+    uint8_t read_cmd;
+    uint8_t write_cmd;
+    uint8_t bit;
+
+    switch (flash->part.quad_enable) {
+    case QSPI_QE_SR2_BIT1:
+        read_cmd = QSPI_CMD_READ_STATUS2;
+        write_cmd = QSPI_CMD_WRITE_STATUS2;
+        bit = 0x02;
+        break;
+    case QSPI_QE_SR1_BIT6:
+        read_cmd = QSPI_CMD_READ_STATUS1;
+        write_cmd = QSPI_CMD_WRITE_STATUS1;
+        bit = 0x40;
+        break;
+    default:
+        return 0;
+    }
+
+    qspi_command_t cmd = command(read_cmd);
+    cmd.data_lines = 1;
+    uint8_t status = 0;
+    if (flash->ops->read(flash->hw, &cmd, &status, 1) != 0) {
+        return -3;
+    }
+    if (status & bit) {
+        return 0;
+    }
+
+    status |= bit;
+    cmd = command(write_cmd);
+    cmd.data_lines = 1;
+    if (write_enable(flash) != 0 || flash->ops->write(flash->hw, &cmd, &status, 1) != 0 ||
+        flash->ops->wait_ready(flash->hw, QSPI_FLASH_ERASE_TIMEOUT_MS) != 0) {
+        return -3;
+    }
+    return 0;
+}
+
+// Public API implementations
+
+int qspi_flash_init(qspi_flash_t* flash, const qspi_flash_ops_t* ops, void* hw, const qspi_flash_part_t* part) {
+    if (!flash || !ops || !ops->command || !ops->read || !ops->write || !ops->wait_ready ||
+        !ops->memory_map || !ops->abort || !part || part->size == 0 || part->size > QSPI_FLASH_MAX_SIZE || (part->size & (part->size - 1U)) ||
+        part->page_size == 0 || (part->page_size & (part->page_size - 1U)) ||
+        (part->program_lines != 1U && part->program_lines != 4U)) {
+        return -1;
+    }
+
+    flash->ops = ops;
+    flash->hw = hw;
+    flash->part = *part;
+    flash->mapped = false;
+    return set_quad_enable(flash);
+}
+
+int qspi_flash_read_id(qspi_flash_t* flash, uint8_t id[3]) {
+    if (flash->mapped) {
+        return -4;
+    }
+    qspi_command_t cmd = command(QSPI_CMD_READ_ID);
+    cmd.data_lines = 1;
+    return (flash->ops->read(flash->hw, &cmd, id, 3) == 0) ? 0 : -3;
+}
+
+int qspi_flash_read(qspi_flash_t* flash, uint32_t address, uint8_t* data, uint32_t len) {
+    if (!data || len == 0) {
+        return -1;
+    }
+    if (!in_range(flash, address, len)) {
+        return -2;
+    }
+    if (flash->mapped) {
+        return -4;
+    }
+
+    const qspi_command_t cmd = read_command(flash, address);
+    return (flash->ops->read(flash->hw, &cmd, data, len) == 0) ? 0 : -3;
+}
+
+int qspi_flash_program(qspi_flash_t* flash, uint32_t address, const uint8_t* data, uint32_t len) {
+    if (!data || len == 0) {
+        return -1;
+    }
+    if (!in_range(flash, address, len)) {
+        return -2;
+    }
+    if (flash->mapped) {
+        return -4;
+    }
+
+    // A page program wraps within its page: never cross a page boundary
+    const uint32_t page = flash->part.page_size;
+    while (len > 0) {
+        uint32_t chunk = page - (address & (page - 1U));
+        if (chunk > len) {
+            chunk = len;
+        }
+
+        const qspi_command_t cmd = {flash->part.program_cmd, true, address, 1, 0, flash->part.program_lines};
+        if (write_enable(flash) != 0 || flash->ops->write(flash->hw, &cmd, data, chunk) != 0 ||
+            flash->ops->wait_ready(flash->hw, QSPI_FLASH_PROGRAM_TIMEOUT_MS) != 0) {
+            return -3;
+        }
+        address += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+    return 0;
+}
+
+int qspi_flash_erase(qspi_flash_t* flash, uint32_t address, uint32_t len) {
+    if (len == 0 || (address % QSPI_FLASH_SECTOR) != 0 || (len % QSPI_FLASH_SECTOR) != 0) {
+        return -1;
+    }
+    if (!in_range(flash, address, len)) {
+        return -2;
+    }
+    if (flash->mapped) {
+        return -4;
+    }
+
+    while (len > 0) {
+        const bool block = (address % QSPI_FLASH_BLOCK) == 0 && len >= QSPI_FLASH_BLOCK;
+        qspi_command_t cmd = command(block ? QSPI_CMD_BLOCK_ERASE : QSPI_CMD_SECTOR_ERASE);
+        cmd.has_address = true;
+        cmd.address = address;
+        if (write_enable(flash) != 0 || flash->ops->command(flash->hw, &cmd) != 0 ||
+            flash->ops->wait_ready(flash->hw, QSPI_FLASH_ERASE_TIMEOUT_MS) != 0) {
+            return -3;
+        }
+
+        const uint32_t step = block ? QSPI_FLASH_BLOCK : QSPI_FLASH_SECTOR;
+        address += step;
+        len -= step;
+    }
+    return 0;
+}
+
+int qspi_flash_memory_map(qspi_flash_t* flash) {
+    if (flash->mapped) {
+        return 0;
+    }
+    const qspi_command_t cmd = read_command(flash, 0);
+    if (flash->ops->memory_map(flash->hw, &cmd) != 0) {
+        return -3;
+    }
+    flash->mapped = true;
+    return 0;
+}
+
+int qspi_flash_memory_unmap(qspi_flash_t* flash) {
+    if (!flash->mapped) {
+        return 0;
+    }
+    if (flash->ops->abort(flash->hw) != 0) {
+        return -3;
+    }
+    flash->mapped = false;
+    return 0;
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+/**
+ * @file qspi_flash.h
+ * @brief Serial NOR flash on the QUADSPI controller
+ *
+ * Two ways to reach the flash:
+ * - Indirect mode: qspi_flash_read(), qspi_flash_program() and
+ *   qspi_flash_erase() run one command at a time, moving data by DMA, and
+ *   block the calling task until the flash reports it is no longer busy.
+ * - Memory-mapped mode: qspi_flash_memory_map() hands the controller to
+ *   the CPU bus. The flash then reads like internal memory at
+ *   QSPI_FLASH_MAPPED_BASE: constant assets placed in the .qspi section
+ *   (QSPI_CONST in sections.h) are used in place, with no copies, and the
+ *   controller prefetches sequential reads. Indirect commands are refused
+ *   until qspi_flash_memory_unmap().
+ *
+ * Reads use Fast Read Quad Output (1-1-4); programs use the configured page
+ * program command. The part's quad enable bit is set at init. Programs are
+ * split at page boundaries; erases use 64 KiB blocks where the range
+ * allows and 4 KiB sectors elsewhere.
+ *
+ * The hardware is reached through qspi_flash_ops_t (qspi_stm32l4xx.c).
+ * None of this may be called from an ISR.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#define QSPI_FLASH_MAPPED_BASE      0x90000000UL
+#define QSPI_FLASH_MAX_SIZE         (16UL * 1024UL * 1024UL)   // 24-bit addresses
+
+// Standard SPI NOR commands
+#define QSPI_CMD_WRITE_ENABLE       0x06
+#define QSPI_CMD_READ_STATUS1       0x05
+#define QSPI_CMD_READ_STATUS2       0x35
+#define QSPI_CMD_WRITE_STATUS1      0x01
+#define QSPI_CMD_WRITE_STATUS2      0x31
+#define QSPI_CMD_READ_ID            0x9F
+#define QSPI_CMD_FAST_READ_QUAD     0x6B
+#define QSPI_CMD_PAGE_PROGRAM       0x02
+#define QSPI_CMD_PAGE_PROGRAM_QUAD  0x32
+#define QSPI_CMD_SECTOR_ERASE       0x20    // 4 KiB
+#define QSPI_CMD_BLOCK_ERASE        0xD8    // 64 KiB
+
+#define QSPI_FLASH_SECTOR           4096U
+#define QSPI_FLASH_BLOCK            65536U
+#define QSPI_FLASH_STATUS_BUSY      0x01
+
+#define QSPI_FLASH_ERASE_TIMEOUT_MS     2000U
+#define QSPI_FLASH_PROGRAM_TIMEOUT_MS   5U
+
+/**
+ * @brief Quad Enable Bit Location
+ */
+typedef enum {
+    QSPI_QE_NONE,               // Quad always on
+    QSPI_QE_SR2_BIT1,           // Winbond, GigaDevice: written with 0x31
+    QSPI_QE_SR1_BIT6            // Macronix, ISSI: written with 0x01
+} qspi_quad_enable_t;
+
+/**
+ * @brief Flash Part Description
+ */
+typedef struct {
+    uint32_t size;              // Bytes, a power of two up to QSPI_FLASH_MAX_SIZE
+    uint16_t page_size;         // Program page
+    uint8_t read_dummy;         // Dummy cycles of the quad read
+    uint8_t program_cmd;        // QSPI_CMD_PAGE_PROGRAM(_QUAD)
+    uint8_t program_lines;      // Data lines of program_cmd: 1 or 4
+    qspi_quad_enable_t quad_enable;
+    uint32_t max_hz;            // Fastest clock for every command used
+} qspi_flash_part_t;
+
+// Winbond W25Q128JV (16 MiB)
+#define QSPI_FLASH_PART_W25Q128 { 16UL * 1024UL * 1024UL, 256, 8, QSPI_CMD_PAGE_PROGRAM_QUAD, 4, QSPI_QE_SR2_BIT1, 104000000UL }
+
+/**
+ * @brief One Command (instruction on one line, 24-bit address)
+ */
+typedef struct {
+    uint8_t instruction;
+    bool has_address;
+    uint32_t address;
+    uint8_t address_lines;      // 1 or 4
+    uint8_t dummy_cycles;
+    uint8_t data_lines;         // 0 (no data), 1 or 4
+} qspi_command_t;
+
+/**
+ * @brief Hardware Operations (blocking; 0 on success, negative on failure)
+ */
+typedef struct {
+    int (*command)(void* hw, const qspi_command_t* cmd);
+    int (*read)(void* hw, const qspi_command_t* cmd, uint8_t* data, uint32_t len);
+    int (*write)(void* hw, const qspi_command_t* cmd, const uint8_t* data, uint32_t len);
+    int (*wait_ready)(void* hw, uint32_t timeout_ms);   // Poll status 1 until not busy
+    int (*memory_map)(void* hw, const qspi_command_t* read_cmd);
+    int (*abort)(void* hw);                             // Leave memory-mapped mode
+} qspi_flash_ops_t;
+
+/**
+ * @brief Flash State
+ */
+typedef struct {
+    const qspi_flash_ops_t* ops;
+    void* hw;
+    qspi_flash_part_t part;
+    bool mapped;
+} qspi_flash_t;
+
+// =============================================================================
+// Flash API
+// =============================================================================
+
+/**
+ * @brief Initialize a flash and set its quad enable bit
+ * @return 0 on success, -1 on invalid arguments, -3 on a hardware error
+ */
+int qspi_flash_init(qspi_flash_t* flash, const qspi_flash_ops_t* ops, void* hw, const qspi_flash_part_t* part);
+
+/**
+ * @brief Read the JEDEC ID (manufacturer, type, capacity)
+ * @return 0 on success, negative error code on failure
+ */
+int qspi_flash_read_id(qspi_flash_t* flash, uint8_t id[3]);
+
+/**
+ * @brief Read through indirect mode
+ * @return 0 on success, -1 on invalid arguments, -2 if out of range,
+ *         -3 on a hardware error, -4 while memory mapped
+ */
+int qspi_flash_read(qspi_flash_t* flash, uint32_t address, uint8_t* data, uint32_t len);
+
+/**
+ * @brief Program erased flash (bits can only be cleared)
+ * @return As qspi_flash_read()
+ */
+int qspi_flash_program(qspi_flash_t* flash, uint32_t address, const uint8_t* data, uint32_t len);
+
+/**
+ * @brief Erase a range aligned to QSPI_FLASH_SECTOR
+ * @return As qspi_flash_read(), -1 also if the range is not aligned
+ */
+int qspi_flash_erase(qspi_flash_t* flash, uint32_t address, uint32_t len);
+
+/**
+ * @brief Enter memory-mapped mode
+ * @return 0 on success, -3 on a hardware error
+ */
+int qspi_flash_memory_map(qspi_flash_t* flash);
+
+/**
+ * @brief Leave memory-mapped mode
+ * @return 0 on success, -3 on a hardware error
+ */
+int qspi_flash_memory_unmap(qspi_flash_t* flash);
+
+#ifdef __cplusplus
+}
+#endif
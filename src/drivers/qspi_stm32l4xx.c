@@ -0,0 +1,272 @@
+/**
+ * @file qspi_stm32l4xx.c
+ * @brief External NOR flash on the QUADSPI controller for STM32L4xx
+ */
+
+#include "qspi.h"
+#include "hal_irq.h"
+#include "stm32l4xx_hal.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+// QUADSPI is request 5 on DMA1 channel 5
+#define DMA_CHANNEL         DMA1_Channel5
+#define DMA_REQUEST         (5UL << DMA_CSELR_C5S_Pos)
+
+#define FMODE_WRITE         0UL
+#define FMODE_READ          QUADSPI_CCR_FMODE_0
+#define FMODE_POLL          QUADSPI_CCR_FMODE_1
+#define FMODE_MAPPED        QUADSPI_CCR_FMODE
+
+#define DONE_IRQS           (QUADSPI_CR_TCIE | QUADSPI_CR_TEIE | QUADSPI_CR_SMIE)
+
+#define CS_HIGH_NS          50U     // Deselect time after a program or erase
+#define POLL_INTERVAL       16U     // Clocks between automatic status reads
+#define MAPPED_IDLE_CLOCKS  64U     // Release NCS after this long without a mapped read
+
+static qspi_flash_t flash;
+static TaskHandle_t waiter;
+static volatile uint32_t done_sr;
+
+// =============================================================================
+// Command sequencing
+// =============================================================================
+
+static uint32_t mode_bits(uint8_t lines) {
+    return (lines == 4U) ? 3UL : (lines == 2U) ? 2UL : 1UL;
+}
+
+static uint32_t ccr_for(const qspi_command_t* cmd, uint32_t fmode) {
+    uint32_t ccr = fmode | QUADSPI_CCR_IMODE_0 | cmd->instruction |
+                   ((uint32_t)cmd->dummy_cycles << QUADSPI_CCR_DCYC_Pos);
+    if (cmd->has_address) {
+        ccr |= (mode_bits(cmd->address_lines) << QUADSPI_CCR_ADMODE_Pos) | QUADSPI_CCR_ADSIZE_1;
+    }
+    if (cmd->data_lines) {
+        ccr |= mode_bits(cmd->data_lines) << QUADSPI_CCR_DMODE_Pos;
+    }
+    return ccr;
+}
+
+static void dma_start(uint8_t* data, uint32_t len, uint32_t dir) {
+    DMA_CHANNEL->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF5;
+    DMA_CHANNEL->CMAR = (uint32_t)data;
+    DMA_CHANNEL->CNDTR = len;
+    DMA_CHANNEL->CCR = DMA_CCR_PL_1 | DMA_CCR_MINC | dir | DMA_CCR_EN;
+    QUADSPI->CR |= QUADSPI_CR_DMAEN;
+}
+
+static void dma_stop(void) {
+    DMA_CHANNEL->CCR = 0;
+    QUADSPI->CR &= ~QUADSPI_CR_DMAEN;
+}
+
+static void abort_transfer(void) {
+    QUADSPI->CR |= QUADSPI_CR_ABORT;
+    while (QUADSPI->CR & QUADSPI_CR_ABORT) {
+    }
+    QUADSPI->CR &= ~DONE_IRQS;
+    dma_stop();
+}
+
+// Start a command and sleep until the controller reports it done. A
+// command starts on the write to AR when it has an address, else on the
+// write to CCR (reads) or on the first data byte (writes), so a read's DMA
+// is armed before CCR and a write's between CCR and AR, once FMODE says
+// which way the FIFO runs.
+static int run(const qspi_command_t* cmd, uint32_t fmode, uint8_t* data, uint32_t len, uint32_t timeout_ms) {
+    while (QUADSPI->SR & QUADSPI_SR_BUSY) {
+    }
+
+    waiter = xTaskGetCurrentTaskHandle();
+    (void)ulTaskNotifyTake(pdTRUE, 0);
+    done_sr = 0;
+    QUADSPI->FCR = QUADSPI_FCR_CTCF | QUADSPI_FCR_CTEF | QUADSPI_FCR_CSMF;
+    QUADSPI->CR |= (fmode == FMODE_POLL) ? (QUADSPI_CR_SMIE | QUADSPI_CR_TEIE) : (QUADSPI_CR_TCIE | QUADSPI_CR_TEIE);
+    if (len > 0) {
+        QUADSPI->DLR = len - 1U;
+    }
+
+    if (data && fmode == FMODE_READ) {
+        dma_start(data, len, 0);
+    }
+    QUADSPI->CCR = ccr_for(cmd, fmode);
+    if (data && fmode == FMODE_WRITE) {
+        dma_start(data, len, DMA_CCR_DIR);
+    }
+    if (cmd->has_address) {
+        QUADSPI->AR = cmd->address;
+    }
+
+    if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms)) == 0) {
+        abort_transfer();
+        return -1;
+    }
+
+    // In a read, TCF is raised once the last byte has arrived; the DMA may
+    // still be draining the FIFO
+    while (data && fmode == FMODE_READ && (done_sr & QUADSPI_SR_TEF) == 0 && DMA_CHANNEL->CNDTR != 0) {
+    }
+    if (data) {
+        dma_stop();
+    }
+    return (done_sr & QUADSPI_SR_TEF) ? -1 : 0;
+}
+
+// =============================================================================
+// Hardware operations
+// =============================================================================
+
+static int qspi_command(void* hw, const qspi_command_t* cmd) {
+    (void)hw;
+    return run(cmd, FMODE_WRITE, NULL, 0, QSPI_XFER_TIMEOUT_MS);
+}
+
+static int qspi_read(void* hw, const qspi_command_t* cmd, uint8_t* data, uint32_t len) {
+    (void)hw;
+    qspi_command_t part = *cmd;
+
+    // CNDTR is 16 bits: longer reads are split into consecutive commands
+    while (len > 0) {
+        const uint32_t chunk = (len > 0xFFFCU) ? 0xFFFCU : len;
+        const int rc = run(&part, FMODE_READ, data, chunk, QSPI_XFER_TIMEOUT_MS);
+        if (rc != 0) {
+            return rc;
+        }
+        part.address += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+    return 0;
+}
+
+static int qspi_write(void* hw, const qspi_command_t* cmd, const uint8_t* data, uint32_t len) {
+    (void)hw;
+    if (len == 0 || len > 0xFFFFU) {
+        return -1;
+    }
+    return run(cmd, FMODE_WRITE, (uint8_t*)data, len, QSPI_XFER_TIMEOUT_MS);
+}
+
+static int qspi_wait_ready(void* hw, uint32_t timeout_ms) {
+    (void)hw;
+    const qspi_command_t cmd = {QSPI_CMD_READ_STATUS1, false, 0, 1, 0, 1};
+
+    // The controller reads status 1 every POLL_INTERVAL clocks and stops
+    // when BUSY reads 0
+    QUADSPI->PSMKR = QSPI_FLASH_STATUS_BUSY;
+    QUADSPI->PSMAR = 0;
+    QUADSPI->PIR = POLL_INTERVAL;
+    QUADSPI->CR |= QUADSPI_CR_APMS;
+    return run(&cmd, FMODE_POLL, NULL, 1, timeout_ms);
+}
+
+static int qspi_memory_map(void* hw, const qspi_command_t* read_cmd) {
+    (void)hw;
+    while (QUADSPI->SR & QUADSPI_SR_BUSY) {
+    }
+    QUADSPI->LPTR = MAPPED_IDLE_CLOCKS;
+    QUADSPI->CR |= QUADSPI_CR_TCEN;
+    QUADSPI->CCR = ccr_for(read_cmd, FMODE_MAPPED);
+    return 0;
+}
+
+static int qspi_abort(void* hw) {
+    (void)hw;
+    abort_transfer();
+    QUADSPI->CR &= ~QUADSPI_CR_TCEN;
+    while (QUADSPI->SR & QUADSPI_SR_BUSY) {
+    }
+    return 0;
+}
+
+static const qspi_flash_ops_t qspi_ops = {
+    qspi_command,
+    qspi_read,
+    qspi_write,
+    qspi_wait_ready,
+    qspi_memory_map,
+    qspi_abort
+};
+
+// =============================================================================
+// Interrupt
+// =============================================================================
+
+static void qspi_irq(void) {
+    const uint32_t sr = QUADSPI->SR;
+    if ((sr & (QUADSPI_SR_TCF | QUADSPI_SR_TEF | QUADSPI_SR_SMF)) == 0) {
+        return;
+    }
+    QUADSPI->CR &= ~DONE_IRQS;
+    QUADSPI->FCR = QUADSPI_FCR_CTCF | QUADSPI_FCR_CTEF | QUADSPI_FCR_CSMF;
+    done_sr = sr;
+
+    BaseType_t woken = pdFALSE;
+    if (waiter) {
+        vTaskNotifyGiveFromISR(waiter, &woken);
+    }
+    portYIELD_FROM_ISR(woken);
+}
+
+// Public API implementations
+
+int qspi_init(const qspi_flash_part_t* part) {
+    if (!part || part->size < 2U || part->max_hz == 0) {
+        return -1;
+    }
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_QSPI_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    __HAL_RCC_QSPI_FORCE_RESET();
+    __HAL_RCC_QSPI_RELEASE_RESET();
+
+    GPIO_InitTypeDef gpio = {0};
+    gpio.Mode = GPIO_MODE_AF_PP;
+    gpio.Pull = GPIO_NOPULL;
+    gpio.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+    gpio.Alternate = GPIO_AF10_QUADSPI;
+    gpio.Pin = GPIO_PIN_2 | GPIO_PIN_3 | GPIO_PIN_6 | GPIO_PIN_7;
+    HAL_GPIO_Init(GPIOA, &gpio);
+    gpio.Pin = GPIO_PIN_0 | GPIO_PIN_1;
+    HAL_GPIO_Init(GPIOB, &gpio);
+
+    // QUADSPI runs from HCLK: the smallest divider within the part's limit
+    const uint32_t hclk = HAL_RCC_GetHCLKFreq();
+    uint32_t div = (hclk + part->max_hz - 1U) / part->max_hz;
+    if (div > 256U) {
+        div = 256U;
+    }
+    const uint32_t clk = hclk / div;
+    uint32_t csht = (uint32_t)(((uint64_t)clk * CS_HIGH_NS + 999999999ULL) / 1000000000ULL);
+    csht = (csht > 8U) ? 7U : (csht ? csht - 1U : 0U);
+
+    uint32_t fsize = 0;
+    while ((2UL << fsize) < part->size) {
+        fsize++;
+    }
+
+    // Sample half a cycle late: at full speed the data arrives late in the cycle
+    QUADSPI->CR = ((div - 1U) << QUADSPI_CR_PRESCALER_Pos) | QUADSPI_CR_SSHIFT;
+    QUADSPI->DCR = (fsize << QUADSPI_DCR_FSIZE_Pos) | (csht << QUADSPI_DCR_CSHT_Pos);
+    QUADSPI->CR |= QUADSPI_CR_EN;
+
+    DMA_CHANNEL->CCR = 0;
+    DMA_CHANNEL->CPAR = (uint32_t)&QUADSPI->DR;
+    DMA1_CSELR->CSELR = (DMA1_CSELR->CSELR & ~DMA_CSELR_C5S) | DMA_REQUEST;
+
+    if (hal_irq_bind(QUADSPI_IRQn, qspi_irq) != 0) {
+        return -2;
+    }
+    HAL_NVIC_SetPriority(QUADSPI_IRQn, QSPI_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(QUADSPI_IRQn);
+
+    return (qspi_flash_init(&flash, &qspi_ops, QUADSPI, part) == 0) ? 0 : -3;
+}
+
+qspi_flash_t* qspi_flash(void) {
+    return &flash;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+/**
+ * @file sai1.h
+ * @brief SAI1 audio interface with circular DMA ping-pong buffers
+ *
+ * Block A is the master transmitter (PA3 MCLK, PA8 SCK, PA9 FS, PA10 SD)
+ * and block B a receiver synchronous to it (PB5 SD), so one set of clocks
+ * serves a codec's DAC and ADC. Audio moves through DMA2 channels 1 (A)
+ * and 2 (B); audio_stream runs the block callback from the interrupt of
+ * the receive channel (the transmit channel when playback only).
+ *
+ * The frame (channels x slot width) must be a power of two from 32 to 256
+ * bits, since MCLK is 256 x fs. The sample clock comes from PLLSAI1 fed by
+ * the main PLL input (HSI16 on this board), which cannot hit 44.1 or
+ * 48 kHz exactly: the nearest rate is chosen and sai1_sample_rate()
+ * reports it (47.794 kHz for 48 kHz).
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_stream.h"
+
+#define SAI1_IRQ_PRIORITY       6       // Below configMAX_SYSCALL_INTERRUPT_PRIORITY
+
+/**
+ * @brief Frame Formats
+ */
+typedef enum {
+    SAI1_FRAMING_I2S,       // Two slots, FS low for the left one, data one bit after FS
+    SAI1_FRAMING_TDM        // 1 to 8 slots, one-bit FS pulse before slot 0
+} sai1_framing_t;
+
+/**
+ * @brief Interface Configuration
+ *
+ * stream.format sets the slots: S16 in 16-bit slots, S24 and Q31 in
+ * 32-bit slots (24 or 32 data bits).
+ */
+typedef struct {
+    uint32_t sample_rate;
+    sai1_framing_t framing;
+    bool capture;           // Block B receives
+    bool playback;          // Block A transmits (its clocks run either way)
+    audio_stream_config_t stream;
+} sai1_config_t;
+
+/**
+ * @brief Configure the clocks, pins, both SAI blocks and their DMA
+ *        channels, and bind the interrupt
+ *
+ * Requires the RAM vector table (hal_irq_vectors_init()).
+ *
+ * @return 0 on success, -1 on an invalid configuration, -2 if PLLSAI1 did
+ *         not lock, -3 if the interrupt could not be bound
+ */
+int sai1_init(const sai1_config_t* cfg);
+
+/**
+ * @brief Start the clocks and the DMA (the output starts with two silent blocks)
+ */
+void sai1_start(void);
+
+/**
+ * @brief Stop both blocks and their DMA channels
+ */
+void sai1_stop(void);
+
+/**
+ * @brief Frame rate actually produced (valid after sai1_init())
+ */
+uint32_t sai1_sample_rate(void);
+
+/**
+ * @brief The SAI1 stream (statistics; valid after sai1_init())
+ */
+audio_stream_t* sai1_stream(void);
+
+#ifdef __cplusplus
+}
+#endif
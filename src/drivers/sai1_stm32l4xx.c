@@ -0,0 +1,280 @@
+/**
+ * @file sai1_stm32l4xx.c
+ * @brief SAI1 audio interface with circular DMA ping-pong buffers for STM32L4xx
+ */
+
+#include "sai1.h"
+#include "hal_irq.h"
+#include "stm32l4xx_hal.h"
+#include <stddef.h>
+#include <string.h>
+
+// SAI1_A and SAI1_B are request 1 on DMA2 channels 1 and 2
+#define TX_DMA_CHANNEL      DMA2_Channel1
+#define RX_DMA_CHANNEL      DMA2_Channel2
+#define TX_DMA_IRQn         DMA2_Channel1_IRQn
+#define RX_DMA_IRQn         DMA2_Channel2_IRQn
+#define DMA_REQUESTS        ((1UL << DMA_CSELR_C1S_Pos) | (1UL << DMA_CSELR_C2S_Pos))
+
+#define PLLSAI1_VCO_MIN     64000000U
+#define PLLSAI1_VCO_MAX     344000000U
+#define SAI_CK_MAX          80000000U
+
+static audio_stream_t stream;
+static uint32_t dma_buffers[2][2 * AUDIO_STREAM_MAX_SAMPLES];     // TX, RX: two blocks each
+static sai1_config_t config;
+static uint32_t actual_rate;
+
+// =============================================================================
+// Clocks
+// =============================================================================
+
+static uint32_t pll_input_hz(void) {
+    const uint32_t cfgr = RCC->PLLCFGR;
+    const uint32_t m = ((cfgr & RCC_PLLCFGR_PLLM) >> RCC_PLLCFGR_PLLM_Pos) + 1U;
+    uint32_t src;
+
+    switch (cfgr & RCC_PLLCFGR_PLLSRC) {
+    case RCC_PLLCFGR_PLLSRC_HSE:
+        src = HSE_VALUE;
+        break;
+    case RCC_PLLCFGR_PLLSRC_MSI:
+        src = (RCC->CR & RCC_CR_MSIRGSEL) ? MSIRangeTable[(RCC->CR & RCC_CR_MSIRANGE) >> RCC_CR_MSIRANGE_Pos]
+                                          : MSIRangeTable[(RCC->CSR & RCC_CSR_MSISRANGE) >> RCC_CSR_MSISRANGE_Pos];
+        break;
+    default:
+        src = HSI_VALUE;
+        break;
+    }
+    return src / m;
+}
+
+// Search PLLSAI1 N and P and the SAI master clock divider for the frame
+// rate closest to the target: fs = in * N / P / 256 / (MCKDIV ? 2 * MCKDIV : 1)
+static int configure_clock(uint32_t rate_hz) {
+    const uint32_t in = pll_input_hz();
+    uint32_t best_err = UINT32_MAX;
+    uint32_t best_n = 0;
+    uint32_t best_p17 = 0;
+    uint32_t best_div = 0;
+
+    for (uint32_t n = 8; n <= 86U; n++) {
+        const uint32_t vco = in * n;
+        if (vco < PLLSAI1_VCO_MIN || vco > PLLSAI1_VCO_MAX) {
+            continue;
+        }
+        for (uint32_t p17 = 0; p17 < 2U; p17++) {
+            const uint32_t sai_ck = vco / (p17 ? 17U : 7U);
+            if (sai_ck > SAI_CK_MAX) {
+                continue;
+            }
+            for (uint32_t div = 0; div < 16U; div++) {
+                const uint32_t fs = sai_ck / 256U / (div ? 2U * div : 1U);
+                const uint32_t err = (fs > rate_hz) ? fs - rate_hz : rate_hz - fs;
+                if (err < best_err) {
+                    best_err = err;
+                    best_n = n;
+                    best_p17 = p17;
+                    best_div = div;
+                    actual_rate = fs;
+                }
+            }
+        }
+    }
+    if (best_n == 0) {
+        return -1;
+    }
+
+    RCC->CR &= ~RCC_CR_PLLSAI1ON;
+    while (RCC->CR & RCC_CR_PLLSAI1RDY) {
+    }
+    RCC->PLLSAI1CFGR = (best_n << RCC_PLLSAI1CFGR_PLLSAI1N_Pos) | RCC_PLLSAI1CFGR_PLLSAI1PEN |
+                       (best_p17 ? RCC_PLLSAI1CFGR_PLLSAI1P : 0U);
+    RCC->CR |= RCC_CR_PLLSAI1ON;
+
+    const uint32_t start = HAL_GetTick();
+    while ((RCC->CR & RCC_CR_PLLSAI1RDY) == 0) {
+        if (HAL_GetTick() - start > 2U) {
+            return -2;
+        }
+    }
+
+    // SAI1 kernel clock from PLLSAI1 P
+    RCC->CCIPR &= ~RCC_CCIPR_SAI1SEL;
+    return (int)best_div;
+}
+
+// =============================================================================
+// SAI blocks
+// =============================================================================
+
+static void configure_pins(void) {
+    GPIO_InitTypeDef gpio = {0};
+    gpio.Mode = GPIO_MODE_AF_PP;
+    gpio.Pull = GPIO_NOPULL;
+    gpio.Speed = GPIO_SPEED_FREQ_HIGH;
+    gpio.Alternate = GPIO_AF13_SAI1;
+
+    gpio.Pin = GPIO_PIN_3 | GPIO_PIN_8 | GPIO_PIN_9 | GPIO_PIN_10;     // MCLK, SCK, FS, SD_A
+    HAL_GPIO_Init(GPIOA, &gpio);
+    gpio.Pin = GPIO_PIN_5;                                              // SD_B
+    HAL_GPIO_Init(GPIOB, &gpio);
+}
+
+static void configure_blocks(const sai1_config_t* cfg, uint32_t mckdiv) {
+    const audio_format_t format = cfg->stream.format;
+    const uint32_t slot_bits = (format == AUDIO_FMT_S16) ? 16U : 32U;
+    const uint32_t frame_bits = slot_bits * cfg->stream.channels;
+    const uint32_t ds = (format == AUDIO_FMT_S16) ? 4U : (format == AUDIO_FMT_S24) ? 6U : 7U;
+
+    // Both blocks: data driven on the falling SCK edge and sampled on the rising one
+    const uint32_t common = (ds << SAI_xCR1_DS_Pos) | SAI_xCR1_CKSTR | SAI_xCR1_DMAEN;
+
+    uint32_t frcr = ((frame_bits - 1U) << SAI_xFRCR_FRL_Pos) | SAI_xFRCR_FSOFF;
+    if (cfg->framing == SAI1_FRAMING_I2S) {
+        // FS low for the left slot, high for the right one
+        frcr |= ((frame_bits / 2U - 1U) << SAI_xFRCR_FSALL_Pos) | SAI_xFRCR_FSDEF;
+    } else {
+        frcr |= SAI_xFRCR_FSPOL;
+    }
+
+    const uint32_t slotr = ((uint32_t)(cfg->stream.channels - 1U) << SAI_xSLOTR_NBSLOT_Pos) |
+                           ((slot_bits == 16U ? 1U : 2U) << SAI_xSLOTR_SLOTSZ_Pos) |
+                           (((1UL << cfg->stream.channels) - 1U) << SAI_xSLOTR_SLOTEN_Pos);
+
+    SAI1_Block_A->CR1 = 0;
+    SAI1_Block_B->CR1 = 0;
+    SAI1->GCR = 0;
+
+    // A: master transmitter, MCLK = 256 x fs
+    SAI1_Block_A->CR1 = common | (mckdiv << SAI_xCR1_MCKDIV_Pos);
+    SAI1_Block_A->CR2 = SAI_xCR2_FTH_1 | SAI_xCR2_FFLUSH;
+    SAI1_Block_A->FRCR = frcr;
+    SAI1_Block_A->SLOTR = slotr;
+
+    // B: slave receiver on A's clocks
+    SAI1_Block_B->CR1 = common | SAI_xCR1_MODE_0 | SAI_xCR1_MODE_1 | SAI_xCR1_SYNCEN_0;
+    SAI1_Block_B->CR2 = SAI_xCR2_FTH_1 | SAI_xCR2_FFLUSH;
+    SAI1_Block_B->FRCR = frcr;
+    SAI1_Block_B->SLOTR = slotr;
+}
+
+static bool config_valid(const sai1_config_t* cfg) {
+    if (!cfg || (!cfg->capture && !cfg->playback) || cfg->sample_rate == 0) {
+        return false;
+    }
+    const uint8_t channels = cfg->stream.channels;
+    if (cfg->framing == SAI1_FRAMING_I2S && channels != 2U) {
+        return false;
+    }
+    const uint32_t frame_bits = channels * ((cfg->stream.format == AUDIO_FMT_S16) ? 16U : 32U);
+    return frame_bits >= 32U && frame_bits <= 256U && (frame_bits & (frame_bits - 1U)) == 0;
+}
+
+// =============================================================================
+// Interrupt
+// =============================================================================
+
+static void dma_irq(void) {
+    // The pacing channel: receive, or transmit when playback only
+    const uint32_t shift = config.capture ? 4U : 0U;    // DMA_ISR flags are 4 bits per channel
+    const uint32_t isr = DMA2->ISR >> shift;
+
+    if (isr & DMA_ISR_HTIF1) {
+        DMA2->IFCR = DMA_IFCR_CHTIF1 << shift;
+        audio_stream_half_done(&stream, 0);
+    }
+    if (isr & DMA_ISR_TCIF1) {
+        DMA2->IFCR = DMA_IFCR_CTCIF1 << shift;
+        audio_stream_half_done(&stream, 1);
+    }
+    if (isr & DMA_ISR_TEIF1) {
+        DMA2->IFCR = DMA_IFCR_CGIF1 << shift;
+        sai1_stop();
+    }
+}
+
+// Public API implementations
+
+int sai1_init(const sai1_config_t* cfg) {
+    if (!config_valid(cfg)) {
+        return -1;
+    }
+    if (audio_stream_init(&stream, &cfg->stream, cfg->capture ? dma_buffers[1] : NULL,
+                          cfg->playback ? dma_buffers[0] : NULL) != 0 ||
+        audio_stream_dma_bytes(&cfg->stream) > sizeof(dma_buffers[0])) {
+        return -1;
+    }
+    config = *cfg;
+    if (!cfg->playback) {
+        memset(dma_buffers[0], 0, sizeof(dma_buffers[0]));
+    }
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    const int mckdiv = configure_clock(cfg->sample_rate);
+    if (mckdiv < 0) {
+        return -2;
+    }
+    __HAL_RCC_SAI1_CLK_ENABLE();
+    configure_pins();
+    configure_blocks(cfg, (uint32_t)mckdiv);
+
+    TX_DMA_CHANNEL->CCR = 0;
+    RX_DMA_CHANNEL->CCR = 0;
+    TX_DMA_CHANNEL->CPAR = (uint32_t)&SAI1_Block_A->DR;
+    RX_DMA_CHANNEL->CPAR = (uint32_t)&SAI1_Block_B->DR;
+    DMA2_CSELR->CSELR = (DMA2_CSELR->CSELR & ~(DMA_CSELR_C1S | DMA_CSELR_C2S)) | DMA_REQUESTS;
+
+    const IRQn_Type irq = cfg->capture ? RX_DMA_IRQn : TX_DMA_IRQn;
+    if (hal_irq_bind(irq, dma_irq) != 0) {
+        return -3;
+    }
+    HAL_NVIC_SetPriority(irq, SAI1_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(irq);
+    return 0;
+}
+
+void sai1_start(void) {
+    const uint32_t bytes = audio_format_bytes(config.stream.format);
+    const uint32_t size = (bytes == 2U) ? (DMA_CCR_MSIZE_0 | DMA_CCR_PSIZE_0) : (DMA_CCR_MSIZE_1 | DMA_CCR_PSIZE_1);
+    const uint32_t count = (uint32_t)audio_stream_dma_bytes(&config.stream) / bytes;
+    const uint32_t pacing = DMA_CCR_HTIE | DMA_CCR_TCIE | DMA_CCR_TEIE;
+
+    sai1_stop();
+    DMA2->IFCR = DMA_IFCR_CGIF1 | DMA_IFCR_CGIF2;
+
+    // Transmit always runs so that block A produces the clocks; with
+    // playback off it repeats the silence sai1_init() left in its buffer
+    TX_DMA_CHANNEL->CMAR = (uint32_t)dma_buffers[0];
+    TX_DMA_CHANNEL->CNDTR = count;
+    TX_DMA_CHANNEL->CCR = size | DMA_CCR_PL_1 | DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_DIR |
+                          (config.capture ? 0U : pacing) | DMA_CCR_EN;
+
+    if (config.capture) {
+        RX_DMA_CHANNEL->CMAR = (uint32_t)dma_buffers[1];
+        RX_DMA_CHANNEL->CNDTR = count;
+        RX_DMA_CHANNEL->CCR = size | DMA_CCR_PL_1 | DMA_CCR_MINC | DMA_CCR_CIRC | pacing | DMA_CCR_EN;
+        SAI1_Block_B->CR1 |= SAI_xCR1_SAIEN;    // Slave first, so it sees the first frame
+    }
+    SAI1_Block_A->CR1 |= SAI_xCR1_SAIEN;
+}
+
+void sai1_stop(void) {
+    SAI1_Block_A->CR1 &= ~SAI_xCR1_SAIEN;
+    SAI1_Block_B->CR1 &= ~SAI_xCR1_SAIEN;
+    while ((SAI1_Block_A->CR1 | SAI1_Block_B->CR1) & SAI_xCR1_SAIEN) {
+    }
+    TX_DMA_CHANNEL->CCR = 0;
+    RX_DMA_CHANNEL->CCR = 0;
+}
+
+uint32_t sai1_sample_rate(void) {
+    return actual_rate;
+}
+
+audio_stream_t* sai1_stream(void) {
+    return &stream;
+}
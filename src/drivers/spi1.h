@@ -0,0 +1,43 @@
+#pragma once
+
+/**
+ * @file spi1.h
+ * @brief SPI1 bus on the Nucleo-L432KC Arduino pins (PA5 SCK, PA6 MISO, PA7 MOSI)
+ *
+ * Runs the spi_bus manager over SPI1 with DMA1 channels 2 (RX) and 3 (TX).
+ * Completion is taken from the receive channel, since the last byte has
+ * been clocked in when it finishes.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "spi_bus.h"
+
+#define SPI1_IRQ_PRIORITY       6       // Below configMAX_SYSCALL_INTERRUPT_PRIORITY
+
+/**
+ * @brief Configure the pins, SPI1 and its DMA channels, and bind the interrupt
+ *
+ * Requires the RAM vector table (hal_irq_vectors_init()).
+ *
+ * @return 0 on success, negative error code on failure
+ */
+int spi1_init(void);
+
+/**
+ * @brief The SPI1 bus (valid after spi1_init())
+ */
+spi_bus_t* spi1_bus(void);
+
+/**
+ * @brief Configure a device's chip select as a push-pull output, deasserted
+ * @param device Device whose cs_port is a GPIO_TypeDef*
+ * @return 0 on success, negative error code on failure
+ */
+int spi1_init_device(const spi_device_t* device);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @file spi1_stm32l4xx.c
+ * @brief SPI1 bus with DMA for STM32L4xx microcontrollers
+ */
+
+#include "spi1.h"
+#include "hal_irq.h"
+#include "stm32l4xx_hal.h"
+
+// SPI1_RX and SPI1_TX are request 1 on DMA1 channels 2 and 3
+#define RX_DMA_CHANNEL      DMA1_Channel2
+#define TX_DMA_CHANNEL      DMA1_Channel3
+#define RX_DMA_IRQn         DMA1_Channel2_IRQn
+#define DMA_REQUESTS        ((1UL << DMA_CSELR_C2S_Pos) | (1UL << DMA_CSELR_C3S_Pos))
+
+static spi_bus_t bus;
+static const uint8_t dummy_tx = 0xFF;
+static uint8_t dummy_rx;
+
+// =============================================================================
+// Hardware operations
+// =============================================================================
+
+static void spi1_configure(void* hw, uint8_t mode, uint32_t max_hz) {
+    (void)hw;
+
+    // Smallest divider whose clock stays within the device limit
+    const uint32_t pclk = HAL_RCC_GetPCLK2Freq();
+    uint32_t br = 0;
+    while (br < 7U && (pclk >> (br + 1U)) > max_hz) {
+        br++;
+    }
+
+    SPI1->CR1 &= ~SPI_CR1_SPE;
+    SPI1->CR1 = SPI_CR1_MSTR | SPI_CR1_SSM | SPI_CR1_SSI | (br << SPI_CR1_BR_Pos) |
+                ((mode & 2U) ? SPI_CR1_CPOL : 0U) | ((mode & 1U) ? SPI_CR1_CPHA : 0U);
+    SPI1->CR1 |= SPI_CR1_SPE;
+}
+
+static void spi1_chip_select(void* hw, const spi_device_t* device, bool asserted) {
+    (void)hw;
+    GPIO_TypeDef* port = (GPIO_TypeDef*)device->cs_port;
+    port->BSRR = asserted ? ((uint32_t)device->cs_pin << 16) : device->cs_pin;
+}
+
+static void spi1_start(void* hw, const uint8_t* tx, uint8_t* rx, uint16_t len) {
+    (void)hw;
+
+    // Receive channel armed before transmit so no byte is missed
+    RX_DMA_CHANNEL->CCR = 0;
+    RX_DMA_CHANNEL->CMAR = (uint32_t)(rx ? rx : &dummy_rx);
+    RX_DMA_CHANNEL->CNDTR = len;
+    RX_DMA_CHANNEL->CCR = (rx ? DMA_CCR_MINC : 0U) | DMA_CCR_TCIE | DMA_CCR_TEIE | DMA_CCR_EN;
+
+    TX_DMA_CHANNEL->CCR = 0;
+    TX_DMA_CHANNEL->CMAR = (uint32_t)(tx ? tx : &dummy_tx);
+    TX_DMA_CHANNEL->CNDTR = len;
+    TX_DMA_CHANNEL->CCR = DMA_CCR_DIR | (tx ? DMA_CCR_MINC : 0U) | DMA_CCR_EN;
+
+    SPI1->CR2 |= SPI_CR2_RXDMAEN;
+    SPI1->CR2 |= SPI_CR2_TXDMAEN;
+}
+
+static const spi_bus_ops_t spi1_ops = {
+    spi1_configure,
+    spi1_chip_select,
+    spi1_start
+};
+
+static void rx_dma_irq(void) {
+    const uint32_t isr = DMA1->ISR;
+    if ((isr & (DMA_ISR_TCIF2 | DMA_ISR_TEIF2)) == 0) {
+        return;
+    }
+
+    DMA1->IFCR = DMA_IFCR_CGIF2 | DMA_IFCR_CGIF3;
+    RX_DMA_CHANNEL->CCR = 0;
+    TX_DMA_CHANNEL->CCR = 0;
+    SPI1->CR2 &= ~(SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN);
+
+    spi_bus_complete(&bus, (isr & DMA_ISR_TEIF2) ? -1 : 0);
+}
+
+// Public API implementations
+
+int spi1_init(void) {
+    if (spi_bus_init(&bus, &spi1_ops, SPI1) != 0) {
+        return -1;
+    }
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_SPI1_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    GPIO_InitTypeDef gpio = {0};
+    gpio.Pin = GPIO_PIN_5 | GPIO_PIN_6 | GPIO_PIN_7;
+    gpio.Mode = GPIO_MODE_AF_PP;
+    gpio.Pull = GPIO_NOPULL;
+    gpio.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+    gpio.Alternate = GPIO_AF5_SPI1;
+    HAL_GPIO_Init(GPIOA, &gpio);
+
+    // 8-bit frames; RXNE at one byte (FRXTH) to match byte-wide DMA
+    SPI1->CR1 = 0;
+    SPI1->CR2 = (7U << SPI_CR2_DS_Pos) | SPI_CR2_FRXTH;
+
+    RX_DMA_CHANNEL->CPAR = (uint32_t)&SPI1->DR;
+    TX_DMA_CHANNEL->CPAR = (uint32_t)&SPI1->DR;
+    DMA1_CSELR->CSELR = (DMA1_CSELR->CSELR & ~(DMA_CSELR_C2S | DMA_CSELR_C3S)) | DMA_REQUESTS;
+
+    if (hal_irq_bind(RX_DMA_IRQn, rx_dma_irq) != 0) {
+        return -2;
+    }
+    HAL_NVIC_SetPriority(RX_DMA_IRQn, SPI1_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(RX_DMA_IRQn);
+    return 0;
+}
+
+spi_bus_t* spi1_bus(void) {
+    return &bus;
+}
+
+int spi1_init_device(const spi_device_t* device) {
+    if (!device || !device->cs_port || device->cs_pin == 0) {
+        return -1;
+    }
+
+    GPIO_TypeDef* port = (GPIO_TypeDef*)device->cs_port;
+    port->BSRR = device->cs_pin;
+
+    GPIO_InitTypeDef gpio = {0};
+    gpio.Pin = device->cs_pin;
+    gpio.Mode = GPIO_MODE_OUTPUT_PP;
+    gpio.Pull = GPIO_NOPULL;
+    gpio.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(port, &gpio);
+    return 0;
+}
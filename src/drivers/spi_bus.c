@@ -0,0 +1,234 @@
+/**
+ * @file spi_bus.c
+ * @brief Queued SPI bus manager shared by several devices
+ *
+ * The pending transfers form a binary max-heap on (priority, submission
+ * order). Whoever finds the bus idle while holding the critical section
+ * claims the next transfer and starts it after leaving the section; the
+ * claim keeps everyone else from touching the hardware until the
+ * completion interrupt releases it.
+ */
+
+#include "spi_bus.h"
+#include "crit_section.h"
+#include <stddef.h>
+#include <string.h>
+
+// =============================================================================
+// Priority heap
+// =============================================================================
+
+static inline bool runs_before(const spi_transfer_t* a, const spi_transfer_t* b) {
+    if (a->priority != b->priority) {
+        return a->priority > b->priority;
+    }
+    return (int32_t)(a->seq - b->seq) < 0;
+}
+
+static void heap_place(spi_bus_t* bus, uint32_t index, spi_transfer_t* xfer) {
+    bus->heap[index] = xfer;
+    xfer->heap_index = (uint8_t)index;
+}
+
+static void heap_insert(spi_bus_t* bus, spi_transfer_t* xfer) {
+    uint32_t index = bus->count++;
+    while (index > 0) {
+        const uint32_t parent = (index - 1) / 2;
+        if (!runs_before(xfer, bus->heap[parent])) {
+            break;
+        }
+        heap_place(bus, index, bus->heap[parent]);
+        index = parent;
+    }
+    heap_place(bus, index, xfer);
+}
+
+static spi_transfer_t* heap_pop(spi_bus_t* bus) {
+    spi_transfer_t* top = bus->heap[0];
+    spi_transfer_t* last = bus->heap[--bus->count];
+
+    uint32_t index = 0;
+    while (true) {
+        uint32_t child = 2 * index + 1;
+        if (child >= bus->count) {
+            break;
+        }
+        if (child + 1 < bus->count && runs_before(bus->heap[child + 1], bus->heap[child])) {
+            child++;
+        }
+        if (!runs_before(bus->heap[child], last)) {
+            break;
+        }
+        heap_place(bus, index, bus->heap[child]);
+        index = child;
+    }
+    if (bus->count > 0) {
+        heap_place(bus, index, last);
+    }
+    return top;
+}
+
+// =============================================================================
+// Transfer sequencing
+// =============================================================================
+
+// Caller holds the critical section
+static spi_transfer_t* claim_next(spi_bus_t* bus) {
+    if (bus->active || bus->count == 0) {
+        return NULL;
+    }
+    spi_transfer_t* xfer = heap_pop(bus);
+    bus->active = xfer;
+    bus->segment = xfer;
+    return xfer;
+}
+
+// Runs outside the critical section; the claim makes the hardware ours
+static void begin(spi_bus_t* bus, spi_transfer_t* xfer) {
+    const spi_device_t* device = xfer->device;
+    if (!bus->configured || device->mode != bus->mode || device->max_hz != bus->hz) {
+        bus->ops->configure(bus->hw, device->mode, device->max_hz);
+        bus->mode = device->mode;
+        bus->hz = device->max_hz;
+        bus->configured = true;
+        bus->stats.reconfigurations++;
+    }
+
+    bus->ops->chip_select(bus->hw, device, true);
+    bus->ops->start(bus->hw, xfer->tx, xfer->rx, xfer->len);
+}
+
+// Public API implementations
+
+int spi_bus_init(spi_bus_t* bus, const spi_bus_ops_t* ops, void* hw) {
+    if (!bus || !ops || !ops->configure || !ops->chip_select || !ops->start) {
+        return -1;
+    }
+
+    memset(bus, 0, sizeof(*bus));
+    bus->ops = ops;
+    bus->hw = hw;
+    return 0;
+}
+
+int spi_bus_submit(spi_bus_t* bus, spi_transfer_t* xfer) {
+    if (!bus || !xfer || !xfer->device) {
+        return -1;
+    }
+    for (const spi_transfer_t* seg = xfer; seg; seg = seg->next) {
+        if (seg->len == 0) {
+            return -1;  // Error: empty segment
+        }
+    }
+
+    CRIT_STAT;
+    CRIT_ENTER();
+    if (xfer->status == SPI_XFER_PENDING) {
+        CRIT_EXIT();
+        return -3;
+    }
+    if (bus->count >= SPI_BUS_MAX_QUEUED) {
+        bus->stats.rejected++;
+        CRIT_EXIT();
+        return -2;
+    }
+
+    xfer->status = SPI_XFER_PENDING;
+    xfer->seq = bus->seq++;
+    heap_insert(bus, xfer);
+    if (bus->count > bus->stats.queue_peak) {
+        bus->stats.queue_peak = bus->count;
+    }
+    spi_transfer_t* next = claim_next(bus);
+    CRIT_EXIT();
+
+    if (next) {
+        begin(bus, next);
+    }
+    return 0;
+}
+
+void spi_bus_complete(spi_bus_t* bus, int status) {
+    spi_transfer_t* xfer = bus->active;
+    if (!xfer) {
+        return;  // Spurious
+    }
+
+    // Chained segments continue under the same chip select
+    const spi_transfer_t* segment = bus->segment;
+    if (status == 0 && segment->next) {
+        bus->segment = segment->next;
+        bus->ops->start(bus->hw, bus->segment->tx, bus->segment->rx, bus->segment->len);
+        return;
+    }
+
+    bus->ops->chip_select(bus->hw, xfer->device, false);
+    bus->stats.transfers++;
+    if (status != 0) {
+        bus->stats.errors++;
+    }
+
+    CRIT_STAT;
+    CRIT_ENTER();
+    bus->active = NULL;
+    bus->segment = NULL;
+    CRIT_EXIT();
+
+    // The callback may submit a follow-up, which then starts the bus itself
+    xfer->status = status;
+    if (xfer->done) {
+        xfer->done(xfer, status);
+    }
+
+    CRIT_ENTER();
+    spi_transfer_t* next = claim_next(bus);
+    CRIT_EXIT();
+
+    if (next) {
+        begin(bus, next);
+    }
+}
+
+bool spi_bus_busy(const spi_bus_t* bus) {
+    return bus->active != NULL;
+}
+
+void spi_bus_get_stats(const spi_bus_t* bus, spi_bus_stats_t* out) {
+    if (out) {
+        *out = bus->stats;
+    }
+}
+
+// =============================================================================
+// Blocking wrapper
+// =============================================================================
+
+#if !defined(UNIT_TESTING)
+
+static void notify_caller(spi_transfer_t* xfer, int status) {
+    (void)status;
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR((TaskHandle_t)xfer->arg, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+int spi_bus_transfer_sync(spi_bus_t* bus, spi_transfer_t* xfer, uint32_t timeout_ms) {
+    if (!xfer) {
+        return -1;
+    }
+
+    xfer->done = notify_caller;
+    xfer->arg = xTaskGetCurrentTaskHandle();
+    (void)ulTaskNotifyTake(pdTRUE, 0);
+
+    const int rc = spi_bus_submit(bus, xfer);
+    if (rc != 0) {
+        return rc;
+    }
+    if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms)) == 0) {
+        return -4;  // Error: timed out; the transfer is still owned by the bus
+    }
+    return xfer->status;
+}
+
+#endif
@@ -0,0 +1,178 @@
+#pragma once
+
+/**
+ * @file spi_bus.h
+ * @brief Queued SPI bus manager shared by several devices
+ *
+ * Clients describe a transfer (device, buffers, priority, completion
+ * callback) and submit it; the bus keeps pending transfers in a priority
+ * heap and runs them back to back, starting the next one from the DMA
+ * completion interrupt of the previous. Clock polarity/phase and speed are
+ * only reprogrammed when the next device needs different settings.
+ *
+ * Chip select is asserted for one transfer and released after it, since
+ * most devices end a command on the CS edge. A transfer may chain further
+ * segments through `next` (e.g. command then payload); the chain runs
+ * under one CS assertion and reports once, after its last segment.
+ *
+ * Transfers are caller-owned and must stay untouched until their callback
+ * has run. spi_bus_submit() may be called from tasks and ISRs up to
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY; callbacks run in the completion
+ * interrupt and must be short. spi_bus_transfer_sync() blocks the calling
+ * task instead.
+ *
+ * The hardware is reached through spi_bus_ops_t (spi1_stm32l4xx.c for
+ * SPI1 on the Nucleo pins).
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef SPI_BUS_MAX_QUEUED
+#define SPI_BUS_MAX_QUEUED      16      // Pending transfers per bus
+#endif
+
+#define SPI_XFER_PENDING        1       // status while queued or running
+
+/**
+ * @brief Device on the Bus
+ */
+typedef struct {
+    void* cs_port;          // GPIO port of the active-low chip select
+    uint16_t cs_pin;        // GPIO pin mask
+    uint8_t mode;           // SPI mode 0..3 (CPOL << 1 | CPHA)
+    uint32_t max_hz;        // Fastest clock the device accepts
+} spi_device_t;
+
+typedef struct spi_transfer spi_transfer_t;
+
+/**
+ * @brief Completion callback (runs in the DMA interrupt)
+ * @param xfer The first segment of the finished transfer
+ * @param status 0 on success, negative error code on failure
+ */
+typedef void (*spi_done_t)(spi_transfer_t* xfer, int status);
+
+/**
+ * @brief Transfer (one segment, optionally chained)
+ */
+struct spi_transfer {
+    const spi_device_t* device;
+    const uint8_t* tx;      // NULL: clock out 0xFF
+    uint8_t* rx;            // NULL: discard received bytes
+    uint16_t len;
+    uint8_t priority;       // Higher runs first; FIFO within a priority
+    spi_transfer_t* next;   // Next segment under the same chip select
+    spi_done_t done;        // Optional
+    void* arg;              // For the callback's use
+
+    // Owned by the bus
+    volatile int status;
+    uint32_t seq;
+    uint8_t heap_index;
+};
+
+/**
+ * @brief Hardware Operations
+ */
+typedef struct {
+    void (*configure)(void* hw, uint8_t mode, uint32_t max_hz);
+    void (*chip_select)(void* hw, const spi_device_t* device, bool asserted);
+    void (*start)(void* hw, const uint8_t* tx, uint8_t* rx, uint16_t len);
+} spi_bus_ops_t;
+
+/**
+ * @brief Bus Statistics
+ */
+typedef struct {
+    uint32_t transfers;         // Completed transfers (chains count once)
+    uint32_t errors;            // Completed with an error
+    uint32_t reconfigurations;  // Mode/speed changes
+    uint32_t rejected;          // Submissions refused (queue full)
+    uint32_t queue_peak;        // Most transfers pending at once
+} spi_bus_stats_t;
+
+/**
+ * @brief Bus State
+ */
+typedef struct {
+    const spi_bus_ops_t* ops;
+    void* hw;
+    spi_transfer_t* heap[SPI_BUS_MAX_QUEUED];
+    uint32_t count;
+    uint32_t seq;
+    spi_transfer_t* active;     // Transfer owning the bus
+    spi_transfer_t* segment;    // Segment of it on the wire
+    uint8_t mode;
+    uint32_t hz;
+    bool configured;
+    spi_bus_stats_t stats;
+} spi_bus_t;
+
+// =============================================================================
+// Bus API
+// =============================================================================
+
+/**
+ * @brief Initialize a bus
+ * @param bus Bus state
+ * @param ops Hardware operations
+ * @param hw Context passed to the operations
+ * @return 0 on success, negative error code on failure
+ */
+int spi_bus_init(spi_bus_t* bus, const spi_bus_ops_t* ops, void* hw);
+
+/**
+ * @brief Queue a transfer, starting it at once if the bus is idle
+ * @param bus Bus
+ * @param xfer Transfer (first segment)
+ * @return 0 on success, -1 on invalid arguments, -2 if the queue is full,
+ *         -3 if the transfer is already pending
+ */
+int spi_bus_submit(spi_bus_t* bus, spi_transfer_t* xfer);
+
+/**
+ * @brief Report the end of the segment on the wire (DMA interrupt)
+ * @param bus Bus
+ * @param status 0 on success, negative error code on failure
+ */
+void spi_bus_complete(spi_bus_t* bus, int status);
+
+/**
+ * @brief Check whether a transfer is running
+ */
+bool spi_bus_busy(const spi_bus_t* bus);
+
+/**
+ * @brief Read the bus statistics
+ */
+void spi_bus_get_stats(const spi_bus_t* bus, spi_bus_stats_t* out);
+
+#if !defined(UNIT_TESTING)
+
+/**
+ * @brief Submit a transfer and wait for it (task context)
+ *
+ * Uses the calling task's notification; xfer->done and xfer->arg are
+ * overwritten.
+ *
+ * @param bus Bus
+ * @param xfer Transfer
+ * @param timeout_ms Longest wait
+ * @return Transfer status, or negative if it could not be queued or timed out
+ */
+int spi_bus_transfer_sync(spi_bus_t* bus, spi_transfer_t* xfer, uint32_t timeout_ms);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,127 @@
+#pragma once
+
+/**
+ * @file uart_rx.hpp
+ * @brief UART receive by circular DMA with idle-line detection
+ *
+ * The DMA channel runs forever in circular mode over an N byte buffer. Three
+ * interrupts report progress: half-transfer and transfer-complete from the
+ * DMA, and idle-line from the UART when a burst ends. Each one calls
+ * on_dma_event() with the channel's remaining count; the bytes written
+ * since the previous event are handed to Port::deliver() as at most two
+ * contiguous spans (two when the data wraps). A burst costs one interrupt
+ * instead of one per byte.
+ *
+ * Port::deliver() typically pushes into a stream buffer for the consumer
+ * task and returns how much it accepted; the rest is counted as dropped.
+ * Line errors (overrun, framing, noise) are counted by on_line_errors().
+ *
+ * The events must not preempt each other (give the DMA and UART interrupts
+ * the same priority). Data is lost without notice only if more than N/2
+ * bytes arrive while the interrupts are held off, since half-transfer and
+ * transfer-complete bound every lap.
+ *
+ * @code
+ * struct Port {
+ *     static std::size_t deliver(const uint8_t* data, std::size_t len);  // ISR
+ * };
+ * @endcode
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Line error flags passed to on_line_errors()
+ */
+enum : uint32_t {
+    UART_RX_ERR_OVERRUN = 1U << 0,
+    UART_RX_ERR_FRAMING = 1U << 1,
+    UART_RX_ERR_NOISE   = 1U << 2
+};
+
+/**
+ * @brief Receive Statistics
+ */
+struct UartRxStats {
+    uint32_t bytes_received;    // Delivered to the consumer
+    uint32_t bytes_dropped;     // Consumer had no room
+    uint32_t events;            // Interrupts that found new data
+    uint32_t overruns;
+    uint32_t framing_errors;
+    uint32_t noise_errors;
+};
+
+template <std::size_t N, typename Port>
+class UartRx {
+    static_assert(N >= 2 && N <= 0xFFFF, "The DMA buffer length must fit CNDTR");
+
+public:
+    UartRx() = default;
+    UartRx(const UartRx&) = delete;
+    UartRx& operator=(const UartRx&) = delete;
+
+    static constexpr std::size_t size() { return N; }
+
+    /**
+     * @brief Buffer to hand to the DMA channel (circular, N transfers)
+     */
+    uint8_t* dma_buffer() { return buffer_; }
+
+    /**
+     * @brief Forget the read position (call when (re)starting the DMA)
+     */
+    void reset() { last_ = 0; }
+
+    /**
+     * @brief Half-transfer, transfer-complete or idle-line interrupt
+     * @param remaining The channel's CNDTR value
+     */
+    void on_dma_event(std::size_t remaining) {
+        const std::size_t pos = (remaining == 0 || remaining > N) ? 0 : N - remaining;
+        if (pos == last_) {
+            return;  // Idle after a half/complete event already took the data
+        }
+
+        stats_.events++;
+        if (pos > last_) {
+            deliver(&buffer_[last_], pos - last_);
+        } else {
+            deliver(&buffer_[last_], N - last_);
+            deliver(&buffer_[0], pos);
+        }
+        last_ = pos;
+    }
+
+    /**
+     * @brief Count line errors reported by the UART interrupt
+     * @param flags UART_RX_ERR_* bits
+     */
+    void on_line_errors(uint32_t flags) {
+        if (flags & UART_RX_ERR_OVERRUN) {
+            stats_.overruns++;
+        }
+        if (flags & UART_RX_ERR_FRAMING) {
+            stats_.framing_errors++;
+        }
+        if (flags & UART_RX_ERR_NOISE) {
+            stats_.noise_errors++;
+        }
+    }
+
+    const UartRxStats& stats() const { return stats_; }
+
+private:
+    void deliver(const uint8_t* data, std::size_t len) {
+        if (len == 0) {
+            return;
+        }
+        const std::size_t accepted = Port::deliver(data, len);
+        stats_.bytes_received += static_cast<uint32_t>(accepted);
+        stats_.bytes_dropped += static_cast<uint32_t>(len - accepted);
+    }
+
+    uint8_t buffer_[N];
+    std::size_t last_ = 0;
+    UartRxStats stats_{};
+};
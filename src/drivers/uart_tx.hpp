@@ -0,0 +1,161 @@
+#pragma once
+
+/**
+ * @file uart_tx.hpp
+ * @brief Non-blocking UART transmit path: ring buffer drained by DMA
+ *
+ * Writers copy into an SpscRing and return; the DMA engine sends the
+ * largest contiguous readable span of the ring, and its transfer-complete
+ * interrupt releases that span and starts the next one. A writer therefore
+ * costs a memcpy instead of one character time per byte.
+ *
+ * Several tasks may write: they are serialized by Port::lock(), so the ring
+ * still sees a single producer. The DMA interrupt is the single consumer;
+ * starting a transfer from the writer side happens inside
+ * Port::enter_critical() so it cannot race the interrupt.
+ *
+ * When the ring is full the policy decides:
+ * - UartTxPolicy::DropNewest: keep what fits, drop the rest at once
+ * - UartTxPolicy::Block: wait for the DMA to free space, dropping the rest
+ *   only if the line makes no progress for the configured timeout
+ *
+ * The hardware and RTOS glue is a Port type with static members:
+ * @code
+ * struct Port {
+ *     static bool lock();                              // false: write nothing
+ *     static void unlock();
+ *     static bool wait_space(uint32_t timeout);        // false on timeout
+ *     static void signal_space();                      // from the DMA ISR
+ *     static void enter_critical();                    // task and ISR safe
+ *     static void exit_critical();
+ *     static void start_dma(const uint8_t* data, std::size_t len);
+ * };
+ * @endcode
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include "spsc_ring.hpp"
+
+enum class UartTxPolicy : uint8_t {
+    DropNewest,     // Never wait; excess bytes are dropped
+    Block           // Wait for space, up to the timeout per stall
+};
+
+/**
+ * @brief Transmit Statistics
+ */
+struct UartTxStats {
+    uint32_t bytes_queued;      // Accepted into the ring
+    uint32_t bytes_dropped;     // Rejected (ring full, timeout or no lock)
+    uint32_t overflows;         // write() calls that dropped anything
+    uint32_t dma_transfers;     // Transfers started
+    uint32_t peak_used;         // Highest ring occupancy seen by a writer
+};
+
+template <std::size_t N, typename Port>
+class UartTx {
+    static_assert(N <= 0xFFFF, "A DMA transfer length must fit CNDTR");
+
+public:
+    explicit UartTx(UartTxPolicy policy = UartTxPolicy::DropNewest, uint32_t timeout = 0)
+        : policy_(policy), timeout_(timeout) {}
+
+    UartTx(const UartTx&) = delete;
+    UartTx& operator=(const UartTx&) = delete;
+
+    void set_policy(UartTxPolicy policy, uint32_t timeout) {
+        policy_ = policy;
+        timeout_ = timeout;
+    }
+
+    /**
+     * @brief Queue bytes for transmission
+     * @return Number of bytes accepted (the rest are dropped)
+     */
+    std::size_t write(const uint8_t* data, std::size_t len) {
+        if (!Port::lock()) {
+            // Another writer may hold the lock and be updating the counters
+            Port::enter_critical();
+            drop(len);
+            Port::exit_critical();
+            return 0;
+        }
+
+        std::size_t done = 0;
+        while (true) {
+            done += ring_.write(data + done, len - done);
+            note_usage();
+            kick();
+            if (done == len || policy_ != UartTxPolicy::Block || !Port::wait_space(timeout_)) {
+                break;
+            }
+        }
+        Port::enter_critical();
+        stats_.bytes_queued += static_cast<uint32_t>(done);
+        drop(len - done);
+        Port::exit_critical();
+
+        Port::unlock();
+        return done;
+    }
+
+    /**
+     * @brief DMA transfer-complete handler (ISR)
+     */
+    void on_dma_complete() {
+        ring_.commit_read(in_flight_);
+        in_flight_ = 0;
+        start_next();
+        Port::signal_space();
+    }
+
+    /**
+     * @brief Bytes waiting or being sent
+     */
+    std::size_t pending() const { return ring_.size(); }
+
+    bool busy() const { return in_flight_ != 0; }
+
+    const UartTxStats& stats() const { return stats_; }
+
+private:
+    void drop(std::size_t count) {
+        if (count != 0) {
+            stats_.bytes_dropped += static_cast<uint32_t>(count);
+            stats_.overflows++;
+        }
+    }
+
+    void note_usage() {
+        const uint32_t used = static_cast<uint32_t>(ring_.size());
+        if (used > stats_.peak_used) {
+            stats_.peak_used = used;
+        }
+    }
+
+    // Start a transfer if the DMA is idle (writer side)
+    void kick() {
+        Port::enter_critical();
+        if (in_flight_ == 0) {
+            start_next();
+        }
+        Port::exit_critical();
+    }
+
+    // Called with the DMA idle, from the ISR or inside a critical section
+    void start_next() {
+        const auto span = ring_.read_span();
+        if (!span.empty()) {
+            in_flight_ = span.size();
+            stats_.dma_transfers++;
+            Port::start_dma(span.data(), span.size());
+        }
+    }
+
+    SpscRing<uint8_t, N> ring_;
+    volatile std::size_t in_flight_ = 0;
+    UartTxPolicy policy_;
+    uint32_t timeout_;
+    UartTxStats stats_{};
+};
@@ -0,0 +1,406 @@
+#pragma once
+
+/**
+ * @file usb_cdc.hpp
+ * @brief USB CDC-ACM (virtual serial port) class with ring-buffered bulk endpoints
+ *
+ * The transmit path is zero-copy on the device side: producers append to
+ * an SpscRing (write(), or write_span() / commit() to format in place),
+ * and the bulk IN endpoint is handed the largest contiguous readable span
+ * of that ring directly, up to USB_CDC_MAX_TRANSFER bytes per transfer.
+ * The span is released when the controller reports the transfer done:
+ * once the host has read it, or for a double-buffered endpoint once its
+ * last packet is in packet memory, up to two packets ahead of the host.
+ * The completion immediately submits the next span, so the endpoint is
+ * never left idle while data is waiting.
+ *
+ * Back-pressure is the ring itself. When the host stops reading, IN
+ * transfers stall, the ring fills and write() accepts fewer bytes (the
+ * producer decides whether to wait, see Port::signal_space(), or drop).
+ * In the other direction the OUT endpoint is only armed while the receive
+ * ring has room for a whole packet; otherwise it NAKs and the host holds
+ * its data until read() frees space.
+ *
+ * Both bulk endpoints are opened double-buffered, so the controller can
+ * move one packet on the bus while the other is being filled or drained.
+ *
+ * Data written before the host configures the device waits in the ring.
+ * DTR (the host opening the port) is reported by dtr() but does not gate
+ * transmission.
+ *
+ * The RTOS glue is a Port type with static members:
+ * @code
+ * struct Port {
+ *     static void enter_critical();    // Masks the USB interrupt (task and ISR safe)
+ *     static void exit_critical();
+ *     static void signal_space();      // IN transfer done: ring space freed (ISR)
+ *     static void signal_data();       // OUT packet stored (ISR)
+ * };
+ * @endcode
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include "spsc_ring.hpp"
+
+extern "C" {
+#include "usb_device.h"
+}
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef USB_CDC_VID
+#define USB_CDC_VID                 0x0483  // STMicroelectronics
+#endif
+
+#ifndef USB_CDC_PID
+#define USB_CDC_PID                 0x5740  // Virtual COM port
+#endif
+
+#ifndef USB_CDC_MAX_TRANSFER
+#define USB_CDC_MAX_TRANSFER        1024    // Bytes per IN transfer, a multiple of the packet size
+#endif
+
+#define USB_CDC_PACKET              64
+#define USB_CDC_EP_OUT              0x01
+#define USB_CDC_EP_IN               0x82
+#define USB_CDC_EP_NOTIFY           0x83
+
+// String descriptor indices
+#define USB_CDC_STR_MANUFACTURER    1
+#define USB_CDC_STR_PRODUCT         2
+#define USB_CDC_STR_SERIAL          3
+
+inline constexpr uint8_t usb_cdc_device_descriptor[18] = {
+    18, USB_DESC_DEVICE,
+    0x00, 0x02,                     // USB 2.0
+    0x02, 0x00, 0x00,               // Communications device class
+    USB_EP0_SIZE,
+    USB_CDC_VID & 0xFF, USB_CDC_VID >> 8,
+    USB_CDC_PID & 0xFF, USB_CDC_PID >> 8,
+    0x00, 0x01,                     // Device release 1.00
+    USB_CDC_STR_MANUFACTURER, USB_CDC_STR_PRODUCT, USB_CDC_STR_SERIAL,
+    1                               // Configurations
+};
+
+inline constexpr uint8_t usb_cdc_config_descriptor[67] = {
+    9, USB_DESC_CONFIGURATION, 67, 0, 2, 1, 0, 0x80, 50,    // Bus powered, 100 mA
+
+    // Communications interface: control requests and the notification endpoint
+    9, USB_DESC_INTERFACE, 0, 0, 1, 0x02, 0x02, 0x00, 0,    // ACM, no AT protocol
+    5, 0x24, 0x00, 0x10, 0x01,                              // Header, CDC 1.10
+    5, 0x24, 0x01, 0x00, 1,                                 // Call management: data interface 1
+    4, 0x24, 0x02, 0x02,                                    // ACM: line coding and control line state
+    5, 0x24, 0x06, 0, 1,                                    // Union: 0 controls 1
+    7, USB_DESC_ENDPOINT, USB_CDC_EP_NOTIFY, USB_EP_TYPE_INTERRUPT, 8, 0, 16,
+
+    // Data interface: the two bulk endpoints
+    9, USB_DESC_INTERFACE, 1, 0, 2, 0x0A, 0x00, 0x00, 0,
+    7, USB_DESC_ENDPOINT, USB_CDC_EP_OUT, USB_EP_TYPE_BULK, USB_CDC_PACKET, 0, 0,
+    7, USB_DESC_ENDPOINT, USB_CDC_EP_IN, USB_EP_TYPE_BULK, USB_CDC_PACKET, 0, 0
+};
+
+/**
+ * @brief Line Coding set by the host (informational: there is no UART behind it)
+ */
+struct UsbCdcLineCoding {
+    uint32_t baud;
+    uint8_t stop_bits;          // 0: 1, 1: 1.5, 2: 2
+    uint8_t parity;             // 0: none, 1: odd, 2: even, 3: mark, 4: space
+    uint8_t data_bits;
+};
+
+/**
+ * @brief Class Statistics
+ */
+struct UsbCdcStats {
+    uint32_t bytes_sent;        // Handed to the controller (up to two packets ahead of the host)
+    uint32_t bytes_received;
+    uint32_t transfers;         // IN transfers submitted
+    uint32_t zlps;              // Zero-length packets ending a transfer
+    uint32_t tx_full;           // write() calls that did not fit
+    uint32_t rx_throttled;      // Times the OUT endpoint was left NAKing for lack of room
+};
+
+template <std::size_t TxN, std::size_t RxN, typename Port>
+class UsbCdc {
+    static_assert(RxN >= 2 * USB_CDC_PACKET, "The receive ring must hold two packets");
+    static_assert(USB_CDC_MAX_TRANSFER % USB_CDC_PACKET == 0 && USB_CDC_MAX_TRANSFER <= 0xFFC0,
+                  "USB_CDC_MAX_TRANSFER must be whole packets");
+
+    // SET_LINE_CODING, GET_LINE_CODING, SET_CONTROL_LINE_STATE, SEND_BREAK
+    static constexpr uint8_t kSetLineCoding = 0x20;
+    static constexpr uint8_t kGetLineCoding = 0x21;
+    static constexpr uint8_t kSetControlLineState = 0x22;
+    static constexpr uint8_t kSendBreak = 0x23;
+
+public:
+    UsbCdc() = default;
+    UsbCdc(const UsbCdc&) = delete;
+    UsbCdc& operator=(const UsbCdc&) = delete;
+
+    /**
+     * @brief Initialize the device core with this class
+     * @return 0 on success, negative error code on failure
+     */
+    int init(usb_device_t* dev, const usb_dcd_ops_t* ops, void* hw, const usb_descriptors_t* desc) {
+        dev_ = dev;
+        return usb_device_init(dev, ops, hw, desc, &kClass, this);
+    }
+
+    // =========================================================================
+    // Producer side (one task at a time)
+    // =========================================================================
+
+    /**
+     * @brief Queue bytes for the host
+     * @return Number of bytes accepted (fewer when the ring is full)
+     */
+    std::size_t write(const uint8_t* data, std::size_t len) {
+        const std::size_t done = tx_.write(data, len);
+        if (done < len) {
+            stats_.tx_full++;
+        }
+        kick();
+        return done;
+    }
+
+    /**
+     * @brief Contiguous free space of the transmit ring, to fill in place
+     */
+    std::span<uint8_t> write_span() { return tx_.write_span(); }
+
+    /**
+     * @brief Queue bytes written through write_span()
+     */
+    void commit(std::size_t count) {
+        tx_.commit_write(count);
+        kick();
+    }
+
+    /**
+     * @brief Bytes waiting or being sent
+     */
+    std::size_t tx_pending() const { return tx_.size(); }
+
+    // =========================================================================
+    // Consumer side (one task)
+    // =========================================================================
+
+    /**
+     * @brief Take received bytes
+     * @return Number of bytes read
+     */
+    std::size_t read(uint8_t* data, std::size_t len) {
+        const std::size_t done = rx_.read(data, len);
+        if (done != 0) {
+            Port::enter_critical();
+            if (!rx_armed_) {
+                arm_rx();
+            }
+            Port::exit_critical();
+        }
+        return done;
+    }
+
+    std::size_t rx_available() const { return rx_.size(); }
+
+    // =========================================================================
+    // State
+    // =========================================================================
+
+    bool configured() const { return configured_; }
+    bool dtr() const { return dtr_; }
+
+    UsbCdcLineCoding line_coding() const {
+        UsbCdcLineCoding coding;
+        coding.baud = static_cast<uint32_t>(line_coding_[0]) | (static_cast<uint32_t>(line_coding_[1]) << 8) |
+                      (static_cast<uint32_t>(line_coding_[2]) << 16) |
+                      (static_cast<uint32_t>(line_coding_[3]) << 24);
+        coding.stop_bits = line_coding_[4];
+        coding.parity = line_coding_[5];
+        coding.data_bits = line_coding_[6];
+        return coding;
+    }
+
+    const UsbCdcStats& stats() const { return stats_; }
+
+private:
+    static UsbCdc* self(void* arg) { return static_cast<UsbCdc*>(arg); }
+
+    // Start an IN transfer if none is running (writer side)
+    void kick() {
+        Port::enter_critical();
+        if (!in_busy_) {
+            start_tx();
+        }
+        Port::exit_critical();
+    }
+
+    // Called with the IN endpoint idle, from the ISR or inside a critical section
+    void start_tx() {
+        if (!configured_) {
+            return;
+        }
+        const auto span = tx_.read_span();
+        std::size_t len = span.size();
+        if (len > USB_CDC_MAX_TRANSFER) {
+            len = USB_CDC_MAX_TRANSFER;
+        }
+        if (len != 0) {
+            in_busy_ = true;
+            in_flight_ = len;
+            zlp_due_ = false;
+            stats_.transfers++;
+            usb_device_ep_transmit(dev_, USB_CDC_EP_IN, span.data(), static_cast<uint16_t>(len));
+        } else if (zlp_due_) {
+            // The host only sees the end of a transfer at a short packet
+            in_busy_ = true;
+            zlp_due_ = false;
+            stats_.zlps++;
+            usb_device_ep_transmit(dev_, USB_CDC_EP_IN, nullptr, 0);
+        }
+    }
+
+    // Arm the OUT endpoint straight into the ring when a whole packet fits
+    // contiguously, else through the bounce buffer; with no room, leave it
+    // NAKing until read() frees some
+    void arm_rx() {
+        if (!configured_) {
+            return;
+        }
+        const auto span = rx_.write_span();
+        if (span.size() >= USB_CDC_PACKET) {
+            rx_bounce_used_ = false;
+            rx_armed_ = true;
+            usb_device_ep_receive(dev_, USB_CDC_EP_OUT, span.data(), USB_CDC_PACKET);
+        } else if (RxN - rx_.size() >= USB_CDC_PACKET) {
+            rx_bounce_used_ = true;
+            rx_armed_ = true;
+            usb_device_ep_receive(dev_, USB_CDC_EP_OUT, rx_bounce_, USB_CDC_PACKET);
+        } else {
+            stats_.rx_throttled++;
+        }
+    }
+
+    // =========================================================================
+    // Class callbacks (USB interrupt)
+    // =========================================================================
+
+    static void on_reset(void* arg) {
+        UsbCdc* cdc = self(arg);
+        cdc->configured_ = false;
+        cdc->in_busy_ = false;
+        cdc->in_flight_ = 0;
+        cdc->zlp_due_ = false;
+        cdc->rx_armed_ = false;
+        cdc->dtr_ = false;
+    }
+
+    static void on_configured(void* arg, uint8_t configuration) {
+        UsbCdc* cdc = self(arg);
+        on_reset(arg);
+        if (configuration == 0) {
+            return;
+        }
+
+        usb_device_ep_open(cdc->dev_, USB_CDC_EP_OUT, USB_EP_TYPE_BULK, USB_CDC_PACKET, true);
+        usb_device_ep_open(cdc->dev_, USB_CDC_EP_IN, USB_EP_TYPE_BULK, USB_CDC_PACKET, true);
+        usb_device_ep_open(cdc->dev_, USB_CDC_EP_NOTIFY, USB_EP_TYPE_INTERRUPT, 8, false);
+        cdc->configured_ = true;
+        cdc->arm_rx();
+        cdc->start_tx();
+    }
+
+    static int on_setup(void* arg, const usb_setup_t* setup, const uint8_t** data, uint16_t* len) {
+        UsbCdc* cdc = self(arg);
+        if ((setup->request_type & 0x60) != 0x20 || setup->index != 0) {
+            return -1;      // Not a class request to the communications interface
+        }
+
+        switch (setup->request) {
+        case kSetLineCoding:
+            return (setup->length == sizeof(cdc->line_coding_)) ? 0 : -1;
+        case kGetLineCoding:
+            *data = cdc->line_coding_;
+            *len = sizeof(cdc->line_coding_);
+            return 0;
+        case kSetControlLineState:
+            cdc->dtr_ = (setup->value & 0x01U) != 0;
+            return 0;
+        case kSendBreak:
+            return 0;
+        default:
+            return -1;
+        }
+    }
+
+    static int on_control_out(void* arg, const usb_setup_t* setup, const uint8_t* data, uint16_t len) {
+        UsbCdc* cdc = self(arg);
+        if (setup->request != kSetLineCoding || len != sizeof(cdc->line_coding_)) {
+            return -1;
+        }
+        std::memcpy(cdc->line_coding_, data, len);
+        return 0;
+    }
+
+    static void on_in_done(void* arg, uint8_t ep) {
+        UsbCdc* cdc = self(arg);
+        if (ep != USB_CDC_EP_IN) {
+            return;
+        }
+
+        const std::size_t sent = cdc->in_flight_;
+        cdc->tx_.commit_read(sent);
+        cdc->stats_.bytes_sent += static_cast<uint32_t>(sent);
+        cdc->in_flight_ = 0;
+        cdc->in_busy_ = false;
+        cdc->zlp_due_ = sent != 0 && (sent % USB_CDC_PACKET) == 0;
+        cdc->start_tx();
+        if (sent != 0) {
+            Port::signal_space();
+        }
+    }
+
+    static void on_out_done(void* arg, uint8_t ep, uint16_t len) {
+        UsbCdc* cdc = self(arg);
+        if (ep != USB_CDC_EP_OUT) {
+            return;
+        }
+
+        cdc->rx_armed_ = false;
+        if (cdc->rx_bounce_used_) {
+            cdc->rx_.write(cdc->rx_bounce_, len);
+        } else {
+            cdc->rx_.commit_write(len);
+        }
+        cdc->stats_.bytes_received += len;
+        cdc->arm_rx();
+        if (len != 0) {
+            Port::signal_data();
+        }
+    }
+
+    static constexpr usb_class_t kClass = {
+        on_reset, on_configured, on_setup, on_control_out, on_in_done, on_out_done
+    };
+
+    usb_device_t* dev_ = nullptr;
+    SpscRing<uint8_t, TxN> tx_;
+    SpscRing<uint8_t, RxN> rx_;
+    uint8_t rx_bounce_[USB_CDC_PACKET];
+    uint8_t line_coding_[7] = {0x00, 0xC2, 0x01, 0x00, 0, 0, 8};   // 115200 8N1
+
+    volatile bool configured_ = false;
+    volatile bool in_busy_ = false;
+    std::size_t in_flight_ = 0;
+    bool zlp_due_ = false;
+    volatile bool rx_armed_ = false;
+    bool rx_bounce_used_ = false;
+    volatile bool dtr_ = false;
+    UsbCdcStats stats_{};
+};
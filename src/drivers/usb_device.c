@@ -0,0 +1,354 @@
+/**
+ * @file usb_device.c
+ * @brief Minimal full-speed USB device core: enumeration and endpoint 0
+ *
+ * A control transfer is SETUP, an optional data stage and a status stage
+ * in the opposite direction. The stage field follows it so that each
+ * endpoint 0 completion knows what comes next; a new SETUP always starts
+ * over, whatever was in progress.
+ */
+
+#include "usb_device.h"
+#include <stddef.h>
+#include <string.h>
+
+// bmRequestType fields
+#define REQ_DIR_IN              0x80
+#define REQ_TYPE_MASK           0x60
+#define REQ_TYPE_STANDARD       0x00
+#define REQ_RECIPIENT_MASK      0x1F
+#define REQ_RECIPIENT_DEVICE    0
+#define REQ_RECIPIENT_INTERFACE 1
+#define REQ_RECIPIENT_ENDPOINT  2
+
+// Standard requests
+#define REQ_GET_STATUS          0
+#define REQ_CLEAR_FEATURE       1
+#define REQ_SET_FEATURE         3
+#define REQ_SET_ADDRESS         5
+#define REQ_GET_DESCRIPTOR      6
+#define REQ_GET_CONFIGURATION   8
+#define REQ_SET_CONFIGURATION   9
+#define REQ_GET_INTERFACE       10
+#define REQ_SET_INTERFACE       11
+
+#define FEATURE_ENDPOINT_HALT   0
+
+static const uint8_t language_ids[4] = {4, USB_DESC_STRING, 0x09, 0x04};
+
+static uint16_t halt_bit(uint8_t ep) {
+    return (uint16_t)(1U << ((ep & 0x0FU) + ((ep & USB_EP_IN) ? 8U : 0U)));
+}
+
+static uint16_t min16(uint16_t a, uint16_t b) {
+    return (a < b) ? a : b;
+}
+
+// =============================================================================
+// Control transfer stages
+// =============================================================================
+
+static void stall_ep0(usb_device_t* dev) {
+    dev->ops->ep_stall(dev->hw, USB_EP_IN, true);
+    dev->ops->ep_stall(dev->hw, 0x00, true);
+    dev->stage = USB_CTRL_IDLE;
+}
+
+static void send_status(usb_device_t* dev) {
+    dev->stage = USB_CTRL_STATUS_IN;
+    dev->ops->ep_transmit(dev->hw, USB_EP_IN, NULL, 0);
+}
+
+// A data stage shorter than requested ends with a short packet; one that
+// is a whole number of packets needs a zero-length packet to end it
+static void send_data(usb_device_t* dev, const uint8_t* data, uint16_t len) {
+    if (dev->setup.length == 0) {
+        send_status(dev);
+        return;
+    }
+    len = min16(len, dev->setup.length);
+    dev->ctrl_zlp = len > 0 && len < dev->setup.length && (len % USB_EP0_SIZE) == 0;
+    dev->stage = USB_CTRL_DATA_IN;
+    dev->ops->ep_transmit(dev->hw, USB_EP_IN, data, len);
+}
+
+static void receive_data(usb_device_t* dev) {
+    if (dev->setup.length > USB_CTRL_BUFFER) {
+        stall_ep0(dev);
+        return;
+    }
+    dev->stage = USB_CTRL_DATA_OUT;
+    dev->ctrl_received = 0;
+    dev->ops->ep_receive(dev->hw, 0x00, dev->ctrl_buf, min16(dev->setup.length, USB_EP0_SIZE));
+}
+
+// =============================================================================
+// Standard requests
+// =============================================================================
+
+static void get_descriptor(usb_device_t* dev) {
+    const uint8_t type = (uint8_t)(dev->setup.value >> 8);
+    const uint8_t index = (uint8_t)dev->setup.value;
+
+    switch (type) {
+    case USB_DESC_DEVICE:
+        send_data(dev, dev->desc->device, dev->desc->device[0]);
+        return;
+    case USB_DESC_CONFIGURATION:
+        send_data(dev, dev->desc->config, (uint16_t)(dev->desc->config[2] | (dev->desc->config[3] << 8)));
+        return;
+    case USB_DESC_STRING:
+        if (index == 0) {
+            send_data(dev, language_ids, sizeof(language_ids));
+            return;
+        }
+        if (index <= dev->desc->string_count) {
+            // ASCII to UTF-16LE
+            const char* s = dev->desc->strings[index - 1];
+            size_t n = strlen(s);
+            if (n > (USB_CTRL_BUFFER - 2U) / 2U) {
+                n = (USB_CTRL_BUFFER - 2U) / 2U;
+            }
+            dev->ctrl_buf[0] = (uint8_t)(2U + 2U * n);
+            dev->ctrl_buf[1] = USB_DESC_STRING;
+            for (size_t i = 0; i < n; i++) {
+                dev->ctrl_buf[2U + 2U * i] = (uint8_t)s[i];
+                dev->ctrl_buf[3U + 2U * i] = 0;
+            }
+            send_data(dev, dev->ctrl_buf, dev->ctrl_buf[0]);
+            return;
+        }
+        break;
+    default:
+        break;  // No device qualifier: full speed only
+    }
+    stall_ep0(dev);
+}
+
+static void set_configuration(usb_device_t* dev) {
+    const uint8_t value = (uint8_t)dev->setup.value;
+    if (value != 0 && value != dev->desc->config[5]) {
+        stall_ep0(dev);
+        return;
+    }
+
+    dev->configuration = value;
+    dev->halted = 0;
+    if (dev->cls->configured) {
+        dev->cls->configured(dev->cls_arg, value);
+    }
+    send_status(dev);
+}
+
+static void standard_request(usb_device_t* dev) {
+    const usb_setup_t* s = &dev->setup;
+    const uint8_t recipient = s->request_type & REQ_RECIPIENT_MASK;
+
+    switch (s->request) {
+    case REQ_GET_DESCRIPTOR:
+        get_descriptor(dev);
+        return;
+
+    case REQ_SET_ADDRESS:
+        // Takes effect after the status stage, which still uses address 0
+        dev->address = (uint8_t)(s->value & 0x7FU);
+        dev->address_pending = true;
+        send_status(dev);
+        return;
+
+    case REQ_GET_CONFIGURATION:
+        dev->ctrl_buf[0] = dev->configuration;
+        send_data(dev, dev->ctrl_buf, 1);
+        return;
+
+    case REQ_SET_CONFIGURATION:
+        set_configuration(dev);
+        return;
+
+    case REQ_GET_STATUS:
+        dev->ctrl_buf[0] = 0;
+        dev->ctrl_buf[1] = 0;
+        if (recipient == REQ_RECIPIENT_DEVICE) {
+            dev->ctrl_buf[0] = (dev->desc->config[7] & 0x40U) ? 1U : 0U;   // Self powered
+        } else if (recipient == REQ_RECIPIENT_ENDPOINT) {
+            dev->ctrl_buf[0] = (dev->halted & halt_bit((uint8_t)s->index)) ? 1U : 0U;
+        }
+        send_data(dev, dev->ctrl_buf, 2);
+        return;
+
+    case REQ_CLEAR_FEATURE:
+    case REQ_SET_FEATURE:
+        if (recipient == REQ_RECIPIENT_ENDPOINT && s->value == FEATURE_ENDPOINT_HALT) {
+            const uint8_t ep = (uint8_t)(s->index & 0x8FU);
+            const bool halt = s->request == REQ_SET_FEATURE;
+            if ((ep & 0x0FU) != 0) {
+                dev->ops->ep_stall(dev->hw, ep, halt);
+                dev->halted = halt ? (uint16_t)(dev->halted | halt_bit(ep))
+                                   : (uint16_t)(dev->halted & ~halt_bit(ep));
+            }
+        }
+        // Remote wakeup and test modes are acknowledged and ignored
+        send_status(dev);
+        return;
+
+    case REQ_GET_INTERFACE:
+        if (dev->configuration != 0 && recipient == REQ_RECIPIENT_INTERFACE) {
+            dev->ctrl_buf[0] = 0;
+            send_data(dev, dev->ctrl_buf, 1);
+            return;
+        }
+        break;
+
+    case REQ_SET_INTERFACE:
+        if (dev->configuration != 0 && s->value == 0) {
+            send_status(dev);
+            return;
+        }
+        break;
+
+    default:
+        break;
+    }
+    stall_ep0(dev);
+}
+
+static void class_request(usb_device_t* dev) {
+    const uint8_t* data = NULL;
+    uint16_t len = 0;
+
+    if (!dev->cls->setup || dev->cls->setup(dev->cls_arg, &dev->setup, &data, &len) != 0) {
+        stall_ep0(dev);
+    } else if (dev->setup.request_type & REQ_DIR_IN) {
+        send_data(dev, data, len);
+    } else if (dev->setup.length > 0) {
+        receive_data(dev);
+    } else {
+        send_status(dev);
+    }
+}
+
+// Public API implementations
+
+int usb_device_init(usb_device_t* dev, const usb_dcd_ops_t* ops, void* hw, const usb_descriptors_t* desc,
+                    const usb_class_t* cls, void* cls_arg) {
+    if (!dev || !ops || !ops->set_address || !ops->ep_open || !ops->ep_transmit ||
+        !ops->ep_receive || !ops->ep_stall || !desc || !desc->device || !desc->config || !cls) {
+        return -1;
+    }
+
+    memset(dev, 0, sizeof(*dev));
+    dev->ops = ops;
+    dev->hw = hw;
+    dev->desc = desc;
+    dev->cls = cls;
+    dev->cls_arg = cls_arg;
+    return 0;
+}
+
+bool usb_device_configured(const usb_device_t* dev) {
+    return dev->configuration != 0;
+}
+
+void usb_device_ep_open(usb_device_t* dev, uint8_t ep, uint8_t type, uint16_t max_packet, bool double_buffered) {
+    dev->ops->ep_open(dev->hw, ep, type, max_packet, double_buffered);
+}
+
+void usb_device_ep_transmit(usb_device_t* dev, uint8_t ep, const uint8_t* data, uint16_t len) {
+    dev->ops->ep_transmit(dev->hw, ep, data, len);
+}
+
+void usb_device_ep_receive(usb_device_t* dev, uint8_t ep, uint8_t* buf, uint16_t len) {
+    dev->ops->ep_receive(dev->hw, ep, buf, len);
+}
+
+void usb_device_on_reset(usb_device_t* dev) {
+    dev->stage = USB_CTRL_IDLE;
+    dev->ctrl_zlp = false;
+    dev->address_pending = false;
+    dev->address = 0;
+    dev->configuration = 0;
+    dev->halted = 0;
+
+    dev->ops->ep_open(dev->hw, 0x00, USB_EP_TYPE_CONTROL, USB_EP0_SIZE, false);
+    dev->ops->ep_open(dev->hw, USB_EP_IN, USB_EP_TYPE_CONTROL, USB_EP0_SIZE, false);
+    if (dev->cls->reset) {
+        dev->cls->reset(dev->cls_arg);
+    }
+}
+
+void usb_device_on_setup(usb_device_t* dev, const uint8_t packet[8]) {
+    dev->setup.request_type = packet[0];
+    dev->setup.request = packet[1];
+    dev->setup.value = (uint16_t)(packet[2] | (packet[3] << 8));
+    dev->setup.index = (uint16_t)(packet[4] | (packet[5] << 8));
+    dev->setup.length = (uint16_t)(packet[6] | (packet[7] << 8));
+    dev->stage = USB_CTRL_IDLE;
+    dev->ctrl_zlp = false;
+
+    if ((dev->setup.request_type & REQ_TYPE_MASK) == REQ_TYPE_STANDARD) {
+        standard_request(dev);
+    } else {
+        class_request(dev);
+    }
+}
+
+void usb_device_on_in(usb_device_t* dev, uint8_t ep) {
+    if ((ep & 0x0FU) != 0) {
+        if (dev->cls->in_done) {
+            dev->cls->in_done(dev->cls_arg, ep);
+        }
+        return;
+    }
+
+    switch (dev->stage) {
+    case USB_CTRL_DATA_IN:
+        if (dev->ctrl_zlp) {
+            dev->ctrl_zlp = false;
+            dev->ops->ep_transmit(dev->hw, USB_EP_IN, NULL, 0);
+            return;
+        }
+        dev->stage = USB_CTRL_STATUS_OUT;
+        dev->ops->ep_receive(dev->hw, 0x00, NULL, 0);
+        break;
+    case USB_CTRL_STATUS_IN:
+        if (dev->address_pending) {
+            dev->address_pending = false;
+            dev->ops->set_address(dev->hw, dev->address);
+        }
+        dev->stage = USB_CTRL_IDLE;
+        break;
+    default:
+        break;
+    }
+}
+
+void usb_device_on_out(usb_device_t* dev, uint8_t ep, uint16_t len) {
+    if ((ep & 0x0FU) != 0) {
+        if (dev->cls->out_done) {
+            dev->cls->out_done(dev->cls_arg, ep, len);
+        }
+        return;
+    }
+
+    switch (dev->stage) {
+    case USB_CTRL_DATA_OUT:
+        dev->ctrl_received = (uint16_t)(dev->ctrl_received + len);
+        if (len == USB_EP0_SIZE && dev->ctrl_received < dev->setup.length) {
+            dev->ops->ep_receive(dev->hw, 0x00, dev->ctrl_buf + dev->ctrl_received,
+                                 min16((uint16_t)(dev->setup.length - dev->ctrl_received), USB_EP0_SIZE));
+            return;
+        }
+        if (dev->cls->control_out &&
+            dev->cls->control_out(dev->cls_arg, &dev->setup, dev->ctrl_buf, dev->ctrl_received) == 0) {
+            send_status(dev);
+        } else {
+            stall_ep0(dev);
+        }
+        break;
+    case USB_CTRL_STATUS_OUT:
+        dev->stage = USB_CTRL_IDLE;
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+/**
+ * @file usb_device.h
+ * @brief Minimal full-speed USB device core: enumeration and endpoint 0
+ *
+ * Runs the control endpoint: the standard requests a host sends to
+ * enumerate and configure a device (descriptors, address, configuration,
+ * status, endpoint halt) are answered here from a descriptor table, and
+ * class or vendor requests are passed to one class driver (usb_class_t).
+ * The device has a single configuration.
+ *
+ * The hardware is reached through usb_dcd_ops_t, a device controller
+ * driver that moves whole transfers: the core and the class hand it a
+ * buffer and are told when it has gone out or come in. The controller
+ * driver reports bus events by calling usb_device_on_*() from its
+ * interrupt; class callbacks therefore run in interrupt context.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#define USB_EP0_SIZE                64
+#define USB_CTRL_BUFFER             128     // Largest OUT data stage and string descriptor
+
+// Endpoint types (bmAttributes)
+#define USB_EP_TYPE_CONTROL         0
+#define USB_EP_TYPE_ISOCHRONOUS     1
+#define USB_EP_TYPE_BULK            2
+#define USB_EP_TYPE_INTERRUPT       3
+
+#define USB_EP_IN                   0x80
+
+// Descriptor types
+#define USB_DESC_DEVICE             1
+#define USB_DESC_CONFIGURATION      2
+#define USB_DESC_STRING             3
+#define USB_DESC_INTERFACE          4
+#define USB_DESC_ENDPOINT           5
+
+/**
+ * @brief SETUP Packet
+ */
+typedef struct {
+    uint8_t request_type;       // bmRequestType
+    uint8_t request;            // bRequest
+    uint16_t value;
+    uint16_t index;
+    uint16_t length;            // Data stage length
+} usb_setup_t;
+
+/**
+ * @brief Descriptor Table
+ *
+ * String descriptor n (n >= 1) is strings[n - 1], sent as UTF-16; index 0
+ * is the language list (US English).
+ */
+typedef struct {
+    const uint8_t* device;      // 18 bytes
+    const uint8_t* config;      // wTotalLength bytes, all interfaces and endpoints
+    const char* const* strings;
+    uint8_t string_count;
+} usb_descriptors_t;
+
+/**
+ * @brief Device Controller Operations
+ *
+ * Transfers complete with usb_device_on_in() / usb_device_on_out(). Buffers
+ * must stay valid until then. A controller may complete an IN transfer
+ * once its data is copied into its own buffers, before the host reads it.
+ */
+typedef struct {
+    void (*set_address)(void* hw, uint8_t address);
+    void (*ep_open)(void* hw, uint8_t ep, uint8_t type, uint16_t max_packet, bool double_buffered);
+    // Send len bytes as max_packet pieces and a final short packet if any
+    // remainder (len == 0 sends one zero-length packet)
+    void (*ep_transmit)(void* hw, uint8_t ep, const uint8_t* data, uint16_t len);
+    // Accept one packet of up to len bytes (len == 0 for a status stage)
+    void (*ep_receive)(void* hw, uint8_t ep, uint8_t* buf, uint16_t len);
+    void (*ep_stall)(void* hw, uint8_t ep, bool stall);
+} usb_dcd_ops_t;
+
+/**
+ * @brief Class Driver (all callbacks run in the controller interrupt)
+ */
+typedef struct {
+    void (*reset)(void* arg);                               // Bus reset
+    void (*configured)(void* arg, uint8_t configuration);   // 0: deconfigured
+    // Class or vendor request: 0 to accept (for a device-to-host request,
+    // set *data and *len), negative to stall
+    int (*setup)(void* arg, const usb_setup_t* setup, const uint8_t** data, uint16_t* len);
+    // Data stage of an accepted host-to-device request: 0 to acknowledge
+    int (*control_out)(void* arg, const usb_setup_t* setup, const uint8_t* data, uint16_t len);
+    void (*in_done)(void* arg, uint8_t ep);
+    void (*out_done)(void* arg, uint8_t ep, uint16_t len);
+} usb_class_t;
+
+typedef enum {
+    USB_CTRL_IDLE,
+    USB_CTRL_DATA_IN,
+    USB_CTRL_DATA_OUT,
+    USB_CTRL_STATUS_IN,
+    USB_CTRL_STATUS_OUT
+} usb_ctrl_stage_t;
+
+/**
+ * @brief Device State
+ */
+typedef struct {
+    const usb_dcd_ops_t* ops;
+    void* hw;
+    const usb_descriptors_t* desc;
+    const usb_class_t* cls;
+    void* cls_arg;
+
+    usb_setup_t setup;          // Request in progress
+    usb_ctrl_stage_t stage;
+    bool ctrl_zlp;              // Data stage needs a terminating zero-length packet
+    bool address_pending;
+    uint8_t address;
+    uint8_t configuration;
+    uint16_t halted;            // Endpoint halt bits: OUT n in bit n, IN n in bit n + 8
+    uint16_t ctrl_received;
+    uint8_t ctrl_buf[USB_CTRL_BUFFER];
+} usb_device_t;
+
+// =============================================================================
+// Device API
+// =============================================================================
+
+/**
+ * @brief Initialize the core (the controller driver then connects the bus)
+ * @return 0 on success, -1 on invalid arguments
+ */
+int usb_device_init(usb_device_t* dev, const usb_dcd_ops_t* ops, void* hw, const usb_descriptors_t* desc,
+                    const usb_class_t* cls, void* cls_arg);
+
+/**
+ * @brief True once the host has selected the configuration
+ */
+bool usb_device_configured(const usb_device_t* dev);
+
+// Endpoint access for the class driver
+
+void usb_device_ep_open(usb_device_t* dev, uint8_t ep, uint8_t type, uint16_t max_packet, bool double_buffered);
+void usb_device_ep_transmit(usb_device_t* dev, uint8_t ep, const uint8_t* data, uint16_t len);
+void usb_device_ep_receive(usb_device_t* dev, uint8_t ep, uint8_t* buf, uint16_t len);
+
+// =============================================================================
+// Controller Events (controller interrupt)
+// =============================================================================
+
+void usb_device_on_reset(usb_device_t* dev);
+void usb_device_on_setup(usb_device_t* dev, const uint8_t packet[8]);
+void usb_device_on_in(usb_device_t* dev, uint8_t ep);
+void usb_device_on_out(usb_device_t* dev, uint8_t ep, uint16_t len);
+
+#ifdef __cplusplus
+}
+#endif
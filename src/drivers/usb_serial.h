@@ -0,0 +1,112 @@
+#pragma once
+
+/**
+ * @file usb_serial.h
+ * @brief USB CDC-ACM virtual serial port on the USB full-speed device controller
+ *
+ * A second console next to debug_uart, fast enough to stream telemetry:
+ * full-speed bulk carries up to 19 packets of 64 bytes per 1 ms frame,
+ * about 1.2 MB/s, against 11.5 kB/s for the UART at 115200 baud.
+ *
+ * Transmission goes through a USB_SERIAL_TX_BUFFER byte ring whose
+ * contiguous spans are handed to the bulk IN endpoint without copying
+ * (usb_cdc.hpp). usb_serial_reserve() / usb_serial_commit() let a producer
+ * format straight into the ring. Received bytes wait in a
+ * USB_SERIAL_RX_BUFFER byte ring; when it is full the OUT endpoint NAKs
+ * and the host holds its data.
+ *
+ * Writers are serialized by a mutex. A single task may read.
+ *
+ * Hardware: USB_DP on PA12 and USB_DM on PA11, clocked from HSI48 trimmed
+ * to the host's start-of-frame by CRS, so no crystal is needed. The
+ * Nucleo-L432KC only brings PA11/PA12 out to header pins (D10/D2): a USB
+ * connector must be wired to them.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef USB_SERIAL_TX_BUFFER
+#define USB_SERIAL_TX_BUFFER        4096U   // Power of two
+#endif
+
+#ifndef USB_SERIAL_RX_BUFFER
+#define USB_SERIAL_RX_BUFFER        1024U   // Power of two, at least two packets
+#endif
+
+#define USB_SERIAL_IRQ_PRIORITY     6       // Below configMAX_SYSCALL_INTERRUPT_PRIORITY
+
+/**
+ * @brief Port Statistics
+ */
+typedef struct {
+    uint32_t bytes_sent;        // In packet memory or read by the host
+    uint32_t bytes_received;
+    uint32_t transfers;         // Bulk IN transfers
+    uint32_t zlps;              // Zero-length packets ending a transfer
+    uint32_t tx_full;           // Writes that had to wait or gave up
+    uint32_t rx_throttled;      // Times the OUT endpoint was left NAKing
+    uint32_t bus_resets;
+} usb_serial_stats_t;
+
+/**
+ * @brief Start HSI48 and CRS, configure the pins and the controller, bind
+ *        the interrupt and connect to the bus
+ *
+ * Requires the RAM vector table (hal_irq_vectors_init()).
+ *
+ * @return 0 on success, negative error code on failure
+ */
+int usb_serial_init(void);
+
+/**
+ * @brief Queue bytes for the host, waiting for ring space as needed
+ * @param timeout_ms Longest wait for the host to make progress
+ * @return Number of bytes accepted (fewer on timeout), or negative if not initialized
+ */
+int usb_serial_write(const void* data, size_t len, uint32_t timeout_ms);
+
+/**
+ * @brief Reserve contiguous transmit space to fill in place
+ *
+ * Takes the writer mutex; usb_serial_commit() must follow, even with 0.
+ *
+ * @param len Set to the number of bytes available at the returned address
+ * @param timeout_ms Longest wait for any space
+ * @return Start of the space, or NULL on timeout (the mutex is then not held)
+ */
+uint8_t* usb_serial_reserve(size_t* len, uint32_t timeout_ms);
+
+/**
+ * @brief Send bytes written after usb_serial_reserve() and release the mutex
+ */
+void usb_serial_commit(size_t len);
+
+/**
+ * @brief Read received bytes, waiting for at least one
+ * @return Number of bytes read (0 on timeout), or negative if not initialized
+ */
+int usb_serial_read(void* buf, size_t len, uint32_t timeout_ms);
+
+/**
+ * @brief True while the host has the port open (configured and DTR set)
+ */
+bool usb_serial_connected(void);
+
+/**
+ * @brief Read the statistics
+ */
+void usb_serial_get_stats(usb_serial_stats_t* out);
+
+#ifdef __cplusplus
+}
+#endif
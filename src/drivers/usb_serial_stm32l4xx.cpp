@@ -0,0 +1,678 @@
+/**
+ * @file usb_serial_stm32l4xx.cpp
+ * @brief USB CDC-ACM virtual serial port on the STM32L4xx USB full-speed controller
+ */
+
+#include "usb_serial.h"
+#include "usb_cdc.hpp"
+#include "sections.h"
+
+extern "C" {
+#include "stm32l4xx_hal.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "hal_irq.h"
+}
+
+#define NUM_ENDPOINTS       8
+#define PMA_SIZE            1024U
+#define PMA_FIRST_BUFFER    (NUM_ENDPOINTS * 8U)    // After the buffer descriptor table
+
+namespace {
+
+// =============================================================================
+// Registers and packet memory
+// =============================================================================
+
+// EPnR are 16-bit registers on a 32-bit stride
+volatile uint16_t& epr(uint8_t num) {
+    return *reinterpret_cast<volatile uint16_t*>(USB_BASE + 4U * num);
+}
+
+// Packet memory is accessed as 16-bit words at their byte offsets
+volatile uint16_t* pma(uint16_t offset) {
+    return reinterpret_cast<volatile uint16_t*>(USB_PMAADDR + offset);
+}
+
+// Buffer descriptor table (BTABLE = 0): ADDR_TX, COUNT_TX, ADDR_RX, COUNT_RX
+enum : uint8_t { ADDR_TX, COUNT_TX, ADDR_RX, COUNT_RX };
+
+volatile uint16_t& btable(uint8_t num, uint8_t field) {
+    return pma(static_cast<uint16_t>(num * 8U))[field];
+}
+
+// The toggle bits (DTOG, STAT) flip where a 1 is written and the CTR bits
+// clear where a 0 is written, so every write names exactly what it changes
+void set_tx_stat(uint8_t num, uint16_t stat) {
+    const uint16_t v = static_cast<uint16_t>((epr(num) & USB_EPTX_DTOGMASK) ^ stat);
+    epr(num) = v | USB_EP_CTR_RX | USB_EP_CTR_TX;
+}
+
+void set_rx_stat(uint8_t num, uint16_t stat) {
+    const uint16_t v = static_cast<uint16_t>((epr(num) & USB_EPRX_DTOGMASK) ^ stat);
+    epr(num) = v | USB_EP_CTR_RX | USB_EP_CTR_TX;
+}
+
+void toggle(uint8_t num, uint16_t bit) {
+    epr(num) = static_cast<uint16_t>((epr(num) & USB_EPREG_MASK) | USB_EP_CTR_RX | USB_EP_CTR_TX | bit);
+}
+
+void clear_toggle(uint8_t num, uint16_t bit) {
+    if (epr(num) & bit) {
+        toggle(num, bit);
+    }
+}
+
+void clear_ctr_rx(uint8_t num) {
+    epr(num) = static_cast<uint16_t>((epr(num) & USB_EPREG_MASK & ~USB_EP_CTR_RX) | USB_EP_CTR_TX);
+}
+
+void clear_ctr_tx(uint8_t num) {
+    epr(num) = static_cast<uint16_t>((epr(num) & USB_EPREG_MASK & ~USB_EP_CTR_TX) | USB_EP_CTR_RX);
+}
+
+// Every packet is copied through these, up to 19 times a frame in each
+// direction; they make no calls, so they run from SRAM2
+RAMFUNC void pma_write(uint16_t offset, const uint8_t* data, uint16_t len) {
+    volatile uint16_t* word = pma(offset);
+    for (uint16_t i = 0; i < len; i += 2) {
+        const uint16_t hi = (i + 1U < len) ? data[i + 1] : 0U;
+        *word++ = static_cast<uint16_t>(data[i] | (hi << 8));
+    }
+}
+
+RAMFUNC void pma_read(uint16_t offset, uint8_t* data, uint16_t len) {
+    volatile const uint16_t* word = pma(offset);
+    for (uint16_t i = 0; i < len; i += 2) {
+        const uint16_t v = *word++;
+        data[i] = static_cast<uint8_t>(v);
+        if (i + 1U < len) {
+            data[i + 1] = static_cast<uint8_t>(v >> 8);
+        }
+    }
+}
+
+// COUNT_RX: buffer size as 2-byte blocks up to 62, else 32-byte blocks
+uint16_t rx_size_field(uint16_t size) {
+    if (size > 62U) {
+        return static_cast<uint16_t>(USB_COUNT0_RX_BLSIZE | (((size / 32U) - 1U) << 10));
+    }
+    return static_cast<uint16_t>((size / 2U) << 10);
+}
+
+// =============================================================================
+// Endpoint state
+// =============================================================================
+
+// A double-buffered endpoint owns both halves of its EPnR and descriptor:
+// buffer 0 is the TX slot, buffer 1 the RX slot, and the hardware uses
+// buffer DTOG while the software side is marked by the opposite
+// direction's DTOG bit (SW_BUF)
+struct InEndpoint {
+    bool open;
+    bool dbl;
+    uint16_t mps;
+    uint16_t buf[2];
+    const uint8_t* data;
+    uint16_t left;
+    bool active;
+    bool first;         // The first packet is still to load (may be zero-length)
+    uint8_t sw_buf;     // Next buffer to fill
+    uint8_t queued;     // Buffers loaded and not yet sent
+};
+
+struct OutEndpoint {
+    bool open;
+    bool dbl;
+    uint16_t mps;
+    uint16_t buf[2];
+    uint8_t* dest;
+    uint16_t dest_len;
+    bool armed;
+    bool pending;       // A received packet waits in packet memory
+    uint8_t next;       // Buffer the next packet arrives in
+};
+
+usb_device_t device;
+InEndpoint in_eps[NUM_ENDPOINTS];
+OutEndpoint out_eps[NUM_ENDPOINTS];
+uint16_t pma_next;
+uint32_t bus_resets;
+
+uint16_t pma_alloc(uint16_t size) {
+    size = static_cast<uint16_t>((size + 1U) & ~1U);
+    if (pma_next + size > PMA_SIZE) {
+        return 0;
+    }
+    const uint16_t offset = pma_next;
+    pma_next = static_cast<uint16_t>(pma_next + size);
+    return offset;
+}
+
+// Keep buffers across a repeated SET_CONFIGURATION; a reset frees them all
+void ensure_buffers(uint16_t* buf, uint16_t mps, bool dbl, bool reopen) {
+    if (!reopen) {
+        buf[0] = pma_alloc(mps);
+        buf[1] = dbl ? pma_alloc(mps) : 0;
+    } else if (dbl && buf[1] == 0) {
+        buf[1] = pma_alloc(mps);
+    }
+}
+
+// =============================================================================
+// IN transfers
+// =============================================================================
+
+void load_packet(uint8_t num, InEndpoint& e, uint8_t slot) {
+    const uint16_t n = (e.left < e.mps) ? e.left : e.mps;
+    pma_write(e.buf[slot], e.data, n);
+    btable(num, slot ? COUNT_RX : COUNT_TX) = n;
+    e.data += n;
+    e.left = static_cast<uint16_t>(e.left - n);
+    e.first = false;
+}
+
+// Double-buffered: fill free buffers and hand each over by flipping SW_BUF
+void fill(uint8_t num, InEndpoint& e) {
+    while (e.active && e.queued < 2U && (e.left > 0U || e.first)) {
+        load_packet(num, e, e.sw_buf);
+        toggle(num, USB_EP_DTOG_RX);
+        e.sw_buf ^= 1U;
+        e.queued++;
+    }
+}
+
+void on_ctr_tx(uint8_t num) {
+    InEndpoint& e = in_eps[num];
+    clear_ctr_tx(num);
+
+    if (!e.dbl) {
+        if (!e.active) {
+            return;
+        }
+        if (e.left > 0U) {
+            load_packet(num, e, 0);
+            set_tx_stat(num, USB_EP_TX_VALID);
+            return;
+        }
+        e.active = false;
+        usb_device_on_in(&device, static_cast<uint8_t>(num | USB_EP_IN));
+        return;
+    }
+
+    // CTR may stand for both buffers: whatever the hardware has not sent
+    // lies between its DTOG_TX and SW_BUF
+    const uint8_t dtog = (epr(num) & USB_EP_DTOG_TX) ? 1U : 0U;
+    e.queued = (dtog != e.sw_buf) ? 1U : 0U;
+    fill(num, e);
+
+    // The data is in packet memory: release the caller's buffer now so the
+    // next transfer can queue behind the last packet instead of after it
+    if (e.active && e.left == 0U && !e.first) {
+        e.active = false;
+        usb_device_on_in(&device, static_cast<uint8_t>(num | USB_EP_IN));
+    }
+}
+
+// =============================================================================
+// OUT transfers
+// =============================================================================
+
+void deliver(uint8_t num, OutEndpoint& e) {
+    const uint16_t count = static_cast<uint16_t>(btable(num, e.next ? COUNT_RX : COUNT_TX) & 0x3FFU);
+    const uint16_t slot = e.buf[e.next];
+
+    // Give the other buffer back first so the next packet can arrive
+    // while this one is copied
+    e.pending = false;
+    e.armed = false;
+    e.next ^= 1U;
+    toggle(num, USB_EP_DTOG_TX);
+
+    pma_read(slot, e.dest, (count < e.dest_len) ? count : e.dest_len);
+    usb_device_on_out(&device, num, count);
+}
+
+void on_ctr_rx(uint8_t num) {
+    OutEndpoint& e = out_eps[num];
+
+    if (num == 0U && (epr(0) & USB_EP_SETUP)) {
+        uint8_t packet[8];
+        pma_read(e.buf[0], packet, sizeof(packet));
+        clear_ctr_rx(0);
+        usb_device_on_setup(&device, packet);
+        return;
+    }
+
+    clear_ctr_rx(num);
+    if (e.dbl) {
+        // Held in packet memory, NAKing, until the class arms a buffer
+        e.pending = true;
+        if (e.armed) {
+            deliver(num, e);
+        }
+        return;
+    }
+
+    const uint16_t count = static_cast<uint16_t>(btable(num, COUNT_RX) & 0x3FFU);
+    if (!e.armed) {
+        return;
+    }
+    e.armed = false;
+    pma_read(e.buf[0], e.dest, (count < e.dest_len) ? count : e.dest_len);
+    usb_device_on_out(&device, num, count);
+}
+
+// =============================================================================
+// Controller operations
+// =============================================================================
+
+void dcd_set_address(void* hw, uint8_t address) {
+    (void)hw;
+    USB->DADDR = static_cast<uint16_t>(USB_DADDR_EF | address);
+}
+
+void dcd_ep_open(void* hw, uint8_t ep, uint8_t type, uint16_t max_packet, bool double_buffered) {
+    (void)hw;
+    const uint8_t num = ep & 0x0FU;
+    if (num >= NUM_ENDPOINTS) {
+        return;
+    }
+
+    static const uint16_t types[] = {USB_EP_CONTROL, USB_EP_ISOCHRONOUS, USB_EP_BULK, USB_EP_INTERRUPT};
+    const uint16_t kind = double_buffered ? USB_EP_KIND : 0U;
+    epr(num) = static_cast<uint16_t>((epr(num) & (USB_EPREG_MASK & ~(USB_EP_T_FIELD | USB_EP_KIND | USB_EPADDR_FIELD))) |
+                                     types[type & 3U] | kind | num | USB_EP_CTR_RX | USB_EP_CTR_TX);
+
+    if (ep & USB_EP_IN) {
+        InEndpoint& e = in_eps[num];
+        ensure_buffers(e.buf, max_packet, double_buffered, e.open);
+        e.open = true;
+        e.dbl = double_buffered;
+        e.mps = max_packet;
+        e.active = false;
+        e.sw_buf = 0;
+        e.queued = 0;
+        btable(num, ADDR_TX) = e.buf[0];
+        btable(num, COUNT_TX) = 0;
+        clear_toggle(num, USB_EP_DTOG_TX);
+        if (double_buffered) {
+            btable(num, ADDR_RX) = e.buf[1];
+            btable(num, COUNT_RX) = 0;
+            clear_toggle(num, USB_EP_DTOG_RX);
+            set_rx_stat(num, USB_EP_RX_DIS);
+            set_tx_stat(num, USB_EP_TX_VALID);    // Paced by SW_BUF from here on
+        } else {
+            set_tx_stat(num, USB_EP_TX_NAK);
+        }
+    } else {
+        OutEndpoint& e = out_eps[num];
+        ensure_buffers(e.buf, max_packet, double_buffered, e.open);
+        e.open = true;
+        e.dbl = double_buffered;
+        e.mps = max_packet;
+        e.armed = false;
+        e.pending = false;
+        e.next = 0;
+        btable(num, ADDR_RX) = e.buf[double_buffered ? 1 : 0];
+        btable(num, COUNT_RX) = rx_size_field(max_packet);
+        clear_toggle(num, USB_EP_DTOG_RX);
+        if (double_buffered) {
+            // SW_BUF = 1: the hardware may fill buffer 0, then waits for it
+            btable(num, ADDR_TX) = e.buf[0];
+            btable(num, COUNT_TX) = rx_size_field(max_packet);
+            clear_toggle(num, USB_EP_DTOG_TX);
+            toggle(num, USB_EP_DTOG_TX);
+            set_tx_stat(num, USB_EP_TX_DIS);
+            set_rx_stat(num, USB_EP_RX_VALID);
+        } else {
+            set_rx_stat(num, USB_EP_RX_NAK);
+        }
+    }
+}
+
+void dcd_ep_transmit(void* hw, uint8_t ep, const uint8_t* data, uint16_t len) {
+    (void)hw;
+    const uint8_t num = ep & 0x0FU;
+    InEndpoint& e = in_eps[num];
+    e.data = data;
+    e.left = len;
+    e.first = true;
+    e.active = true;
+
+    if (e.dbl) {
+        fill(num, e);
+    } else {
+        load_packet(num, e, 0);
+        set_tx_stat(num, USB_EP_TX_VALID);
+    }
+}
+
+void dcd_ep_receive(void* hw, uint8_t ep, uint8_t* buf, uint16_t len) {
+    (void)hw;
+    const uint8_t num = ep & 0x0FU;
+    OutEndpoint& e = out_eps[num];
+    e.dest = buf;
+    e.dest_len = len;
+    e.armed = true;
+
+    if (!e.dbl) {
+        set_rx_stat(num, USB_EP_RX_VALID);
+    } else if (e.pending) {
+        // Called from a task: let the interrupt hand over the held packet
+        NVIC_SetPendingIRQ(USB_IRQn);
+    }
+}
+
+void dcd_ep_stall(void* hw, uint8_t ep, bool stall) {
+    (void)hw;
+    const uint8_t num = ep & 0x0FU;
+
+    if (ep & USB_EP_IN) {
+        InEndpoint& e = in_eps[num];
+        if (stall) {
+            set_tx_stat(num, USB_EP_TX_STALL);
+            return;
+        }
+        // Clearing a halt restarts the data toggle and drops queued packets
+        clear_toggle(num, USB_EP_DTOG_TX);
+        e.active = false;
+        e.queued = 0;
+        if (e.dbl) {
+            clear_toggle(num, USB_EP_DTOG_RX);
+            e.sw_buf = 0;
+            set_tx_stat(num, USB_EP_TX_VALID);
+        } else {
+            set_tx_stat(num, USB_EP_TX_NAK);
+        }
+    } else {
+        OutEndpoint& e = out_eps[num];
+        if (stall) {
+            set_rx_stat(num, USB_EP_RX_STALL);
+            return;
+        }
+        clear_toggle(num, USB_EP_DTOG_RX);
+        if (e.dbl) {
+            clear_toggle(num, USB_EP_DTOG_TX);
+            toggle(num, USB_EP_DTOG_TX);
+            e.next = 0;
+            e.pending = false;
+            set_rx_stat(num, USB_EP_RX_VALID);
+        } else {
+            set_rx_stat(num, e.armed ? USB_EP_RX_VALID : USB_EP_RX_NAK);
+        }
+    }
+}
+
+const usb_dcd_ops_t dcd_ops = {
+    dcd_set_address,
+    dcd_ep_open,
+    dcd_ep_transmit,
+    dcd_ep_receive,
+    dcd_ep_stall
+};
+
+// =============================================================================
+// CDC class and RTOS glue
+// =============================================================================
+
+SemaphoreHandle_t write_mutex;
+SemaphoreHandle_t space_sem;
+SemaphoreHandle_t data_sem;
+StaticSemaphore_t write_mutex_storage;
+StaticSemaphore_t space_sem_storage;
+StaticSemaphore_t data_sem_storage;
+UBaseType_t critical_mask;
+BaseType_t isr_woken;
+
+struct UsbSerialPort {
+    static void enter_critical() {
+        critical_mask = taskENTER_CRITICAL_FROM_ISR();
+    }
+
+    static void exit_critical() {
+        taskEXIT_CRITICAL_FROM_ISR(critical_mask);
+    }
+
+    static void signal_space() {
+        xSemaphoreGiveFromISR(space_sem, &isr_woken);
+    }
+
+    static void signal_data() {
+        xSemaphoreGiveFromISR(data_sem, &isr_woken);
+    }
+};
+
+UsbCdc<USB_SERIAL_TX_BUFFER, USB_SERIAL_RX_BUFFER, UsbSerialPort> cdc;
+bool initialized = false;
+
+// Serial number: the 96-bit device unique ID in hex
+char serial_number[25];
+const char* const strings[] = {"STMicroelectronics", "STM32L4 Serial Port", serial_number};
+const usb_descriptors_t descriptors = {
+    usb_cdc_device_descriptor, usb_cdc_config_descriptor, strings, 3
+};
+
+void make_serial_number() {
+    static const char hex[] = "0123456789ABCDEF";
+    const uint32_t uid[3] = {HAL_GetUIDw0(), HAL_GetUIDw1(), HAL_GetUIDw2()};
+    for (int i = 0; i < 24; i++) {
+        serial_number[i] = hex[(uid[i / 8] >> (28 - 4 * (i % 8))) & 0xFU];
+    }
+    serial_number[24] = '\0';
+}
+
+void bus_reset() {
+    for (uint8_t n = 0; n < NUM_ENDPOINTS; n++) {
+        epr(n) = 0;
+        in_eps[n] = InEndpoint{};
+        out_eps[n] = OutEndpoint{};
+    }
+    USB->BTABLE = 0;
+    pma_next = PMA_FIRST_BUFFER;
+    bus_resets++;
+    usb_device_on_reset(&device);   // Opens endpoint 0
+    USB->DADDR = USB_DADDR_EF;
+}
+
+void usb_irq() {
+    isr_woken = pdFALSE;
+
+    uint16_t istr;
+    while ((istr = USB->ISTR) & USB_ISTR_CTR) {
+        const uint8_t num = static_cast<uint8_t>(istr & USB_ISTR_EP_ID);
+        const uint16_t reg = epr(num);
+        if (reg & USB_EP_CTR_RX) {
+            on_ctr_rx(num);
+        }
+        if (reg & USB_EP_CTR_TX) {
+            on_ctr_tx(num);
+        }
+    }
+
+    if (istr & USB_ISTR_RESET) {
+        USB->ISTR = static_cast<uint16_t>(~USB_ISTR_RESET);
+        bus_reset();
+    }
+    if (istr & USB_ISTR_SUSP) {
+        USB->ISTR = static_cast<uint16_t>(~USB_ISTR_SUSP);
+        USB->CNTR |= USB_CNTR_FSUSP;
+    }
+    if (istr & USB_ISTR_WKUP) {
+        USB->ISTR = static_cast<uint16_t>(~USB_ISTR_WKUP);
+        USB->CNTR &= static_cast<uint16_t>(~USB_CNTR_FSUSP);
+    }
+
+    // Packets held while the class had no room, now that it has
+    for (uint8_t n = 1; n < NUM_ENDPOINTS; n++) {
+        OutEndpoint& e = out_eps[n];
+        if (e.dbl && e.pending && e.armed) {
+            deliver(n, e);
+        }
+    }
+
+    portYIELD_FROM_ISR(isr_woken);
+}
+
+void configure_clock() {
+    // HSI48 as the 48 MHz clock, trimmed by CRS against the host's 1 ms SOF
+    RCC->CRRCR |= RCC_CRRCR_HSI48ON;
+    while ((RCC->CRRCR & RCC_CRRCR_HSI48RDY) == 0) {
+    }
+    RCC->CCIPR &= ~RCC_CCIPR_CLK48SEL;
+
+    __HAL_RCC_CRS_CLK_ENABLE();
+    CRS->CFGR = (CRS->CFGR & ~CRS_CFGR_SYNCSRC) | CRS_CFGR_SYNCSRC_1;
+    CRS->CR |= CRS_CR_AUTOTRIMEN | CRS_CR_CEN;
+
+    // USB supply valid: VDDUSB is tied to VDD on the board
+    __HAL_RCC_PWR_CLK_ENABLE();
+    PWR->CR2 |= PWR_CR2_USV;
+
+    __HAL_RCC_USB_CLK_ENABLE();
+}
+
+void configure_pins() {
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+
+    GPIO_InitTypeDef gpio = {};
+    gpio.Pin = GPIO_PIN_11 | GPIO_PIN_12;   // PA11: USB_DM, PA12: USB_DP
+    gpio.Mode = GPIO_MODE_AF_PP;
+    gpio.Pull = GPIO_NOPULL;
+    gpio.Speed = GPIO_SPEED_FREQ_VERY_HIGH;
+    gpio.Alternate = GPIO_AF10_USB_FS;
+    HAL_GPIO_Init(GPIOA, &gpio);
+}
+
+bool lock(TickType_t timeout) {
+    return !xPortIsInsideInterrupt() && xSemaphoreTake(write_mutex, timeout) == pdTRUE;
+}
+
+}  // namespace
+
+static_assert((USB_SERIAL_TX_BUFFER & (USB_SERIAL_TX_BUFFER - 1)) == 0,
+              "USB_SERIAL_TX_BUFFER must be a power of two");
+static_assert((USB_SERIAL_RX_BUFFER & (USB_SERIAL_RX_BUFFER - 1)) == 0,
+              "USB_SERIAL_RX_BUFFER must be a power of two");
+
+// Public API implementations
+
+extern "C" int usb_serial_init(void) {
+    if (initialized) {
+        return 0;
+    }
+
+    write_mutex = xSemaphoreCreateMutexStatic(&write_mutex_storage);
+    space_sem = xSemaphoreCreateBinaryStatic(&space_sem_storage);
+    data_sem = xSemaphoreCreateBinaryStatic(&data_sem_storage);
+    make_serial_number();
+
+    if (cdc.init(&device, &dcd_ops, nullptr, &descriptors) != 0) {
+        return -1;
+    }
+
+    configure_clock();
+    configure_pins();
+
+    // Power up the transceiver, hold the controller in reset for tSTARTUP
+    USB->CNTR = USB_CNTR_FRES;
+    for (volatile uint32_t i = SystemCoreClock / 1000000U; i > 0; i--) {
+    }
+    USB->CNTR = 0;
+    USB->ISTR = 0;
+    USB->BTABLE = 0;
+
+    if (hal_irq_bind(USB_IRQn, usb_irq) != 0) {
+        return -2;
+    }
+    HAL_NVIC_SetPriority(USB_IRQn, USB_SERIAL_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(USB_IRQn);
+
+    // Enumeration starts with the host's bus reset once DP is pulled up
+    USB->CNTR = USB_CNTR_CTRM | USB_CNTR_RESETM | USB_CNTR_SUSPM | USB_CNTR_WKUPM;
+    USB->BCDR |= USB_BCDR_DPPU;
+
+    initialized = true;
+    return 0;
+}
+
+extern "C" int usb_serial_write(const void* data, size_t len, uint32_t timeout_ms) {
+    if (!initialized) {
+        return -1;
+    }
+    if (!lock(pdMS_TO_TICKS(timeout_ms))) {
+        return 0;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    size_t done = 0;
+    while (true) {
+        done += cdc.write(bytes + done, len - done);
+        if (done == len || xSemaphoreTake(space_sem, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+            break;
+        }
+    }
+
+    xSemaphoreGive(write_mutex);
+    return static_cast<int>(done);
+}
+
+extern "C" uint8_t* usb_serial_reserve(size_t* len, uint32_t timeout_ms) {
+    if (!initialized || !len || !lock(pdMS_TO_TICKS(timeout_ms))) {
+        return nullptr;
+    }
+
+    while (true) {
+        const auto span = cdc.write_span();
+        if (!span.empty()) {
+            *len = span.size();
+            return span.data();
+        }
+        if (xSemaphoreTake(space_sem, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+            xSemaphoreGive(write_mutex);
+            return nullptr;
+        }
+    }
+}
+
+extern "C" void usb_serial_commit(size_t len) {
+    if (len != 0) {
+        cdc.commit(len);
+    }
+    xSemaphoreGive(write_mutex);
+}
+
+extern "C" int usb_serial_read(void* buf, size_t len, uint32_t timeout_ms) {
+    if (!initialized) {
+        return -1;
+    }
+
+    uint8_t* bytes = static_cast<uint8_t*>(buf);
+    while (true) {
+        const size_t n = cdc.read(bytes, len);
+        if (n != 0 || len == 0) {
+            return static_cast<int>(n);
+        }
+        if (xSemaphoreTake(data_sem, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+            return 0;
+        }
+    }
+}
+
+extern "C" bool usb_serial_connected(void) {
+    return initialized && cdc.configured() && cdc.dtr();
+}
+
+extern "C" void usb_serial_get_stats(usb_serial_stats_t* out) {
+    if (out) {
+        const UsbCdcStats& stats = cdc.stats();
+        out->bytes_sent = stats.bytes_sent;
+        out->bytes_received = stats.bytes_received;
+        out->transfers = stats.transfers;
+        out->zlps = stats.zlps;
+        out->tx_full = stats.tx_full;
+        out->rx_throttled = stats.rx_throttled;
+        out->bus_resets = bus_resets;
+    }
+}
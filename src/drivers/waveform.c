@@ -0,0 +1,137 @@
+/**
+ * @file waveform.c
+ * @brief Fixed-point waveform synthesis for DAC sample buffers
+ */
+
+#include "waveform.h"
+
+// sin(i * pi / 128) in Q15 for i = 0..64: one quarter cycle, mirrored for the rest
+static const int16_t quarter_sine[65] = {
+    0, 804, 1608, 2410, 3212, 4011, 4808, 5602,
+    6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+    27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+    32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767,
+};
+
+static inline int16_t lerp(int16_t a, int16_t b, uint32_t frac16) {
+    return (int16_t)(a + (((int32_t)(b - a) * (int32_t)frac16) >> 16));
+}
+
+static int16_t sine(uint32_t phase) {
+    const uint32_t quarter = phase >> 30;
+    uint32_t pos = (phase >> 8) & 0x3FFFFFU;    // 22-bit position in the quarter
+    if (quarter & 1U) {
+        pos = 0x400000U - pos;
+    }
+
+    const uint32_t index = pos >> 16;
+    int16_t value = quarter_sine[index];
+    if (index < 64U) {
+        value = lerp(value, quarter_sine[index + 1U], pos & 0xFFFFU);
+    }
+    return (quarter & 2U) ? (int16_t)-value : value;
+}
+
+static int16_t triangle(uint32_t phase) {
+    // 17-bit position: up over the first quarter, down to the third, up again
+    const int32_t t = (int32_t)(phase >> 15);
+    int32_t value;
+    if (t < 32768) {
+        value = t;
+    } else if (t < 98304) {
+        value = 65536 - t;
+    } else {
+        value = t - 131072;
+    }
+    return (int16_t)(value > 32767 ? 32767 : (value < -32767 ? -32767 : value));
+}
+
+static int16_t table_lookup(const waveform_t* w, uint32_t phase) {
+    const uint32_t shift = 32U - w->table_log2;
+    const uint32_t mask = (1UL << w->table_log2) - 1U;
+    const uint32_t index = phase >> shift;
+    const uint32_t frac = (uint32_t)(((uint64_t)phase << w->table_log2) >> 16) & 0xFFFFU;
+    return lerp(w->table[index], w->table[(index + 1U) & mask], frac);
+}
+
+static uint16_t to_code(const waveform_t* w, int16_t value) {
+    const int32_t code = (int32_t)w->offset + (((int32_t)w->amplitude * value + (1 << 14)) >> 15);
+    if (code < 0) {
+        return 0;
+    }
+    return (uint16_t)(code > WAVEFORM_DAC_MAX ? WAVEFORM_DAC_MAX : code);
+}
+
+// Public API implementations
+
+int waveform_init(waveform_t* w, waveform_shape_t shape, uint16_t amplitude, uint16_t offset) {
+    if (!w || shape > WAVEFORM_TABLE || offset > WAVEFORM_DAC_MAX) {
+        return -1;
+    }
+
+    w->shape = shape;
+    w->phase = 0;
+    w->step = 0;
+    w->amplitude = amplitude;
+    w->offset = offset;
+    w->table = NULL;
+    w->table_log2 = 0;
+    return 0;
+}
+
+int waveform_set_table(waveform_t* w, const int16_t* table, uint8_t log2_len) {
+    if (!w || !table || log2_len == 0 || log2_len > WAVEFORM_TABLE_MAX_LOG2) {
+        return -1;
+    }
+
+    w->table = table;
+    w->table_log2 = log2_len;
+    return 0;
+}
+
+int waveform_set_frequency(waveform_t* w, uint32_t freq_hz, uint32_t sample_rate_hz) {
+    if (!w || sample_rate_hz == 0 || freq_hz >= sample_rate_hz / 2U) {
+        return -1;
+    }
+
+    w->step = (uint32_t)(((uint64_t)freq_hz << 32) / sample_rate_hz);
+    return 0;
+}
+
+int16_t waveform_sample(const waveform_t* w, uint32_t phase) {
+    switch (w->shape) {
+    case WAVEFORM_SINE:
+        return sine(phase);
+    case WAVEFORM_TRIANGLE:
+        return triangle(phase);
+    case WAVEFORM_TABLE:
+        return w->table ? table_lookup(w, phase) : 0;
+    }
+    return 0;
+}
+
+void waveform_fill(waveform_t* w, uint16_t* out, size_t n) {
+    uint32_t phase = w->phase;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = to_code(w, waveform_sample(w, phase));
+        phase += w->step;
+    }
+    w->phase = phase;
+}
+
+void waveform_render_period(const waveform_t* w, uint16_t* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        // Exact i / n of a cycle, so the last sample leads back into the first
+        const uint32_t phase = (uint32_t)(((uint64_t)i << 32) / n);
+        out[i] = to_code(w, waveform_sample(w, phase));
+    }
+}
+
+void waveform_refill(void* w, uint16_t* out, uint16_t n) {
+    waveform_fill((waveform_t*)w, out, n);
+}
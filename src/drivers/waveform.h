@@ -0,0 +1,97 @@
+#pragma once
+
+/**
+ * @file waveform.h
+ * @brief Fixed-point waveform synthesis for DAC sample buffers
+ *
+ * A waveform is a shape (sine, triangle or an arbitrary one-cycle table)
+ * read through a 32-bit phase accumulator: each sample adds `step` to the
+ * phase, and the phase wraps once per cycle, so the frequency resolution is
+ * sample_rate / 2^32 and no rounding error builds up over time. Shapes are
+ * evaluated in Q15 with linear interpolation between table entries, then
+ * scaled to 12-bit DAC codes around an offset.
+ *
+ * Two ways to feed a DAC:
+ * - waveform_render_period() writes exactly one cycle into a buffer that a
+ *   circular DMA then replays forever: the output is cycle-exact at
+ *   sample_rate / n and costs no CPU at all once started.
+ * - waveform_fill() continues from the current phase, for streams whose
+ *   period does not fit a buffer (or any non-integer number of samples per
+ *   cycle): the DMA plays one half of a double buffer while the other half
+ *   is refilled (waveform_refill() matches dac1_refill_t).
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define WAVEFORM_DAC_MAX        4095    // 12-bit, right aligned
+#define WAVEFORM_TABLE_MAX_LOG2 16
+
+/**
+ * @brief Waveform Shapes
+ */
+typedef enum {
+    WAVEFORM_SINE,
+    WAVEFORM_TRIANGLE,      // Starts at zero rising, like the sine
+    WAVEFORM_TABLE          // One cycle of 2^n Q15 entries
+} waveform_shape_t;
+
+/**
+ * @brief Waveform State
+ */
+typedef struct {
+    waveform_shape_t shape;
+    uint32_t phase;         // Fraction of a cycle, 2^32 per cycle
+    uint32_t step;          // Phase increment per sample
+    uint16_t amplitude;     // Peak deviation from offset, DAC codes
+    uint16_t offset;        // Code for zero, DAC codes
+    const int16_t* table;   // WAVEFORM_TABLE only
+    uint8_t table_log2;
+} waveform_t;
+
+/**
+ * @brief Initialize a waveform at phase 0 and zero frequency
+ * @return 0 on success, -1 on invalid arguments
+ */
+int waveform_init(waveform_t* w, waveform_shape_t shape, uint16_t amplitude, uint16_t offset);
+
+/**
+ * @brief Set the cycle table of a WAVEFORM_TABLE waveform
+ * @param table 2^log2_len Q15 entries (kept by reference)
+ * @return 0 on success, -1 on invalid arguments
+ */
+int waveform_set_table(waveform_t* w, const int16_t* table, uint8_t log2_len);
+
+/**
+ * @brief Set the phase increment for a frequency at a sample rate
+ * @return 0 on success, -1 if the frequency is not below half the sample rate
+ */
+int waveform_set_frequency(waveform_t* w, uint32_t freq_hz, uint32_t sample_rate_hz);
+
+/**
+ * @brief Shape value at a phase, Q15
+ */
+int16_t waveform_sample(const waveform_t* w, uint32_t phase);
+
+/**
+ * @brief Write the next n samples as DAC codes, advancing the phase
+ */
+void waveform_fill(waveform_t* w, uint16_t* out, size_t n);
+
+/**
+ * @brief Write exactly one cycle in n samples (the phase is not used)
+ */
+void waveform_render_period(const waveform_t* w, uint16_t* out, size_t n);
+
+/**
+ * @brief waveform_fill() with the waveform passed as a context pointer
+ */
+void waveform_refill(void* w, uint16_t* out, uint16_t n);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file hal_irq_table.c
+ * @brief Vector table bookkeeping behind hal_irq.h
+ */
+
+#include "hal_irq_table.h"
+
+#include <stddef.h>
+
+// Public API implementations
+
+int hal_irq_table_index(const hal_irq_table_t* table, int irqn) {
+    if (irqn < -(int)HAL_IRQ_CORE_VECTORS + 2 || irqn >= (int)table->count - (int)HAL_IRQ_CORE_VECTORS) {
+        return -1;  // Initial SP and Reset are never rebound
+    }
+    if (irqn == HAL_IRQ_SVCALL || irqn == HAL_IRQ_PENDSV) {
+        return -1;
+    }
+    return irqn + (int)HAL_IRQ_CORE_VECTORS;
+}
+
+void hal_irq_table_copy(hal_irq_table_t* table) {
+    // Entry 0 (initial MSP) is copied too: the FreeRTOS port reloads it
+    // through VTOR when the scheduler starts
+    for (uint32_t i = 0; i < table->count; i++) {
+        table->ram[i] = table->flash[i];
+    }
+}
+
+int hal_irq_table_bind(hal_irq_table_t* table, int irqn, hal_irq_handler_t handler) {
+    if (!table->relocated) {
+        return -1;
+    }
+    const int index = hal_irq_table_index(table, irqn);
+    if (index < 0) {
+        return -2;
+    }
+    if (!handler) {
+        return -3;
+    }
+
+    table->ram[index] = handler;
+    return 0;
+}
+
+int hal_irq_table_unbind(hal_irq_table_t* table, int irqn) {
+    if (!table->relocated) {
+        return -1;
+    }
+    const int index = hal_irq_table_index(table, irqn);
+    if (index < 0) {
+        return -2;
+    }
+
+    table->ram[index] = table->flash[index];
+    return 0;
+}
+
+hal_irq_handler_t hal_irq_table_get(const hal_irq_table_t* table, int irqn) {
+    if (irqn < -(int)HAL_IRQ_CORE_VECTORS + 1 || irqn >= (int)table->count - (int)HAL_IRQ_CORE_VECTORS) {
+        return NULL;
+    }
+    const hal_irq_handler_t* vectors = table->relocated ? table->ram : table->flash;
+    return vectors[irqn + (int)HAL_IRQ_CORE_VECTORS];
+}
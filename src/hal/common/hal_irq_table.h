@@ -0,0 +1,55 @@
+#pragma once
+
+/**
+ * @file hal_irq_table.h
+ * @brief Vector table bookkeeping behind hal_irq.h
+ *
+ * Holds the RAM copy, the linked flash table it was copied from and
+ * whether VTOR points at the copy, and maps CMSIS IRQ numbers to vector
+ * indices. The family port only adds the VTOR write, so this part builds
+ * and is tested on the host.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal_irq.h"
+
+// Cortex-M exceptions owned by the FreeRTOS port
+#define HAL_IRQ_SVCALL          (-5)
+#define HAL_IRQ_PENDSV          (-2)
+
+/**
+ * @brief Vector Table State
+ */
+typedef struct {
+    hal_irq_handler_t* ram;             // Copy VTOR is pointed at
+    const hal_irq_handler_t* flash;     // Linked table (also the source of the copy)
+    uint32_t count;                     // Vectors, core exceptions included
+    bool relocated;
+} hal_irq_table_t;
+
+/**
+ * @brief Vector index for an IRQ that may be rebound
+ * @return Index into the table, or -1 if out of range or reserved
+ */
+int hal_irq_table_index(const hal_irq_table_t* table, int irqn);
+
+/**
+ * @brief Copy the flash table into the RAM table
+ */
+void hal_irq_table_copy(hal_irq_table_t* table);
+
+/**
+ * @brief Bind, unbind and read as described in hal_irq.h
+ */
+int hal_irq_table_bind(hal_irq_table_t* table, int irqn, hal_irq_handler_t handler);
+int hal_irq_table_unbind(hal_irq_table_t* table, int irqn);
+hal_irq_handler_t hal_irq_table_get(const hal_irq_table_t* table, int irqn);
+
+#ifdef __cplusplus
+}
+#endif
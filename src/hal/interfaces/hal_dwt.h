@@ -0,0 +1,56 @@
+#pragma once
+
+/**
+ * @file hal_dwt.h
+ * @brief Portable Cycle Counter Interface (DWT CYCCNT)
+ *
+ * The Data Watchpoint and Trace unit is architectural on Cortex-M3/M4/M7,
+ * so the cycle counter lives at the same address on every supported STM32
+ * family. Reading it is a single load, which makes it suitable for
+ * instrumentation in ISRs and kernel hooks.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Enable the DWT cycle counter and reset it to zero
+ * @return 0 on success, negative error code on failure
+ */
+int hal_dwt_init(void);
+
+/**
+ * @brief Check whether the cycle counter is running
+ * @return true if CYCCNT is enabled
+ */
+bool hal_dwt_is_enabled(void);
+
+#if defined(UNIT_TESTING)
+
+/**
+ * @brief Read the cycle counter (provided by the host test fixtures)
+ * @return Current cycle count
+ */
+uint32_t hal_dwt_get_cycles(void);
+
+#else
+
+#define HAL_DWT_CYCCNT  (*(volatile uint32_t*)0xE0001004UL)
+
+/**
+ * @brief Read the cycle counter
+ * @return Current cycle count (wraps every 2^32 core clock cycles)
+ */
+static inline uint32_t hal_dwt_get_cycles(void) {
+    return HAL_DWT_CYCCNT;
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
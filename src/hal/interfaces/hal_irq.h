@@ -0,0 +1,79 @@
+#pragma once
+
+/**
+ * @file hal_irq.h
+ * @brief Portable RAM Vector Table Interface
+ *
+ * hal_irq_vectors_init() copies the flash vector table into RAM and points
+ * VTOR at the copy. After that a handler can be bound directly to an
+ * interrupt at runtime, so a hot ISR is entered straight from the vector
+ * instead of through a weak xxx_IRQHandler, HAL_xxx_IRQHandler() and a
+ * callback lookup.
+ *
+ * IRQ numbers follow CMSIS: peripheral interrupts are >= 0 and core
+ * exceptions are negative (-14 NMI .. -1 SysTick). SVCall and PendSV
+ * belong to the kernel and cannot be rebound.
+ *
+ * Binding is a single aligned word store, so it may race with the IRQ
+ * firing: the old or the new handler runs, never a torn pointer. Enable
+ * the IRQ in the NVIC only after binding it.
+ *
+ * See hal_irq.hpp for binding C++ member functions.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HAL_IRQ_CORE_VECTORS    16      // Initial SP, Reset and 14 exceptions
+
+/**
+ * @brief Interrupt handler as stored in the vector table
+ */
+typedef void (*hal_irq_handler_t)(void);
+
+/**
+ * @brief Copy the vector table to RAM and relocate VTOR to it
+ *
+ * Call once from main() before the scheduler starts. Repeated calls have
+ * no effect.
+ *
+ * @return 0 on success, negative error code on failure
+ */
+int hal_irq_vectors_init(void);
+
+/**
+ * @brief Check whether the RAM vector table is active
+ * @return true after a successful hal_irq_vectors_init()
+ */
+bool hal_irq_vectors_relocated(void);
+
+/**
+ * @brief Bind a handler to an interrupt
+ * @param irqn CMSIS IRQ number
+ * @param handler Function entered directly from the vector
+ * @return 0 on success, -1 if the table is not relocated, -2 if irqn is
+ *         out of range or reserved for the kernel, -3 if handler is NULL
+ */
+int hal_irq_bind(int irqn, hal_irq_handler_t handler);
+
+/**
+ * @brief Restore the handler linked into the flash vector table
+ * @param irqn CMSIS IRQ number
+ * @return 0 on success, negative error code as for hal_irq_bind()
+ */
+int hal_irq_unbind(int irqn);
+
+/**
+ * @brief Read the handler currently installed for an interrupt
+ * @param irqn CMSIS IRQ number
+ * @return Handler, or NULL if irqn is out of range
+ */
+hal_irq_handler_t hal_irq_get(int irqn);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,98 @@
+#pragma once
+
+/**
+ * @file hal_irq.hpp
+ * @brief Binding C++ member functions to interrupt vectors
+ *
+ * A vector holds a plain function pointer, so a member function needs a
+ * trampoline. IrqBinding generates one per (IRQ, member function) pair at
+ * compile time: the object pointer lives in a static slot owned by that
+ * pair and the member is called directly, so the generated handler is one
+ * load and one (usually inlined) call, with no lookup table or virtual
+ * dispatch.
+ *
+ * @code
+ * class UartRx {
+ * public:
+ *     void onIrq();
+ * };
+ *
+ * static UartRx rx;
+ * hal::IrqBinding<USART2_IRQn, &UartRx::onIrq>::bind(rx);
+ * @endcode
+ */
+
+extern "C" {
+#include "hal_irq.h"
+}
+
+namespace hal {
+
+namespace detail {
+
+template <typename M>
+struct MemberClass;
+
+template <typename C>
+struct MemberClass<void (C::*)()> {
+    using type = C;
+};
+
+template <typename C>
+struct MemberClass<void (C::*)() noexcept> {
+    using type = C;
+};
+
+}  // namespace detail
+
+/**
+ * @brief Trampoline from interrupt vector Irq to member function Method
+ * @tparam Irq CMSIS IRQ number
+ * @tparam Method Pointer to a `void()` member function
+ */
+template <int Irq, auto Method>
+class IrqBinding {
+public:
+    using Class = typename detail::MemberClass<decltype(Method)>::type;
+
+    /**
+     * @brief Install the trampoline for obj
+     * @return 0 on success, negative error code from hal_irq_bind()
+     */
+    static int bind(Class& obj) {
+        instance_ = &obj;
+        return hal_irq_bind(Irq, &handler);
+    }
+
+    /**
+     * @brief Restore the flash handler and forget the object
+     * @return 0 on success, negative error code from hal_irq_unbind()
+     */
+    static int unbind() {
+        const int rc = hal_irq_unbind(Irq);
+        if (rc == 0) {
+            instance_ = nullptr;
+        }
+        return rc;
+    }
+
+    /**
+     * @brief The function installed in the vector
+     */
+    static void handler() {
+        (instance_->*Method)();
+    }
+
+private:
+    static inline Class* instance_ = nullptr;
+};
+
+/**
+ * @brief Bind a free or static function (no trampoline needed)
+ */
+template <int Irq>
+inline int irq_bind(hal_irq_handler_t handler) {
+    return hal_irq_bind(Irq, handler);
+}
+
+}  // namespace hal
@@ -0,0 +1,44 @@
+#pragma once
+
+/**
+ * @file hal_watchdog.h
+ * @brief Portable Independent Watchdog Hardware Abstraction Layer Interface
+ *
+ * The independent watchdog runs from its own low-speed oscillator and
+ * cannot be stopped once started, so only initialization and refresh are
+ * exposed.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Start the independent watchdog
+ * @param timeout_ms Time without refresh after which the MCU is reset
+ * @return 0 on success, negative error code on failure
+ */
+int hal_watchdog_init(uint32_t timeout_ms);
+
+/**
+ * @brief Reload the watchdog counter
+ */
+void hal_watchdog_refresh(void);
+
+/**
+ * @brief Check whether the last reset was caused by the watchdog
+ * @return true if the independent watchdog reset the MCU
+ */
+bool hal_watchdog_caused_reset(void);
+
+/**
+ * @brief Clear the reset cause flags
+ */
+void hal_watchdog_clear_reset_flags(void);
+
+#ifdef __cplusplus
+}
+#endif
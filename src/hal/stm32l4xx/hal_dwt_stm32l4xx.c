@@ -0,0 +1,26 @@
+/**
+ * @file hal_dwt_stm32l4xx.c
+ * @brief DWT cycle counter implementation for STM32L4xx microcontrollers
+ */
+
+#include "hal_dwt.h"
+#include "stm32l4xx_hal.h"
+
+int hal_dwt_init(void) {
+    // Trace must be enabled in the debug block before DWT registers respond
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // Some parts implement DWT without a cycle counter
+    if ((DWT->CTRL & DWT_CTRL_NOCYCCNT_Msk) != 0) {
+        return -1;
+    }
+
+    return 0;  // Success
+}
+
+bool hal_dwt_is_enabled(void) {
+    return (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0;
+}
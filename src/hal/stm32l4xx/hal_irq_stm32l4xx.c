@@ -0,0 +1,64 @@
+/**
+ * @file hal_irq_stm32l4xx.c
+ * @brief RAM vector table (VTOR relocation) for STM32L4xx microcontrollers
+ */
+
+#include "hal_irq.h"
+#include "hal_irq_table.h"
+#include "stm32l4xx_hal.h"
+
+// Core exceptions plus every peripheral interrupt up to the last one (CRS)
+#define VECTOR_COUNT        (HAL_IRQ_CORE_VECTORS + (uint32_t)CRS_IRQn + 1U)
+
+// VTOR requires alignment to the table size rounded up to a power of two
+#define VECTOR_ALIGN        512U
+
+_Static_assert(VECTOR_COUNT * sizeof(hal_irq_handler_t) <= VECTOR_ALIGN,
+               "Vector table exceeds its alignment");
+
+// Linked table (startup_stm32l432kcux.s). SystemInit() leaves VTOR at its
+// reset value 0, where flash is aliased, so VTOR cannot name the source
+extern const hal_irq_handler_t g_pfnVectors[];
+
+static hal_irq_handler_t ram_vectors[VECTOR_COUNT] __attribute__((aligned(VECTOR_ALIGN)));
+static hal_irq_table_t table = {ram_vectors, g_pfnVectors, VECTOR_COUNT, false};
+
+// Public API implementations
+
+int hal_irq_vectors_init(void) {
+    if (table.relocated) {
+        return 0;
+    }
+
+    hal_irq_table_copy(&table);
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    SCB->VTOR = (uint32_t)ram_vectors;
+    __DSB();
+    __ISB();
+    table.relocated = true;
+    __set_PRIMASK(primask);
+
+    return 0;  // Success
+}
+
+bool hal_irq_vectors_relocated(void) {
+    return table.relocated;
+}
+
+int hal_irq_bind(int irqn, hal_irq_handler_t handler) {
+    const int rc = hal_irq_table_bind(&table, irqn, handler);
+    __DSB();
+    return rc;
+}
+
+int hal_irq_unbind(int irqn) {
+    const int rc = hal_irq_table_unbind(&table, irqn);
+    __DSB();
+    return rc;
+}
+
+hal_irq_handler_t hal_irq_get(int irqn) {
+    return hal_irq_table_get(&table, irqn);
+}
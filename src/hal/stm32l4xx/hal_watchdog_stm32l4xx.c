@@ -0,0 +1,45 @@
+/**
+ * @file hal_watchdog_stm32l4xx.c
+ * @brief Independent watchdog (IWDG) implementation for STM32L4xx microcontrollers
+ */
+
+#include "hal_watchdog.h"
+#include "stm32l4xx_hal.h"
+
+// LSI is ~32 kHz; with a /64 prescaler one reload count is 2 ms
+#define IWDG_LSI_HZ         32000U
+#define IWDG_PRESCALER_DIV  64U
+#define IWDG_MAX_RELOAD     0x0FFFU
+
+static IWDG_HandleTypeDef iwdg_handle;
+
+int hal_watchdog_init(uint32_t timeout_ms) {
+    uint32_t reload = (timeout_ms * (IWDG_LSI_HZ / 1000U)) / IWDG_PRESCALER_DIV;
+
+    if (reload == 0 || reload > IWDG_MAX_RELOAD) {
+        return -1;  // Error: timeout out of range (2 ms .. 8.19 s)
+    }
+
+    iwdg_handle.Instance = IWDG;
+    iwdg_handle.Init.Prescaler = IWDG_PRESCALER_64;
+    iwdg_handle.Init.Reload = reload;
+    iwdg_handle.Init.Window = IWDG_WINDOW_DISABLE;
+
+    if (HAL_IWDG_Init(&iwdg_handle) != HAL_OK) {
+        return -2;
+    }
+
+    return 0;  // Success
+}
+
+void hal_watchdog_refresh(void) {
+    HAL_IWDG_Refresh(&iwdg_handle);
+}
+
+bool hal_watchdog_caused_reset(void) {
+    return __HAL_RCC_GET_FLAG(RCC_FLAG_IWDGRST) != 0;
+}
+
+void hal_watchdog_clear_reset_flags(void) {
+    __HAL_RCC_CLEAR_RESET_FLAGS();
+}
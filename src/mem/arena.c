@@ -0,0 +1,83 @@
+/**
+ * @file arena.c
+ * @brief Bump arenas for per-frame scratch memory
+ */
+
+#include "arena.h"
+
+#if !defined(UNIT_TESTING)
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if configNUM_THREAD_LOCAL_STORAGE_POINTERS <= ARENA_TLS_INDEX
+#error arena.c needs configNUM_THREAD_LOCAL_STORAGE_POINTERS > ARENA_TLS_INDEX
+#endif
+#else
+// Host builds: one binding per thread stands in for the task's TLS slot
+static _Thread_local arena_t* bound_arena = NULL;
+#endif
+
+// Public API implementations
+
+int arena_init(arena_t* arena, void* storage, size_t size) {
+    if (!arena || !storage || size == 0) {
+        return -1;
+    }
+    if (((uintptr_t)storage & (ARENA_ALIGN - 1)) != 0) {
+        return -2;  // Error: storage misaligned
+    }
+
+    arena->base = (uint8_t*)storage;
+    arena->size = size;
+    arena->used = 0;
+    arena->high_water = 0;
+    arena->failures = 0;
+    return 0;
+}
+
+void* arena_alloc_aligned(arena_t* arena, size_t size, size_t align) {
+    if (align == 0 || (align & (align - 1)) != 0) {
+        return NULL;
+    }
+
+    // Align the address, not the offset: storage is only ARENA_ALIGN aligned
+    const uintptr_t cursor = (uintptr_t)arena->base + arena->used;
+    const size_t offset = (size_t)(((cursor + align - 1) & ~(uintptr_t)(align - 1)) - (uintptr_t)arena->base);
+    if (offset > arena->size || size > arena->size - offset) {
+        arena->failures++;
+        return NULL;
+    }
+
+    arena->used = offset + size;
+    if (arena->used > arena->high_water) {
+        arena->high_water = arena->used;
+    }
+    return arena->base + offset;
+}
+
+void arena_get_stats(const arena_t* arena, arena_stats_t* out) {
+    out->size = arena->size;
+    out->used = arena->used;
+    out->high_water = arena->high_water;
+    out->failures = arena->failures;
+}
+
+// =============================================================================
+// Per-task arenas
+// =============================================================================
+
+void arena_bind(arena_t* arena) {
+#if !defined(UNIT_TESTING)
+    vTaskSetThreadLocalStoragePointer(NULL, ARENA_TLS_INDEX, arena);
+#else
+    bound_arena = arena;
+#endif
+}
+
+arena_t* arena_task(void) {
+#if !defined(UNIT_TESTING)
+    return (arena_t*)pvTaskGetThreadLocalStoragePointer(NULL, ARENA_TLS_INDEX);
+#else
+    return bound_arena;
+#endif
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+/**
+ * @file arena.h
+ * @brief Bump arenas for per-frame scratch memory
+ *
+ * An arena hands out memory by advancing an offset through a fixed buffer,
+ * so an allocation is an align, a compare and an add. Nothing is freed
+ * individually: the owner takes a mark before processing a frame (packet,
+ * DSP block, log line) and rolls the arena back to it afterwards, which
+ * releases everything allocated in between at once.
+ *
+ * An arena belongs to one task and is not ISR safe. Each task can bind its
+ * own arena (kept in FreeRTOS thread-local slot ARENA_TLS_INDEX) so library
+ * code can find scratch space with arena_task() without passing it around.
+ * C++ code uses ArenaScope (arena.hpp) to roll back automatically.
+ *
+ * @code
+ * ARENA_DEFINE_SRAM2(rx_scratch, 2048);
+ *
+ * arena_init(&rx_scratch, rx_scratch_storage, sizeof(rx_scratch_storage));
+ * arena_mark_t m = arena_mark(&rx_scratch);
+ * uint8_t* frame = arena_alloc(&rx_scratch, len);
+ * ...
+ * arena_release(&rx_scratch, m);
+ * @endcode
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sections.h"
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#define ARENA_ALIGN             8       // Default allocation alignment
+#define ARENA_TLS_INDEX         0       // FreeRTOS thread-local storage slot
+
+/**
+ * @brief Define an arena and its storage (<name> and <name>_storage)
+ */
+#define ARENA_DEFINE(name, size) \
+    static uint8_t name##_storage[size] __attribute__((aligned(ARENA_ALIGN))); \
+    static arena_t name
+
+/**
+ * @brief Define an arena whose storage lives in SRAM2 (not zeroed at reset)
+ */
+#define ARENA_DEFINE_SRAM2(name, size) \
+    static uint8_t name##_storage[size] SRAM2_NOINIT __attribute__((aligned(ARENA_ALIGN))); \
+    static arena_t name
+
+/**
+ * @brief Bump Arena
+ */
+typedef struct {
+    uint8_t* base;
+    size_t size;
+    size_t used;
+    size_t high_water;          // Largest value of used since init
+    uint32_t failures;          // Allocations that did not fit
+} arena_t;
+
+/**
+ * @brief Position to roll an arena back to
+ */
+typedef size_t arena_mark_t;
+
+/**
+ * @brief Arena Statistics
+ */
+typedef struct {
+    size_t size;
+    size_t used;
+    size_t high_water;
+    uint32_t failures;
+} arena_stats_t;
+
+// =============================================================================
+// API
+// =============================================================================
+
+/**
+ * @brief Initialize an arena over a buffer
+ * @param arena Arena
+ * @param storage Buffer, ARENA_ALIGN aligned
+ * @param size Buffer size in bytes
+ * @return 0 on success, negative error code on failure
+ */
+int arena_init(arena_t* arena, void* storage, size_t size);
+
+/**
+ * @brief Allocate with explicit alignment
+ * @param arena Arena
+ * @param size Bytes required
+ * @param align Power-of-two alignment
+ * @return Memory, or NULL if the arena is exhausted
+ */
+void* arena_alloc_aligned(arena_t* arena, size_t size, size_t align);
+
+/**
+ * @brief Allocate ARENA_ALIGN aligned memory
+ * @return Memory, or NULL if the arena is exhausted
+ */
+static inline void* arena_alloc(arena_t* arena, size_t size) {
+    const size_t offset = (arena->used + (ARENA_ALIGN - 1)) & ~(size_t)(ARENA_ALIGN - 1);
+    if (offset > arena->size || size > arena->size - offset) {
+        arena->failures++;
+        return NULL;
+    }
+    arena->used = offset + size;
+    if (arena->used > arena->high_water) {
+        arena->high_water = arena->used;
+    }
+    return arena->base + offset;
+}
+
+/**
+ * @brief Current position, for a later arena_release()
+ */
+static inline arena_mark_t arena_mark(const arena_t* arena) {
+    return arena->used;
+}
+
+/**
+ * @brief Release everything allocated since a mark
+ * @param arena Arena
+ * @param mark Value from arena_mark() (marks must be released innermost first)
+ */
+static inline void arena_release(arena_t* arena, arena_mark_t mark) {
+    if (mark < arena->used) {
+        arena->used = mark;
+    }
+}
+
+/**
+ * @brief Release everything
+ */
+static inline void arena_reset(arena_t* arena) {
+    arena->used = 0;
+}
+
+/**
+ * @brief Read arena statistics
+ * @param arena Arena
+ * @param out Destination
+ */
+void arena_get_stats(const arena_t* arena, arena_stats_t* out);
+
+// =============================================================================
+// Per-task arenas
+// =============================================================================
+
+/**
+ * @brief Bind an arena to the calling task
+ * @param arena Arena, or NULL to unbind
+ */
+void arena_bind(arena_t* arena);
+
+/**
+ * @brief Arena bound to the calling task
+ * @return Arena, or NULL if none is bound
+ */
+arena_t* arena_task(void);
+
+#ifdef __cplusplus
+}
+#endif
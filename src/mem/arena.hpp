@@ -0,0 +1,85 @@
+#pragma once
+
+/**
+ * @file arena.hpp
+ * @brief RAII scope for bump arenas
+ *
+ * An ArenaScope takes a mark on construction and rolls the arena back when
+ * it goes out of scope, so every early return of a frame handler releases
+ * its scratch memory. Scopes nest; the innermost must end first, which C++
+ * scoping guarantees.
+ *
+ * @code
+ * void handle_packet(const uint8_t* raw, size_t len) {
+ *     ArenaScope scratch;                     // Calling task's arena
+ *     auto* fields = scratch.alloc<Field>(16);
+ *     char* line = scratch.alloc<char>(80);
+ *     ...
+ * }                                           // Both released here
+ * @endcode
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+extern "C" {
+#include "arena.h"
+}
+
+class ArenaScope {
+public:
+    /**
+     * @brief Open a scope on the calling task's arena (see arena_bind())
+     */
+    ArenaScope() : ArenaScope(arena_task()) {}
+
+    explicit ArenaScope(arena_t* arena)
+        : arena_(arena), mark_(arena ? arena_mark(arena) : 0) {}
+
+    ~ArenaScope() {
+        if (arena_) {
+            arena_release(arena_, mark_);
+        }
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    /**
+     * @brief Uninitialized storage for count objects of T
+     * @return Storage, or nullptr if the arena is exhausted or unbound
+     *
+     * Objects are never destroyed by the scope; use it for trivially
+     * destructible data such as buffers, samples and parsed fields.
+     */
+    template <typename T>
+    T* alloc(std::size_t count = 1) {
+        if (!arena_ || count > SIZE_MAX / sizeof(T)) {
+            return nullptr;
+        }
+        void* p = (alignof(T) <= ARENA_ALIGN)
+            ? arena_alloc(arena_, count * sizeof(T))
+            : arena_alloc_aligned(arena_, count * sizeof(T), alignof(T));
+        return static_cast<T*>(p);
+    }
+
+    /**
+     * @brief Construct one object in the arena
+     * @return Object, or nullptr if the arena is exhausted or unbound
+     */
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena objects are never destroyed");
+        T* p = alloc<T>();
+        return p ? new (p) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    arena_t* arena() const { return arena_; }
+
+private:
+    arena_t* arena_;
+    arena_mark_t mark_;
+};
@@ -0,0 +1,162 @@
+/**
+ * @file block_pool.c
+ * @brief Fixed-block memory pools with O(1) allocation
+ *
+ * The critical sections mask interrupts up to the kernel's syscall
+ * priority and are valid in task and ISR context; each covers only a list
+ * head update and the counters.
+ */
+
+#include "block_pool.h"
+#include "crit_section.h"
+#include <string.h>
+
+static block_pool_t* classes[MEM_MAX_CLASSES];
+static uint32_t class_count = 0;
+
+// Public API implementations
+
+int block_pool_init(block_pool_t* pool, void* storage, size_t block_size, uint16_t blocks) {
+    if (!pool || !storage || blocks == 0 || block_size == 0) {
+        return -1;
+    }
+    if (((uintptr_t)storage & (BLOCK_POOL_ALIGN - 1)) != 0) {
+        return -2;  // Error: storage misaligned
+    }
+
+    block_size = BLOCK_POOL_BLOCK_SIZE(block_size);
+    if (block_size > UINT16_MAX) {
+        return -3;
+    }
+
+    uint8_t* block = (uint8_t*)storage;
+    pool->free_list = NULL;
+    for (uint16_t i = 0; i < blocks; i++) {
+        // Link in address order so the first allocations are the lowest blocks
+        uint8_t* b = block + (size_t)(blocks - 1U - i) * block_size;
+        *(void**)b = pool->free_list;
+        pool->free_list = b;
+    }
+
+    pool->start = block;
+    pool->end = block + (size_t)blocks * block_size;
+    pool->block_size = (uint16_t)block_size;
+    pool->blocks = blocks;
+    pool->used = 0;
+    pool->peak_used = 0;
+    pool->failures = 0;
+    return 0;
+}
+
+void* block_pool_alloc(block_pool_t* pool) {
+    CRIT_STAT;
+
+    CRIT_ENTER();
+    void* block = pool->free_list;
+    if (block) {
+        pool->free_list = *(void**)block;
+        pool->used = pool->used + 1;
+        if (pool->used > pool->peak_used) {
+            pool->peak_used = pool->used;
+        }
+    } else {
+        pool->failures++;
+    }
+    CRIT_EXIT();
+
+    return block;
+}
+
+void block_pool_free(block_pool_t* pool, void* block) {
+    CRIT_STAT;
+
+    if (!block) {
+        return;
+    }
+
+    CRIT_ENTER();
+    *(void**)block = pool->free_list;
+    pool->free_list = block;
+    pool->used = pool->used - 1;
+    CRIT_EXIT();
+}
+
+bool block_pool_owns(const block_pool_t* pool, const void* ptr) {
+    const uint8_t* p = (const uint8_t*)ptr;
+    return p >= pool->start && p < pool->end;
+}
+
+void block_pool_get_stats(const block_pool_t* pool, block_pool_stats_t* out) {
+    out->block_size = pool->block_size;
+    out->blocks = pool->blocks;
+    out->used = pool->used;
+    out->peak_used = pool->peak_used;
+    out->failures = pool->failures;
+}
+
+// =============================================================================
+// Size Classes
+// =============================================================================
+
+void mem_reset_pools(void) {
+    memset(classes, 0, sizeof(classes));
+    class_count = 0;
+}
+
+int mem_register_pool(block_pool_t* pool) {
+    if (!pool || pool->blocks == 0) {
+        return -1;
+    }
+    if (class_count >= MEM_MAX_CLASSES) {
+        return -2;  // Error: too many size classes
+    }
+
+    // Insertion sort by block size; registration happens once at startup
+    uint32_t i = class_count++;
+    while (i > 0 && classes[i - 1]->block_size > pool->block_size) {
+        classes[i] = classes[i - 1];
+        i--;
+    }
+    classes[i] = pool;
+    return 0;
+}
+
+void* mem_alloc(size_t size) {
+    for (uint32_t i = 0; i < class_count; i++) {
+        if (size > classes[i]->block_size) {
+            continue;
+        }
+        // An exhausted class spills into the next larger one
+        void* block = block_pool_alloc(classes[i]);
+        if (block) {
+            return block;
+        }
+    }
+    return NULL;
+}
+
+int mem_free(void* ptr) {
+    if (!ptr) {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < class_count; i++) {
+        if (block_pool_owns(classes[i], ptr)) {
+            block_pool_free(classes[i], ptr);
+            return 0;
+        }
+    }
+    return -1;  // Error: not a pool block
+}
+
+int mem_get_class_stats(uint32_t index, block_pool_stats_t* out) {
+    if (index >= class_count || !out) {
+        return -1;
+    }
+    block_pool_get_stats(classes[index], out);
+    return 0;
+}
+
+uint32_t mem_class_count(void) {
+    return class_count;
+}
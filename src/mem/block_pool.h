@@ -0,0 +1,167 @@
+#pragma once
+
+/**
+ * @file block_pool.h
+ * @brief Fixed-block memory pools with O(1) allocation
+ *
+ * A pool carves static storage into equal blocks linked in a free list.
+ * Allocation and release pop and push the list head inside a critical
+ * section of a few instructions, so both are constant time and may be
+ * called from ISRs up to configMAX_SYSCALL_INTERRUPT_PRIORITY.
+ *
+ * Pools of different block sizes can be registered as size classes;
+ * mem_alloc() then serves a request from the smallest class that has a
+ * free block, and mem_free() finds the owning pool from the address.
+ *
+ * @code
+ * BLOCK_POOL_DEFINE(msg_pool, 64, 16);
+ *
+ * block_pool_init(&msg_pool, msg_pool_storage, 64, 16);
+ * mem_register_pool(&msg_pool);
+ * void* buf = mem_alloc(40);
+ * mem_free(buf);
+ * @endcode
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef MEM_MAX_CLASSES
+#define MEM_MAX_CLASSES         6       // Size classes known to mem_alloc()
+#endif
+
+#define BLOCK_POOL_ALIGN        8       // Block alignment (doubles, uint64_t)
+
+// Round a block size up to the pool alignment
+#define BLOCK_POOL_BLOCK_SIZE(size) \
+    ((((size) < sizeof(void*) ? sizeof(void*) : (size)) + BLOCK_POOL_ALIGN - 1) & ~(size_t)(BLOCK_POOL_ALIGN - 1))
+
+/**
+ * @brief Define a pool and its static storage (<name> and <name>_storage)
+ */
+#define BLOCK_POOL_DEFINE(name, block_size, count) \
+    static uint8_t name##_storage[BLOCK_POOL_BLOCK_SIZE(block_size) * (count)] \
+        __attribute__((aligned(BLOCK_POOL_ALIGN))); \
+    static block_pool_t name
+
+/**
+ * @brief Fixed-Block Pool
+ */
+typedef struct {
+    void* free_list;
+    uint8_t* start;             // First block, for ownership checks
+    uint8_t* end;               // One past the last block
+    uint16_t block_size;
+    uint16_t blocks;
+    volatile uint16_t used;
+    uint16_t peak_used;
+    uint32_t failures;          // Allocations that found the pool empty
+} block_pool_t;
+
+/**
+ * @brief Pool Statistics
+ */
+typedef struct {
+    uint16_t block_size;
+    uint16_t blocks;
+    uint16_t used;
+    uint16_t peak_used;
+    uint32_t failures;
+} block_pool_stats_t;
+
+// =============================================================================
+// Block Pool API
+// =============================================================================
+
+/**
+ * @brief Carve storage into blocks
+ * @param pool Pool
+ * @param storage Storage of BLOCK_POOL_BLOCK_SIZE(block_size) * blocks bytes,
+ *                BLOCK_POOL_ALIGN aligned
+ * @param block_size Requested block size (rounded up)
+ * @param blocks Number of blocks
+ * @return 0 on success, negative error code on failure
+ */
+int block_pool_init(block_pool_t* pool, void* storage, size_t block_size, uint16_t blocks);
+
+/**
+ * @brief Take a block (task and ISR safe, O(1))
+ * @param pool Pool
+ * @return Block, or NULL if the pool is empty
+ */
+void* block_pool_alloc(block_pool_t* pool);
+
+/**
+ * @brief Return a block (task and ISR safe, O(1))
+ * @param pool Pool that owns the block
+ * @param block Block from block_pool_alloc(), or NULL
+ */
+void block_pool_free(block_pool_t* pool, void* block);
+
+/**
+ * @brief Check whether an address lies inside a pool's storage
+ */
+bool block_pool_owns(const block_pool_t* pool, const void* ptr);
+
+/**
+ * @brief Read pool statistics
+ * @param pool Pool
+ * @param out Destination
+ */
+void block_pool_get_stats(const block_pool_t* pool, block_pool_stats_t* out);
+
+// =============================================================================
+// Size Classes
+// =============================================================================
+
+/**
+ * @brief Forget all registered size classes
+ */
+void mem_reset_pools(void);
+
+/**
+ * @brief Register an initialized pool as a size class
+ * @param pool Pool (kept sorted by block size)
+ * @return 0 on success, negative error code on failure
+ */
+int mem_register_pool(block_pool_t* pool);
+
+/**
+ * @brief Allocate from the smallest size class with a free block
+ * @param size Bytes required
+ * @return Block, or NULL if no class can serve the request
+ */
+void* mem_alloc(size_t size);
+
+/**
+ * @brief Return a block to the size class that owns it
+ * @param ptr Block from mem_alloc(), or NULL
+ * @return 0 on success, negative error code if no class owns the block
+ */
+int mem_free(void* ptr);
+
+/**
+ * @brief Read statistics of a size class
+ * @param index Class index, smallest first
+ * @param out Destination
+ * @return 0 on success, negative error code on failure
+ */
+int mem_get_class_stats(uint32_t index, block_pool_stats_t* out);
+
+/**
+ * @brief Number of registered size classes
+ */
+uint32_t mem_class_count(void);
+
+#ifdef __cplusplus
+}
+#endif
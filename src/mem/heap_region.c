@@ -0,0 +1,20 @@
+/**
+ * @file heap_region.c
+ * @brief Placement of the FreeRTOS heap array
+ *
+ * Built with -DFREERTOS_HEAP_IN_SRAM2=ON, the root CMakeLists.txt sets
+ * configAPPLICATION_ALLOCATED_HEAP so heap_4 (or heap_tlsf) uses this
+ * array instead of its own, and places it in SRAM2. Otherwise the heap
+ * allocator keeps its array in SRAM1 .bss and this file is empty.
+ */
+
+#include "FreeRTOS.h"
+#include "sections.h"
+
+#if configAPPLICATION_ALLOCATED_HEAP == 1
+#if defined(FREERTOS_HEAP_IN_SRAM2)
+uint8_t ucHeap[configTOTAL_HEAP_SIZE] SRAM2_NOINIT __attribute__((aligned(8)));
+#else
+uint8_t ucHeap[configTOTAL_HEAP_SIZE] __attribute__((aligned(8)));
+#endif
+#endif
@@ -0,0 +1,128 @@
+/**
+ * @file heap_tlsf.c
+ * @brief FreeRTOS heap implementation backed by the TLSF allocator
+ *
+ * Drop-in replacement for heap_4.c, selected with -DUSE_TLSF_HEAP=ON in the
+ * root CMakeLists.txt. pvPortMalloc() and vPortFree() run in bounded time
+ * (two bitmap scans, at most two merges), so a task's allocation latency no
+ * longer depends on how fragmented the heap is.
+ *
+ * The heap spans two regions: configTOTAL_HEAP_SIZE bytes in SRAM1 (.bss)
+ * and HEAP_TLSF_SRAM2_SIZE bytes in SRAM2 (.sram2_noinit, not zeroed).
+ * Like heap_4, access is serialized by suspending the scheduler, so the
+ * heap must not be used from ISRs.
+ */
+
+#include <string.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "tlsf.h"
+#include "heap_tlsf.h"
+#include "sections.h"
+
+#if configSUPPORT_DYNAMIC_ALLOCATION == 0
+#error heap_tlsf.c requires configSUPPORT_DYNAMIC_ALLOCATION
+#endif
+
+#if configAPPLICATION_ALLOCATED_HEAP == 1
+extern uint8_t ucHeap[configTOTAL_HEAP_SIZE];
+#else
+static uint8_t ucHeap[configTOTAL_HEAP_SIZE] __attribute__((aligned(TLSF_ALIGN)));
+#endif
+
+#if HEAP_TLSF_SRAM2_SIZE > 0
+static uint8_t sram2_heap[HEAP_TLSF_SRAM2_SIZE] SRAM2_NOINIT __attribute__((aligned(TLSF_ALIGN)));
+#endif
+
+static tlsf_t heap;
+static BaseType_t heap_ready = pdFALSE;
+
+static void heap_init(void) {
+    int rc;
+
+    tlsf_init(&heap);
+    rc = tlsf_add_pool(&heap, ucHeap, sizeof(ucHeap));
+    configASSERT(rc == 0);
+#if HEAP_TLSF_SRAM2_SIZE > 0
+    rc = tlsf_add_pool(&heap, sram2_heap, sizeof(sram2_heap));
+    configASSERT(rc == 0);
+#endif
+    (void)rc;
+    heap_ready = pdTRUE;
+}
+
+// =============================================================================
+// FreeRTOS heap interface (portable.h)
+// =============================================================================
+
+void* pvPortMalloc(size_t xWantedSize) {
+    void* ptr;
+
+    vTaskSuspendAll();
+    {
+        if (heap_ready == pdFALSE) {
+            heap_init();
+        }
+        ptr = tlsf_malloc(&heap, xWantedSize);
+        traceMALLOC(ptr, xWantedSize);
+    }
+    (void)xTaskResumeAll();
+
+#if configUSE_MALLOC_FAILED_HOOK == 1
+    if (ptr == NULL && xWantedSize > 0) {
+        extern void vApplicationMallocFailedHook(void);
+        vApplicationMallocFailedHook();
+    }
+#endif
+
+    return ptr;
+}
+
+void vPortFree(void* pv) {
+    if (pv == NULL) {
+        return;
+    }
+
+    vTaskSuspendAll();
+    {
+        traceFREE(pv, tlsf_block_size(pv));
+        tlsf_free(&heap, pv);
+    }
+    (void)xTaskResumeAll();
+}
+
+size_t xPortGetFreeHeapSize(void) {
+    return heap.free_bytes;
+}
+
+size_t xPortGetMinimumEverFreeHeapSize(void) {
+    return heap.min_free_bytes;
+}
+
+void vPortGetHeapStats(HeapStats_t* pxHeapStats) {
+    tlsf_stats_t stats;
+    heap_tlsf_get_stats(&stats);
+
+    pxHeapStats->xAvailableHeapSpaceInBytes = stats.free_bytes;
+    pxHeapStats->xSizeOfLargestFreeBlockInBytes = stats.largest_free;
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = stats.smallest_free;
+    pxHeapStats->xNumberOfFreeBlocks = stats.free_blocks;
+    pxHeapStats->xMinimumEverFreeBytesRemaining = stats.min_free_bytes;
+    pxHeapStats->xNumberOfSuccessfulAllocations = stats.allocs;
+    pxHeapStats->xNumberOfSuccessfulFrees = stats.frees;
+}
+
+// =============================================================================
+// Fragmentation report
+// =============================================================================
+
+void heap_tlsf_get_stats(tlsf_stats_t* out) {
+    vTaskSuspendAll();
+    {
+        if (heap_ready == pdFALSE) {
+            heap_init();
+        }
+        tlsf_get_stats(&heap, out);
+    }
+    (void)xTaskResumeAll();
+}
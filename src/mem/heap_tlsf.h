@@ -0,0 +1,37 @@
+#pragma once
+
+/**
+ * @file heap_tlsf.h
+ * @brief Fragmentation report for the TLSF-backed FreeRTOS heap
+ *
+ * Only available when the firmware is built with -DUSE_TLSF_HEAP=ON; the
+ * standard pvPortMalloc()/vPortFree()/vPortGetHeapStats() interface is
+ * provided by heap_tlsf.c in place of heap_4.c.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "tlsf.h"
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef HEAP_TLSF_SRAM2_SIZE
+#define HEAP_TLSF_SRAM2_SIZE    8192    // Second heap region in SRAM2 (0 = none)
+#endif
+
+/**
+ * @brief Walk the heap and report free space, block counts and fragmentation
+ * @param out Destination
+ *
+ * Suspends the scheduler for the walk, which is proportional to the number
+ * of blocks; call it from a diagnostics task, not a time-critical path.
+ */
+void heap_tlsf_get_stats(tlsf_stats_t* out);
+
+#ifdef __cplusplus
+}
+#endif
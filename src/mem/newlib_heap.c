@@ -0,0 +1,153 @@
+/**
+ * @file newlib_heap.c
+ * @brief C library allocation routed to the FreeRTOS heap
+ *
+ * pvPortMalloc() serializes callers by suspending the scheduler, so the
+ * wrappers need no lock of their own and __malloc_lock()/__malloc_unlock()
+ * are never reached. As with pvPortMalloc(), none of these may be called
+ * from an ISR.
+ */
+
+#include "newlib_heap.h"
+#include <stdint.h>
+#include <string.h>
+
+#if !defined(UNIT_TESTING)
+#include <errno.h>
+#include <reent.h>
+#include "FreeRTOS.h"
+#else
+void* pvPortMalloc(size_t size);
+void vPortFree(void* ptr);
+#endif
+
+_Static_assert(sizeof(size_t) <= NEWLIB_HEAP_HEADER, "Size prefix must fit the header");
+
+static inline size_t* header_of(const void* ptr) {
+    return (size_t*)((uint8_t*)ptr - NEWLIB_HEAP_HEADER);
+}
+
+// Public API implementations
+
+void* newlib_heap_malloc(size_t size) {
+    if (size > SIZE_MAX - NEWLIB_HEAP_HEADER) {
+        return NULL;
+    }
+
+    uint8_t* block = (uint8_t*)pvPortMalloc(size + NEWLIB_HEAP_HEADER);
+    if (!block) {
+        return NULL;
+    }
+    *(size_t*)block = size;
+    return block + NEWLIB_HEAP_HEADER;
+}
+
+void newlib_heap_free(void* ptr) {
+    if (ptr) {
+        vPortFree(header_of(ptr));
+    }
+}
+
+void* newlib_heap_realloc(void* ptr, size_t size) {
+    if (!ptr) {
+        return newlib_heap_malloc(size);
+    }
+    if (size == 0) {
+        newlib_heap_free(ptr);
+        return NULL;
+    }
+
+    // Shrinking keeps the block; its recorded capacity stays unchanged
+    const size_t capacity = *header_of(ptr);
+    if (size <= capacity) {
+        return ptr;
+    }
+
+    void* moved = newlib_heap_malloc(size);
+    if (moved) {
+        memcpy(moved, ptr, capacity);
+        newlib_heap_free(ptr);
+    }
+    return moved;
+}
+
+void* newlib_heap_calloc(size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) {
+        return NULL;
+    }
+
+    void* ptr = newlib_heap_malloc(count * size);
+    if (ptr) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+size_t newlib_heap_usable_size(const void* ptr) {
+    return ptr ? *header_of(ptr) : 0;
+}
+
+#if !defined(UNIT_TESTING)
+
+// =============================================================================
+// newlib entry points
+// =============================================================================
+
+static void* set_enomem(struct _reent* r) {
+#if defined(_REENT_ERRNO)
+    _REENT_ERRNO(r) = ENOMEM;
+#else
+    r->_errno = ENOMEM;
+#endif
+    return NULL;
+}
+
+void* _malloc_r(struct _reent* r, size_t size) {
+    void* ptr = newlib_heap_malloc(size);
+    return ptr ? ptr : set_enomem(r);
+}
+
+void _free_r(struct _reent* r, void* ptr) {
+    (void)r;
+    newlib_heap_free(ptr);
+}
+
+void* _realloc_r(struct _reent* r, void* ptr, size_t size) {
+    void* moved = newlib_heap_realloc(ptr, size);
+    return (moved || size == 0) ? moved : set_enomem(r);
+}
+
+void* _calloc_r(struct _reent* r, size_t count, size_t size) {
+    void* ptr = newlib_heap_calloc(count, size);
+    return ptr ? ptr : set_enomem(r);
+}
+
+// Blocks are only guaranteed 8-byte alignment; stricter requests fail
+void* _memalign_r(struct _reent* r, size_t align, size_t size) {
+    return (align <= 8) ? _malloc_r(r, size) : set_enomem(r);
+}
+
+size_t _malloc_usable_size_r(struct _reent* r, void* ptr) {
+    (void)r;
+    return newlib_heap_usable_size(ptr);
+}
+
+// Non-reentrant forms, so newlib's malloc objects are never pulled in
+
+void* malloc(size_t size) {
+    return _malloc_r(_REENT, size);
+}
+
+void free(void* ptr) {
+    newlib_heap_free(ptr);
+}
+
+void* realloc(void* ptr, size_t size) {
+    return _realloc_r(_REENT, ptr, size);
+}
+
+void* calloc(size_t count, size_t size) {
+    return _calloc_r(_REENT, count, size);
+}
+
+#endif
@@ -0,0 +1,57 @@
+#pragma once
+
+/**
+ * @file newlib_heap.h
+ * @brief C library allocation routed to the FreeRTOS heap
+ *
+ * newlib_heap.c provides newlib's reentrant allocator entry points
+ * (_malloc_r, _free_r, _realloc_r, _calloc_r, ...) and the plain malloc()
+ * family on top of pvPortMalloc()/vPortFree(). newlib's own allocator is
+ * therefore never linked: printf buffers, strdup() and C++ operator new
+ * draw from the same heap as kernel objects (heap_4 or TLSF), which is
+ * already safe to use from any task, and no RAM is reserved for a second
+ * heap behind _sbrk.
+ *
+ * Every block carries a NEWLIB_HEAP_HEADER byte prefix recording its size,
+ * since realloc() needs it and the RTOS heap does not expose it.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+#define NEWLIB_HEAP_HEADER      8       // Size prefix; keeps 8-byte alignment
+
+/**
+ * @brief Allocate from the RTOS heap
+ * @return Memory, or NULL on exhaustion
+ */
+void* newlib_heap_malloc(size_t size);
+
+/**
+ * @brief Free memory from newlib_heap_malloc() (NULL is ignored)
+ */
+void newlib_heap_free(void* ptr);
+
+/**
+ * @brief Resize an allocation, moving it if it has to grow
+ * @return Memory, or NULL on exhaustion (the original block is kept)
+ */
+void* newlib_heap_realloc(void* ptr, size_t size);
+
+/**
+ * @brief Allocate zeroed memory for count objects of size bytes
+ * @return Memory, or NULL on exhaustion or overflow
+ */
+void* newlib_heap_calloc(size_t count, size_t size);
+
+/**
+ * @brief Capacity of an allocation
+ */
+size_t newlib_heap_usable_size(const void* ptr);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,101 @@
+#pragma once
+
+/**
+ * @file pool_allocator.hpp
+ * @brief C++ adaptors for the fixed-block size classes
+ *
+ * PoolAllocator<T> satisfies the standard Allocator requirements on top of
+ * mem_alloc()/mem_free(), so containers of message buffers or driver
+ * descriptors draw from the registered size classes instead of the RTOS
+ * heap. A request no class can serve calls mem_pool_exhausted().
+ *
+ * pool_new()/pool_delete() construct single objects and report exhaustion
+ * by returning nullptr, which suits ISR paths that cannot throw.
+ *
+ * @code
+ * std::vector<Sample, PoolAllocator<Sample>> samples;
+ * samples.reserve(8);
+ *
+ * auto* desc = pool_new<DmaDescriptor>(channel);
+ * pool_delete(desc);
+ * @endcode
+ */
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+extern "C" {
+#include "block_pool.h"
+}
+
+/**
+ * @brief Called when a PoolAllocator request cannot be served
+ *
+ * Throws std::bad_alloc when exceptions are enabled and aborts otherwise.
+ */
+[[noreturn]] inline void mem_pool_exhausted() {
+#if defined(__cpp_exceptions)
+    throw std::bad_alloc();
+#else
+    std::abort();
+#endif
+}
+
+template <typename T>
+class PoolAllocator {
+    static_assert(alignof(T) <= BLOCK_POOL_ALIGN, "Type alignment exceeds pool block alignment");
+
+public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if (n > SIZE_MAX / sizeof(T)) {
+            mem_pool_exhausted();
+        }
+        void* p = mem_alloc(n * sizeof(T));
+        if (!p) {
+            mem_pool_exhausted();
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        mem_free(p);
+    }
+
+    // Stateless: every instance draws from the same size classes
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+};
+
+/**
+ * @brief Construct an object in a pool block
+ * @return Object, or nullptr if no size class has a free block
+ */
+template <typename T, typename... Args>
+T* pool_new(Args&&... args) {
+    static_assert(alignof(T) <= BLOCK_POOL_ALIGN, "Type alignment exceeds pool block alignment");
+    void* p = mem_alloc(sizeof(T));
+    if (!p) {
+        return nullptr;
+    }
+    return new (p) T(std::forward<Args>(args)...);
+}
+
+/**
+ * @brief Destroy an object from pool_new() and return its block
+ */
+template <typename T>
+void pool_delete(T* obj) {
+    if (obj) {
+        obj->~T();
+        mem_free(obj);
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+/**
+ * @file sections.h
+ * @brief Placement of code and data in RAM, SRAM2 and external flash
+ *
+ * The linker script (linker/STM32L432KCUX_FLASH.ld) lays out SRAM2 as:
+ *
+ *   .ramfunc       code, copied from flash at reset and executed through
+ *                  the ICode alias at 0x10000000 (no flash wait states, and
+ *                  instruction fetches do not compete with data on the S-bus)
+ *   .sram2         initialized data, copied from flash at reset
+ *   .sram2_bss     zero-initialized data
+ *   .sram2_noinit  data left untouched at reset (heap regions, arenas,
+ *                  state kept through Standby with PWR_CR3.RRS set)
+ *   main stack     at the top, unless linked with MAIN_STACK_IN_SRAM1
+ *
+ * SRAM2 is parity checked: after a power-on reset .sram2_noinit contents
+ * are undefined and must be written before they are read.
+ *
+ * QSPI_CONST places constants in the external flash (.qspi, at 0x90000000),
+ * built into a separate image. They are readable only while QUADSPI is
+ * memory mapped (qspi_flash_memory_map()), so nothing that runs before
+ * that, or while the flash is erased or programmed, may touch them.
+ *
+ * RAMFUNC code must not call into flash on its hot path, or the benefit is
+ * lost; keep such functions small and self-contained.
+ */
+
+#if !defined(UNIT_TESTING)
+#define RAMFUNC         __attribute__((section(".ramfunc"), noinline, long_call))
+#define SRAM2_DATA      __attribute__((section(".sram2")))
+#define SRAM2_BSS       __attribute__((section(".sram2_bss")))
+#define SRAM2_NOINIT    __attribute__((section(".sram2_noinit")))
+#define QSPI_CONST      __attribute__((section(".qspi")))
+#else
+#define RAMFUNC
+#define SRAM2_DATA
+#define SRAM2_BSS
+#define SRAM2_NOINIT
+#define QSPI_CONST
+#endif
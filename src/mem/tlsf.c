@@ -0,0 +1,366 @@
+/**
+ * @file tlsf.c
+ * @brief Two-Level Segregated Fit allocator
+ *
+ * Block layout: a two-word header (previous physical block, payload size
+ * with FREE/PREV_FREE flags in the low bits) followed by the payload.
+ * While a block is free, its first two payload words link it into the
+ * free list of its size class. The previous-block pointer is maintained
+ * only while that block is free, which is all merging needs. Every region
+ * ends with a zero-size used sentinel so merging never runs past it.
+ */
+
+#include "tlsf.h"
+#include <stdbool.h>
+#include <string.h>
+
+typedef struct tlsf_block {
+    struct tlsf_block* prev_phys;   // Valid while the previous block is free
+    size_t size;                    // Payload bytes | BLOCK_FREE | BLOCK_PREV_FREE
+    struct tlsf_block* next_free;   // Payload starts here; valid while free
+    struct tlsf_block* prev_free;
+} tlsf_block_t;
+
+#define BLOCK_FREE              ((size_t)1)
+#define BLOCK_PREV_FREE         ((size_t)2)
+#define BLOCK_FLAGS             (BLOCK_FREE | BLOCK_PREV_FREE)
+
+#define ALIGN_UP(x)             (((x) + (TLSF_ALIGN - 1)) & ~(size_t)(TLSF_ALIGN - 1))
+#define ALIGN_DOWN(x)           ((x) & ~(size_t)(TLSF_ALIGN - 1))
+
+#define BLOCK_OVERHEAD          offsetof(tlsf_block_t, next_free)
+#define BLOCK_MIN_PAYLOAD       ALIGN_UP(sizeof(tlsf_block_t) - BLOCK_OVERHEAD)
+#define BLOCK_MAX_PAYLOAD       ((size_t)1 << TLSF_FL_INDEX_MAX)
+#define SMALL_BLOCK_SIZE        ((size_t)1 << TLSF_FL_SHIFT)
+
+_Static_assert(BLOCK_OVERHEAD % TLSF_ALIGN == 0, "Block header must preserve payload alignment");
+_Static_assert(TLSF_FL_COUNT <= 32, "First-level bitmap is 32 bits");
+_Static_assert(TLSF_SL_COUNT <= 32, "Second-level bitmap is 32 bits");
+
+// =============================================================================
+// Block helpers
+// =============================================================================
+
+static inline size_t block_size(const tlsf_block_t* b) {
+    return b->size & ~BLOCK_FLAGS;
+}
+
+static inline void block_set_size(tlsf_block_t* b, size_t size) {
+    b->size = size | (b->size & BLOCK_FLAGS);
+}
+
+static inline void* block_to_ptr(const tlsf_block_t* b) {
+    return (uint8_t*)b + BLOCK_OVERHEAD;
+}
+
+static inline tlsf_block_t* block_from_ptr(const void* ptr) {
+    return (tlsf_block_t*)((uint8_t*)ptr - BLOCK_OVERHEAD);
+}
+
+static inline tlsf_block_t* block_next(const tlsf_block_t* b) {
+    return (tlsf_block_t*)((uint8_t*)block_to_ptr(b) + block_size(b));
+}
+
+static inline uint32_t fls32(uint32_t x) {
+    return 31U - (uint32_t)__builtin_clz(x);
+}
+
+static inline uint32_t ffs32(uint32_t x) {
+    return (uint32_t)__builtin_ctz(x);
+}
+
+// =============================================================================
+// Size class mapping
+// =============================================================================
+
+// List that holds blocks of exactly this size
+static void mapping_insert(size_t size, uint32_t* fl, uint32_t* sl) {
+    if (size < SMALL_BLOCK_SIZE) {
+        *fl = 0;
+        *sl = (uint32_t)(size / (SMALL_BLOCK_SIZE / TLSF_SL_COUNT));
+    } else {
+        const uint32_t f = fls32((uint32_t)size);
+        *sl = (uint32_t)(size >> (f - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+        *fl = f - (TLSF_FL_SHIFT - 1);
+    }
+}
+
+// First list whose every block is at least this size
+static void mapping_search(size_t size, uint32_t* fl, uint32_t* sl) {
+    if (size >= SMALL_BLOCK_SIZE) {
+        size += ((size_t)1 << (fls32((uint32_t)size) - TLSF_SL_LOG2)) - 1;
+    }
+    mapping_insert(size, fl, sl);
+}
+
+static tlsf_block_t* find_suitable(const tlsf_t* tlsf, uint32_t fl, uint32_t sl) {
+    uint32_t sl_map = tlsf->sl_bitmap[fl] & (~0U << sl);
+    if (!sl_map) {
+        const uint32_t fl_map = (fl + 1 < 32) ? (tlsf->fl_bitmap & (~0U << (fl + 1))) : 0;
+        if (!fl_map) {
+            return NULL;
+        }
+        fl = ffs32(fl_map);
+        sl_map = tlsf->sl_bitmap[fl];
+    }
+    return tlsf->blocks[fl][ffs32(sl_map)];
+}
+
+// =============================================================================
+// Free lists
+// =============================================================================
+
+static void insert_free(tlsf_t* tlsf, tlsf_block_t* b) {
+    uint32_t fl, sl;
+    mapping_insert(block_size(b), &fl, &sl);
+
+    tlsf_block_t* head = tlsf->blocks[fl][sl];
+    b->next_free = head;
+    b->prev_free = NULL;
+    if (head) {
+        head->prev_free = b;
+    }
+    tlsf->blocks[fl][sl] = b;
+    tlsf->fl_bitmap |= 1U << fl;
+    tlsf->sl_bitmap[fl] |= 1U << sl;
+    tlsf->free_bytes += block_size(b);
+}
+
+static void remove_free(tlsf_t* tlsf, tlsf_block_t* b) {
+    uint32_t fl, sl;
+    mapping_insert(block_size(b), &fl, &sl);
+
+    if (b->next_free) {
+        b->next_free->prev_free = b->prev_free;
+    }
+    if (b->prev_free) {
+        b->prev_free->next_free = b->next_free;
+    } else {
+        tlsf->blocks[fl][sl] = b->next_free;
+        if (!b->next_free) {
+            tlsf->sl_bitmap[fl] &= ~(1U << sl);
+            if (!tlsf->sl_bitmap[fl]) {
+                tlsf->fl_bitmap &= ~(1U << fl);
+            }
+        }
+    }
+    tlsf->free_bytes -= block_size(b);
+}
+
+// Public API implementations
+
+void tlsf_init(tlsf_t* tlsf) {
+    memset(tlsf, 0, sizeof(*tlsf));
+}
+
+int tlsf_add_pool(tlsf_t* tlsf, void* mem, size_t bytes) {
+    if (!tlsf || !mem) {
+        return -1;
+    }
+    if (tlsf->pool_count >= TLSF_MAX_POOLS) {
+        return -2;  // Error: too many regions
+    }
+
+    const uintptr_t start = ALIGN_UP((uintptr_t)mem);
+    const size_t skew = start - (uintptr_t)mem;
+    if (bytes < skew + 2 * BLOCK_OVERHEAD + BLOCK_MIN_PAYLOAD) {
+        return -3;  // Error: region too small
+    }
+    const size_t payload = ALIGN_DOWN(bytes - skew - 2 * BLOCK_OVERHEAD);
+    if (payload >= BLOCK_MAX_PAYLOAD) {
+        return -4;  // Error: region exceeds TLSF_FL_INDEX_MAX
+    }
+
+    tlsf_block_t* block = (tlsf_block_t*)start;
+    block->prev_phys = NULL;
+    block->size = payload | BLOCK_FREE;
+
+    // Zero-size used sentinel closes the region
+    tlsf_block_t* sentinel = block_next(block);
+    sentinel->prev_phys = block;
+    sentinel->size = BLOCK_PREV_FREE;
+
+    insert_free(tlsf, block);
+    tlsf->pools[tlsf->pool_count++] = block;
+    tlsf->total_bytes += payload;
+    tlsf->min_free_bytes += payload;
+    return 0;
+}
+
+void* tlsf_malloc(tlsf_t* tlsf, size_t size) {
+    if (size == 0) {
+        return NULL;
+    }
+    if (size >= BLOCK_MAX_PAYLOAD) {
+        tlsf->failures++;
+        return NULL;
+    }
+
+    size_t adjusted = ALIGN_UP(size);
+    if (adjusted < BLOCK_MIN_PAYLOAD) {
+        adjusted = BLOCK_MIN_PAYLOAD;
+    }
+
+    uint32_t fl, sl;
+    mapping_search(adjusted, &fl, &sl);
+    tlsf_block_t* block = (fl < TLSF_FL_COUNT) ? find_suitable(tlsf, fl, sl) : NULL;
+    if (!block) {
+        tlsf->failures++;
+        return NULL;
+    }
+    remove_free(tlsf, block);
+
+    // Return the tail to the free lists if it can hold a block of its own
+    const size_t available = block_size(block);
+    if (available >= adjusted + BLOCK_OVERHEAD + BLOCK_MIN_PAYLOAD) {
+        tlsf_block_t* rest = (tlsf_block_t*)((uint8_t*)block_to_ptr(block) + adjusted);
+        rest->prev_phys = block;
+        rest->size = (available - adjusted - BLOCK_OVERHEAD) | BLOCK_FREE;
+        block_set_size(block, adjusted);
+        block_next(rest)->prev_phys = rest;
+        insert_free(tlsf, rest);
+    } else {
+        block_next(block)->size &= ~BLOCK_PREV_FREE;
+    }
+    block->size &= ~BLOCK_FREE;
+
+    tlsf->allocs++;
+    if (tlsf->free_bytes < tlsf->min_free_bytes) {
+        tlsf->min_free_bytes = tlsf->free_bytes;
+    }
+    return block_to_ptr(block);
+}
+
+void tlsf_free(tlsf_t* tlsf, void* ptr) {
+    if (!ptr) {
+        return;
+    }
+
+    tlsf_block_t* block = block_from_ptr(ptr);
+    if (block->size & BLOCK_FREE) {
+        return;  // Double free: the block is already in a list
+    }
+    block->size |= BLOCK_FREE;
+    tlsf->frees++;
+
+    if (block->size & BLOCK_PREV_FREE) {
+        tlsf_block_t* prev = block->prev_phys;
+        remove_free(tlsf, prev);
+        block_set_size(prev, block_size(prev) + BLOCK_OVERHEAD + block_size(block));
+        block = prev;
+    }
+
+    tlsf_block_t* next = block_next(block);
+    if (next->size & BLOCK_FREE) {
+        remove_free(tlsf, next);
+        block_set_size(block, block_size(block) + BLOCK_OVERHEAD + block_size(next));
+        next = block_next(block);
+    }
+    next->prev_phys = block;
+    next->size |= BLOCK_PREV_FREE;
+
+    insert_free(tlsf, block);
+}
+
+size_t tlsf_block_size(const void* ptr) {
+    return ptr ? block_size(block_from_ptr(ptr)) : 0;
+}
+
+// =============================================================================
+// Diagnostics
+// =============================================================================
+
+void tlsf_get_stats(const tlsf_t* tlsf, tlsf_stats_t* out) {
+    memset(out, 0, sizeof(*out));
+    out->total_bytes = tlsf->total_bytes;
+    out->free_bytes = tlsf->free_bytes;
+    out->min_free_bytes = tlsf->min_free_bytes;
+    out->allocs = tlsf->allocs;
+    out->frees = tlsf->frees;
+    out->failures = tlsf->failures;
+
+    for (uint32_t i = 0; i < tlsf->pool_count; i++) {
+        for (const tlsf_block_t* b = tlsf->pools[i]; block_size(b) != 0; b = block_next(b)) {
+            if (!(b->size & BLOCK_FREE)) {
+                out->used_blocks++;
+                continue;
+            }
+            const size_t size = block_size(b);
+            out->free_blocks++;
+            if (size > out->largest_free) {
+                out->largest_free = size;
+            }
+            if (out->smallest_free == 0 || size < out->smallest_free) {
+                out->smallest_free = size;
+            }
+        }
+    }
+
+    if (out->free_bytes > 0) {
+        out->fragmentation_pct = (uint32_t)(100U - (out->largest_free * 100U) / out->free_bytes);
+    }
+}
+
+static bool list_contains(const tlsf_t* tlsf, const tlsf_block_t* b) {
+    uint32_t fl, sl;
+    mapping_insert(block_size(b), &fl, &sl);
+    for (const tlsf_block_t* it = tlsf->blocks[fl][sl]; it; it = it->next_free) {
+        if (it == b) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int tlsf_check(const tlsf_t* tlsf) {
+    uint32_t walked_free = 0;
+    size_t walked_bytes = 0;
+
+    for (uint32_t i = 0; i < tlsf->pool_count; i++) {
+        bool prev_free = false;
+        const tlsf_block_t* prev = NULL;
+        const tlsf_block_t* b = tlsf->pools[i];
+        for (;; b = block_next(b)) {
+            const bool is_free = (b->size & BLOCK_FREE) != 0;
+            if (((b->size & BLOCK_PREV_FREE) != 0) != prev_free) {
+                return -1;  // PREV_FREE flag out of sync
+            }
+            if (prev_free && (b->prev_phys != prev || is_free)) {
+                return -2;  // Broken back link or unmerged neighbours
+            }
+            if (block_size(b) == 0) {
+                break;      // Sentinel
+            }
+            if (is_free) {
+                if (!list_contains(tlsf, b)) {
+                    return -3;  // Free block missing from its list
+                }
+                walked_free++;
+                walked_bytes += block_size(b);
+            }
+            prev_free = is_free;
+            prev = b;
+        }
+    }
+
+    uint32_t listed = 0;
+    for (uint32_t fl = 0; fl < TLSF_FL_COUNT; fl++) {
+        if (((tlsf->fl_bitmap >> fl) & 1U) != (tlsf->sl_bitmap[fl] != 0)) {
+            return -4;  // First-level bitmap out of sync
+        }
+        for (uint32_t sl = 0; sl < TLSF_SL_COUNT; sl++) {
+            const tlsf_block_t* head = tlsf->blocks[fl][sl];
+            if (((tlsf->sl_bitmap[fl] >> sl) & 1U) != (head != NULL)) {
+                return -5;  // Second-level bitmap out of sync
+            }
+            for (; head; head = head->next_free) {
+                listed++;
+            }
+        }
+    }
+
+    if (listed != walked_free || walked_bytes != tlsf->free_bytes) {
+        return -6;  // Stale entries in the free lists or byte count drift
+    }
+    return 0;
+}
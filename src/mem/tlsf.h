@@ -0,0 +1,136 @@
+#pragma once
+
+/**
+ * @file tlsf.h
+ * @brief Two-Level Segregated Fit allocator
+ *
+ * Free blocks are kept in lists indexed by a two-level size class: the
+ * first level is the power of two of the size, the second splits each
+ * power of two into TLSF_SL_COUNT linear ranges. Two bitmaps record which
+ * lists are non-empty, so finding a fitting block is a couple of
+ * count-leading-zeros instructions and malloc/free run in bounded time
+ * regardless of heap state. Freed blocks are merged with free physical
+ * neighbours immediately.
+ *
+ * An allocator instance can manage several disjoint memory regions
+ * (e.g. SRAM1 and SRAM2). The functions are not thread safe; callers
+ * serialize access (see heap_tlsf.c).
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef TLSF_FL_INDEX_MAX
+#define TLSF_FL_INDEX_MAX       16      // Largest block: 2^16 bytes
+#endif
+
+#ifndef TLSF_MAX_POOLS
+#define TLSF_MAX_POOLS          2       // Memory regions per instance
+#endif
+
+#define TLSF_ALIGN              8       // Allocation alignment (AAPCS)
+#define TLSF_SL_LOG2            4
+#define TLSF_SL_COUNT           (1U << TLSF_SL_LOG2)
+#define TLSF_FL_SHIFT           (TLSF_SL_LOG2 + 3)
+#define TLSF_FL_COUNT           (TLSF_FL_INDEX_MAX - TLSF_FL_SHIFT + 1)
+
+struct tlsf_block;
+
+/**
+ * @brief Allocator Instance
+ */
+typedef struct {
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[TLSF_FL_COUNT];
+    struct tlsf_block* blocks[TLSF_FL_COUNT][TLSF_SL_COUNT];
+
+    struct tlsf_block* pools[TLSF_MAX_POOLS];   // First block of each region
+    uint32_t pool_count;
+
+    size_t total_bytes;             // Payload capacity of all regions
+    size_t free_bytes;
+    size_t min_free_bytes;
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t failures;
+} tlsf_t;
+
+/**
+ * @brief Heap Report
+ */
+typedef struct {
+    size_t total_bytes;
+    size_t free_bytes;
+    size_t min_free_bytes;          // Low-water mark of free_bytes
+    size_t largest_free;
+    size_t smallest_free;
+    uint32_t free_blocks;
+    uint32_t used_blocks;
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t failures;
+    uint32_t fragmentation_pct;     // 100 * (1 - largest_free / free_bytes)
+} tlsf_stats_t;
+
+// =============================================================================
+// API
+// =============================================================================
+
+/**
+ * @brief Reset an instance to manage no memory
+ */
+void tlsf_init(tlsf_t* tlsf);
+
+/**
+ * @brief Hand a memory region to the allocator
+ * @param tlsf Instance
+ * @param mem Region start (aligned up internally)
+ * @param bytes Region size
+ * @return 0 on success, negative error code on failure
+ */
+int tlsf_add_pool(tlsf_t* tlsf, void* mem, size_t bytes);
+
+/**
+ * @brief Allocate in bounded time
+ * @param tlsf Instance
+ * @param size Bytes required
+ * @return TLSF_ALIGN aligned memory, or NULL
+ */
+void* tlsf_malloc(tlsf_t* tlsf, size_t size);
+
+/**
+ * @brief Release memory and merge it with free neighbours in bounded time
+ * @param tlsf Instance
+ * @param ptr Memory from tlsf_malloc(), or NULL
+ */
+void tlsf_free(tlsf_t* tlsf, void* ptr);
+
+/**
+ * @brief Usable size of an allocation
+ */
+size_t tlsf_block_size(const void* ptr);
+
+/**
+ * @brief Build a heap report by walking all regions (diagnostics only, O(n))
+ * @param tlsf Instance
+ * @param out Destination
+ */
+void tlsf_get_stats(const tlsf_t* tlsf, tlsf_stats_t* out);
+
+/**
+ * @brief Verify block headers, free lists and bitmaps (diagnostics only, O(n))
+ * @return 0 if consistent, negative error code otherwise
+ */
+int tlsf_check(const tlsf_t* tlsf);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,346 @@
+/**
+ * @file active_object.c
+ * @brief Active object queues, priority levels, event pools and time events
+ *
+ * Queues, ready masks, pools and the time event list are shared with ISRs
+ * and are only modified inside an interrupt-masking critical section that
+ * is valid in both task and ISR context. Waking a level task calls into
+ * the kernel, so it always happens after the critical section is left.
+ */
+
+#include "active_object.h"
+#include "crit_section.h"
+#include <string.h>
+
+typedef struct {
+    void* free_list;
+    uint16_t block_size;
+    uint16_t blocks;
+    uint16_t free;
+    uint16_t min_free;
+    uint32_t failures;
+} event_pool_t;
+
+typedef struct {
+    ao_active_t* objects[AO_MAX_PER_LEVEL];
+    volatile uint32_t ready;        // Bit n: objects[n] has events queued
+#if !defined(UNIT_TESTING)
+    TaskHandle_t task;
+#endif
+} ao_level_t;
+
+static event_pool_t pools[AO_MAX_POOLS];
+static uint32_t pool_count = 0;
+static ao_level_t levels[AO_MAX_LEVELS];
+static ao_time_event_t* time_events = NULL;
+
+static void wake_level(ao_level_t* level) {
+#if !defined(UNIT_TESTING)
+    if (!level->task) {
+        return;
+    }
+    if (xPortIsInsideInterrupt()) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(level->task, &woken);
+        portYIELD_FROM_ISR(woken);
+    } else if (xTaskGetCurrentTaskHandle() != level->task) {
+        xTaskNotifyGive(level->task);
+    }
+#else
+    (void)level;
+#endif
+}
+
+// =============================================================================
+// Event Pools
+// =============================================================================
+
+int ao_pool_init(void* storage, size_t block_size, uint16_t blocks) {
+    if (pool_count >= AO_MAX_POOLS) {
+        return -1;  // Error: too many pools
+    }
+    if (!storage || blocks == 0 || block_size < sizeof(void*) || block_size < sizeof(ao_event_t)) {
+        return -2;
+    }
+    if (pool_count > 0 && block_size < pools[pool_count - 1].block_size) {
+        return -3;  // Error: pools must be registered smallest first
+    }
+
+    // Round up so every block stays pointer aligned
+    block_size = (block_size + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+
+    event_pool_t* pool = &pools[pool_count];
+    uint8_t* block = (uint8_t*)storage;
+    pool->free_list = NULL;
+    for (uint16_t i = 0; i < blocks; i++) {
+        *(void**)block = pool->free_list;
+        pool->free_list = block;
+        block += block_size;
+    }
+    pool->block_size = (uint16_t)block_size;
+    pool->blocks = blocks;
+    pool->free = blocks;
+    pool->min_free = blocks;
+    pool->failures = 0;
+
+    return (int)++pool_count;
+}
+
+ao_event_t* ao_event_new(size_t size, uint16_t sig) {
+    CRIT_STAT;
+
+    for (uint32_t i = 0; i < pool_count; i++) {
+        event_pool_t* pool = &pools[i];
+        if (size > pool->block_size) {
+            continue;
+        }
+
+        CRIT_ENTER();
+        ao_event_t* e = (ao_event_t*)pool->free_list;
+        if (e) {
+            pool->free_list = *(void**)e;
+            if (--pool->free < pool->min_free) {
+                pool->min_free = pool->free;
+            }
+        } else {
+            pool->failures++;
+        }
+        CRIT_EXIT();
+
+        if (!e) {
+            return NULL;  // Smallest fitting pool is empty; larger pools are reserved
+        }
+        e->sig = sig;
+        e->pool = (uint8_t)(i + 1);
+        e->refs = 0;
+        return e;
+    }
+    return NULL;
+}
+
+void ao_event_gc(const ao_event_t* e) {
+    CRIT_STAT;
+
+    if (!e || e->pool == 0) {
+        return;
+    }
+
+    ao_event_t* event = (ao_event_t*)e;
+    event_pool_t* pool = &pools[event->pool - 1];
+
+    CRIT_ENTER();
+    if (event->refs > 1) {
+        event->refs--;
+    } else {
+        *(void**)event = pool->free_list;
+        pool->free_list = event;
+        pool->free++;
+    }
+    CRIT_EXIT();
+}
+
+int ao_pool_get_stats(int pool, ao_pool_stats_t* out) {
+    if (pool < 1 || (uint32_t)pool > pool_count || !out) {
+        return -1;
+    }
+
+    const event_pool_t* p = &pools[pool - 1];
+    out->block_size = p->block_size;
+    out->blocks = p->blocks;
+    out->free = p->free;
+    out->min_free = p->min_free;
+    out->failures = p->failures;
+    return 0;
+}
+
+// =============================================================================
+// Active Objects
+// =============================================================================
+
+void ao_framework_init(void) {
+    memset(pools, 0, sizeof(pools));
+    pool_count = 0;
+    memset(levels, 0, sizeof(levels));
+    time_events = NULL;
+}
+
+void ao_ctor(ao_active_t* me, hsm_state_t initial) {
+    memset(me, 0, sizeof(*me));
+    hsm_ctor(&me->hsm, initial);
+}
+
+int ao_start(ao_active_t* me, uint8_t level, uint8_t prio,
+             const ao_event_t** queue, uint16_t queue_len, const ao_event_t* init_event) {
+    if (level >= AO_MAX_LEVELS || prio >= AO_MAX_PER_LEVEL || !queue || queue_len == 0) {
+        return -1;
+    }
+    if (levels[level].objects[prio]) {
+        return -2;  // Error: priority already taken
+    }
+
+    me->queue = queue;
+    me->queue_len = queue_len;
+    me->head = 0;
+    me->count = 0;
+    me->level = level;
+    me->prio = prio;
+    levels[level].objects[prio] = me;
+
+    hsm_init(&me->hsm, init_event);
+    return 0;
+}
+
+bool ao_post(ao_active_t* me, const ao_event_t* e) {
+    CRIT_STAT;
+    ao_level_t* level = &levels[me->level];
+    bool queued = false;
+
+    CRIT_ENTER();
+    if (me->count < me->queue_len) {
+        me->queue[(me->head + me->count) % me->queue_len] = e;
+        me->count = me->count + 1;
+        if (me->count > me->max_count) {
+            me->max_count = me->count;
+        }
+        if (e->pool != 0) {
+            ((ao_event_t*)e)->refs = e->refs + 1;
+        }
+        level->ready |= 1UL << me->prio;
+        queued = true;
+    } else {
+        me->dropped++;
+    }
+    CRIT_EXIT();
+
+    if (queued) {
+        wake_level(level);
+    } else if (e->refs == 0) {
+        ao_event_gc(e);  // Nobody else holds it
+    }
+    return queued;
+}
+
+bool ao_level_run_one(uint8_t level_index) {
+    CRIT_STAT;
+    ao_level_t* level = &levels[level_index];
+    ao_active_t* me;
+    const ao_event_t* e;
+
+    CRIT_ENTER();
+    if (level->ready == 0) {
+        CRIT_EXIT();
+        return false;
+    }
+
+    const uint32_t prio = 31U - (uint32_t)__builtin_clz(level->ready);
+    me = level->objects[prio];
+    e = me->queue[me->head];
+    me->head = (uint16_t)((me->head + 1) % me->queue_len);
+    me->count = me->count - 1;
+    if (me->count == 0) {
+        level->ready &= ~(1UL << prio);
+    }
+    CRIT_EXIT();
+
+    hsm_dispatch(&me->hsm, e);
+    ao_event_gc(e);
+    return true;
+}
+
+#if !defined(UNIT_TESTING)
+
+static StaticTask_t level_tcbs[AO_MAX_LEVELS];
+static StackType_t level_stacks[AO_MAX_LEVELS][AO_LEVEL_STACK_WORDS];
+
+static void level_task(void* pvParameters) {
+    const uint8_t level = (uint8_t)(uintptr_t)pvParameters;
+
+    while (1) {
+        while (ao_level_run_one(level)) {
+        }
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
+
+int ao_level_start(uint8_t level, uint32_t priority) {
+    if (level >= AO_MAX_LEVELS) {
+        return -1;
+    }
+
+    levels[level].task = xTaskCreateStatic(level_task, "AO_Level", AO_LEVEL_STACK_WORDS,
+                                           (void*)(uintptr_t)level, priority,
+                                           level_stacks[level], &level_tcbs[level]);
+    return levels[level].task ? 0 : -2;
+}
+
+#endif
+
+// =============================================================================
+// Time Events
+// =============================================================================
+
+void ao_time_event_ctor(ao_time_event_t* te, uint16_t sig, ao_active_t* target) {
+    memset(te, 0, sizeof(*te));
+    te->super.sig = sig;
+    te->target = target;
+}
+
+void ao_time_event_arm(ao_time_event_t* te, uint32_t ticks, uint32_t interval) {
+    CRIT_STAT;
+
+    CRIT_ENTER();
+    te->ctr = ticks ? ticks : 1;
+    te->interval = interval;
+    if (!te->linked) {
+        te->next = time_events;
+        time_events = te;
+        te->linked = true;
+    }
+    CRIT_EXIT();
+}
+
+bool ao_time_event_disarm(ao_time_event_t* te) {
+    CRIT_STAT;
+
+    // Unlinked lazily by ao_tick()
+    CRIT_ENTER();
+    const bool armed = (te->ctr != 0);
+    te->ctr = 0;
+    CRIT_EXIT();
+    return armed;
+}
+
+void ao_tick(void) {
+    CRIT_STAT;
+    ao_time_event_t** link = &time_events;
+
+    // One element per critical section; only ao_tick() unlinks, arming only
+    // pushes at the head, so the walk stays valid between sections
+    while (1) {
+        bool fire = false;
+
+        CRIT_ENTER();
+        ao_time_event_t* te = *link;
+        if (!te) {
+            CRIT_EXIT();
+            break;
+        }
+        if (te->ctr == 0) {
+            *link = te->next;
+            te->linked = false;
+            CRIT_EXIT();
+            continue;
+        }
+        te->ctr = te->ctr - 1;
+        if (te->ctr == 0) {
+            fire = true;
+            te->ctr = te->interval;
+        }
+        link = &te->next;
+        CRIT_EXIT();
+
+        if (fire) {
+            ao_post(te->target, &te->super);
+        }
+    }
+}
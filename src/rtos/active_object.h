@@ -0,0 +1,221 @@
+#pragma once
+
+/**
+ * @file active_object.h
+ * @brief Active objects: state machines with private event queues
+ *
+ * An active object is a hierarchical state machine (hsm.h) with its own
+ * queue of event pointers. Events are processed one at a time to
+ * completion, so an object's data is never touched concurrently and needs
+ * no mutex.
+ *
+ * Objects do not own a task. They are grouped into a few priority levels;
+ * each level is one FreeRTOS task that always dispatches the highest
+ * priority object of its level that has events pending. Objects of the same
+ * level share one stack, and a higher level preempts a lower one through
+ * the normal FreeRTOS scheduler.
+ *
+ * Events are either static (const, pool 0) or allocated from fixed-size
+ * pools with ao_event_new(). Pool events are passed by pointer, reference
+ * counted, and returned to their pool after the last consumer has
+ * processed them.
+ *
+ * Time events post themselves to an object after a number of ticks, once
+ * or periodically. ao_tick() must be called once per RTOS tick
+ * (vApplicationTickHook).
+ *
+ * ao_post() and ao_tick() are safe from tasks and from ISRs up to
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "hsm.h"
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef AO_MAX_LEVELS
+#define AO_MAX_LEVELS           2       // FreeRTOS tasks shared by all objects
+#endif
+
+#ifndef AO_MAX_PER_LEVEL
+#define AO_MAX_PER_LEVEL        8       // Objects per level (priorities 0..N-1)
+#endif
+
+#ifndef AO_MAX_POOLS
+#define AO_MAX_POOLS            3       // Event pools, registered smallest first
+#endif
+
+#ifndef AO_LEVEL_STACK_WORDS
+#define AO_LEVEL_STACK_WORDS    256
+#endif
+
+/**
+ * @brief Active Object
+ */
+typedef struct {
+    hsm_t hsm;                      // Must be first
+    const ao_event_t** queue;       // Ring of event pointers (caller storage)
+    uint16_t queue_len;
+    uint16_t head;
+    volatile uint16_t count;
+    uint16_t max_count;             // Queue high-water mark
+    uint32_t dropped;               // Posts rejected because the queue was full
+    uint8_t level;
+    uint8_t prio;                   // Within the level, higher runs first
+} ao_active_t;
+
+/**
+ * @brief Time Event
+ */
+typedef struct ao_time_event {
+    ao_event_t super;               // Must be first; static, never freed
+    struct ao_time_event* next;
+    ao_active_t* target;
+    volatile uint32_t ctr;          // Ticks until the next post, 0 when disarmed
+    uint32_t interval;              // Reload value, 0 for one-shot
+    bool linked;
+} ao_time_event_t;
+
+/**
+ * @brief Event Pool Statistics
+ */
+typedef struct {
+    uint16_t block_size;
+    uint16_t blocks;
+    uint16_t free;
+    uint16_t min_free;              // Low-water mark of free blocks
+    uint32_t failures;              // Allocations that found the pool empty
+} ao_pool_stats_t;
+
+// =============================================================================
+// Event Pools
+// =============================================================================
+
+/**
+ * @brief Register an event pool (call in ascending block size order)
+ * @param storage Static storage of blocks * block_size bytes, pointer aligned
+ * @param block_size Size of each event, at least sizeof(void*)
+ * @param blocks Number of events
+ * @return Pool id (1-based) on success, negative error code on failure
+ */
+int ao_pool_init(void* storage, size_t block_size, uint16_t blocks);
+
+/**
+ * @brief Allocate an event from the smallest pool that fits (task and ISR safe)
+ * @param size Event size in bytes
+ * @param sig Signal
+ * @return Event, or NULL if no pool can provide one
+ */
+ao_event_t* ao_event_new(size_t size, uint16_t sig);
+
+/**
+ * @brief Drop a reference to an event, freeing it when unused
+ * @param e Event (static events are ignored)
+ */
+void ao_event_gc(const ao_event_t* e);
+
+/**
+ * @brief Read pool statistics
+ * @param pool Pool id returned by ao_pool_init()
+ * @param out Destination
+ * @return 0 on success, negative error code on failure
+ */
+int ao_pool_get_stats(int pool, ao_pool_stats_t* out);
+
+#define AO_EVENT_NEW(type, sig)     ((type*)ao_event_new(sizeof(type), (sig)))
+
+// =============================================================================
+// Active Objects
+// =============================================================================
+
+/**
+ * @brief Reset the framework (pools, levels and time events)
+ */
+void ao_framework_init(void);
+
+/**
+ * @brief Construct an active object
+ * @param me Object
+ * @param initial Initial pseudo-state
+ */
+void ao_ctor(ao_active_t* me, hsm_state_t initial);
+
+/**
+ * @brief Attach an object to a level and run its initial transition
+ * @param me Object
+ * @param level Level index (0..AO_MAX_LEVELS-1)
+ * @param prio Priority within the level, unique (0..AO_MAX_PER_LEVEL-1)
+ * @param queue Queue storage
+ * @param queue_len Queue length
+ * @param init_event Event passed to the initial pseudo-state (may be NULL)
+ * @return 0 on success, negative error code on failure
+ */
+int ao_start(ao_active_t* me, uint8_t level, uint8_t prio,
+             const ao_event_t** queue, uint16_t queue_len, const ao_event_t* init_event);
+
+/**
+ * @brief Queue an event for an object (task and ISR safe)
+ * @param me Target object
+ * @param e Event
+ * @return true if queued; a rejected pool event is freed
+ */
+bool ao_post(ao_active_t* me, const ao_event_t* e);
+
+/**
+ * @brief Dispatch one event of the highest priority ready object of a level
+ * @param level Level index
+ * @return true if an event was dispatched
+ */
+bool ao_level_run_one(uint8_t level);
+
+/**
+ * @brief Create the FreeRTOS task serving a level
+ * @param level Level index
+ * @param priority FreeRTOS task priority
+ * @return 0 on success, negative error code on failure
+ */
+int ao_level_start(uint8_t level, uint32_t priority);
+
+// =============================================================================
+// Time Events
+// =============================================================================
+
+/**
+ * @brief Construct a time event
+ * @param te Time event
+ * @param sig Signal posted on expiry
+ * @param target Object receiving the event
+ */
+void ao_time_event_ctor(ao_time_event_t* te, uint16_t sig, ao_active_t* target);
+
+/**
+ * @brief Arm (or re-arm) a time event
+ * @param te Time event
+ * @param ticks Ticks until the first post, at least 1
+ * @param interval Ticks between later posts, 0 for one-shot
+ */
+void ao_time_event_arm(ao_time_event_t* te, uint32_t ticks, uint32_t interval);
+
+/**
+ * @brief Disarm a time event
+ * @param te Time event
+ * @return true if it was armed
+ */
+bool ao_time_event_disarm(ao_time_event_t* te);
+
+/**
+ * @brief Advance every armed time event by one tick (call from the tick hook)
+ */
+void ao_tick(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,252 @@
+/**
+ * @file coro.cpp
+ * @brief Coroutine frame pool, executor and awaitables
+ *
+ * The ready queue is shared with interrupt handlers and is only touched
+ * inside a CriticalSection. Waking the executor task calls into the kernel,
+ * so it always happens after the critical section is left. The timer list
+ * is only used from the executor task. Every live coroutine is queued at
+ * most once, so a ring of CORO_MAX_FRAMES entries cannot overflow.
+ */
+
+#include "coro.hpp"
+#include <cstdlib>
+
+namespace coro {
+
+// =============================================================================
+// Frame Pool
+// =============================================================================
+
+namespace {
+
+union FrameBlock {
+    FrameBlock* next;
+    alignas(std::max_align_t) unsigned char bytes[CORO_FRAME_BYTES];
+};
+
+FrameBlock frames[CORO_MAX_FRAMES];
+FrameBlock* free_list = nullptr;
+bool pool_ready = false;
+FramePoolStats stats = {};
+
+// Deadline a is earlier than deadline b (tick counter may wrap)
+inline bool before(uint32_t a, uint32_t b) {
+    return static_cast<int32_t>(a - b) < 0;
+}
+
+} // namespace
+
+void* frame_alloc(std::size_t size) noexcept {
+    CriticalSection cs;
+
+    if (!pool_ready) {
+        for (uint32_t i = 0; i < CORO_MAX_FRAMES; i++) {
+            frames[i].next = free_list;
+            free_list = &frames[i];
+        }
+        pool_ready = true;
+    }
+
+    if (size > sizeof(FrameBlock) || !free_list) {
+        stats.failures++;
+        return nullptr;
+    }
+
+    FrameBlock* block = free_list;
+    free_list = block->next;
+    if (++stats.in_use > stats.high_water) {
+        stats.high_water = stats.in_use;
+    }
+    return block;
+}
+
+void frame_free(void* frame) noexcept {
+    if (!frame) {
+        return;
+    }
+
+    CriticalSection cs;
+    FrameBlock* block = static_cast<FrameBlock*>(frame);
+    block->next = free_list;
+    free_list = block;
+    stats.in_use--;
+}
+
+FramePoolStats frame_pool_stats() noexcept {
+    CriticalSection cs;
+    return stats;
+}
+
+// =============================================================================
+// Task
+// =============================================================================
+
+void Task::promise_type::unhandled_exception() noexcept {
+    std::abort();
+}
+
+Task::promise_type::~promise_type() {
+    if (executor) {
+        executor->live_--;
+    }
+}
+
+// =============================================================================
+// Executor
+// =============================================================================
+
+bool Executor::spawn(Task&& task) {
+    if (!task.valid()) {
+        return false;
+    }
+
+    Task::handle_type handle = task.release();
+    handle.promise().executor = this;
+    live_++;
+    post(handle);
+    return true;
+}
+
+void Executor::post(std::coroutine_handle<> handle) {
+    {
+        CriticalSection cs;
+        ready_[(head_ + ready_count_) % CORO_MAX_FRAMES] = handle;
+        ready_count_ = ready_count_ + 1;
+    }
+
+#if !defined(UNIT_TESTING)
+    if (task_) {
+        if (xPortIsInsideInterrupt()) {
+            BaseType_t woken = pdFALSE;
+            vTaskNotifyGiveFromISR(task_, &woken);
+            portYIELD_FROM_ISR(woken);
+        } else if (xTaskGetCurrentTaskHandle() != task_) {
+            xTaskNotifyGive(task_);
+        }
+    }
+#endif
+}
+
+void Executor::add_timer(TimerNode* node, uint32_t ticks) {
+    node->deadline = now_ + ticks;
+
+    // Sorted insert; equal deadlines resume in arrival order
+    TimerNode** link = &timers_;
+    while (*link && !before(node->deadline, (*link)->deadline)) {
+        link = &(*link)->next;
+    }
+    node->next = *link;
+    *link = node;
+}
+
+uint32_t Executor::run_once(uint32_t now) {
+    now_ = now;
+
+    while (timers_ && !before(now, timers_->deadline)) {
+        TimerNode* node = timers_;
+        timers_ = node->next;
+        post(node->handle);
+    }
+
+    // Only resume what is ready now; coroutines posted while running wait
+    // for the next pass so one busy coroutine cannot starve the timers
+    uint32_t count = ready_count_;
+    while (count--) {
+        std::coroutine_handle<> handle;
+        {
+            CriticalSection cs;
+            handle = ready_[head_];
+            head_ = (head_ + 1) % CORO_MAX_FRAMES;
+            ready_count_ = ready_count_ - 1;
+        }
+        handle.resume();
+    }
+
+    if (!timers_) {
+        return CORO_WAIT_FOREVER;
+    }
+    return before(now, timers_->deadline) ? timers_->deadline - now : 0;
+}
+
+#if !defined(UNIT_TESTING)
+
+void Executor::task_entry(void* param) {
+    Executor* self = static_cast<Executor*>(param);
+
+    while (1) {
+        const uint32_t wait = self->run_once(static_cast<uint32_t>(xTaskGetTickCount()));
+        if (self->ready_count_ == 0) {
+            ulTaskNotifyTake(pdTRUE, (wait == CORO_WAIT_FOREVER) ? portMAX_DELAY : (TickType_t)wait);
+        }
+    }
+}
+
+int Executor::start(const char* name, UBaseType_t priority) {
+    task_ = xTaskCreateStatic(task_entry, name, CORO_EXECUTOR_STACK_WORDS, this, priority,
+                              stack_, &tcb_);
+    return task_ ? 0 : -1;
+}
+
+#endif
+
+// =============================================================================
+// Notification
+// =============================================================================
+
+void Notification::notify() {
+    std::coroutine_handle<> waiter;
+    {
+        CriticalSection cs;
+        count_ = count_ + 1;
+        waiter = std::exchange(waiter_, nullptr);
+    }
+    if (waiter) {
+        executor_->post(waiter);
+    }
+}
+
+bool Notification::Awaiter::await_suspend(Task::handle_type h) noexcept {
+    CriticalSection cs;
+    if (self.count_ != 0) {
+        return false;  // Notified between await_ready() and here
+    }
+    self.executor_ = h.promise().executor;
+    self.waiter_ = h;
+    return true;
+}
+
+uint32_t Notification::Awaiter::await_resume() noexcept {
+    CriticalSection cs;
+    const uint32_t count = self.count_;
+    self.count_ = 0;
+    return count;
+}
+
+// =============================================================================
+// GPIO Edge
+// =============================================================================
+
+GpioEdge* GpioEdge::lines_[GpioEdge::kLines] = {};
+
+GpioEdge::GpioEdge(uint16_t pin_mask) : line_(static_cast<uint32_t>(__builtin_ctz(pin_mask | 0x10000U))) {
+    if (line_ < kLines) {
+        lines_[line_] = this;
+    }
+}
+
+GpioEdge::~GpioEdge() {
+    if (line_ < kLines && lines_[line_] == this) {
+        lines_[line_] = nullptr;
+    }
+}
+
+void GpioEdge::dispatch(uint16_t pin_mask) {
+    for (uint32_t line = 0; line < kLines; line++) {
+        if ((pin_mask & (1U << line)) && lines_[line]) {
+            lines_[line]->notify();
+        }
+    }
+}
+
+} // namespace coro
@@ -0,0 +1,399 @@
+#pragma once
+
+/**
+ * @file coro.hpp
+ * @brief C++20 coroutine executor running on a single FreeRTOS task
+ *
+ * A coro::Task is a stackless coroutine: its locals live in a frame taken
+ * from a static pool (CORO_MAX_FRAMES blocks of CORO_FRAME_BYTES), not on
+ * a task stack. One Executor task resumes coroutines when the thing they
+ * await has happened, so hundreds of small state machines share one stack.
+ *
+ * Awaitables:
+ * - coro::delay(ticks): resume after a number of RTOS ticks
+ * - coro::Notification: counting signal, like a task notification
+ * - coro::GpioEdge: a Notification raised from the EXTI callback
+ * - coro::Completion<T>: one-shot result posted by a driver, typically from
+ *   its DMA/transfer-complete interrupt
+ *
+ * Notification, GpioEdge and Completion may be signalled from tasks and from
+ * ISRs up to configMAX_SYSCALL_INTERRUPT_PRIORITY.
+ *
+ * Example:
+ * @code
+ * coro::Task blink() {
+ *     while (true) {
+ *         HAL_GPIO_TogglePin(GPIOB, GPIO_PIN_3);
+ *         co_await coro::delay(pdMS_TO_TICKS(500));
+ *     }
+ * }
+ *
+ * coro::Task echo(Uart& uart) {
+ *     while (true) {
+ *         int status = co_await uart.write(buf, len);  // returns Completion<int>&
+ *         ...
+ *     }
+ * }
+ *
+ * static coro::Executor executor;
+ * executor.spawn(blink());
+ * executor.start("Coro", 1);
+ * @endcode
+ */
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef CORO_MAX_FRAMES
+#define CORO_MAX_FRAMES             32      // Coroutines alive at once
+#endif
+
+#ifndef CORO_FRAME_BYTES
+#define CORO_FRAME_BYTES            128     // Largest coroutine frame
+#endif
+
+#ifndef CORO_EXECUTOR_STACK_WORDS
+#define CORO_EXECUTOR_STACK_WORDS   256     // Shared by every coroutine
+#endif
+
+#define CORO_WAIT_FOREVER           0xFFFFFFFFUL
+
+#if !defined(UNIT_TESTING)
+extern "C" {
+#include "FreeRTOS.h"
+#include "task.h"
+}
+#endif
+
+namespace coro {
+
+class Executor;
+
+// =============================================================================
+// Frame Pool
+// =============================================================================
+
+/**
+ * @brief Frame Pool Statistics
+ */
+struct FramePoolStats {
+    uint32_t in_use;        // Frames currently allocated
+    uint32_t high_water;    // Most frames ever allocated at once
+    uint32_t failures;      // Spawns rejected (pool empty or frame too large)
+};
+
+void* frame_alloc(std::size_t size) noexcept;
+void frame_free(void* frame) noexcept;
+FramePoolStats frame_pool_stats() noexcept;
+
+// =============================================================================
+// Interrupt-safe critical section
+// =============================================================================
+
+class CriticalSection {
+public:
+#if !defined(UNIT_TESTING)
+    CriticalSection() : saved_(taskENTER_CRITICAL_FROM_ISR()) {}
+    ~CriticalSection() { taskEXIT_CRITICAL_FROM_ISR(saved_); }
+#else
+    CriticalSection() {}
+#endif
+    CriticalSection(const CriticalSection&) = delete;
+    CriticalSection& operator=(const CriticalSection&) = delete;
+
+private:
+#if !defined(UNIT_TESTING)
+    UBaseType_t saved_;
+#endif
+};
+
+// =============================================================================
+// Task
+// =============================================================================
+
+/**
+ * @brief Detached coroutine handle returned by coroutine functions
+ *
+ * A Task does nothing until it is passed to Executor::spawn(). If the frame
+ * pool is exhausted the Task is empty and spawn() returns false.
+ */
+class Task {
+public:
+    struct promise_type {
+        Executor* executor = nullptr;
+
+        Task get_return_object() noexcept {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        static Task get_return_object_on_allocation_failure() noexcept { return Task(); }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept;
+
+        static void* operator new(std::size_t size) noexcept { return frame_alloc(size); }
+        static void operator delete(void* frame) noexcept { frame_free(frame); }
+
+        ~promise_type();
+    };
+
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    Task() = default;
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() { reset(); }
+
+    bool valid() const { return static_cast<bool>(handle_); }
+
+private:
+    friend class Executor;
+    explicit Task(handle_type handle) : handle_(handle) {}
+
+    handle_type release() { return std::exchange(handle_, nullptr); }
+    void reset() {
+        if (handle_) {
+            handle_.destroy();  // Never spawned
+            handle_ = nullptr;
+        }
+    }
+
+    handle_type handle_ = nullptr;
+};
+
+// =============================================================================
+// Executor
+// =============================================================================
+
+/**
+ * @brief Timer list entry (lives in the awaiting coroutine's frame)
+ */
+struct TimerNode {
+    TimerNode* next = nullptr;
+    uint32_t deadline = 0;
+    std::coroutine_handle<> handle;
+};
+
+class Executor {
+public:
+    Executor() = default;
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /**
+     * @brief Queue a coroutine for its first resumption
+     * @param task Coroutine to run
+     * @return false if the task is empty (frame allocation failed)
+     */
+    bool spawn(Task&& task);
+
+    /**
+     * @brief Expire timers and resume every ready coroutine
+     * @param now Current time in ticks
+     * @return Ticks until the next timer, or CORO_WAIT_FOREVER
+     */
+    uint32_t run_once(uint32_t now);
+
+    /**
+     * @brief Make a suspended coroutine ready (task and ISR safe)
+     * @param handle Coroutine to resume
+     */
+    void post(std::coroutine_handle<> handle);
+
+    /**
+     * @brief Suspend a coroutine until a deadline
+     * @param node Timer entry in the coroutine frame
+     * @param ticks Delay from the executor's current time
+     */
+    void add_timer(TimerNode* node, uint32_t ticks);
+
+    uint32_t now() const { return now_; }
+    uint32_t live_tasks() const { return live_; }
+
+#if !defined(UNIT_TESTING)
+    /**
+     * @brief Create the FreeRTOS task that runs this executor
+     * @param name Task name
+     * @param priority Task priority
+     * @return 0 on success, negative error code on failure
+     */
+    int start(const char* name, UBaseType_t priority);
+#endif
+
+private:
+    friend struct Task::promise_type;
+
+    std::coroutine_handle<> ready_[CORO_MAX_FRAMES];
+    uint32_t head_ = 0;
+    volatile uint32_t ready_count_ = 0;
+    TimerNode* timers_ = nullptr;
+    uint32_t now_ = 0;
+    uint32_t live_ = 0;
+
+#if !defined(UNIT_TESTING)
+    static void task_entry(void* param);
+
+    TaskHandle_t task_ = nullptr;
+    StaticTask_t tcb_;
+    StackType_t stack_[CORO_EXECUTOR_STACK_WORDS];
+#endif
+};
+
+// =============================================================================
+// Awaitables
+// =============================================================================
+
+/**
+ * @brief Awaiter for coro::delay()
+ */
+struct DelayAwaiter : TimerNode {
+    uint32_t ticks;
+
+    explicit DelayAwaiter(uint32_t t) : ticks(t) {}
+    bool await_ready() const noexcept { return ticks == 0; }
+    void await_suspend(Task::handle_type h) noexcept {
+        handle = h;
+        h.promise().executor->add_timer(this, ticks);
+    }
+    void await_resume() const noexcept {}
+};
+
+/**
+ * @brief Suspend the calling coroutine for a number of ticks
+ */
+inline DelayAwaiter delay(uint32_t ticks) {
+    return DelayAwaiter(ticks);
+}
+
+/**
+ * @brief Counting notification with a single waiting coroutine
+ *
+ * `co_await notification` suspends until the count is non-zero, then
+ * returns the count and clears it (like ulTaskNotifyTake(pdTRUE, ...)).
+ */
+class Notification {
+public:
+    /**
+     * @brief Increment the count and wake the waiter (task and ISR safe)
+     */
+    void notify();
+
+    struct Awaiter {
+        Notification& self;
+
+        bool await_ready() const noexcept { return self.count_ != 0; }
+        bool await_suspend(Task::handle_type h) noexcept;
+        uint32_t await_resume() noexcept;
+    };
+
+    Awaiter operator co_await() noexcept { return Awaiter{*this}; }
+
+    uint32_t pending() const { return count_; }
+
+private:
+    volatile uint32_t count_ = 0;
+    std::coroutine_handle<> waiter_;
+    Executor* executor_ = nullptr;
+};
+
+/**
+ * @brief EXTI line edge as an awaitable notification
+ *
+ * The pin and its EXTI trigger are configured by the application; call
+ * coro::GpioEdge::dispatch() from HAL_GPIO_EXTI_Callback().
+ */
+class GpioEdge : public Notification {
+public:
+    explicit GpioEdge(uint16_t pin_mask);
+    ~GpioEdge();
+
+    /**
+     * @brief Notify every edge object attached to the given EXTI lines
+     * @param pin_mask GPIO_PIN_x mask passed to HAL_GPIO_EXTI_Callback()
+     */
+    static void dispatch(uint16_t pin_mask);
+
+private:
+    static constexpr uint32_t kLines = 16;
+    static GpioEdge* lines_[kLines];
+    uint32_t line_;
+};
+
+/**
+ * @brief One-shot driver completion carrying a result
+ *
+ * A driver owns one Completion per channel, resets it when it starts a
+ * transfer and completes it from its interrupt. Its asynchronous methods
+ * return the Completion by reference so callers can `co_await` them.
+ */
+template <typename T>
+class Completion {
+public:
+    /**
+     * @brief Arm for a new operation
+     */
+    void reset() {
+        CriticalSection cs;
+        done_ = false;
+    }
+
+    /**
+     * @brief Publish the result and wake the waiter (task and ISR safe)
+     * @param value Operation result
+     */
+    void complete(T value) {
+        std::coroutine_handle<> waiter;
+        {
+            CriticalSection cs;
+            value_ = value;
+            done_ = true;
+            waiter = std::exchange(waiter_, nullptr);
+        }
+        if (waiter) {
+            executor_->post(waiter);
+        }
+    }
+
+    bool done() const { return done_; }
+
+    struct Awaiter {
+        Completion& self;
+
+        bool await_ready() const noexcept { return self.done_; }
+        bool await_suspend(Task::handle_type h) noexcept {
+            CriticalSection cs;
+            if (self.done_) {
+                return false;  // Completed between await_ready() and here
+            }
+            self.executor_ = h.promise().executor;
+            self.waiter_ = h;
+            return true;
+        }
+        T await_resume() noexcept { return self.value_; }
+    };
+
+    Awaiter operator co_await() noexcept { return Awaiter{*this}; }
+
+private:
+    volatile bool done_ = false;
+    T value_{};
+    std::coroutine_handle<> waiter_;
+    Executor* executor_ = nullptr;
+};
+
+} // namespace coro
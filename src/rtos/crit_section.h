@@ -0,0 +1,28 @@
+#pragma once
+
+/**
+ * @file crit_section.h
+ * @brief Critical section usable from tasks and interrupts alike
+ *
+ * Wraps taskENTER_CRITICAL_FROM_ISR()/taskEXIT_CRITICAL_FROM_ISR(), which
+ * save and restore BASEPRI and so nest and are safe at any priority up to
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY. Unit tests run single-threaded and
+ * get empty stubs.
+ *
+ *     CRIT_STAT;
+ *     CRIT_ENTER();
+ *     ...
+ *     CRIT_EXIT();
+ */
+
+#if !defined(UNIT_TESTING)
+#include "FreeRTOS.h"
+#include "task.h"
+#define CRIT_STAT                   UBaseType_t crit_saved
+#define CRIT_ENTER()                (crit_saved = taskENTER_CRITICAL_FROM_ISR())
+#define CRIT_EXIT()                 taskEXIT_CRITICAL_FROM_ISR(crit_saved)
+#else
+#define CRIT_STAT
+#define CRIT_ENTER()
+#define CRIT_EXIT()
+#endif
@@ -0,0 +1,163 @@
+/**
+ * @file hsm.c
+ * @brief Hierarchical state machine processor
+ *
+ * The hierarchy is discovered at run time by sending HSM_SIG_EMPTY to a
+ * state, which answers with its parent. Ancestor chains are at most
+ * HSM_MAX_DEPTH long and live on the caller's stack.
+ */
+
+#include "hsm.h"
+
+static const ao_event_t reserved_events[] = {
+    { HSM_SIG_EMPTY, 0, 0 },
+    { HSM_SIG_ENTRY, 0, 0 },
+    { HSM_SIG_EXIT, 0, 0 },
+    { HSM_SIG_INIT, 0, 0 },
+};
+
+static hsm_ret_t trig(hsm_t* me, hsm_state_t state, uint16_t sig) {
+    return state(me, &reserved_events[sig]);
+}
+
+static hsm_state_t parent_of(hsm_t* me, hsm_state_t state) {
+    me->temp = hsm_top;
+    (void)trig(me, state, HSM_SIG_EMPTY);
+    return me->temp;
+}
+
+// Fill chain with state, its parent, ... up to and including stop (or
+// hsm_top); returns the number of entries
+static uint32_t ancestors(hsm_t* me, hsm_state_t state, hsm_state_t stop, hsm_state_t* chain) {
+    uint32_t n = 0;
+    while (n < HSM_MAX_DEPTH) {
+        chain[n++] = state;
+        if (state == stop || state == hsm_top) {
+            break;
+        }
+        state = parent_of(me, state);
+    }
+    return n;
+}
+
+// Enter chain[n-1] .. chain[0] (outermost first)
+static void enter_chain(hsm_t* me, const hsm_state_t* chain, uint32_t n) {
+    while (n > 0) {
+        (void)trig(me, chain[--n], HSM_SIG_ENTRY);
+    }
+}
+
+// Follow initial transitions from the current state down to a leaf
+static void drill_down(hsm_t* me) {
+    hsm_state_t chain[HSM_MAX_DEPTH];
+
+    while (trig(me, me->state, HSM_SIG_INIT) == HSM_RET_TRAN) {
+        const hsm_state_t target = me->temp;
+        const uint32_t n = ancestors(me, target, me->state, chain);
+        enter_chain(me, chain, n - 1);  // chain[n-1] is the already active state
+        me->state = target;
+    }
+    me->temp = me->state;
+}
+
+static void transition(hsm_t* me, hsm_state_t source, hsm_state_t target) {
+    hsm_state_t src_chain[HSM_MAX_DEPTH];
+    hsm_state_t tgt_chain[HSM_MAX_DEPTH];
+
+    if (source == target) {
+        // Self-transition: external, exit and re-enter
+        (void)trig(me, source, HSM_SIG_EXIT);
+        (void)trig(me, target, HSM_SIG_ENTRY);
+    } else {
+        const uint32_t ns = ancestors(me, source, hsm_top, src_chain);
+        const uint32_t nt = ancestors(me, target, hsm_top, tgt_chain);
+
+        // Least common ancestor: the first ancestor of the source that is
+        // also an ancestor of the target (or the target itself)
+        uint32_t is = 0;
+        uint32_t it = nt;
+        for (; is < ns; is++) {
+            for (it = 0; it < nt && tgt_chain[it] != src_chain[is]; it++) {
+            }
+            if (it < nt) {
+                break;
+            }
+        }
+
+        for (uint32_t i = 0; i < is; i++) {
+            (void)trig(me, src_chain[i], HSM_SIG_EXIT);
+        }
+        enter_chain(me, tgt_chain, it);
+    }
+
+    me->state = target;
+    drill_down(me);
+}
+
+// Public API implementations
+
+hsm_ret_t hsm_top(hsm_t* me, const ao_event_t* e) {
+    (void)me;
+    (void)e;
+    return HSM_RET_IGNORED;
+}
+
+void hsm_ctor(hsm_t* me, hsm_state_t initial) {
+    me->state = hsm_top;
+    me->temp = initial;
+}
+
+void hsm_init(hsm_t* me, const ao_event_t* e) {
+    hsm_state_t chain[HSM_MAX_DEPTH];
+    const hsm_state_t initial = me->temp;
+
+    if (initial(me, e ? e : &reserved_events[HSM_SIG_INIT]) != HSM_RET_TRAN) {
+        return;  // Initial pseudo-state must transition
+    }
+
+    const hsm_state_t target = me->temp;
+    const uint32_t n = ancestors(me, target, hsm_top, chain);
+    enter_chain(me, chain, n - 1);  // Skip hsm_top
+    me->state = target;
+    drill_down(me);
+}
+
+void hsm_dispatch(hsm_t* me, const ao_event_t* e) {
+    hsm_state_t source = me->state;
+    hsm_ret_t ret;
+
+    // Offer the event to the leaf state, then to each parent in turn
+    while (1) {
+        me->temp = source;
+        ret = source(me, e);
+        if (ret != HSM_RET_SUPER) {
+            break;
+        }
+        source = me->temp;
+    }
+
+    if (ret != HSM_RET_TRAN) {
+        me->temp = me->state;
+        return;
+    }
+
+    // The transition may be inherited from a parent: leave the substates first
+    const hsm_state_t target = me->temp;
+    for (hsm_state_t s = me->state; s != source; s = parent_of(me, s)) {
+        (void)trig(me, s, HSM_SIG_EXIT);
+    }
+    transition(me, source, target);
+}
+
+int hsm_is_in(hsm_t* me, hsm_state_t state) {
+    hsm_state_t chain[HSM_MAX_DEPTH];
+    const uint32_t n = ancestors(me, me->state, hsm_top, chain);
+    me->temp = me->state;
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (chain[i] == state) {
+            return 1;
+        }
+    }
+    return 0;
+}
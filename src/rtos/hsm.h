@@ -0,0 +1,127 @@
+#pragma once
+
+/**
+ * @file hsm.h
+ * @brief Hierarchical state machine processor
+ *
+ * A state is a handler function. It handles an event and returns one of
+ * HSM_HANDLED(), HSM_TRAN(target) or HSM_SUPER(parent); every handler ends
+ * with `default: return HSM_SUPER(parent);`, and the outermost states use
+ * hsm_top as parent. Entry, exit and initial transitions are delivered as
+ * the reserved signals below.
+ *
+ * Transitions follow UML semantics: states are exited up to the least
+ * common ancestor of source and target, then entered down to the target,
+ * then initial transitions are followed until a leaf state is reached.
+ *
+ * @code
+ * static hsm_ret_t blinky_on(hsm_t* me, const ao_event_t* e) {
+ *     switch (e->sig) {
+ *     case HSM_SIG_ENTRY: led_on(); return HSM_HANDLED();
+ *     case SIG_TIMEOUT:   return HSM_TRAN(blinky_off);
+ *     default:            return HSM_SUPER(blinky_active);
+ *     }
+ * }
+ * @endcode
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef HSM_MAX_DEPTH
+#define HSM_MAX_DEPTH       6       // Deepest state nesting, including hsm_top
+#endif
+
+/**
+ * @brief Reserved Signals
+ */
+enum {
+    HSM_SIG_EMPTY = 0,  // Parent query; handlers must return HSM_SUPER()
+    HSM_SIG_ENTRY,
+    HSM_SIG_EXIT,
+    HSM_SIG_INIT,
+    HSM_SIG_USER        // First application signal
+};
+
+/**
+ * @brief Event Header (embed as the first member of application events)
+ */
+typedef struct {
+    uint16_t sig;               // Signal
+    uint8_t pool;               // Owning event pool, 0 for static events
+    volatile uint8_t refs;      // Outstanding references (pool events only)
+} ao_event_t;
+
+typedef uint8_t hsm_ret_t;
+
+typedef struct hsm hsm_t;
+typedef hsm_ret_t (*hsm_state_t)(hsm_t* me, const ao_event_t* e);
+
+/**
+ * @brief State Machine Base (embed as the first member of a state machine)
+ */
+struct hsm {
+    hsm_state_t state;      // Current leaf state
+    hsm_state_t temp;       // Transition target or parent, set by handlers
+};
+
+#define HSM_RET_HANDLED     0
+#define HSM_RET_IGNORED     1
+#define HSM_RET_TRAN        2
+#define HSM_RET_SUPER       3
+
+// Handlers may take a pointer to the derived state machine type
+#define HSM_STATE(handler)  ((hsm_state_t)(void (*)(void))(handler))
+
+#define HSM_HANDLED()       ((hsm_ret_t)HSM_RET_HANDLED)
+#define HSM_TRAN(target)    (((hsm_t*)(me))->temp = HSM_STATE(target), (hsm_ret_t)HSM_RET_TRAN)
+#define HSM_SUPER(parent)   (((hsm_t*)(me))->temp = HSM_STATE(parent), (hsm_ret_t)HSM_RET_SUPER)
+
+// =============================================================================
+// State Machine API
+// =============================================================================
+
+/**
+ * @brief Outermost state: ignores every event
+ */
+hsm_ret_t hsm_top(hsm_t* me, const ao_event_t* e);
+
+/**
+ * @brief Set the initial pseudo-state (a handler that returns HSM_TRAN())
+ * @param me State machine
+ * @param initial Initial pseudo-state
+ */
+void hsm_ctor(hsm_t* me, hsm_state_t initial);
+
+/**
+ * @brief Take the initial transition and enter the initial leaf state
+ * @param me State machine
+ * @param e Initialization event passed to the pseudo-state (may be NULL)
+ */
+void hsm_init(hsm_t* me, const ao_event_t* e);
+
+/**
+ * @brief Process one event to completion
+ * @param me State machine
+ * @param e Event
+ */
+void hsm_dispatch(hsm_t* me, const ao_event_t* e);
+
+/**
+ * @brief Check whether a state is active (the leaf state or one of its parents)
+ * @param me State machine
+ * @param state State to test
+ * @return 1 if active, 0 otherwise
+ */
+int hsm_is_in(hsm_t* me, hsm_state_t state);
+
+#ifdef __cplusplus
+}
+#endif
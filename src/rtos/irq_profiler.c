@@ -0,0 +1,151 @@
+/**
+ * @file irq_profiler.c
+ * @brief DWT-timed interrupt-masking profiler
+ *
+ * Entry points are called inside masked sections, but a BASEPRI section
+ * (taskENTER_CRITICAL) still admits interrupts above
+ * configMAX_SYSCALL_INTERRUPT_PRIORITY, which may mask and profile too.
+ * The bookkeeping therefore runs with PRIMASK set. Such an interrupt
+ * arriving inside a profiled section is folded into that section.
+ */
+
+#include "irq_profiler.h"
+#include "hal_dwt.h"
+#include <string.h>
+
+#if defined(UNIT_TESTING)
+#define IRQPROF_LOCK(saved)     ((void)(saved))
+#define IRQPROF_UNLOCK(saved)   ((void)(saved))
+#else
+#include "cmsis_compiler.h"
+#define IRQPROF_LOCK(saved)     do { (saved) = __get_PRIMASK(); __disable_irq(); } while (0)
+#define IRQPROF_UNLOCK(saved)   __set_PRIMASK(saved)
+#endif
+
+irqprof_stats_t g_irqprof_stats;
+
+static uint32_t nesting = 0;
+static uint32_t section_start = 0;
+static uintptr_t section_pc = 0;
+static uint32_t worst_floor = 0;    // Shortest duration currently in the worst table
+
+uint32_t irqprof_bucket(uint32_t cycles) {
+    uint32_t bucket = 0;
+    while (cycles > 1U && bucket < IRQPROF_HISTOGRAM_BUCKETS - 1U) {
+        cycles >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+// The table is kept sorted by max_cycles, longest first, so the last
+// entry is the floor and the one a new site replaces
+static void record_worst(uintptr_t pc, uint32_t cycles) {
+    irqprof_site_t* sites = g_irqprof_stats.worst;
+    uint32_t slot = IRQPROF_WORST_SITES - 1U;
+
+    for (uint32_t i = 0; i < IRQPROF_WORST_SITES; i++) {
+        if (sites[i].pc == pc) {
+            slot = i;
+            break;
+        }
+    }
+
+    if (sites[slot].pc != pc) {
+        sites[slot].pc = pc;
+        sites[slot].max_cycles = 0;
+        sites[slot].count = 0;
+    }
+    sites[slot].count++;
+    if (cycles > sites[slot].max_cycles) {
+        sites[slot].max_cycles = cycles;
+    }
+
+    // Only this entry grew: move it up to its place
+    while (slot > 0 && sites[slot].max_cycles > sites[slot - 1U].max_cycles) {
+        const irqprof_site_t tmp = sites[slot - 1U];
+        sites[slot - 1U] = sites[slot];
+        sites[slot] = tmp;
+        slot--;
+    }
+
+    worst_floor = sites[IRQPROF_WORST_SITES - 1U].max_cycles;
+}
+
+// Public API implementations
+
+int irqprof_init(void) {
+    irqprof_reset();
+    if (!hal_dwt_is_enabled()) {
+        return hal_dwt_init();
+    }
+    return 0;
+}
+
+void irqprof_reset(void) {
+    memset(&g_irqprof_stats, 0, sizeof(g_irqprof_stats));
+    worst_floor = 0;
+}
+
+void irqprof_enter_at(uintptr_t pc) {
+    uint32_t primask;
+    IRQPROF_LOCK(primask);
+    if (nesting++ == 0) {
+        section_pc = pc;
+        section_start = hal_dwt_get_cycles();
+    }
+    IRQPROF_UNLOCK(primask);
+}
+
+__attribute__((noinline)) void irqprof_enter(void) {
+    irqprof_enter_at((uintptr_t)__builtin_return_address(0));
+}
+
+void irqprof_exit(void) {
+    uint32_t primask;
+    IRQPROF_LOCK(primask);
+    if (nesting == 0 || --nesting != 0) {
+        // Nested, or unbalanced (e.g. profiler reset inside a section)
+        IRQPROF_UNLOCK(primask);
+        return;
+    }
+
+    const uint32_t cycles = hal_dwt_get_cycles() - section_start;
+    irqprof_stats_t* stats = &g_irqprof_stats;
+
+    stats->sections++;
+    stats->total_cycles += cycles;
+    stats->histogram[irqprof_bucket(cycles)]++;
+
+    if (cycles > stats->max_cycles) {
+        stats->max_cycles = cycles;
+        stats->max_pc = section_pc;
+    }
+
+    // Fast path: most sections are shorter than anything in the table
+    if (cycles > worst_floor) {
+        record_worst(section_pc, cycles);
+    }
+    IRQPROF_UNLOCK(primask);
+}
+
+// =============================================================================
+// Kernel critical section wrappers (-Wl,--wrap=vPortEnterCritical,...)
+// =============================================================================
+
+#if defined(IRQ_PROFILER_ENABLED) && !defined(UNIT_TESTING)
+
+void __real_vPortEnterCritical(void);
+void __real_vPortExitCritical(void);
+
+void __wrap_vPortEnterCritical(void) {
+    __real_vPortEnterCritical();
+    irqprof_enter_at((uintptr_t)__builtin_return_address(0));
+}
+
+void __wrap_vPortExitCritical(void) {
+    irqprof_exit();
+    __real_vPortExitCritical();
+}
+
+#endif
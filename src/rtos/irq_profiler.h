@@ -0,0 +1,132 @@
+#pragma once
+
+/**
+ * @file irq_profiler.h
+ * @brief Interrupt-masking latency profiler
+ *
+ * Measures how long interrupts stay masked, using the DWT cycle counter.
+ * Only the outermost section of a nest is timed. For every section the
+ * profiler updates a log2 histogram of durations and keeps the worst call
+ * sites (caller PC and longest duration), so the code responsible for the
+ * system's worst-case interrupt latency can be identified with
+ * `info symbol <pc>` in GDB.
+ *
+ * Coverage:
+ * - taskENTER_CRITICAL()/taskEXIT_CRITICAL(): the build links with
+ *   -Wl,--wrap=vPortEnterCritical,--wrap=vPortExitCritical when
+ *   ENABLE_IRQ_PROFILER is ON, so every kernel and application critical
+ *   section is timed without patching the kernel.
+ * - Direct PRIMASK/BASEPRI masking in application and driver code: use the
+ *   IRQPROF_* macros below instead of __disable_irq()/__enable_irq() and
+ *   taskENTER_CRITICAL_FROM_ISR()/taskEXIT_CRITICAL_FROM_ISR().
+ *
+ * Masking done with inline CMSIS intrinsics inside third-party code (the
+ * STM32Cube HAL, portDISABLE_INTERRUPTS in portmacro.h) cannot be
+ * intercepted from here.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef IRQPROF_HISTOGRAM_BUCKETS
+#define IRQPROF_HISTOGRAM_BUCKETS   20      // Bucket i: [2^i, 2^(i+1)) cycles, last is open-ended
+#endif
+
+#ifndef IRQPROF_WORST_SITES
+#define IRQPROF_WORST_SITES         8       // Distinct call sites kept, longest first
+#endif
+
+/**
+ * @brief Masked-Section Call Site
+ */
+typedef struct {
+    uintptr_t pc;           // Return address of the masking call
+    uint32_t max_cycles;    // Longest masked duration seen from this site
+    uint32_t count;         // Sections from this site that entered the table
+} irqprof_site_t;
+
+/**
+ * @brief Profiler Statistics
+ */
+typedef struct {
+    uint32_t sections;                              // Outermost sections measured
+    uint32_t max_cycles;                            // Longest masked section
+    uintptr_t max_pc;                               // Call site of the longest section
+    uint64_t total_cycles;                          // Sum of all masked time
+    uint32_t histogram[IRQPROF_HISTOGRAM_BUCKETS];
+    irqprof_site_t worst[IRQPROF_WORST_SITES];
+} irqprof_stats_t;
+
+extern irqprof_stats_t g_irqprof_stats;
+
+// =============================================================================
+// Profiler API
+// =============================================================================
+
+/**
+ * @brief Start the cycle counter and clear statistics
+ * @return 0 on success, negative error code on failure
+ */
+int irqprof_init(void);
+
+/**
+ * @brief Clear statistics
+ */
+void irqprof_reset(void);
+
+/**
+ * @brief Mark the start of a masked section (call after masking)
+ * @param pc Call site to attribute the section to
+ */
+void irqprof_enter_at(uintptr_t pc);
+
+/**
+ * @brief Mark the start of a masked section, attributed to the caller
+ */
+void irqprof_enter(void);
+
+/**
+ * @brief Mark the end of a masked section (call before unmasking)
+ */
+void irqprof_exit(void);
+
+/**
+ * @brief Histogram bucket index for a duration
+ * @param cycles Duration in cycles
+ * @return Bucket index
+ */
+uint32_t irqprof_bucket(uint32_t cycles);
+
+// =============================================================================
+// Instrumented Masking Macros
+// =============================================================================
+
+#if defined(IRQ_PROFILER_ENABLED)
+
+#define IRQPROF_DISABLE_IRQ()   do { __disable_irq(); irqprof_enter(); } while (0)
+#define IRQPROF_ENABLE_IRQ()    do { irqprof_exit(); __enable_irq(); } while (0)
+
+#define IRQPROF_ENTER_CRITICAL_FROM_ISR(saved) \
+    do { (saved) = taskENTER_CRITICAL_FROM_ISR(); irqprof_enter(); } while (0)
+#define IRQPROF_EXIT_CRITICAL_FROM_ISR(saved) \
+    do { irqprof_exit(); taskEXIT_CRITICAL_FROM_ISR(saved); } while (0)
+
+#else
+
+#define IRQPROF_DISABLE_IRQ()                   __disable_irq()
+#define IRQPROF_ENABLE_IRQ()                    __enable_irq()
+#define IRQPROF_ENTER_CRITICAL_FROM_ISR(saved)  ((saved) = taskENTER_CRITICAL_FROM_ISR())
+#define IRQPROF_EXIT_CRITICAL_FROM_ISR(saved)   taskEXIT_CRITICAL_FROM_ISR(saved)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,234 @@
+/**
+ * @file job_scheduler.c
+ * @brief Deadline-ordered job heap and its worker task
+ *
+ * Deadlines are compared with signed differences so the tick counter may
+ * wrap. Heap updates happen inside a critical section; callbacks run
+ * outside of it.
+ */
+
+#include "job_scheduler.h"
+#include <string.h>
+
+#if !defined(UNIT_TESTING)
+#include "FreeRTOS.h"
+#include "task.h"
+#define JOB_ENTER_CRITICAL()    taskENTER_CRITICAL()
+#define JOB_EXIT_CRITICAL()     taskEXIT_CRITICAL()
+#else
+#define JOB_ENTER_CRITICAL()
+#define JOB_EXIT_CRITICAL()
+#endif
+
+static job_t* heap[JOB_SCHED_MAX_JOBS];
+static uint32_t heap_size = 0;
+
+#if !defined(UNIT_TESTING)
+static TaskHandle_t worker = NULL;
+#endif
+
+// true if deadline a is earlier than deadline b
+static inline bool before(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+static void heap_place(uint32_t index, job_t* job) {
+    heap[index] = job;
+    job->heap_index = (uint8_t)index;
+}
+
+static void sift_up(uint32_t index) {
+    job_t* job = heap[index];
+    while (index > 0) {
+        const uint32_t parent = (index - 1) / 2;
+        if (!before(job->deadline, heap[parent]->deadline)) {
+            break;
+        }
+        heap_place(index, heap[parent]);
+        index = parent;
+    }
+    heap_place(index, job);
+}
+
+static void sift_down(uint32_t index) {
+    job_t* job = heap[index];
+    while (1) {
+        uint32_t child = 2 * index + 1;
+        if (child >= heap_size) {
+            break;
+        }
+        if (child + 1 < heap_size && before(heap[child + 1]->deadline, heap[child]->deadline)) {
+            child++;
+        }
+        if (!before(heap[child]->deadline, job->deadline)) {
+            break;
+        }
+        heap_place(index, heap[child]);
+        index = child;
+    }
+    heap_place(index, job);
+}
+
+static void heap_remove(job_t* job) {
+    const uint32_t index = job->heap_index;
+    job_t* last = heap[--heap_size];
+    if (index == heap_size) {
+        return;
+    }
+
+    heap_place(index, last);
+    if (index > 0 && before(last->deadline, heap[(index - 1) / 2]->deadline)) {
+        sift_up(index);
+    } else {
+        sift_down(index);
+    }
+}
+
+static void heap_insert(job_t* job) {
+    heap[heap_size] = job;
+    sift_up(heap_size++);
+}
+
+// Public API implementations
+
+int job_scheduler_init(void) {
+    memset(heap, 0, sizeof(heap));
+    heap_size = 0;
+    return 0;
+}
+
+void job_init(job_t* job, const char* name, job_callback_t callback, void* arg) {
+    if (!job) {
+        return;
+    }
+    memset(job, 0, sizeof(*job));
+    job->name = name;
+    job->callback = callback;
+    job->arg = arg;
+}
+
+int job_start(job_t* job, uint32_t now, uint32_t delay, uint32_t period) {
+    if (!job || !job->callback) {
+        return -1;
+    }
+
+    JOB_ENTER_CRITICAL();
+    if (job->state == JOB_SCHEDULED) {
+        heap_remove(job);
+    } else if (heap_size >= JOB_SCHED_MAX_JOBS) {
+        JOB_EXIT_CRITICAL();
+        return -2;  // Error: heap full
+    }
+
+    job->deadline = now + delay;
+    job->period = period;
+    job->state = JOB_SCHEDULED;
+    heap_insert(job);
+    JOB_EXIT_CRITICAL();
+
+#if !defined(UNIT_TESTING)
+    // The worker may be sleeping towards a later deadline
+    if (worker) {
+        xTaskNotifyGive(worker);
+    }
+#endif
+    return 0;
+}
+
+void job_cancel(job_t* job) {
+    if (!job) {
+        return;
+    }
+
+    JOB_ENTER_CRITICAL();
+    if (job->state == JOB_SCHEDULED) {
+        heap_remove(job);
+    }
+    // A running job is simply not rescheduled when its callback returns
+    job->state = JOB_IDLE;
+    JOB_EXIT_CRITICAL();
+}
+
+uint32_t job_scheduler_run_due(job_clock_t clock) {
+    if (!clock) {
+        return JOB_SCHED_FOREVER;
+    }
+
+    while (1) {
+        const uint32_t now = clock();
+
+        JOB_ENTER_CRITICAL();
+        if (heap_size == 0) {
+            JOB_EXIT_CRITICAL();
+            return JOB_SCHED_FOREVER;
+        }
+
+        job_t* job = heap[0];
+        if (before(now, job->deadline)) {
+            const uint32_t wait = job->deadline - now;
+            JOB_EXIT_CRITICAL();
+            return wait;
+        }
+
+        heap_remove(job);
+        job->state = JOB_RUNNING;
+        const uint32_t late = now - job->deadline;
+        if (late > job->max_late) {
+            job->max_late = late;
+        }
+        JOB_EXIT_CRITICAL();
+
+        job->callback(job->arg);
+
+        JOB_ENTER_CRITICAL();
+        job->runs++;
+        if (job->state == JOB_RUNNING) {
+            if (job->period == 0) {
+                job->state = JOB_IDLE;
+            } else {
+                // Next release follows the previous deadline; skip any
+                // releases that are already in the past
+                const uint32_t missed = late / job->period;
+                job->overruns += missed;
+                job->deadline += (missed + 1) * job->period;
+                job->state = JOB_SCHEDULED;
+                heap_insert(job);
+            }
+        }
+        JOB_EXIT_CRITICAL();
+    }
+}
+
+uint32_t job_scheduler_count(void) {
+    return heap_size;
+}
+
+// =============================================================================
+// Worker task
+// =============================================================================
+
+#if !defined(UNIT_TESTING)
+
+static StaticTask_t worker_tcb;
+static StackType_t worker_stack[JOB_SCHED_STACK_WORDS];
+
+static uint32_t tick_clock(void) {
+    return (uint32_t)xTaskGetTickCount();
+}
+
+static void job_worker(void* pvParameters) {
+    (void)pvParameters;
+
+    while (1) {
+        const uint32_t wait = job_scheduler_run_due(tick_clock);
+        ulTaskNotifyTake(pdTRUE, (wait == JOB_SCHED_FOREVER) ? portMAX_DELAY : (TickType_t)wait);
+    }
+}
+
+int job_scheduler_start(uint32_t priority) {
+    worker = xTaskCreateStatic(job_worker, "Jobs", JOB_SCHED_STACK_WORDS, NULL, priority,
+                               worker_stack, &worker_tcb);
+    return worker ? 0 : -1;
+}
+
+#endif
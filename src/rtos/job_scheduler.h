@@ -0,0 +1,134 @@
+#pragma once
+
+/**
+ * @file job_scheduler.h
+ * @brief Periodic and one-shot jobs multiplexed on a single worker task
+ *
+ * Small periodic activities (blinkers, heartbeats, polling) do not need a
+ * task and a stack each. A job is a callback with a deadline, kept in a
+ * binary min-heap ordered by deadline. One worker task sleeps until the
+ * earliest deadline, runs every due job and goes back to sleep.
+ *
+ * Periodic jobs are rescheduled from their previous deadline, not from the
+ * time they ran, so they do not drift. A job that falls a whole period or
+ * more behind skips the missed releases and counts them as overruns.
+ *
+ * Jobs are caller-owned (typically static) and must stay alive while
+ * scheduled. Callbacks run on the worker task and must not block; the
+ * scheduling functions are for task context only.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef JOB_SCHED_MAX_JOBS
+#define JOB_SCHED_MAX_JOBS      32      // Jobs that can be scheduled at once
+#endif
+
+#ifndef JOB_SCHED_STACK_WORDS
+#define JOB_SCHED_STACK_WORDS   256     // Worker stack, shared by every job
+#endif
+
+#define JOB_SCHED_FOREVER       0xFFFFFFFFUL
+
+typedef void (*job_callback_t)(void* arg);
+
+// Current time in ticks
+typedef uint32_t (*job_clock_t)(void);
+
+/**
+ * @brief Job State
+ */
+typedef enum {
+    JOB_IDLE = 0,
+    JOB_SCHEDULED,
+    JOB_RUNNING
+} job_state_t;
+
+/**
+ * @brief Job Control Block
+ */
+typedef struct {
+    const char* name;
+    job_callback_t callback;
+    void* arg;
+    uint32_t period;        // Ticks between releases, 0 for one-shot
+    uint32_t deadline;      // Next release time in ticks
+    uint32_t runs;          // Completed executions
+    uint32_t overruns;      // Releases skipped because the job fell behind
+    uint32_t max_late;      // Worst release-to-start delay in ticks
+    job_state_t state;
+    uint8_t heap_index;
+} job_t;
+
+// =============================================================================
+// Job Scheduler API
+// =============================================================================
+
+/**
+ * @brief Clear the job heap
+ * @return 0 on success, negative error code on failure
+ */
+int job_scheduler_init(void);
+
+/**
+ * @brief Initialize a job control block
+ * @param job Job to initialize
+ * @param name Name for debugging
+ * @param callback Function to run
+ * @param arg Argument passed to the callback
+ */
+void job_init(job_t* job, const char* name, job_callback_t callback, void* arg);
+
+/**
+ * @brief Schedule a job (reschedules it if already scheduled)
+ * @param job Initialized job
+ * @param now Current time in ticks
+ * @param delay Ticks until the first release
+ * @param period Ticks between releases, 0 for one-shot
+ * @return 0 on success, negative error code on failure
+ */
+int job_start(job_t* job, uint32_t now, uint32_t delay, uint32_t period);
+
+/**
+ * @brief Remove a job from the schedule (safe from its own callback)
+ * @param job Job to cancel
+ */
+void job_cancel(job_t* job);
+
+/**
+ * @brief Run every job whose deadline has passed
+ *
+ * The clock is read again after each callback, so jobs that fall due
+ * while others run are run too and the returned wait starts from the
+ * time the last callback finished.
+ *
+ * @param clock Time source
+ * @return Ticks until the next deadline, or JOB_SCHED_FOREVER if none
+ */
+uint32_t job_scheduler_run_due(job_clock_t clock);
+
+/**
+ * @brief Number of scheduled jobs
+ * @return Job count
+ */
+uint32_t job_scheduler_count(void);
+
+/**
+ * @brief Create the worker task
+ * @param priority Task priority
+ * @return 0 on success, negative error code on failure
+ */
+int job_scheduler_start(uint32_t priority);
+
+#ifdef __cplusplus
+}
+#endif
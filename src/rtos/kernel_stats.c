@@ -0,0 +1,225 @@
+/**
+ * @file kernel_stats.c
+ * @brief Aggregated kernel object contention counters
+ *
+ * All entry points except the reporting API run from kernel hooks, i.e.
+ * with the scheduler suspended or interrupts masked, so plain read-modify-
+ * write updates are sufficient.
+ */
+
+#include "kernel_stats.h"
+#include "hal_dwt.h"
+#include <string.h>
+
+#if !defined(UNIT_TESTING)
+#include "FreeRTOS.h"
+#include "task.h"
+#define KSTATS_ENTER_CRITICAL()     taskENTER_CRITICAL()
+#define KSTATS_EXIT_CRITICAL()      taskEXIT_CRITICAL()
+#else
+#define KSTATS_ENTER_CRITICAL()
+#define KSTATS_EXIT_CRITICAL()
+#endif
+
+// A task waiting on an object: which object and since when
+typedef struct {
+    uint8_t object;
+    uint32_t start;
+} pending_wait_t;
+
+static kstats_object_t objects[KSTATS_MAX_OBJECTS];
+static pending_wait_t pending[KSTATS_MAX_TASKS + 1];
+static uint32_t cpu_hz = 80000000;
+
+static kstats_object_t* lookup(uint32_t object) {
+    if (object < 1 || object > KSTATS_MAX_OBJECTS) {
+        return NULL;
+    }
+    return &objects[object - 1];
+}
+
+static pending_wait_t* lookup_wait(uint32_t task) {
+    if (task < 1 || task > KSTATS_MAX_TASKS) {
+        return NULL;
+    }
+    return &pending[task];
+}
+
+// Close a pending wait of @p task on @p obj; returns true if one was open
+static bool complete_wait(kstats_object_t* obj, uint32_t object, uint32_t task) {
+    pending_wait_t* wait = lookup_wait(task);
+    if (!wait || wait->object != object) {
+        return false;
+    }
+
+    const uint32_t blocked = hal_dwt_get_cycles() - wait->start;
+    wait->object = 0;
+
+    obj->total_blocked_cycles += blocked;
+    if (blocked > obj->max_blocked_cycles) {
+        obj->max_blocked_cycles = blocked;
+    }
+    return true;
+}
+
+// Hook entry points
+
+void kstats_object_create(uint32_t object, uint8_t type, uint32_t length) {
+    kstats_object_t* obj = lookup(object);
+    if (!obj) {
+        return;
+    }
+    memset(obj, 0, sizeof(*obj));
+    obj->in_use = true;
+    obj->type = type;
+    obj->length = (uint16_t)length;
+}
+
+void kstats_object_name(uint32_t object, const char* name) {
+    kstats_object_t* obj = lookup(object);
+    if (!obj || !name) {
+        return;
+    }
+    strncpy(obj->name, name, KSTATS_NAME_LEN - 1);
+    obj->name[KSTATS_NAME_LEN - 1] = '\0';
+}
+
+void kstats_block(uint32_t object, uint32_t task) {
+    kstats_object_t* obj = lookup(object);
+    pending_wait_t* wait = lookup_wait(task);
+    if (!obj || !wait) {
+        return;
+    }
+
+    // The kernel re-blocks after a spurious wake; count the wait only once
+    if (wait->object == object) {
+        return;
+    }
+
+    wait->object = (uint8_t)object;
+    wait->start = hal_dwt_get_cycles();
+    obj->block_count++;
+}
+
+void kstats_send(uint32_t object, uint32_t task, uint32_t depth_after) {
+    kstats_object_t* obj = lookup(object);
+    if (!obj) {
+        return;
+    }
+
+    obj->send_count++;
+    if (depth_after > obj->length) {
+        depth_after = obj->length;  // Overwrite on a full queue
+    }
+    if (depth_after > obj->peak_depth) {
+        obj->peak_depth = (uint16_t)depth_after;
+    }
+    complete_wait(obj, object, task);
+}
+
+void kstats_receive(uint32_t object, uint32_t task) {
+    kstats_object_t* obj = lookup(object);
+    if (!obj) {
+        return;
+    }
+
+    obj->receive_count++;
+    complete_wait(obj, object, task);
+}
+
+void kstats_peek(uint32_t object, uint32_t task) {
+    kstats_object_t* obj = lookup(object);
+    if (!obj) {
+        return;
+    }
+    complete_wait(obj, object, task);
+}
+
+void kstats_failed(uint32_t object, uint32_t task) {
+    kstats_object_t* obj = lookup(object);
+    if (!obj) {
+        return;
+    }
+
+    // Only a wait that actually blocked counts as a timeout
+    if (complete_wait(obj, object, task)) {
+        obj->timeout_count++;
+    }
+}
+
+void kstats_priority_inherit(uint32_t blocked_task) {
+    pending_wait_t* wait = lookup_wait(blocked_task);
+    if (!wait) {
+        return;
+    }
+
+    kstats_object_t* obj = lookup(wait->object);
+    if (obj) {
+        obj->inherit_count++;
+    }
+}
+
+// Reporting API
+
+int kstats_init(uint32_t hz) {
+    if (hz != 0) {
+        cpu_hz = hz;
+    }
+
+    // Shares the cycle counter with the trace recorder; only start it once
+    if (!hal_dwt_is_enabled()) {
+        return hal_dwt_init();
+    }
+    return 0;
+}
+
+void kstats_reset(void) {
+    KSTATS_ENTER_CRITICAL();
+    for (uint32_t i = 0; i < KSTATS_MAX_OBJECTS; i++) {
+        kstats_object_t* obj = &objects[i];
+        obj->peak_depth = 0;
+        obj->send_count = 0;
+        obj->receive_count = 0;
+        obj->block_count = 0;
+        obj->timeout_count = 0;
+        obj->inherit_count = 0;
+        obj->max_blocked_cycles = 0;
+        obj->total_blocked_cycles = 0;
+    }
+    memset(pending, 0, sizeof(pending));
+    KSTATS_EXIT_CRITICAL();
+}
+
+int kstats_get(uint32_t object, kstats_object_t* out) {
+    const kstats_object_t* obj = lookup(object);
+    if (!obj || !out) {
+        return -1;
+    }
+    if (!obj->in_use) {
+        return -2;
+    }
+
+    KSTATS_ENTER_CRITICAL();
+    *out = *obj;
+    KSTATS_EXIT_CRITICAL();
+    return 0;
+}
+
+uint32_t kstats_most_contended(void) {
+    uint32_t best = 0;
+    uint64_t best_cycles = 0;
+
+    for (uint32_t i = 0; i < KSTATS_MAX_OBJECTS; i++) {
+        if (objects[i].in_use && objects[i].total_blocked_cycles > best_cycles) {
+            best_cycles = objects[i].total_blocked_cycles;
+            best = i + 1;
+        }
+    }
+    return best;
+}
+
+uint32_t kstats_cycles_to_us(uint64_t cycles) {
+    // Whole seconds and the remainder separately: exact for any clock
+    // (MSI runs below 1 MHz) without overflowing the 64-bit product
+    return (uint32_t)((cycles / cpu_hz) * 1000000U + (cycles % cpu_hz) * 1000000U / cpu_hz);
+}
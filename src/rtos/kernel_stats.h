@@ -0,0 +1,109 @@
+#pragma once
+
+/**
+ * @file kernel_stats.h
+ * @brief Aggregated contention metrics for queues, semaphores and mutexes
+ *
+ * Fed from the same FreeRTOS trace hooks as the trace recorder (see
+ * trace_hooks.h), but instead of an event stream it keeps a handful of
+ * counters per kernel object: blocking waits, total and worst blocked time,
+ * timeouts, peak queue depth and priority-inheritance events. The cost is a
+ * few loads and stores per kernel call, so it can stay enabled in
+ * production builds.
+ *
+ * Objects are numbered in creation order and named when they are added to
+ * the queue registry (vQueueAddToRegistry, sized by configQUEUE_REGISTRY_SIZE).
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef KSTATS_MAX_OBJECTS
+#define KSTATS_MAX_OBJECTS      16      // Objects beyond this number are not tracked
+#endif
+
+#ifndef KSTATS_MAX_TASKS
+#define KSTATS_MAX_TASKS        16      // Tasks beyond this number are not tracked
+#endif
+
+#define KSTATS_NAME_LEN         16
+
+/**
+ * @brief Per-Object Contention Counters
+ */
+typedef struct {
+    char name[KSTATS_NAME_LEN];     // Registry name ("" if never registered)
+    bool in_use;                    // Object has been created
+    uint8_t type;                   // FreeRTOS queueQUEUE_TYPE_* value
+    uint16_t length;                // Capacity in items
+    uint16_t peak_depth;            // Highest number of items ever waiting
+    uint32_t send_count;            // Successful sends/gives
+    uint32_t receive_count;         // Successful receives/takes
+    uint32_t block_count;           // Waits that had to block
+    uint32_t timeout_count;         // Blocking waits that expired
+    uint32_t inherit_count;         // Priority inheritance triggered by this mutex
+    uint32_t max_blocked_cycles;    // Longest single blocking wait
+    uint64_t total_blocked_cycles;  // Sum of all blocking waits
+} kstats_object_t;
+
+// =============================================================================
+// Hook Entry Points (called from trace_hooks.h)
+// =============================================================================
+
+void kstats_object_create(uint32_t object, uint8_t type, uint32_t length);
+void kstats_object_name(uint32_t object, const char* name);
+void kstats_block(uint32_t object, uint32_t task);
+void kstats_send(uint32_t object, uint32_t task, uint32_t depth_after);
+void kstats_receive(uint32_t object, uint32_t task);
+void kstats_peek(uint32_t object, uint32_t task);
+void kstats_failed(uint32_t object, uint32_t task);
+void kstats_priority_inherit(uint32_t blocked_task);
+
+// =============================================================================
+// Reporting API
+// =============================================================================
+
+/**
+ * @brief Clear all counters (names and object types are kept)
+ */
+void kstats_reset(void);
+
+/**
+ * @brief Copy the counters of one object
+ * @param object Object number (1-based, as used by the trace recorder)
+ * @param out Destination
+ * @return 0 on success, negative error code if the object is not tracked
+ */
+int kstats_get(uint32_t object, kstats_object_t* out);
+
+/**
+ * @brief Find the object with the largest total blocked time
+ * @return Object number, or 0 if no task ever blocked
+ */
+uint32_t kstats_most_contended(void);
+
+/**
+ * @brief Convert cycles to microseconds using the configured clock
+ * @param cycles DWT cycle count
+ * @return Microseconds
+ */
+uint32_t kstats_cycles_to_us(uint64_t cycles);
+
+/**
+ * @brief Start the cycle counter and set the clock used for time conversion
+ * @param cpu_hz Core clock frequency
+ * @return 0 on success, negative error code on failure
+ */
+int kstats_init(uint32_t cpu_hz);
+
+#ifdef __cplusplus
+}
+#endif
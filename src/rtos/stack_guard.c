@@ -0,0 +1,123 @@
+/**
+ * @file stack_guard.c
+ * @brief MPU guard region below the running task's stack
+ */
+
+#include "stack_guard.h"
+#include <string.h>
+
+#if !defined(UNIT_TESTING)
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stm32l4xx.h"
+#define STACK_GUARD_NOINIT  __attribute__((section(".noinit")))
+#else
+#define STACK_GUARD_NOINIT
+#endif
+
+#define STACK_GUARD_MAGIC   0x53544B47U     // "STKG"
+
+// Written by the fault handler; validated by its magic on the next boot
+static stack_guard_fault_record_t fault_record STACK_GUARD_NOINIT;
+static stack_guard_fault_record_t previous_record;
+static bool previous_valid = false;
+
+static void latch_previous_record(void) {
+    previous_valid = (fault_record.magic == STACK_GUARD_MAGIC);
+    if (previous_valid) {
+        previous_record = fault_record;
+    }
+
+    // Keep the fault counter across boots, clear everything else
+    const uint32_t faults = previous_valid ? fault_record.faults : 0;
+    memset(&fault_record, 0, sizeof(fault_record));
+    fault_record.faults = faults;
+}
+
+// Public API implementations
+
+bool stack_guard_record_fault(const char* task_name, uint32_t cfsr, uint32_t mmfar,
+                              uint32_t guard_base) {
+    const bool address_valid = (cfsr & STACK_GUARD_CFSR_MMARVALID) != 0;
+
+    // Exception entry pushes onto the task stack, so a guard hit while
+    // stacking reports MSTKERR/MLSPERR without a fault address
+    bool overflow = (cfsr & (STACK_GUARD_CFSR_MSTKERR | STACK_GUARD_CFSR_MLSPERR)) != 0;
+    if (address_valid && mmfar >= guard_base && mmfar - guard_base < STACK_GUARD_SIZE) {
+        overflow = true;
+    }
+
+    memset(fault_record.task_name, 0, sizeof(fault_record.task_name));
+    if (task_name) {
+        strncpy(fault_record.task_name, task_name, STACK_GUARD_NAME_LEN - 1);
+    }
+    fault_record.guard_base = guard_base;
+    fault_record.fault_address = address_valid ? mmfar : 0;
+    fault_record.cfsr = cfsr;
+    fault_record.overflow = overflow;
+    fault_record.faults++;
+    fault_record.magic = STACK_GUARD_MAGIC;
+    return overflow;
+}
+
+bool stack_guard_get_fault_record(stack_guard_fault_record_t* out) {
+    if (!previous_valid) {
+        return false;
+    }
+    if (out) {
+        *out = previous_record;
+    }
+    return true;
+}
+
+#if defined(UNIT_TESTING)
+
+int stack_guard_init(void) {
+    latch_previous_record();
+    return 0;
+}
+
+#else
+
+int stack_guard_init(void) {
+    latch_previous_record();
+
+    if (((MPU->TYPE & MPU_TYPE_DREGION_Msk) >> MPU_TYPE_DREGION_Pos) <= STACK_GUARD_REGION) {
+        return -1;  // Error: no MPU or too few regions
+    }
+
+    // Park the region on the start of flash until the first task switch;
+    // RASR is constant, so each switch only rewrites RBAR
+    MPU->CTRL = 0;
+    MPU->RNR = STACK_GUARD_REGION;
+    MPU->RBAR = FLASH_BASE;
+    MPU->RASR = STACK_GUARD_RASR;
+
+    // HFNMIENA = 0 bypasses the MPU only for HardFault, NMI and code run
+    // with FAULTMASK set; MemManage_Handler runs with the guard active, on
+    // the main stack, and never writes the task stack it covers
+    MPU->CTRL = MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_ENABLE_Msk;
+    SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk;
+    __DSB();
+    __ISB();
+    return 0;
+}
+
+// Replaces the weak alias to Default_Handler in the startup file
+void MemManage_Handler(void) {
+    const uint32_t cfsr = SCB->CFSR;
+    const uint32_t mmfar = SCB->MMFAR;
+
+    // RNR still selects the guard region, so RBAR reads back its base
+    const uint32_t guard_base = MPU->RBAR & MPU_RBAR_ADDR_Msk;
+
+    const char* name = NULL;
+    if (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) {
+        name = pcTaskGetName(NULL);
+    }
+    stack_guard_record_fault(name, cfsr, mmfar, guard_base);
+
+    NVIC_SystemReset();
+}
+
+#endif
@@ -0,0 +1,128 @@
+#pragma once
+
+/**
+ * @file stack_guard.h
+ * @brief MPU guard region below the running task's stack
+ *
+ * One MPU region (STACK_GUARD_REGION) covers the lowest STACK_GUARD_SIZE
+ * aligned bytes of the running task's stack and is made read-only. The
+ * traceTASK_SWITCHED_IN hook (trace_hooks.h) moves it to the incoming task
+ * with a single RBAR write, so a push past the end of the stack faults on
+ * the offending instruction instead of being found later by a pattern
+ * check. All other memory keeps the default map (PRIVDEFENA).
+ *
+ * The region is read-only rather than no-access so that a task can still
+ * read its own stack watermark (uxTaskGetStackHighWaterMark(NULL)).
+ *
+ * The first task runs unguarded until its first switch: the scheduler
+ * starts it without traceTASK_SWITCHED_IN, so the region stays parked on
+ * FLASH_BASE until the next context switch.
+ *
+ * The guard costs between STACK_GUARD_SIZE and 2 * STACK_GUARD_SIZE - 1
+ * bytes of each task stack, depending on the stack's alignment.
+ *
+ * On a guard hit MemManage_Handler() records the task name and fault
+ * address in .noinit RAM and resets the MCU; the record is read back after
+ * the reset with stack_guard_get_fault_record().
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#define STACK_GUARD_SIZE        32U     // Smallest ARMv7-M MPU region
+#define STACK_GUARD_REGION      7U      // Highest number wins on overlap
+#define STACK_GUARD_NAME_LEN    16
+
+// MPU_RBAR: VALID selects the region from the REGION field in the same write
+#define STACK_GUARD_RBAR_VALID  (1UL << 4)
+
+// MPU_RASR: XN, AP = privileged read-only, SIZE = log2(32) - 1, ENABLE
+#define STACK_GUARD_RASR        ((1UL << 28) | (5UL << 24) | (4UL << 1) | 1UL)
+
+// MemManage fault status bits (SCB->CFSR[7:0])
+#define STACK_GUARD_CFSR_DACCVIOL   (1UL << 1)
+#define STACK_GUARD_CFSR_MSTKERR    (1UL << 4)
+#define STACK_GUARD_CFSR_MLSPERR    (1UL << 5)
+#define STACK_GUARD_CFSR_MMARVALID  (1UL << 7)
+
+/**
+ * @brief Fault Record (kept in .noinit RAM across the reset)
+ */
+typedef struct {
+    uint32_t magic;
+    char task_name[STACK_GUARD_NAME_LEN];   // Task running at the fault
+    uint32_t guard_base;                    // Its guard region
+    uint32_t fault_address;                 // MMFAR, 0 if not captured
+    uint32_t cfsr;                          // Configurable fault status
+    bool overflow;                          // Fault hit the stack guard
+    uint32_t faults;                        // Consecutive faulting boots
+} stack_guard_fault_record_t;
+
+// =============================================================================
+// Guard API
+// =============================================================================
+
+/**
+ * @brief RBAR value placing the guard at the bottom of a stack
+ * @param stack_low Lowest address of the stack (TCB pxStack)
+ * @return Aligned guard base with the VALID and REGION fields set
+ */
+static inline uint32_t stack_guard_rbar(uintptr_t stack_low) {
+    const uint32_t base = ((uint32_t)stack_low + STACK_GUARD_SIZE - 1U) & ~(STACK_GUARD_SIZE - 1U);
+    return base | STACK_GUARD_RBAR_VALID | STACK_GUARD_REGION;
+}
+
+#if !defined(UNIT_TESTING)
+
+#define STACK_GUARD_MPU_RBAR    (*(volatile uint32_t*)0xE000ED9CUL)
+
+/**
+ * @brief Move the guard to the incoming task (context switch, interrupts masked)
+ * @param stack_low Lowest address of the task's stack
+ */
+static inline void stack_guard_switch_in(const void* stack_low) {
+    STACK_GUARD_MPU_RBAR = stack_guard_rbar((uintptr_t)stack_low);
+}
+
+#endif
+
+/**
+ * @brief Latch the previous boot's fault record, program the guard region
+ *        and enable the MPU and the MemManage fault
+ *
+ * Call before the scheduler starts; the first task switch places the guard
+ * (the task the scheduler starts first is unguarded until then).
+ *
+ * @return 0 on success, negative error code if the MPU is missing
+ */
+int stack_guard_init(void);
+
+/**
+ * @brief Classify a MemManage fault and write the fault record
+ * @param task_name Task running at the fault (may be NULL)
+ * @param cfsr SCB->CFSR
+ * @param mmfar SCB->MMFAR
+ * @param guard_base Base of the guard region active at the fault
+ * @return true if the fault was a stack overflow into the guard
+ */
+bool stack_guard_record_fault(const char* task_name, uint32_t cfsr, uint32_t mmfar,
+                              uint32_t guard_base);
+
+/**
+ * @brief Read the fault record left by the previous boot
+ * @param out Destination
+ * @return true if the previous reset followed a MemManage fault
+ */
+bool stack_guard_get_fault_record(stack_guard_fault_record_t* out);
+
+#ifdef __cplusplus
+}
+#endif
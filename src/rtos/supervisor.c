@@ -0,0 +1,179 @@
+/**
+ * @file supervisor.c
+ * @brief Task liveness supervisor driving the independent watchdog
+ *
+ * Registration happens before the scheduler starts and supervisor_poll()
+ * only runs in the supervisor task, so the only shared state is the
+ * check-in word (atomic) and the live mask (atomic).
+ */
+
+#include "supervisor.h"
+#include <string.h>
+
+#if !defined(UNIT_TESTING)
+#include "FreeRTOS.h"
+#include "task.h"
+#include "hal_watchdog.h"
+#define SUPERVISOR_NOINIT   __attribute__((section(".noinit")))
+#else
+#define SUPERVISOR_NOINIT
+#endif
+
+#define SUPERVISOR_MAGIC    0x53555056U     // "SUPV"
+
+typedef struct {
+    char name[SUPERVISOR_NAME_LEN];
+    uint32_t deadline_ms;
+    uint32_t last_seen_ms;
+} supervised_task_t;
+
+volatile uint32_t g_supervisor_checkins = 0;
+
+static supervised_task_t tasks[SUPERVISOR_MAX_TASKS];
+static uint32_t task_count = 0;
+static volatile uint32_t live_mask = 0;
+static uint32_t reported_mask = 0;
+static bool stalled = false;
+
+// Survives the watchdog reset; validated by its magic on the next boot
+static supervisor_reset_record_t reset_record SUPERVISOR_NOINIT;
+static supervisor_reset_record_t previous_record;
+static bool previous_valid = false;
+
+// Public API implementations
+
+int supervisor_init(void) {
+    previous_valid = (reset_record.magic == SUPERVISOR_MAGIC);
+    if (previous_valid) {
+        previous_record = reset_record;
+    }
+
+    // Keep the reset counter across boots, clear everything else
+    const uint32_t resets = previous_valid ? reset_record.watchdog_resets : 0;
+    memset(&reset_record, 0, sizeof(reset_record));
+    reset_record.watchdog_resets = resets;
+
+    memset(tasks, 0, sizeof(tasks));
+    task_count = 0;
+    live_mask = 0;
+    reported_mask = 0;
+    stalled = false;
+    g_supervisor_checkins = 0;
+    return 0;
+}
+
+int supervisor_register(const char* name, uint32_t deadline_ms) {
+    if (task_count >= SUPERVISOR_MAX_TASKS) {
+        return -1;  // Error: no free check-in bit
+    }
+    if (deadline_ms == 0) {
+        return -2;
+    }
+
+    const uint32_t id = task_count++;
+    if (name) {
+        strncpy(tasks[id].name, name, SUPERVISOR_NAME_LEN - 1);
+    }
+    tasks[id].deadline_ms = deadline_ms;
+    tasks[id].last_seen_ms = 0;
+    supervisor_set_live((int)id, true);
+    return (int)id;
+}
+
+void supervisor_set_live(int id, bool live) {
+    if (id < 0 || (uint32_t)id >= task_count) {
+        return;
+    }
+
+    const uint32_t bit = 1UL << (uint32_t)id;
+    if (live) {
+        // Resuming counts as a check-in so the deadline restarts from now
+        supervisor_checkin(id);
+        __atomic_fetch_or(&live_mask, bit, __ATOMIC_RELAXED);
+    } else {
+        __atomic_fetch_and(&live_mask, ~bit, __ATOMIC_RELAXED);
+    }
+}
+
+supervisor_result_t supervisor_poll(uint32_t now_ms) {
+    if (stalled) {
+        return SUPERVISOR_STALLED;  // Latched until the watchdog resets the MCU
+    }
+
+    const uint32_t checkins = __atomic_exchange_n(&g_supervisor_checkins, 0, __ATOMIC_RELAXED);
+    const uint32_t live = live_mask;
+
+    uint32_t late = 0;
+    for (uint32_t id = 0; id < task_count; id++) {
+        const uint32_t bit = 1UL << id;
+        if (checkins & bit) {
+            tasks[id].last_seen_ms = now_ms;
+        } else if ((live & bit) && (now_ms - tasks[id].last_seen_ms) > tasks[id].deadline_ms) {
+            late |= bit;
+        }
+    }
+
+    if (late) {
+        const uint32_t first = (uint32_t)__builtin_ctz(late);
+        reset_record.magic = SUPERVISOR_MAGIC;
+        reset_record.stalled_mask = late;
+        memcpy(reset_record.task_name, tasks[first].name, SUPERVISOR_NAME_LEN);
+        reset_record.uptime_ms = now_ms;
+        reset_record.watchdog_resets++;
+        stalled = true;
+        return SUPERVISOR_STALLED;
+    }
+
+    reported_mask |= checkins;
+    if ((reported_mask & live) == live) {
+        reported_mask = 0;
+        return SUPERVISOR_FEED;
+    }
+    return SUPERVISOR_WAIT;
+}
+
+bool supervisor_get_reset_record(supervisor_reset_record_t* out) {
+    if (!previous_valid) {
+        return false;
+    }
+    if (out) {
+        *out = previous_record;
+    }
+    return true;
+}
+
+// =============================================================================
+// Supervisor task
+// =============================================================================
+
+#if !defined(UNIT_TESTING)
+
+static StaticTask_t supervisor_tcb;
+static StackType_t supervisor_stack[configMINIMAL_STACK_SIZE];
+
+static void supervisor_task(void* pvParameters) {
+    (void)pvParameters;
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(SUPERVISOR_PERIOD_MS));
+
+        const uint32_t now_ms = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+        if (supervisor_poll(now_ms) == SUPERVISOR_FEED) {
+            hal_watchdog_refresh();
+        }
+    }
+}
+
+int supervisor_start(uint32_t priority) {
+    if (hal_watchdog_init(SUPERVISOR_WATCHDOG_MS) != 0) {
+        return -1;
+    }
+
+    // Statically allocated so a heap exhaustion cannot take the supervisor down
+    TaskHandle_t handle = xTaskCreateStatic(supervisor_task, "Supervisor", configMINIMAL_STACK_SIZE,
+                                            NULL, priority, supervisor_stack, &supervisor_tcb);
+    return handle ? 0 : -2;
+}
+
+#endif
@@ -0,0 +1,123 @@
+#pragma once
+
+/**
+ * @file supervisor.h
+ * @brief Task liveness supervisor driving the independent watchdog
+ *
+ * Monitored tasks register once with a deadline and then check in from
+ * their main loop. A check-in is a single atomic OR of the task's bit into
+ * a shared word, so it is cheap enough for tight loops and ISRs.
+ *
+ * The supervisor task collects the bits periodically. It refreshes the
+ * watchdog only after every live task has reported; when a task misses its
+ * deadline the supervisor writes which task stalled into a .noinit record
+ * and stops refreshing, so the watchdog resets the MCU. The record survives
+ * the reset and can be read back with supervisor_get_reset_record().
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#define SUPERVISOR_MAX_TASKS        32      // One bit per task in the check-in word
+#define SUPERVISOR_NAME_LEN         16
+
+#ifndef SUPERVISOR_PERIOD_MS
+#define SUPERVISOR_PERIOD_MS        100
+#endif
+
+#ifndef SUPERVISOR_WATCHDOG_MS
+#define SUPERVISOR_WATCHDOG_MS      4000    // Must exceed the longest deadline
+#endif
+
+/**
+ * @brief Supervisor Poll Result
+ */
+typedef enum {
+    SUPERVISOR_WAIT,        // Some live tasks have not reported yet
+    SUPERVISOR_FEED,        // Every live task reported: refresh the watchdog
+    SUPERVISOR_STALLED      // A live task missed its deadline: let the watchdog expire
+} supervisor_result_t;
+
+/**
+ * @brief Stall Record (kept in .noinit RAM across the watchdog reset)
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t stalled_mask;              // Bits of every task past its deadline
+    char task_name[SUPERVISOR_NAME_LEN];// First stalled task
+    uint32_t uptime_ms;                 // Time of detection
+    uint32_t watchdog_resets;           // Consecutive supervisor resets
+} supervisor_reset_record_t;
+
+// Check-in word, written by monitored tasks and consumed by the supervisor
+extern volatile uint32_t g_supervisor_checkins;
+
+// =============================================================================
+// Supervisor API
+// =============================================================================
+
+/**
+ * @brief Reset registrations and latch the stall record of the previous boot
+ * @return 0 on success, negative error code on failure
+ */
+int supervisor_init(void);
+
+/**
+ * @brief Register a task to be monitored (call before supervisor_start)
+ * @param name Task name recorded on a stall
+ * @param deadline_ms Longest allowed interval between check-ins
+ * @return Check-in id on success, negative error code on failure
+ */
+int supervisor_register(const char* name, uint32_t deadline_ms);
+
+/**
+ * @brief Report liveness (task and ISR safe, one atomic OR)
+ * @param id Check-in id returned by supervisor_register(); a failed
+ *        registration's negative id is ignored
+ */
+static inline void supervisor_checkin(int id) {
+    if (id < 0 || id >= SUPERVISOR_MAX_TASKS) {
+        return;
+    }
+    __atomic_fetch_or(&g_supervisor_checkins, 1UL << (uint32_t)id, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Pause or resume monitoring of a task (e.g. around a long suspend)
+ * @param id Check-in id
+ * @param live true to monitor the task
+ */
+void supervisor_set_live(int id, bool live);
+
+/**
+ * @brief Collect check-ins and evaluate deadlines
+ * @param now_ms Current time in milliseconds
+ * @return What to do with the watchdog
+ */
+supervisor_result_t supervisor_poll(uint32_t now_ms);
+
+/**
+ * @brief Read the stall record left by the previous boot
+ * @param out Destination
+ * @return true if the previous reset was a supervisor stall
+ */
+bool supervisor_get_reset_record(supervisor_reset_record_t* out);
+
+/**
+ * @brief Start the watchdog and create the supervisor task
+ * @param priority Task priority (should be above every monitored task)
+ * @return 0 on success, negative error code on failure
+ */
+int supervisor_start(uint32_t priority);
+
+#ifdef __cplusplus
+}
+#endif
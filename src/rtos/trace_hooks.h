@@ -0,0 +1,191 @@
+#pragma once
+
+/**
+ * @file trace_hooks.h
+ * @brief FreeRTOS trace macro definitions
+ *
+ * Included at the end of FreeRTOSConfig.h. The macros expand inside the
+ * kernel sources (tasks.c, queue.c), so they may reference kernel-private
+ * fields such as pxCurrentTCB->uxTCBNumber and pxQueue->uxQueueNumber,
+ * which exist because configUSE_TRACE_FACILITY is enabled.
+ *
+ * Each hook fans out to the consumers enabled in FreeRTOSConfig.h:
+ * - configUSE_TRACE_RECORDER: raw event stream (trace_recorder.h)
+ * - configUSE_KERNEL_STATS: aggregated contention counters (kernel_stats.h)
+ * - configUSE_MPU_STACK_GUARD: per-task MPU stack guard (stack_guard.h),
+ *   moved on every switch-in
+ */
+
+#if !defined(configUSE_TRACE_RECORDER)
+#define configUSE_TRACE_RECORDER    0
+#endif
+
+#if !defined(configUSE_KERNEL_STATS)
+#define configUSE_KERNEL_STATS      0
+#endif
+
+#if !defined(configUSE_MPU_STACK_GUARD)
+#define configUSE_MPU_STACK_GUARD   0
+#endif
+
+#if (configUSE_TRACE_RECORDER == 1) || (configUSE_KERNEL_STATS == 1)
+// Object numbering is owned by the recorder module even when only the
+// statistics consumer is enabled
+#include "trace_recorder.h"
+#endif
+
+#if (configUSE_KERNEL_STATS == 1)
+#include "kernel_stats.h"
+#endif
+
+#if (configUSE_MPU_STACK_GUARD == 1)
+#include "stack_guard.h"
+#endif
+
+// =============================================================================
+// Per-consumer fragments
+// =============================================================================
+
+#if (configUSE_TRACE_RECORDER == 1)
+#define TRACE_REC(type, id, data)   trace_record((type), (uint8_t)(id), (uint16_t)(data))
+#define TRACE_REC_TASK_CREATE(pxNewTCB) \
+    trace_task_create((pxNewTCB)->uxTCBNumber, (pxNewTCB)->pcTaskName, (pxNewTCB)->uxPriority)
+#define TRACE_REC_OBJECT_NAME(number, name) trace_object_name((number), (name))
+#else
+#define TRACE_REC(type, id, data)
+#define TRACE_REC_TASK_CREATE(pxNewTCB)
+#define TRACE_REC_OBJECT_NAME(number, name)
+#endif
+
+#if (configUSE_KERNEL_STATS == 1)
+// Queue hooks run in queue.c, where pxCurrentTCB is not visible
+#define KSTATS_CURRENT_TASK()               uxTaskGetTaskNumber(xTaskGetCurrentTaskHandle())
+#define KSTATS(call)                        call
+#else
+#define KSTATS(call)
+#endif
+
+#if (configUSE_MPU_STACK_GUARD == 1)
+#define STACK_GUARD_SWITCH_IN()     stack_guard_switch_in(pxCurrentTCB->pxStack)
+#else
+#define STACK_GUARD_SWITCH_IN()
+#endif
+
+#define QUEUE_NUMBER(pxQueue)   ((pxQueue)->uxQueueNumber)
+#define QUEUE_WAITING(pxQueue)  ((pxQueue)->uxMessagesWaiting)
+
+#if (configUSE_TRACE_RECORDER == 1) || (configUSE_KERNEL_STATS == 1)
+
+// =============================================================================
+// Task events (tasks.c)
+// =============================================================================
+
+#define traceTASK_SWITCHED_OUT() \
+    TRACE_REC(TRACE_EVT_TASK_SWITCHED_OUT, pxCurrentTCB->uxTCBNumber, pxCurrentTCB->uxPriority)
+
+#define traceMOVED_TASK_TO_READY_STATE(pxTCB) \
+    TRACE_REC(TRACE_EVT_TASK_READY, (pxTCB)->uxTCBNumber, (pxTCB)->uxPriority)
+
+#define traceTASK_DELAY() \
+    TRACE_REC(TRACE_EVT_TASK_DELAY, pxCurrentTCB->uxTCBNumber, xTicksToDelay)
+
+#define traceTASK_CREATE(pxNewTCB) \
+    TRACE_REC_TASK_CREATE(pxNewTCB)
+
+// The blocked task (pxCurrentTCB) has just recorded which mutex it waits on
+#define traceTASK_PRIORITY_INHERIT(pxTCBOfMutexHolder, uxInheritedPriority) \
+    do { \
+        TRACE_REC(TRACE_EVT_PRIORITY_INHERIT, (pxTCBOfMutexHolder)->uxTCBNumber, uxInheritedPriority); \
+        KSTATS(kstats_priority_inherit(pxCurrentTCB->uxTCBNumber)); \
+    } while (0)
+
+#define traceTASK_PRIORITY_DISINHERIT(pxTCBOfMutexHolder, uxOriginalPriority) \
+    TRACE_REC(TRACE_EVT_PRIORITY_DISINHERIT, (pxTCBOfMutexHolder)->uxTCBNumber, uxOriginalPriority)
+
+// =============================================================================
+// Queue, semaphore and mutex events (queue.c)
+// =============================================================================
+
+#define traceQUEUE_CREATE(pxNewQueue) \
+    do { \
+        (pxNewQueue)->uxQueueNumber = trace_next_object_number(); \
+        TRACE_REC(TRACE_EVT_QUEUE_CREATE, QUEUE_NUMBER(pxNewQueue), (pxNewQueue)->ucQueueType); \
+        KSTATS(kstats_object_create(QUEUE_NUMBER(pxNewQueue), (pxNewQueue)->ucQueueType, \
+                                    (pxNewQueue)->uxLength)); \
+    } while (0)
+
+#define traceQUEUE_REGISTRY_ADD(xQueue, pcQueueName) \
+    do { \
+        TRACE_REC_OBJECT_NAME(uxQueueGetQueueNumber(xQueue), pcQueueName); \
+        KSTATS(kstats_object_name(uxQueueGetQueueNumber(xQueue), pcQueueName)); \
+    } while (0)
+
+#define traceQUEUE_SEND(pxQueue) \
+    do { \
+        TRACE_REC(TRACE_EVT_QUEUE_SEND, QUEUE_NUMBER(pxQueue), QUEUE_WAITING(pxQueue)); \
+        KSTATS(kstats_send(QUEUE_NUMBER(pxQueue), KSTATS_CURRENT_TASK(), QUEUE_WAITING(pxQueue) + 1U)); \
+    } while (0)
+
+#define traceQUEUE_SEND_FROM_ISR(pxQueue) \
+    do { \
+        TRACE_REC(TRACE_EVT_QUEUE_SEND_FROM_ISR, QUEUE_NUMBER(pxQueue), QUEUE_WAITING(pxQueue)); \
+        KSTATS(kstats_send(QUEUE_NUMBER(pxQueue), 0, QUEUE_WAITING(pxQueue) + 1U)); \
+    } while (0)
+
+#define traceQUEUE_RECEIVE(pxQueue) \
+    do { \
+        TRACE_REC(TRACE_EVT_QUEUE_RECEIVE, QUEUE_NUMBER(pxQueue), QUEUE_WAITING(pxQueue)); \
+        KSTATS(kstats_receive(QUEUE_NUMBER(pxQueue), KSTATS_CURRENT_TASK())); \
+    } while (0)
+
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue) \
+    do { \
+        TRACE_REC(TRACE_EVT_QUEUE_RECEIVE_FROM_ISR, QUEUE_NUMBER(pxQueue), QUEUE_WAITING(pxQueue)); \
+        KSTATS(kstats_receive(QUEUE_NUMBER(pxQueue), 0)); \
+    } while (0)
+
+#define traceQUEUE_PEEK(pxQueue) \
+    KSTATS(kstats_peek(QUEUE_NUMBER(pxQueue), KSTATS_CURRENT_TASK()))
+
+#define traceQUEUE_SEND_FAILED(pxQueue) \
+    do { \
+        TRACE_REC(TRACE_EVT_QUEUE_SEND_FAILED, QUEUE_NUMBER(pxQueue), QUEUE_WAITING(pxQueue)); \
+        KSTATS(kstats_failed(QUEUE_NUMBER(pxQueue), KSTATS_CURRENT_TASK())); \
+    } while (0)
+
+#define traceQUEUE_RECEIVE_FAILED(pxQueue) \
+    do { \
+        TRACE_REC(TRACE_EVT_QUEUE_RECEIVE_FAILED, QUEUE_NUMBER(pxQueue), QUEUE_WAITING(pxQueue)); \
+        KSTATS(kstats_failed(QUEUE_NUMBER(pxQueue), KSTATS_CURRENT_TASK())); \
+    } while (0)
+
+#define traceQUEUE_PEEK_FAILED(pxQueue) \
+    KSTATS(kstats_failed(QUEUE_NUMBER(pxQueue), KSTATS_CURRENT_TASK()))
+
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue) \
+    do { \
+        TRACE_REC(TRACE_EVT_QUEUE_BLOCK_SEND, QUEUE_NUMBER(pxQueue), QUEUE_WAITING(pxQueue)); \
+        KSTATS(kstats_block(QUEUE_NUMBER(pxQueue), KSTATS_CURRENT_TASK())); \
+    } while (0)
+
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) \
+    do { \
+        TRACE_REC(TRACE_EVT_QUEUE_BLOCK_RECEIVE, QUEUE_NUMBER(pxQueue), QUEUE_WAITING(pxQueue)); \
+        KSTATS(kstats_block(QUEUE_NUMBER(pxQueue), KSTATS_CURRENT_TASK())); \
+    } while (0)
+
+#define traceBLOCKING_ON_QUEUE_PEEK(pxQueue) \
+    KSTATS(kstats_block(QUEUE_NUMBER(pxQueue), KSTATS_CURRENT_TASK()))
+
+#endif /* configUSE_TRACE_RECORDER || configUSE_KERNEL_STATS */
+
+#if (configUSE_TRACE_RECORDER == 1) || (configUSE_KERNEL_STATS == 1) || (configUSE_MPU_STACK_GUARD == 1)
+
+// Runs in vTaskSwitchContext() after pxCurrentTCB has been updated
+#define traceTASK_SWITCHED_IN() \
+    do { \
+        TRACE_REC(TRACE_EVT_TASK_SWITCHED_IN, pxCurrentTCB->uxTCBNumber, pxCurrentTCB->uxPriority); \
+        STACK_GUARD_SWITCH_IN(); \
+    } while (0)
+
+#endif
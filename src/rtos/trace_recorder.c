@@ -0,0 +1,171 @@
+/**
+ * @file trace_recorder.c
+ * @brief Lock-free binary trace ring for FreeRTOS kernel events
+ */
+
+#include "trace_recorder.h"
+#include "hal_dwt.h"
+#include <string.h>
+
+#if (TRACE_BUFFER_EVENTS & (TRACE_BUFFER_EVENTS - 1)) != 0
+#error "TRACE_BUFFER_EVENTS must be a power of two"
+#endif
+
+_Static_assert(sizeof(trace_event_t) == 8, "trace_event_t must stay 8 bytes");
+
+trace_buffer_t g_trace_buffer = {
+    .magic = TRACE_MAGIC,
+    .version = TRACE_VERSION,
+    .event_size = sizeof(trace_event_t),
+    .capacity = TRACE_BUFFER_EVENTS,
+    .cpu_hz = 0,
+    .head = 0,
+    .frozen = 0,
+    .trigger_index = UINT32_MAX,
+    .max_tasks = TRACE_MAX_TASKS,
+    .max_objects = TRACE_MAX_OBJECTS,
+    .name_len = TRACE_NAME_LEN,
+    .reserved = 0,
+};
+
+// Trigger state (not part of the dump)
+static volatile bool trigger_armed = false;
+static volatile uint8_t trigger_type = TRACE_EVT_NONE;
+static volatile uint8_t trigger_id = TRACE_ANY_OBJECT;
+static volatile uint32_t trigger_post_events = 0;
+static volatile bool stop_pending = false;
+static volatile uint32_t stop_at = 0;
+
+static uint8_t next_object_number = 0;
+
+static void copy_name(char* dst, const char* src) {
+    if (!src) {
+        dst[0] = '\0';
+        return;
+    }
+    strncpy(dst, src, TRACE_NAME_LEN - 1);
+    dst[TRACE_NAME_LEN - 1] = '\0';
+}
+
+static void schedule_stop(uint32_t index, uint32_t post_events) {
+    g_trace_buffer.trigger_index = index;
+    stop_at = index + post_events + 1;
+    stop_pending = true;
+}
+
+// Public API implementations
+
+int trace_init(uint32_t cpu_hz) {
+    g_trace_buffer.cpu_hz = cpu_hz;
+    trace_reset();
+    return hal_dwt_init();
+}
+
+void trace_reset(void) {
+    g_trace_buffer.frozen = 1;
+
+    trigger_armed = false;
+    stop_pending = false;
+    g_trace_buffer.trigger_index = UINT32_MAX;
+    memset(g_trace_buffer.events, 0, sizeof(g_trace_buffer.events));
+    g_trace_buffer.head = 0;
+
+    g_trace_buffer.frozen = 0;
+}
+
+void trace_record(trace_event_type_t type, uint8_t id, uint16_t data) {
+    if (g_trace_buffer.frozen) {
+        return;
+    }
+
+    const uint32_t timestamp = hal_dwt_get_cycles();
+
+    // Claim a slot; this is the only shared write and it is a single atomic op
+    const uint32_t index = __atomic_fetch_add(&g_trace_buffer.head, 1U, __ATOMIC_RELAXED);
+    trace_event_t* event = &g_trace_buffer.events[index & (TRACE_BUFFER_EVENTS - 1U)];
+
+    event->timestamp = timestamp;
+    event->type = (uint8_t)type;
+    event->id = id;
+    event->data = data;
+
+    if (trigger_armed && (uint8_t)type == trigger_type &&
+        (trigger_id == TRACE_ANY_OBJECT || trigger_id == id)) {
+        trigger_armed = false;
+        schedule_stop(index, trigger_post_events);
+    }
+
+    if (stop_pending && (int32_t)(index + 1U - stop_at) >= 0) {
+        stop_pending = false;
+        g_trace_buffer.frozen = 1;
+    }
+}
+
+void trace_user_event(uint8_t channel, uint16_t value) {
+    trace_record(TRACE_EVT_USER, channel, value);
+}
+
+void trace_task_create(uint32_t task_number, const char* name, uint32_t priority) {
+    if (task_number >= 1 && task_number <= TRACE_MAX_TASKS) {
+        copy_name(g_trace_buffer.task_names[task_number - 1], name);
+    }
+    trace_record(TRACE_EVT_TASK_CREATE, (uint8_t)task_number, (uint16_t)priority);
+}
+
+uint8_t trace_next_object_number(void) {
+    uint8_t number = __atomic_add_fetch(&next_object_number, 1U, __ATOMIC_RELAXED);
+    if (number == 0 || number == TRACE_ANY_OBJECT) {
+        next_object_number = 1;
+        number = 1;
+    }
+    return number;
+}
+
+void trace_object_name(uint32_t object_number, const char* name) {
+    if (object_number >= 1 && object_number <= TRACE_MAX_OBJECTS) {
+        copy_name(g_trace_buffer.object_names[object_number - 1], name);
+    }
+}
+
+void trace_arm_trigger(trace_event_type_t type, uint8_t id, uint32_t post_events) {
+    trigger_armed = false;
+    trigger_type = (uint8_t)type;
+    trigger_id = id;
+    trigger_post_events = post_events;
+    trigger_armed = true;
+}
+
+void trace_disarm_trigger(void) {
+    trigger_armed = false;
+    stop_pending = false;
+}
+
+void trace_trigger(uint32_t post_events) {
+    if (post_events == 0) {
+        g_trace_buffer.trigger_index = g_trace_buffer.head;
+        trace_freeze();
+        return;
+    }
+    schedule_stop(g_trace_buffer.head, post_events - 1U);
+}
+
+void trace_freeze(void) {
+    g_trace_buffer.frozen = 1;
+}
+
+bool trace_is_frozen(void) {
+    return g_trace_buffer.frozen != 0;
+}
+
+uint32_t trace_event_count(void) {
+    const uint32_t head = g_trace_buffer.head;
+    return (head < TRACE_BUFFER_EVENTS) ? head : TRACE_BUFFER_EVENTS;
+}
+
+void trace_isr_enter(uint8_t exception_number) {
+    trace_record(TRACE_EVT_ISR_ENTER, exception_number, 0);
+}
+
+void trace_isr_exit(uint8_t exception_number) {
+    trace_record(TRACE_EVT_ISR_EXIT, exception_number, 0);
+}
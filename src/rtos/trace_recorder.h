@@ -0,0 +1,226 @@
+#pragma once
+
+/**
+ * @file trace_recorder.h
+ * @brief Binary trace recorder for FreeRTOS scheduling and kernel events
+ *
+ * Kernel trace hooks (see trace_hooks.h) write fixed-size 8-byte events
+ * stamped with the DWT cycle counter into a lock-free RAM ring. Slots are
+ * claimed with a single atomic increment, so tasks and ISRs at any priority
+ * can record without masking interrupts.
+ *
+ * The ring is self-describing: dump `g_trace_buffer` from a debugger
+ * (e.g. `dump binary value trace.bin g_trace_buffer` in GDB) and decode it
+ * with `tools/trace_decode.py` into a Chrome/Perfetto JSON timeline.
+ *
+ * A trigger can freeze the ring a configurable number of events after a
+ * matching event, keeping the history that led up to it.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+#ifndef TRACE_BUFFER_EVENTS
+#define TRACE_BUFFER_EVENTS     256     // Must be a power of two
+#endif
+
+#ifndef TRACE_MAX_TASKS
+#define TRACE_MAX_TASKS         16      // Named task slots in the dump header
+#endif
+
+#ifndef TRACE_MAX_OBJECTS
+#define TRACE_MAX_OBJECTS       8       // Named queue/semaphore slots
+#endif
+
+#define TRACE_NAME_LEN          16
+#define TRACE_MAGIC             0x52545246UL   // "FRTR"
+#define TRACE_VERSION           1
+#define TRACE_ANY_OBJECT        0xFFU
+
+/**
+ * @brief Trace Event Types
+ */
+typedef enum {
+    TRACE_EVT_NONE = 0,
+    TRACE_EVT_TASK_SWITCHED_IN,     // id = task number, data = priority
+    TRACE_EVT_TASK_SWITCHED_OUT,    // id = task number, data = priority
+    TRACE_EVT_TASK_READY,           // id = task number, data = priority
+    TRACE_EVT_TASK_DELAY,           // id = task number, data = ticks
+    TRACE_EVT_TASK_CREATE,          // id = task number, data = priority
+    TRACE_EVT_PRIORITY_INHERIT,     // id = holder task number, data = new priority
+    TRACE_EVT_PRIORITY_DISINHERIT,  // id = holder task number, data = restored priority
+    TRACE_EVT_ISR_ENTER,            // id = exception number
+    TRACE_EVT_ISR_EXIT,             // id = exception number
+    TRACE_EVT_QUEUE_CREATE,         // id = object number, data = queue type
+    TRACE_EVT_QUEUE_SEND,           // id = object number, data = items waiting
+    TRACE_EVT_QUEUE_SEND_FAILED,
+    TRACE_EVT_QUEUE_SEND_FROM_ISR,
+    TRACE_EVT_QUEUE_RECEIVE,
+    TRACE_EVT_QUEUE_RECEIVE_FAILED,
+    TRACE_EVT_QUEUE_RECEIVE_FROM_ISR,
+    TRACE_EVT_QUEUE_BLOCK_SEND,
+    TRACE_EVT_QUEUE_BLOCK_RECEIVE,
+    TRACE_EVT_USER,                 // id = user channel, data = user value
+    TRACE_EVT_COUNT
+} trace_event_type_t;
+
+/**
+ * @brief Trace Event (8 bytes, stored as-is in the ring)
+ */
+typedef struct {
+    uint32_t timestamp;     // DWT cycle count
+    uint8_t type;           // trace_event_type_t
+    uint8_t id;             // Task, object or exception number
+    uint16_t data;          // Event-specific payload
+} trace_event_t;
+
+/**
+ * @brief Trace Buffer (layout decoded by tools/trace_decode.py)
+ */
+typedef struct {
+    uint32_t magic;                 // TRACE_MAGIC
+    uint16_t version;               // TRACE_VERSION
+    uint16_t event_size;            // sizeof(trace_event_t)
+    uint32_t capacity;              // Event slots (power of two)
+    uint32_t cpu_hz;                // Timestamp frequency
+    volatile uint32_t head;         // Total events claimed since reset
+    volatile uint32_t frozen;       // Non-zero once recording stopped
+    volatile uint32_t trigger_index;// head value of the trigger event, or UINT32_MAX
+    uint16_t max_tasks;
+    uint16_t max_objects;
+    uint16_t name_len;
+    uint16_t reserved;
+    char task_names[TRACE_MAX_TASKS][TRACE_NAME_LEN];
+    char object_names[TRACE_MAX_OBJECTS][TRACE_NAME_LEN];
+    trace_event_t events[TRACE_BUFFER_EVENTS];
+} trace_buffer_t;
+
+extern trace_buffer_t g_trace_buffer;
+
+// =============================================================================
+// Trace Recorder API
+// =============================================================================
+
+/**
+ * @brief Start the cycle counter and reset the ring
+ * @param cpu_hz Core clock frequency used for timestamps
+ * @return 0 on success, negative error code on failure
+ */
+int trace_init(uint32_t cpu_hz);
+
+/**
+ * @brief Clear all recorded events and resume recording
+ */
+void trace_reset(void);
+
+/**
+ * @brief Record one event (ISR and task safe, lock-free)
+ * @param type Event type
+ * @param id Task, object or exception number
+ * @param data Event-specific payload
+ */
+void trace_record(trace_event_type_t type, uint8_t id, uint16_t data);
+
+/**
+ * @brief Record an application-defined marker
+ * @param channel User channel number
+ * @param value User value
+ */
+void trace_user_event(uint8_t channel, uint16_t value);
+
+/**
+ * @brief Record the name of a newly created task
+ * @param task_number Kernel task number (uxTCBNumber)
+ * @param name Task name
+ * @param priority Task priority
+ */
+void trace_task_create(uint32_t task_number, const char* name, uint32_t priority);
+
+/**
+ * @brief Allocate a trace number for a new queue, semaphore or mutex
+ * @return Object number (1-based, wraps at 255)
+ */
+uint8_t trace_next_object_number(void);
+
+/**
+ * @brief Record the registry name of a queue, semaphore or mutex
+ * @param object_number Object number assigned at creation
+ * @param name Registry name
+ */
+void trace_object_name(uint32_t object_number, const char* name);
+
+/**
+ * @brief Arm a snapshot trigger
+ *
+ * When an event of @p type (and @p id, unless TRACE_ANY_OBJECT) is recorded,
+ * recording continues for @p post_events more events and then freezes.
+ *
+ * @param type Event type to match
+ * @param id Object to match, or TRACE_ANY_OBJECT
+ * @param post_events Events to keep after the trigger
+ */
+void trace_arm_trigger(trace_event_type_t type, uint8_t id, uint32_t post_events);
+
+/**
+ * @brief Disarm the snapshot trigger
+ */
+void trace_disarm_trigger(void);
+
+/**
+ * @brief Trigger a snapshot now (as if a trigger event had matched)
+ * @param post_events Events to keep after this point
+ */
+void trace_trigger(uint32_t post_events);
+
+/**
+ * @brief Stop recording immediately
+ */
+void trace_freeze(void);
+
+/**
+ * @brief Check whether recording has stopped
+ * @return true if frozen
+ */
+bool trace_is_frozen(void);
+
+/**
+ * @brief Number of valid events currently held in the ring
+ * @return Event count (at most TRACE_BUFFER_EVENTS)
+ */
+uint32_t trace_event_count(void);
+
+/**
+ * @brief Mark ISR entry (use TRACE_ISR_ENTER() from handlers)
+ * @param exception_number Active exception number (IPSR)
+ */
+void trace_isr_enter(uint8_t exception_number);
+
+/**
+ * @brief Mark ISR exit (use TRACE_ISR_EXIT() from handlers)
+ * @param exception_number Active exception number (IPSR)
+ */
+void trace_isr_exit(uint8_t exception_number);
+
+/*
+ * ISR instrumentation: place TRACE_ISR_ENTER() first and TRACE_ISR_EXIT()
+ * last in an interrupt handler. The CMSIS core header must be in scope.
+ */
+#if defined(configUSE_TRACE_RECORDER) && (configUSE_TRACE_RECORDER == 1)
+#define TRACE_ISR_ENTER()   trace_isr_enter((uint8_t)__get_IPSR())
+#define TRACE_ISR_EXIT()    trace_isr_exit((uint8_t)__get_IPSR())
+#else
+#define TRACE_ISR_ENTER()
+#define TRACE_ISR_EXIT()
+#endif
+
+#ifdef __cplusplus
+}
+#endif
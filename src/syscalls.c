@@ -5,6 +5,8 @@
 
 #include <sys/stat.h>
 #include <errno.h>
+#include <stdint.h>
+#include "debug_uart.h"
 
 #undef errno
 extern int errno;
@@ -37,13 +39,19 @@ int _getpid(void) {
 }
 
 /**
- * @brief Send a signal to a process
+ * @brief Write to a file: stdout and stderr go to the debug UART
+ *
+ * Bytes the UART drops under its overflow policy are still reported as
+ * written (they are counted in its statistics); a short count would make
+ * stdio retry them.
  */
 int _write(int file, char *ptr, int len) {
-    (void)file;
-    (void)ptr;
-    (void)len;
-    return 0;
+    if (file != 1 && file != 2) {
+        errno = EBADF;
+        return -1;
+    }
+    debug_uart_write(ptr, (size_t)len);
+    return len;
 }
 
 /**
@@ -93,19 +101,31 @@ int _close(int file) {
 
 /**
  * @brief Increase program data space
+ *
+ * malloc() is served by the FreeRTOS heap (src/mem/newlib_heap.c), so
+ * nothing should reach this. It stays below _sbrk_limit (the end of SRAM1,
+ * or the main stack when that is in SRAM1) so a stray caller gets ENOMEM
+ * instead of overwriting SRAM2 or the stack.
  */
-extern char _end; // Defined by the linker script
+extern char _end;               // Defined by the linker script
+extern char _sbrk_limit;        // Defined by the linker script
 static char *heap_end = 0;
 
 void *_sbrk(int incr) {
     char *prev_heap_end;
-    
+    const char *limit = &_sbrk_limit;
+
     if (heap_end == 0) {
         heap_end = &_end;
     }
-    
+
+    if (incr > limit - heap_end || incr < &_end - heap_end) {
+        errno = ENOMEM;
+        return (void *)-1;
+    }
+
     prev_heap_end = heap_end;
     heap_end += incr;
-    
+
     return (void *)prev_heap_end;
 }
@@ -0,0 +1,221 @@
+#pragma once
+
+/**
+ * @file spsc_ring.hpp
+ * @brief Lock-free single-producer/single-consumer ring buffer
+ *
+ * Intended for ISR-to-task (or task-to-ISR) data paths: exactly one context
+ * writes and exactly one context reads, so no critical section is needed.
+ * The write index is only stored by the producer and the read index only by
+ * the consumer; release/acquire ordering publishes the data before the
+ * index that makes it visible.
+ *
+ * Indices run freely and are reduced with a mask, so N must be a power of
+ * two and all N slots are usable. Besides element-wise and bulk copies, the
+ * ring exposes contiguous spans of its storage so a DMA transfer can fill
+ * or drain it in place:
+ *
+ * @code
+ * SpscRing<uint8_t, 256> rx;
+ *
+ * // Producer (e.g. DMA half/complete ISR)
+ * auto span = rx.write_span();
+ * start_dma(span.data(), span.size());
+ * ...
+ * rx.commit_write(received);
+ *
+ * // Consumer (task)
+ * uint8_t buf[32];
+ * size_t n = rx.read(buf, sizeof(buf));
+ * @endcode
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+// Indices are kept apart to avoid false sharing on cached hosts; the
+// Cortex-M4 has no data cache, so word alignment is enough there
+#ifndef SPSC_RING_ALIGNMENT
+#if defined(__arm__)
+#define SPSC_RING_ALIGNMENT     4
+#else
+#define SPSC_RING_ALIGNMENT     64
+#endif
+#endif
+
+template <typename T, std::size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+    static_assert(N <= (1UL << 31), "SpscRing size must fit the 32-bit index range");
+    static_assert(std::is_trivially_copyable_v<T>, "SpscRing elements are copied as raw data");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "SpscRing needs lock-free indices");
+
+public:
+    using value_type = T;
+
+    SpscRing() = default;
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    static constexpr std::size_t capacity() { return N; }
+
+    // =========================================================================
+    // Either side
+    // =========================================================================
+
+    std::size_t size() const {
+        // Tail first: the head loaded afterwards can only be further ahead
+        const uint32_t tail = tail_.load(std::memory_order_acquire);
+        const std::size_t used = head_.load(std::memory_order_acquire) - tail;
+        return used < N ? used : N;
+    }
+
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() == N; }
+
+    /**
+     * @brief Discard all data (only while neither side is active)
+     */
+    void reset() {
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+    }
+
+    // =========================================================================
+    // Producer side
+    // =========================================================================
+
+    /**
+     * @brief Append one element
+     * @return false if the ring is full
+     */
+    bool push(const T& value) {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == N) {
+            return false;
+        }
+        buffer_[head & kMask] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Append up to count elements
+     * @return Number of elements written
+     */
+    std::size_t write(const T* data, std::size_t count) {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t space = N - (head - tail_.load(std::memory_order_acquire));
+        if (count > space) {
+            count = space;
+        }
+
+        const std::size_t start = head & kMask;
+        const std::size_t first = (count < N - start) ? count : N - start;
+        copy(&buffer_[start], data, first);
+        copy(&buffer_[0], data + first, count - first);
+
+        head_.store(head + static_cast<uint32_t>(count), std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Largest contiguous free region at the write position
+     *
+     * Fill it (e.g. by DMA) and publish with commit_write(). The region may
+     * be shorter than the total free space when it reaches the end of the
+     * storage.
+     */
+    std::span<T> write_span() {
+        const uint32_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t space = N - (head - tail_.load(std::memory_order_acquire));
+        const std::size_t start = head & kMask;
+        const std::size_t contiguous = N - start;
+        return std::span<T>(&buffer_[start], space < contiguous ? space : contiguous);
+    }
+
+    /**
+     * @brief Publish elements written through write_span()
+     * @param count Elements written, at most write_span().size()
+     */
+    void commit_write(std::size_t count) {
+        head_.store(head_.load(std::memory_order_relaxed) + static_cast<uint32_t>(count),
+                    std::memory_order_release);
+    }
+
+    // =========================================================================
+    // Consumer side
+    // =========================================================================
+
+    /**
+     * @brief Remove one element
+     * @return false if the ring is empty
+     */
+    bool pop(T& value) {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load(std::memory_order_acquire) == tail) {
+            return false;
+        }
+        value = buffer_[tail & kMask];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove up to count elements
+     * @return Number of elements read
+     */
+    std::size_t read(T* data, std::size_t count) {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t available = head_.load(std::memory_order_acquire) - tail;
+        if (count > available) {
+            count = available;
+        }
+
+        const std::size_t start = tail & kMask;
+        const std::size_t first = (count < N - start) ? count : N - start;
+        copy(data, &buffer_[start], first);
+        copy(data + first, &buffer_[0], count - first);
+
+        tail_.store(tail + static_cast<uint32_t>(count), std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Largest contiguous readable region at the read position
+     *
+     * Drain it (e.g. by DMA) and release it with commit_read().
+     */
+    std::span<const T> read_span() const {
+        const uint32_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t available = head_.load(std::memory_order_acquire) - tail;
+        const std::size_t start = tail & kMask;
+        const std::size_t contiguous = N - start;
+        return std::span<const T>(&buffer_[start], available < contiguous ? available : contiguous);
+    }
+
+    /**
+     * @brief Release elements consumed through read_span()
+     * @param count Elements consumed, at most read_span().size()
+     */
+    void commit_read(std::size_t count) {
+        tail_.store(tail_.load(std::memory_order_relaxed) + static_cast<uint32_t>(count),
+                    std::memory_order_release);
+    }
+
+private:
+    static constexpr uint32_t kMask = static_cast<uint32_t>(N - 1);
+
+    static void copy(T* dst, const T* src, std::size_t count) {
+        for (std::size_t i = 0; i < count; i++) {
+            dst[i] = src[i];
+        }
+    }
+
+    alignas(SPSC_RING_ALIGNMENT) std::atomic<uint32_t> head_{0};    // Written by the producer
+    alignas(SPSC_RING_ALIGNMENT) std::atomic<uint32_t> tail_{0};    // Written by the consumer
+    alignas(SPSC_RING_ALIGNMENT) T buffer_[N];
+};
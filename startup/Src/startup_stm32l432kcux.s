@@ -95,6 +95,31 @@ LoopFillZerobss:
   cmp r2, r4
   bcc FillZerobss
 
+/* Copy RAM functions and SRAM2 data from flash, zero fill SRAM2 bss
+   (section layout in src/mem/sections.h) */
+  ldr r0, =_sramfunc
+  ldr r1, =_eramfunc
+  ldr r2, =_siramfunc
+  bl  CopySection
+
+  ldr r0, =_ssram2
+  ldr r1, =_esram2
+  ldr r2, =_sisram2
+  bl  CopySection
+
+  ldr r2, =_ssram2_bss
+  ldr r4, =_esram2_bss
+  movs r3, #0
+  b LoopFillZeroSram2
+
+FillZeroSram2:
+  str  r3, [r2]
+  adds r2, r2, #4
+
+LoopFillZeroSram2:
+  cmp r2, r4
+  bcc FillZeroSram2
+
 /* Call static constructors */
     bl __libc_init_array
 /* Call the application's entry point.*/
@@ -102,7 +127,23 @@ LoopFillZerobss:
 
 LoopForever:
     b LoopForever
-    
+
+/* Copy words from r2 to [r0, r1); clobbers r3 and r4 */
+CopySection:
+  movs r3, #0
+  b LoopCopySection
+
+CopySectionWord:
+  ldr r4, [r2, r3]
+  str r4, [r0, r3]
+  adds r3, r3, #4
+
+LoopCopySection:
+  adds r4, r0, r3
+  cmp r4, r1
+  bcc CopySectionWord
+  bx lr
+
 .size	Reset_Handler, .-Reset_Handler
 
 /**
@@ -0,0 +1,102 @@
+#include "heap4_model.h"
+
+Heap4Model::Heap4Model(void* mem, std::size_t bytes) {
+    auto addr = reinterpret_cast<uintptr_t>(mem);
+    const uintptr_t aligned = (addr + kAlign - 1) & ~uintptr_t(kAlign - 1);
+    bytes -= aligned - addr;
+
+    // End marker at the top of the region, one free block below it
+    const uintptr_t end = (aligned + bytes - kHeader) & ~uintptr_t(kAlign - 1);
+    end_ = reinterpret_cast<Block*>(end);
+    end_->next = nullptr;
+    end_->size = 0;
+
+    auto* first = reinterpret_cast<Block*>(aligned);
+    first->size = end - aligned;
+    first->next = end_;
+    start_.next = first;
+    start_.size = 0;
+    free_bytes_ = first->size;
+}
+
+void* Heap4Model::malloc(std::size_t size) {
+    last_steps_ = 0;
+    if (size == 0) {
+        return nullptr;
+    }
+    size = (size + kHeader + kAlign - 1) & ~(kAlign - 1);
+    if (size > free_bytes_) {
+        return nullptr;
+    }
+
+    // First fit over the address-ordered list
+    Block* prev = &start_;
+    Block* block = start_.next;
+    while (block->size < size && block->next) {
+        prev = block;
+        block = block->next;
+        last_steps_++;
+    }
+    if (block == end_) {
+        return nullptr;
+    }
+
+    prev->next = block->next;
+    if (block->size - size > kMinBlock) {
+        auto* rest = reinterpret_cast<Block*>(reinterpret_cast<uint8_t*>(block) + size);
+        rest->size = block->size - size;
+        block->size = size;
+        insert(rest);
+    }
+    free_bytes_ -= block->size;
+    block->size |= kAllocated;
+    block->next = nullptr;
+    return reinterpret_cast<uint8_t*>(block) + kHeader;
+}
+
+void Heap4Model::free(void* ptr) {
+    last_steps_ = 0;
+    if (!ptr) {
+        return;
+    }
+    auto* block = reinterpret_cast<Block*>(static_cast<uint8_t*>(ptr) - kHeader);
+    block->size &= ~kAllocated;
+    free_bytes_ += block->size;
+    insert(block);
+}
+
+void Heap4Model::insert(Block* block) {
+    Block* it = &start_;
+    while (it->next < block) {
+        it = it->next;
+        last_steps_++;
+    }
+
+    auto* bytes = reinterpret_cast<uint8_t*>(block);
+    if (it != &start_ && reinterpret_cast<uint8_t*>(it) + it->size == bytes) {
+        it->size += block->size;
+        block = it;
+        bytes = reinterpret_cast<uint8_t*>(block);
+    }
+
+    if (bytes + block->size == reinterpret_cast<uint8_t*>(it->next) && it->next != end_) {
+        block->size += it->next->size;
+        block->next = it->next->next;
+    } else {
+        block->next = it->next;
+    }
+
+    if (it != block) {
+        it->next = block;
+    }
+}
+
+std::size_t Heap4Model::largest_free() const {
+    std::size_t largest = 0;
+    for (const Block* b = start_.next; b != end_; b = b->next) {
+        if (b->size > largest) {
+            largest = b->size;
+        }
+    }
+    return largest;
+}
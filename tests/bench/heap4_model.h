@@ -0,0 +1,47 @@
+#pragma once
+
+/**
+ * @file heap4_model.h
+ * @brief Host model of FreeRTOS heap_4 for allocator benchmarks
+ *
+ * Reproduces heap_4.c's algorithm: an address-ordered singly linked free
+ * list searched first-fit on allocation, blocks split when the remainder
+ * exceeds two headers, and freed blocks merged with both neighbours during
+ * the ordered insert. Both walks are counted so benchmarks can report the
+ * search length that makes heap_4's timing unbounded.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+class Heap4Model {
+public:
+    Heap4Model(void* mem, std::size_t bytes);
+
+    void* malloc(std::size_t size);
+    void free(void* ptr);
+
+    std::size_t free_bytes() const { return free_bytes_; }
+    std::size_t largest_free() const;
+
+    // Free list nodes visited by the last malloc()/free()
+    uint32_t last_steps() const { return last_steps_; }
+
+private:
+    struct Block {
+        Block* next;
+        std::size_t size;           // Includes the header; top bit = allocated
+    };
+
+    static constexpr std::size_t kAlign = 8;
+    static constexpr std::size_t kHeader = (sizeof(Block) + kAlign - 1) & ~(kAlign - 1);
+    static constexpr std::size_t kMinBlock = kHeader * 2;
+    static constexpr std::size_t kAllocated = std::size_t(1) << (sizeof(std::size_t) * 8 - 1);
+
+    void insert(Block* block);
+
+    Block start_{};
+    Block* end_ = nullptr;
+    std::size_t free_bytes_ = 0;
+    uint32_t last_steps_ = 0;
+};
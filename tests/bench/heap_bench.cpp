@@ -0,0 +1,301 @@
+/**
+ * @file heap_bench.cpp
+ * @brief Replay allocation traces against TLSF and the heap_4 model
+ *
+ * Usage:
+ *   heap_bench                      run the built-in workloads
+ *   heap_bench trace.txt ...        replay recorded traces
+ *   heap_bench --dump <workload>    print a built-in workload as a trace
+ *
+ * Trace format, one operation per line ('#' starts a comment):
+ *   a <id> <bytes>     allocate and remember the block as <id>
+ *   f <id>             free block <id>
+ *
+ * Each trace is replayed several times; per-operation latency is the
+ * minimum over the runs, which strips host scheduling noise while keeping
+ * the allocator's own data-dependent cost. Reported per allocator: worst
+ * and 99th percentile latency, heap_4's longest free-list walk, failed
+ * allocations, and peak/final fragmentation (1 - largest free / free).
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "heap4_model.h"
+
+extern "C" {
+#include "tlsf.h"
+}
+
+namespace {
+
+constexpr std::size_t kHeapBytes = 15360;   // configTOTAL_HEAP_SIZE
+constexpr int kRuns = 7;
+constexpr int kFragSampleEvery = 64;
+
+struct Op {
+    bool alloc;
+    uint32_t id;
+    uint32_t size;
+};
+
+struct Trace {
+    std::string name;
+    std::vector<Op> ops;
+};
+
+struct Result {
+    std::vector<double> op_ns;      // Min over runs, per operation
+    uint32_t max_steps = 0;
+    uint32_t failures = 0;
+    double peak_frag = 0.0;
+    double final_frag = 0.0;
+};
+
+// =============================================================================
+// Allocator adapters
+// =============================================================================
+
+struct TlsfHeap {
+    alignas(8) uint8_t mem[kHeapBytes];
+    tlsf_t tlsf;
+
+    TlsfHeap() {
+        tlsf_init(&tlsf);
+        tlsf_add_pool(&tlsf, mem, sizeof(mem));
+    }
+    void* malloc(std::size_t n) { return tlsf_malloc(&tlsf, n); }
+    void free(void* p) { tlsf_free(&tlsf, p); }
+    uint32_t steps() const { return 0; }
+    double fragmentation() const {
+        tlsf_stats_t s;
+        tlsf_get_stats(&tlsf, &s);
+        return s.free_bytes ? 1.0 - double(s.largest_free) / double(s.free_bytes) : 0.0;
+    }
+};
+
+struct Heap4 {
+    alignas(8) uint8_t mem[kHeapBytes];
+    Heap4Model heap{mem, sizeof(mem)};
+
+    void* malloc(std::size_t n) { return heap.malloc(n); }
+    void free(void* p) { heap.free(p); }
+    uint32_t steps() const { return heap.last_steps(); }
+    double fragmentation() const {
+        const std::size_t free_bytes = heap.free_bytes();
+        return free_bytes ? 1.0 - double(heap.largest_free()) / double(free_bytes) : 0.0;
+    }
+};
+
+template <typename Heap>
+Result replay(const Trace& trace) {
+    Result result;
+    result.op_ns.assign(trace.ops.size(), 1e18);
+
+    for (int run = 0; run < kRuns; run++) {
+        auto heap = std::make_unique<Heap>();
+        std::unordered_map<uint32_t, void*> live;
+        live.reserve(trace.ops.size());
+
+        for (std::size_t i = 0; i < trace.ops.size(); i++) {
+            const Op& op = trace.ops[i];
+            void* freed = nullptr;
+            if (!op.alloc) {
+                auto it = live.find(op.id);
+                if (it == live.end()) {
+                    continue;   // Allocation failed earlier
+                }
+                freed = it->second;
+                live.erase(it);
+            }
+
+            const auto t0 = std::chrono::steady_clock::now();
+            void* p = nullptr;
+            if (op.alloc) {
+                p = heap->malloc(op.size);
+            } else {
+                heap->free(freed);
+            }
+            const auto t1 = std::chrono::steady_clock::now();
+
+            const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+            result.op_ns[i] = std::min(result.op_ns[i], ns);
+
+            if (run == 0) {
+                result.max_steps = std::max(result.max_steps, heap->steps());
+                if (op.alloc && !p) {
+                    result.failures++;
+                }
+                if (i % kFragSampleEvery == 0) {
+                    result.peak_frag = std::max(result.peak_frag, heap->fragmentation());
+                }
+            }
+            if (op.alloc && p) {
+                live[op.id] = p;
+            }
+        }
+        if (run == 0) {
+            result.final_frag = heap->fragmentation();
+        }
+    }
+    return result;
+}
+
+// =============================================================================
+// Workloads
+// =============================================================================
+
+// Short-lived messages of mixed size, as from a protocol stack
+Trace workload_churn(uint32_t seed) {
+    Trace t{"churn", {}};
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> size(16, 384);
+    std::vector<uint32_t> live;
+    uint32_t next_id = 0;
+
+    for (int i = 0; i < 20000; i++) {
+        if (live.size() < 24 && (live.empty() || rng() % 100 < 55)) {
+            t.ops.push_back({true, next_id, size(rng)});
+            live.push_back(next_id++);
+        } else {
+            const std::size_t k = rng() % live.size();
+            t.ops.push_back({false, live[k], 0});
+            live[k] = live.back();
+            live.pop_back();
+        }
+    }
+    return t;
+}
+
+// Small long-lived objects interleaved with large transient buffers: the
+// pattern that leaves heap_4 with a long list of unusable fragments
+Trace workload_bimodal(uint32_t seed) {
+    Trace t{"bimodal", {}};
+    std::mt19937 rng(seed);
+    std::vector<uint32_t> small;
+    uint32_t next_id = 0;
+
+    for (int round = 0; round < 400; round++) {
+        std::vector<uint32_t> large;
+        for (int k = 0; k < 6; k++) {
+            t.ops.push_back({true, next_id, static_cast<uint32_t>(24 + rng() % 40)});
+            small.push_back(next_id++);
+            t.ops.push_back({true, next_id, static_cast<uint32_t>(512 + rng() % 512)});
+            large.push_back(next_id++);
+        }
+        for (uint32_t id : large) {
+            t.ops.push_back({false, id, 0});
+        }
+        // Retire old small objects at random, keeping a working set
+        while (small.size() > 48) {
+            const std::size_t k = rng() % small.size();
+            t.ops.push_back({false, small[k], 0});
+            small[k] = small.back();
+            small.pop_back();
+        }
+    }
+    return t;
+}
+
+bool load_trace(const char* path, Trace& out) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    out.name = path;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream ls(line);
+        char kind;
+        Op op{};
+        ls >> kind >> op.id;
+        op.alloc = (kind == 'a');
+        if (op.alloc) {
+            ls >> op.size;
+        }
+        if (ls && (kind == 'a' || kind == 'f')) {
+            out.ops.push_back(op);
+        }
+    }
+    return true;
+}
+
+void dump_trace(const Trace& t) {
+    std::printf("# %s\n", t.name.c_str());
+    for (const Op& op : t.ops) {
+        if (op.alloc) {
+            std::printf("a %u %u\n", op.id, op.size);
+        } else {
+            std::printf("f %u\n", op.id);
+        }
+    }
+}
+
+// =============================================================================
+// Report
+// =============================================================================
+
+void print_result(const char* heap, const Result& r) {
+    std::vector<double> sorted = r.op_ns;
+    std::sort(sorted.begin(), sorted.end());
+    const double worst = sorted.empty() ? 0.0 : sorted.back();
+    const double p99 = sorted.empty() ? 0.0 : sorted[sorted.size() * 99 / 100];
+
+    std::printf("  %-7s worst %8.0f ns  p99 %6.0f ns  max walk %5u  failed %5u  "
+                "frag peak %3.0f%% final %3.0f%%\n",
+                heap, worst, p99, r.max_steps, r.failures,
+                r.peak_frag * 100.0, r.final_frag * 100.0);
+}
+
+void bench(const Trace& t) {
+    std::printf("%s (%zu ops, %zu byte heap)\n", t.name.c_str(), t.ops.size(), kHeapBytes);
+    print_result("tlsf", replay<TlsfHeap>(t));
+    print_result("heap_4", replay<Heap4>(t));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::vector<Trace> builtin = {workload_churn(1), workload_bimodal(2)};
+
+    if (argc == 3 && std::strcmp(argv[1], "--dump") == 0) {
+        for (const Trace& t : builtin) {
+            if (t.name == argv[2]) {
+                dump_trace(t);
+                return 0;
+            }
+        }
+        std::fprintf(stderr, "unknown workload: %s\n", argv[2]);
+        return 1;
+    }
+
+    if (argc == 1) {
+        for (const Trace& t : builtin) {
+            bench(t);
+        }
+        return 0;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        Trace t;
+        if (!load_trace(argv[i], t)) {
+            std::fprintf(stderr, "cannot read %s\n", argv[i]);
+            return 1;
+        }
+        bench(t);
+    }
+    return 0;
+}
@@ -0,0 +1,34 @@
+#include "hal_dwt_fake.h"
+
+extern "C" {
+#include "hal_dwt.h"
+}
+
+static uint32_t fake_cycles = 0;
+static bool fake_enabled = false;
+
+void hal_dwt_fake_set_cycles(uint32_t cycles) {
+    fake_cycles = cycles;
+}
+
+void hal_dwt_fake_advance(uint32_t cycles) {
+    fake_cycles += cycles;
+}
+
+extern "C" {
+
+int hal_dwt_init(void) {
+    fake_enabled = true;
+    fake_cycles = 0;
+    return 0;
+}
+
+bool hal_dwt_is_enabled(void) {
+    return fake_enabled;
+}
+
+uint32_t hal_dwt_get_cycles(void) {
+    return fake_cycles;
+}
+
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+// Host stand-in for the DWT cycle counter used by the instrumentation modules.
+// Tests set the value returned by hal_dwt_get_cycles() explicitly.
+void hal_dwt_fake_set_cycles(uint32_t cycles);
+void hal_dwt_fake_advance(uint32_t cycles);
@@ -0,0 +1,66 @@
+#include "hal_irq_fake.h"
+
+extern "C" {
+#include "hal_irq.h"
+#include "hal_irq_table.h"
+}
+
+// Only the VTOR write is faked: binding, unbinding and the index checks
+// run through the real hal_irq_table
+#define FAKE_VECTORS (HAL_IRQ_CORE_VECTORS + HAL_IRQ_FAKE_IRQS)
+
+static unsigned default_calls = 0;
+static hal_irq_handler_t flash_vectors[FAKE_VECTORS];
+static hal_irq_handler_t ram_vectors[FAKE_VECTORS];
+static hal_irq_table_t table = {ram_vectors, flash_vectors, FAKE_VECTORS, false};
+
+static void fake_default_handler() {
+    default_calls++;
+}
+
+void hal_irq_fake_reset() {
+    default_calls = 0;
+    table.relocated = false;
+    for (auto& v : flash_vectors) {
+        v = fake_default_handler;
+    }
+    for (auto& v : ram_vectors) {
+        v = nullptr;
+    }
+}
+
+void hal_irq_fake_raise(int irqn) {
+    hal_irq_get(irqn)();
+}
+
+unsigned hal_irq_fake_default_calls() {
+    return default_calls;
+}
+
+extern "C" {
+
+int hal_irq_vectors_init(void) {
+    if (!table.relocated) {
+        hal_irq_table_copy(&table);
+        table.relocated = true;
+    }
+    return 0;
+}
+
+bool hal_irq_vectors_relocated(void) {
+    return table.relocated;
+}
+
+int hal_irq_bind(int irqn, hal_irq_handler_t handler) {
+    return hal_irq_table_bind(&table, irqn, handler);
+}
+
+int hal_irq_unbind(int irqn) {
+    return hal_irq_table_unbind(&table, irqn);
+}
+
+hal_irq_handler_t hal_irq_get(int irqn) {
+    return hal_irq_table_get(&table, irqn);
+}
+
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+// Host stand-in for the RAM vector table. The "flash" table holds one
+// default handler that counts invocations; tests raise an IRQ by calling
+// whatever is installed in its vector.
+#define HAL_IRQ_FAKE_IRQS 96
+
+void hal_irq_fake_reset();
+void hal_irq_fake_raise(int irqn);
+unsigned hal_irq_fake_default_calls();
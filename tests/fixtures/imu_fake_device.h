@@ -0,0 +1,67 @@
+#pragma once
+
+// Host model of an IMU with a sample FIFO. It produces one frame per
+// output period (the real period may differ from the nominal one, as a
+// sensor's internal oscillator does), encodes it in the configured layout
+// and pulses its interrupt each time the FIFO level reaches a multiple of
+// the watermark. Sample k carries
+// channel c = sample_value(k, c), so decoded batches can be checked exactly.
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+class FakeImu {
+public:
+    FakeImu(uint8_t channels, uint8_t header_bytes, bool big_endian, uint8_t watermark, uint32_t real_period_us)
+        : channels_(channels), header_(header_bytes), big_endian_(big_endian), watermark_(watermark),
+          period_us_(real_period_us) {}
+
+    static int16_t sample_value(uint32_t k, uint8_t c) {
+        return static_cast<int16_t>((k * 37u + c * 1000u) % 60000u) - 30000;
+    }
+
+    // Time the sample was taken
+    uint32_t sample_time(uint32_t k) const { return start_us_ + (k + 1) * period_us_; }
+
+    // Produce the next sample; true when it pulses the watermark interrupt
+    bool step() {
+        const uint32_t k = produced_++;
+        for (uint8_t h = 0; h < header_; h++) {
+            fifo_.push_back(static_cast<uint8_t>(0xF0 + h));
+        }
+        for (uint8_t c = 0; c < channels_; c++) {
+            const auto v = static_cast<uint16_t>(sample_value(k, c));
+            const auto hi = static_cast<uint8_t>(v >> 8);
+            const auto lo = static_cast<uint8_t>(v);
+            fifo_.push_back(big_endian_ ? hi : lo);
+            fifo_.push_back(big_endian_ ? lo : hi);
+        }
+        return frames() % watermark_ == 0;
+    }
+
+    // Burst read of the FIFO data register
+    void read(uint8_t* data, std::size_t len) {
+        for (std::size_t i = 0; i < len; i++) {
+            if (fifo_.empty()) {
+                data[i] = 0;
+                continue;
+            }
+            data[i] = fifo_.front();
+            fifo_.pop_front();
+        }
+    }
+
+    std::size_t frames() const { return fifo_.size() / (header_ + 2u * channels_); }
+    uint32_t produced() const { return produced_; }
+
+private:
+    uint8_t channels_;
+    uint8_t header_;
+    bool big_endian_;
+    uint8_t watermark_;
+    uint32_t period_us_;
+    uint32_t start_us_ = 100000;
+    uint32_t produced_ = 0;
+    std::deque<uint8_t> fifo_;
+};
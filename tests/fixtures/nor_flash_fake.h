@@ -0,0 +1,158 @@
+#pragma once
+
+// Host model of a serial NOR flash behind the qspi_flash ops. It decodes
+// the commands the driver issues and enforces the part's rules: program
+// and erase need the write enable latch (cleared by each of them), a
+// program can only clear bits and wraps within its page, erase sets a
+// whole sector or block to 0xFF, and the quad enable bit must be set
+// before any 4-line transfer. Every command is logged for inspection.
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "qspi_flash.h"
+}
+
+class FakeNorFlash {
+public:
+    explicit FakeNorFlash(uint32_t size, uint16_t page = 256) : mem_(size, 0xFF), page_(page) {}
+
+    static const qspi_flash_ops_t* ops() {
+        static const qspi_flash_ops_t table = {command, read, write, wait_ready, memory_map, abort};
+        return &table;
+    }
+
+    std::vector<uint8_t>& memory() { return mem_; }
+    const std::vector<qspi_command_t>& log() const { return log_; }
+    void clear_log() { log_.clear(); }
+
+    uint8_t status2 = 0;
+    bool write_enabled = false;
+    bool mapped = false;
+    bool fail_wait = false;
+    int wait_calls = 0;
+    int violations = 0;     // Commands the real part would have ignored or corrupted
+    uint8_t id[3] = {0xEF, 0x40, 0x18};
+
+private:
+    static FakeNorFlash* self(void* hw) { return static_cast<FakeNorFlash*>(hw); }
+
+    // Everything but reads needs the controller out of memory-mapped mode,
+    // 4-line data needs QE, program and erase consume the write enable
+    bool accept(const qspi_command_t* cmd) {
+        log_.push_back(*cmd);
+        if (mapped || (cmd->data_lines == 4 && (status2 & 0x02) == 0)) {
+            violations++;
+            return false;
+        }
+        return true;
+    }
+
+    bool take_wel() {
+        const bool ok = write_enabled;
+        write_enabled = false;
+        if (!ok) {
+            violations++;
+        }
+        return ok;
+    }
+
+    static int command(void* hw, const qspi_command_t* cmd) {
+        FakeNorFlash* f = self(hw);
+        if (!f->accept(cmd)) {
+            return 0;
+        }
+        switch (cmd->instruction) {
+        case QSPI_CMD_WRITE_ENABLE:
+            f->write_enabled = true;
+            break;
+        case QSPI_CMD_SECTOR_ERASE:
+        case QSPI_CMD_BLOCK_ERASE: {
+            if (!f->take_wel()) {
+                break;
+            }
+            const uint32_t span = (cmd->instruction == QSPI_CMD_BLOCK_ERASE) ? QSPI_FLASH_BLOCK : QSPI_FLASH_SECTOR;
+            const uint32_t base = cmd->address & ~(span - 1u);
+            std::memset(&f->mem_[base], 0xFF, span);
+            break;
+        }
+        default:
+            f->violations++;
+            break;
+        }
+        return 0;
+    }
+
+    static int read(void* hw, const qspi_command_t* cmd, uint8_t* data, uint32_t len) {
+        FakeNorFlash* f = self(hw);
+        if (!f->accept(cmd)) {
+            return 0;
+        }
+        switch (cmd->instruction) {
+        case QSPI_CMD_READ_ID:
+            std::memcpy(data, f->id, len < 3 ? len : 3);
+            break;
+        case QSPI_CMD_READ_STATUS2:
+            data[0] = f->status2;
+            break;
+        case QSPI_CMD_FAST_READ_QUAD:
+            for (uint32_t i = 0; i < len; i++) {
+                data[i] = f->mem_[(cmd->address + i) % f->mem_.size()];
+            }
+            break;
+        default:
+            f->violations++;
+            break;
+        }
+        return 0;
+    }
+
+    static int write(void* hw, const qspi_command_t* cmd, const uint8_t* data, uint32_t len) {
+        FakeNorFlash* f = self(hw);
+        if (!f->accept(cmd) || !f->take_wel()) {
+            return 0;
+        }
+        switch (cmd->instruction) {
+        case QSPI_CMD_WRITE_STATUS2:
+            f->status2 = data[0];
+            break;
+        case QSPI_CMD_PAGE_PROGRAM:
+        case QSPI_CMD_PAGE_PROGRAM_QUAD: {
+            const uint32_t base = cmd->address & ~(f->page_ - 1u);
+            for (uint32_t i = 0; i < len; i++) {
+                const uint32_t offset = (cmd->address + i - base) % f->page_;
+                f->mem_[base + offset] &= data[i];
+            }
+            break;
+        }
+        default:
+            f->violations++;
+            break;
+        }
+        return 0;
+    }
+
+    static int wait_ready(void* hw, uint32_t) {
+        FakeNorFlash* f = self(hw);
+        f->wait_calls++;
+        return f->fail_wait ? -1 : 0;
+    }
+
+    static int memory_map(void* hw, const qspi_command_t* cmd) {
+        FakeNorFlash* f = self(hw);
+        f->log_.push_back(*cmd);
+        f->mapped = true;
+        return 0;
+    }
+
+    static int abort(void* hw) {
+        self(hw)->mapped = false;
+        return 0;
+    }
+
+    std::vector<uint8_t> mem_;
+    uint16_t page_;
+    std::vector<qspi_command_t> log_;
+};
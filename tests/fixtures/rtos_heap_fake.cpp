@@ -0,0 +1,50 @@
+#include "rtos_heap_fake.h"
+#include <cstdlib>
+
+static uint32_t live_blocks = 0;
+static int32_t allocations_left = -1;
+static size_t last_request = 0;
+
+void rtos_heap_fake_reset() {
+    live_blocks = 0;
+    allocations_left = -1;
+    last_request = 0;
+}
+
+void rtos_heap_fake_fail_after(int32_t allocations) {
+    allocations_left = allocations;
+}
+
+uint32_t rtos_heap_fake_live_blocks() {
+    return live_blocks;
+}
+
+size_t rtos_heap_fake_last_request() {
+    return last_request;
+}
+
+extern "C" {
+
+void* pvPortMalloc(size_t size) {
+    last_request = size;
+    if (allocations_left == 0) {
+        return nullptr;
+    }
+    if (allocations_left > 0) {
+        allocations_left--;
+    }
+    void* p = std::malloc(size);
+    if (p) {
+        live_blocks++;
+    }
+    return p;
+}
+
+void vPortFree(void* ptr) {
+    if (ptr) {
+        live_blocks--;
+        std::free(ptr);
+    }
+}
+
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Host stand-in for the FreeRTOS heap (pvPortMalloc/vPortFree). Counts live
+// blocks and can be told to fail after a number of allocations.
+void rtos_heap_fake_reset();
+void rtos_heap_fake_fail_after(int32_t allocations);   // -1: never fail
+uint32_t rtos_heap_fake_live_blocks();
+size_t rtos_heap_fake_last_request();
@@ -0,0 +1,56 @@
+#pragma once
+
+// Host model of a UART feeding a circular DMA channel. Bytes written to the
+// line land in the driver's DMA buffer and decrement CNDTR; crossing the half
+// and the end of the buffer raises the DMA half/complete events, and idle()
+// raises the UART idle-line event, as the hardware would.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+template <typename Rx>
+class UartDmaModel {
+public:
+    explicit UartDmaModel(Rx& rx) : rx_(rx) {}
+
+    std::size_t cndtr() const { return Rx::size() - pos_; }
+
+    // Bytes arriving back to back (no idle gap)
+    void receive(const uint8_t* data, std::size_t len) {
+        for (std::size_t i = 0; i < len; i++) {
+            rx_.dma_buffer()[pos_] = data[i];
+            pos_ = (pos_ + 1) % Rx::size();
+            if (pos_ == Rx::size() / 2) {
+                raise();    // Half transfer
+            } else if (pos_ == 0) {
+                raise();    // Transfer complete; CNDTR reloads
+            }
+        }
+    }
+
+    // One frame time without a start bit after the last byte
+    void idle() { raise(); }
+
+    void line_error(uint32_t flags) { rx_.on_line_errors(flags); }
+
+    // Each recorded burst is followed by an idle line
+    void replay(const std::vector<std::vector<uint8_t>>& bursts) {
+        for (const auto& burst : bursts) {
+            receive(burst.data(), burst.size());
+            idle();
+        }
+    }
+
+    unsigned interrupts() const { return interrupts_; }
+
+private:
+    void raise() {
+        interrupts_++;
+        rx_.on_dma_event(cndtr());
+    }
+
+    Rx& rx_;
+    std::size_t pos_ = 0;
+    unsigned interrupts_ = 0;
+};
@@ -0,0 +1,226 @@
+#pragma once
+
+// Host-side model of a full-speed USB bus for the device core. It plays
+// the device controller (usb_dcd_ops_t) and the host at once: transfers
+// the device arms are held per endpoint, and the host methods move them a
+// packet at a time the way the controller would, raising the same
+// completion events. An endpoint with nothing armed NAKs, which the host
+// methods report rather than wait on.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+extern "C" {
+#include "usb_device.h"
+}
+
+class UsbHostSim {
+public:
+    struct Endpoint {
+        bool open = false;
+        uint8_t type = 0;
+        uint16_t max_packet = 0;
+        bool double_buffered = false;
+        bool stalled = false;
+        // IN: transfer being sent
+        bool in_armed = false;
+        const uint8_t* in_data = nullptr;
+        uint16_t in_left = 0;
+        // OUT: buffer for the next packet
+        bool out_armed = false;
+        uint8_t* out_buf = nullptr;
+        uint16_t out_len = 0;
+    };
+
+    static const usb_dcd_ops_t* ops() {
+        static const usb_dcd_ops_t table = {set_address, ep_open, ep_transmit, ep_receive, ep_stall};
+        return &table;
+    }
+
+    void attach(usb_device_t* dev) { dev_ = dev; }
+
+    Endpoint& ep(uint8_t address) { return eps_[(address & 0x0F) + ((address & 0x80) ? 16 : 0)]; }
+
+    uint8_t address = 0;
+    std::vector<const uint8_t*> in_transfers;   // Data pointers handed to bulk IN endpoints
+    int zlps = 0;                               // Zero-length IN packets seen by the host
+
+    // =========================================================================
+    // Bus and control transfers
+    // =========================================================================
+
+    void bus_reset() {
+        for (auto& e : eps_) {
+            e = Endpoint{};
+        }
+        address = 0;
+        usb_device_on_reset(dev_);
+    }
+
+    // Device-to-host request; nullopt if the device stalls
+    std::optional<std::vector<uint8_t>> control_in(uint8_t type, uint8_t request, uint16_t value, uint16_t index,
+                                                   uint16_t length) {
+        if (!setup(type | 0x80, request, value, index, length)) {
+            return std::nullopt;
+        }
+
+        std::vector<uint8_t> data;
+        while (data.size() < length) {
+            const int n = in_packet(0x80, data);
+            if (n < 0 || ep0_stalled_) {
+                return std::nullopt;
+            }
+            if (n < USB_EP0_SIZE) {
+                break;
+            }
+        }
+
+        // Status stage: zero-length OUT
+        Endpoint& out = ep(0x00);
+        if (!out.out_armed) {
+            return std::nullopt;
+        }
+        out.out_armed = false;
+        usb_device_on_out(dev_, 0x00, 0);
+        return data;
+    }
+
+    // Host-to-device request; false if the device stalls
+    bool control_out(uint8_t type, uint8_t request, uint16_t value, uint16_t index,
+                     const std::vector<uint8_t>& data = {}) {
+        if (!setup(type, request, value, index, static_cast<uint16_t>(data.size()))) {
+            return false;
+        }
+
+        for (std::size_t sent = 0; sent < data.size();) {
+            const auto n = static_cast<uint16_t>(std::min<std::size_t>(USB_EP0_SIZE, data.size() - sent));
+            if (!out_packet(0x00, data.data() + sent, n) || ep0_stalled_) {
+                return false;
+            }
+            sent += n;
+        }
+        if (ep0_stalled_) {
+            return false;
+        }
+
+        // Status stage: zero-length IN
+        std::vector<uint8_t> none;
+        return in_packet(0x80, none) == 0 && !ep0_stalled_;
+    }
+
+    // =========================================================================
+    // Bulk transfers
+    // =========================================================================
+
+    // Up to max_packets IN packets (one frame's worth); stops at a NAK
+    int bulk_in(uint8_t address_in, int max_packets, std::vector<uint8_t>& out) {
+        int packets = 0;
+        while (packets < max_packets && in_packet(address_in, out) >= 0) {
+            packets++;
+        }
+        return packets;
+    }
+
+    // One OUT packet; false if the device NAKs
+    bool bulk_out(uint8_t address_out, const uint8_t* data, uint16_t len) {
+        return out_packet(address_out, data, len);
+    }
+
+private:
+    static UsbHostSim* self(void* hw) { return static_cast<UsbHostSim*>(hw); }
+
+    bool setup(uint8_t type, uint8_t request, uint16_t value, uint16_t index, uint16_t length) {
+        const uint8_t packet[8] = {type, request, static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8),
+                                   static_cast<uint8_t>(index), static_cast<uint8_t>(index >> 8),
+                                   static_cast<uint8_t>(length), static_cast<uint8_t>(length >> 8)};
+        // A SETUP is always accepted and clears an endpoint 0 stall
+        ep0_stalled_ = false;
+        ep(0x00).stalled = false;
+        ep(0x80).stalled = false;
+        usb_device_on_setup(dev_, packet);
+        return !ep0_stalled_;
+    }
+
+    // Take one packet from an IN endpoint: its length, or -1 on NAK/stall
+    int in_packet(uint8_t address_in, std::vector<uint8_t>& out) {
+        Endpoint& e = ep(address_in);
+        if (!e.in_armed || e.stalled) {
+            return -1;
+        }
+        const uint16_t n = std::min<uint16_t>(e.in_left, e.max_packet);
+        out.insert(out.end(), e.in_data, e.in_data + n);
+        e.in_data += n;
+        e.in_left = static_cast<uint16_t>(e.in_left - n);
+        if (n == 0) {
+            zlps++;
+        }
+        // The last packet is the short one, or the full one that used up the data
+        if (e.in_left == 0) {
+            e.in_armed = false;
+            usb_device_on_in(dev_, address_in);
+        }
+        return n;
+    }
+
+    bool out_packet(uint8_t address_out, const uint8_t* data, uint16_t len) {
+        Endpoint& e = ep(address_out);
+        if (!e.out_armed || e.stalled) {
+            return false;
+        }
+        EXPECT_LE(len, e.out_len) << "packet larger than the armed buffer";
+        std::memcpy(e.out_buf, data, std::min(len, e.out_len));
+        e.out_armed = false;
+        usb_device_on_out(dev_, address_out, len);
+        return true;
+    }
+
+    static void set_address(void* hw, uint8_t addr) { self(hw)->address = addr; }
+
+    static void ep_open(void* hw, uint8_t address_ep, uint8_t type, uint16_t max_packet, bool double_buffered) {
+        Endpoint& e = self(hw)->ep(address_ep);
+        e = Endpoint{};
+        e.open = true;
+        e.type = type;
+        e.max_packet = max_packet;
+        e.double_buffered = double_buffered;
+    }
+
+    static void ep_transmit(void* hw, uint8_t address_in, const uint8_t* data, uint16_t len) {
+        UsbHostSim* sim = self(hw);
+        Endpoint& e = sim->ep(address_in);
+        EXPECT_TRUE(e.open);
+        EXPECT_FALSE(e.in_armed) << "IN transfer started while one is in flight";
+        e.in_armed = true;
+        e.in_data = data;
+        e.in_left = len;
+        e.stalled = false;
+        if ((address_in & 0x0F) != 0 && len != 0) {
+            sim->in_transfers.push_back(data);
+        }
+    }
+
+    static void ep_receive(void* hw, uint8_t address_out, uint8_t* buf, uint16_t len) {
+        Endpoint& e = self(hw)->ep(address_out);
+        EXPECT_TRUE(e.open);
+        e.out_armed = true;
+        e.out_buf = buf;
+        e.out_len = len;
+        e.stalled = false;
+    }
+
+    static void ep_stall(void* hw, uint8_t address_ep, bool stall) {
+        UsbHostSim* sim = self(hw);
+        sim->ep(address_ep).stalled = stall;
+        if ((address_ep & 0x0F) == 0 && stall) {
+            sim->ep0_stalled_ = true;
+        }
+    }
+
+    usb_device_t* dev_ = nullptr;
+    Endpoint eps_[32];
+    bool ep0_stalled_ = false;
+};
@@ -0,0 +1,95 @@
+#include "wav_file.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+void put16(std::vector<uint8_t>& out, uint16_t v) {
+    out.push_back(static_cast<uint8_t>(v));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+void put32(std::vector<uint8_t>& out, uint32_t v) {
+    put16(out, static_cast<uint16_t>(v));
+    put16(out, static_cast<uint16_t>(v >> 16));
+}
+
+uint16_t get16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t get32(const uint8_t* p) {
+    return get16(p) | (static_cast<uint32_t>(get16(p + 2)) << 16);
+}
+
+}  // namespace
+
+bool wav_write(const std::string& path, const WavData& wav) {
+    const uint32_t data_bytes = static_cast<uint32_t>(wav.samples.size() * sizeof(int16_t));
+    std::vector<uint8_t> out;
+    out.insert(out.end(), {'R', 'I', 'F', 'F'});
+    put32(out, 36 + data_bytes);
+    out.insert(out.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+    put32(out, 16);
+    put16(out, 1);  // PCM
+    put16(out, wav.channels);
+    put32(out, wav.sample_rate);
+    put32(out, wav.sample_rate * wav.channels * 2);
+    put16(out, static_cast<uint16_t>(wav.channels * 2));
+    put16(out, 16);
+    out.insert(out.end(), {'d', 'a', 't', 'a'});
+    put32(out, data_bytes);
+    for (int16_t s : wav.samples) {
+        put16(out, static_cast<uint16_t>(s));
+    }
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        return false;
+    }
+    const bool ok = std::fwrite(out.data(), 1, out.size(), f) == out.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+bool wav_read(const std::string& path, WavData& wav) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        return false;
+    }
+    std::vector<uint8_t> in;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        in.insert(in.end(), chunk, chunk + n);
+    }
+    std::fclose(f);
+
+    if (in.size() < 12 || std::memcmp(in.data(), "RIFF", 4) != 0 || std::memcmp(in.data() + 8, "WAVE", 4) != 0) {
+        return false;
+    }
+    bool have_fmt = false;
+    for (size_t at = 12; at + 8 <= in.size();) {
+        const uint8_t* id = in.data() + at;
+        const uint32_t len = get32(id + 4);
+        const uint8_t* body = id + 8;
+        if (at + 8 + len > in.size()) {
+            return false;
+        }
+        if (std::memcmp(id, "fmt ", 4) == 0 && len >= 16) {
+            if (get16(body) != 1 || get16(body + 14) != 16) {
+                return false;   // Only 16-bit PCM
+            }
+            wav.channels = get16(body + 2);
+            wav.sample_rate = get32(body + 4);
+            have_fmt = true;
+        } else if (std::memcmp(id, "data", 4) == 0 && have_fmt) {
+            wav.samples.resize(len / 2);
+            for (size_t i = 0; i < wav.samples.size(); i++) {
+                wav.samples[i] = static_cast<int16_t>(get16(body + 2 * i));
+            }
+            return true;
+        }
+        at += 8 + len + (len & 1);
+    }
+    return false;
+}
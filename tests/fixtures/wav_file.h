@@ -0,0 +1,17 @@
+#pragma once
+
+// Minimal 16-bit PCM WAV reader and writer, used as the host-side file
+// source and sink of the audio pipeline tests.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct WavData {
+    uint32_t sample_rate = 0;
+    uint16_t channels = 0;
+    std::vector<int16_t> samples;   // Interleaved by frame
+};
+
+bool wav_write(const std::string& path, const WavData& wav);
+bool wav_read(const std::string& path, WavData& wav);
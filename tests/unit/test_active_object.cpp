@@ -0,0 +1,358 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "active_object.h"
+#include "ao_examples.h"
+}
+
+// =============================================================================
+// Hierarchical state machine
+//
+//   top
+//   +-- s
+//       +-- s1
+//       |   +-- s11
+//       +-- s2
+//           +-- s21
+//               +-- s211
+// =============================================================================
+
+namespace {
+
+enum { SIG_A = HSM_SIG_USER, SIG_B, SIG_C, SIG_D, SIG_E };
+
+struct test_hsm_t {
+    hsm_t super;
+};
+
+std::vector<std::string> g_log;
+
+hsm_ret_t s(test_hsm_t* me, const ao_event_t* e);
+hsm_ret_t s1(test_hsm_t* me, const ao_event_t* e);
+hsm_ret_t s11(test_hsm_t* me, const ao_event_t* e);
+hsm_ret_t s2(test_hsm_t* me, const ao_event_t* e);
+hsm_ret_t s21(test_hsm_t* me, const ao_event_t* e);
+hsm_ret_t s211(test_hsm_t* me, const ao_event_t* e);
+
+bool log_reserved(const char* name, const ao_event_t* e) {
+    switch (e->sig) {
+    case HSM_SIG_ENTRY: g_log.push_back(std::string(name) + "-ENTRY"); return true;
+    case HSM_SIG_EXIT:  g_log.push_back(std::string(name) + "-EXIT"); return true;
+    default: return false;
+    }
+}
+
+hsm_ret_t initial(test_hsm_t* me, const ao_event_t*) {
+    return HSM_TRAN(s2);
+}
+
+hsm_ret_t s(test_hsm_t* me, const ao_event_t* e) {
+    if (log_reserved("s", e)) return HSM_HANDLED();
+    switch (e->sig) {
+    case HSM_SIG_INIT: return HSM_TRAN(s11);
+    case SIG_E:        return HSM_TRAN(s11);
+    default:           return HSM_SUPER(hsm_top);
+    }
+}
+
+hsm_ret_t s1(test_hsm_t* me, const ao_event_t* e) {
+    if (log_reserved("s1", e)) return HSM_HANDLED();
+    switch (e->sig) {
+    case HSM_SIG_INIT: return HSM_TRAN(s11);
+    case SIG_A:        return HSM_TRAN(s1);
+    case SIG_C:        return HSM_TRAN(s2);
+    default:           return HSM_SUPER(s);
+    }
+}
+
+hsm_ret_t s11(test_hsm_t* me, const ao_event_t* e) {
+    if (log_reserved("s11", e)) return HSM_HANDLED();
+    switch (e->sig) {
+    case SIG_D: return HSM_TRAN(s1);
+    default:    return HSM_SUPER(s1);
+    }
+}
+
+hsm_ret_t s2(test_hsm_t* me, const ao_event_t* e) {
+    if (log_reserved("s2", e)) return HSM_HANDLED();
+    switch (e->sig) {
+    case HSM_SIG_INIT: return HSM_TRAN(s211);
+    case SIG_C:        return HSM_TRAN(s1);
+    default:           return HSM_SUPER(s);
+    }
+}
+
+hsm_ret_t s21(test_hsm_t* me, const ao_event_t* e) {
+    if (log_reserved("s21", e)) return HSM_HANDLED();
+    switch (e->sig) {
+    case SIG_B: return HSM_TRAN(s211);
+    default:    return HSM_SUPER(s2);
+    }
+}
+
+hsm_ret_t s211(test_hsm_t* me, const ao_event_t* e) {
+    if (log_reserved("s211", e)) return HSM_HANDLED();
+    switch (e->sig) {
+    case SIG_D: return HSM_TRAN(s21);
+    default:    return HSM_SUPER(s21);
+    }
+}
+
+const ao_event_t evt_a = { SIG_A, 0, 0 };
+const ao_event_t evt_b = { SIG_B, 0, 0 };
+const ao_event_t evt_c = { SIG_C, 0, 0 };
+const ao_event_t evt_d = { SIG_D, 0, 0 };
+const ao_event_t evt_e = { SIG_E, 0, 0 };
+
+using Log = std::vector<std::string>;
+
+} // namespace
+
+class HsmTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        g_log.clear();
+        hsm_ctor(&sm.super, HSM_STATE(initial));
+        hsm_init(&sm.super, nullptr);
+    }
+
+    Log take() {
+        Log out;
+        out.swap(g_log);
+        return out;
+    }
+
+    test_hsm_t sm;
+};
+
+TEST_F(HsmTest, InitEntersDownToLeaf) {
+    EXPECT_EQ(take(), (Log{"s-ENTRY", "s2-ENTRY", "s21-ENTRY", "s211-ENTRY"}));
+    EXPECT_EQ(sm.super.state, HSM_STATE(s211));
+    EXPECT_TRUE(hsm_is_in(&sm.super, HSM_STATE(s2)));
+    EXPECT_FALSE(hsm_is_in(&sm.super, HSM_STATE(s1)));
+}
+
+TEST_F(HsmTest, InheritedTransitionToSibling) {
+    take();
+    hsm_dispatch(&sm.super, &evt_c);  // Handled by s2
+    EXPECT_EQ(take(), (Log{"s211-EXIT", "s21-EXIT", "s2-EXIT", "s1-ENTRY", "s11-ENTRY"}));
+    EXPECT_EQ(sm.super.state, HSM_STATE(s11));
+}
+
+TEST_F(HsmTest, TransitionToOwnSubstateDoesNotExitSource) {
+    take();
+    hsm_dispatch(&sm.super, &evt_b);  // s21 -> s211 while in s211
+    EXPECT_EQ(take(), (Log{"s211-EXIT", "s211-ENTRY"}));
+}
+
+TEST_F(HsmTest, TransitionToSuperstateRunsItsInitial) {
+    take();
+    hsm_dispatch(&sm.super, &evt_d);  // s211 -> s21, s21 has no initial
+    EXPECT_EQ(take(), (Log{"s211-EXIT"}));
+    EXPECT_EQ(sm.super.state, HSM_STATE(s21));
+}
+
+TEST_F(HsmTest, SelfTransitionExitsAndReenters) {
+    hsm_dispatch(&sm.super, &evt_c);
+    take();
+    hsm_dispatch(&sm.super, &evt_a);  // s1 -> s1 from s11
+    EXPECT_EQ(take(), (Log{"s11-EXIT", "s1-EXIT", "s1-ENTRY", "s11-ENTRY"}));
+}
+
+TEST_F(HsmTest, TransitionAcrossLevels) {
+    take();
+    hsm_dispatch(&sm.super, &evt_e);  // s -> s11 from s211
+    EXPECT_EQ(take(), (Log{"s211-EXIT", "s21-EXIT", "s2-EXIT", "s1-ENTRY", "s11-ENTRY"}));
+}
+
+// =============================================================================
+// Active objects, pools and time events
+// =============================================================================
+
+namespace {
+
+struct recorder_t {
+    ao_active_t super;
+    std::vector<uint16_t> seen;
+};
+
+hsm_ret_t recorder_idle(recorder_t* me, const ao_event_t* e) {
+    if (e->sig >= HSM_SIG_USER) {
+        me->seen.push_back(e->sig);
+        return HSM_HANDLED();
+    }
+    return HSM_SUPER(hsm_top);
+}
+
+hsm_ret_t recorder_initial(recorder_t* me, const ao_event_t*) {
+    return HSM_TRAN(recorder_idle);
+}
+
+struct big_evt_t {
+    ao_event_t super;
+    uint8_t payload[24];
+};
+
+} // namespace
+
+class ActiveObjectTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ao_framework_init();
+        start(low, 0);
+        start(high, 1);
+    }
+
+    void start(recorder_t& r, uint8_t prio) {
+        ao_ctor(&r.super, HSM_STATE(recorder_initial));
+        r.seen.clear();
+        ASSERT_EQ(ao_start(&r.super, 0, prio, queues[prio], 4, nullptr), 0);
+    }
+
+    recorder_t low;
+    recorder_t high;
+    const ao_event_t* queues[2][4];
+};
+
+TEST_F(ActiveObjectTest, HigherPriorityObjectRunsFirst) {
+    ao_post(&low.super, &evt_a);
+    ao_post(&high.super, &evt_b);
+    ao_post(&high.super, &evt_c);
+
+    EXPECT_TRUE(ao_level_run_one(0));
+    EXPECT_TRUE(ao_level_run_one(0));
+    EXPECT_TRUE(low.seen.empty());
+    EXPECT_TRUE(ao_level_run_one(0));
+    EXPECT_FALSE(ao_level_run_one(0));
+
+    EXPECT_EQ(high.seen, (std::vector<uint16_t>{SIG_B, SIG_C}));
+    EXPECT_EQ(low.seen, (std::vector<uint16_t>{SIG_A}));
+}
+
+TEST_F(ActiveObjectTest, FullQueueDropsAndCounts) {
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(ao_post(&low.super, &evt_a));
+    }
+    EXPECT_FALSE(ao_post(&low.super, &evt_a));
+    EXPECT_EQ(low.super.dropped, 1u);
+    EXPECT_EQ(low.super.max_count, 4u);
+}
+
+TEST_F(ActiveObjectTest, PoolEventsReturnAfterLastConsumer) {
+    static void* small_pool[2];
+    static big_evt_t big_pool[2];
+    const int small = ao_pool_init(small_pool, sizeof(void*), 2);
+    const int big = ao_pool_init(big_pool, sizeof(big_evt_t), 2);
+    ASSERT_EQ(small, 1);
+    ASSERT_EQ(big, 2);
+
+    big_evt_t* e = AO_EVENT_NEW(big_evt_t, SIG_D);
+    ASSERT_NE(e, nullptr);
+    EXPECT_EQ(e->super.pool, big);
+
+    // Same event to two objects by reference
+    ao_post(&low.super, &e->super);
+    ao_post(&high.super, &e->super);
+
+    ao_pool_stats_t stats;
+    ao_pool_get_stats(big, &stats);
+    EXPECT_EQ(stats.free, 1u);
+
+    ao_level_run_one(0);
+    ao_pool_get_stats(big, &stats);
+    EXPECT_EQ(stats.free, 1u);
+    ao_level_run_one(0);
+    ao_pool_get_stats(big, &stats);
+    EXPECT_EQ(stats.free, 2u);
+    EXPECT_EQ(stats.min_free, 1u);
+
+    // Exhaustion is reported, not served from a larger pool
+    EXPECT_NE(ao_event_new(sizeof(ao_event_t), SIG_A), nullptr);
+    EXPECT_NE(ao_event_new(sizeof(ao_event_t), SIG_A), nullptr);
+    EXPECT_EQ(ao_event_new(sizeof(ao_event_t), SIG_A), nullptr);
+    ao_pool_get_stats(small, &stats);
+    EXPECT_EQ(stats.failures, 1u);
+}
+
+TEST_F(ActiveObjectTest, TimeEventsOneShotAndPeriodic) {
+    ao_time_event_t once;
+    ao_time_event_t every;
+    ao_time_event_ctor(&once, SIG_A, &low.super);
+    ao_time_event_ctor(&every, SIG_B, &low.super);
+    ao_time_event_arm(&once, 2, 0);
+    ao_time_event_arm(&every, 3, 3);
+
+    for (int t = 0; t < 9; t++) {
+        ao_tick();
+        while (ao_level_run_one(0)) {
+        }
+    }
+    EXPECT_EQ(low.seen, (std::vector<uint16_t>{SIG_A, SIG_B, SIG_B, SIG_B}));
+
+    EXPECT_TRUE(ao_time_event_disarm(&every));
+    EXPECT_FALSE(ao_time_event_disarm(&once));
+    ao_tick();
+    ao_tick();
+    ao_tick();
+    EXPECT_FALSE(ao_level_run_one(0));
+}
+
+// =============================================================================
+// Blinky and Heartbeat examples
+// =============================================================================
+
+namespace {
+
+std::vector<bool> g_led;
+std::vector<uint32_t> g_beats;
+
+void set_led(bool on) { g_led.push_back(on); }
+void on_heartbeat(uint32_t count) { g_beats.push_back(count); }
+
+const ao_event_t pause_evt = { SIG_BLINK_PAUSE, 0, 0 };
+const ao_event_t resume_evt = { SIG_BLINK_RESUME, 0, 0 };
+
+void run_ticks(int ticks) {
+    for (int t = 0; t < ticks; t++) {
+        while (ao_level_run_one(0)) {
+        }
+        ao_tick();
+    }
+    while (ao_level_run_one(0)) {
+    }
+}
+
+} // namespace
+
+TEST(AoExamplesTest, BlinkyAndHeartbeatShareOneLevel) {
+    ao_framework_init();
+    g_led.clear();
+    g_beats.clear();
+
+    const ao_examples_config_t config = { set_led, on_heartbeat, 5, 20, 0 };
+    ASSERT_EQ(ao_examples_start(&config), 0);
+    EXPECT_EQ(g_led, (std::vector<bool>{false}));
+
+    run_ticks(40);
+    EXPECT_EQ(g_blinky.toggles, 8u);
+    EXPECT_EQ(g_beats, (std::vector<uint32_t>{1, 2}));
+
+    // Pool events are all back after the consumer ran
+    ao_pool_stats_t stats;
+    ao_pool_get_stats(1, &stats);
+    EXPECT_EQ(stats.free, stats.blocks);
+
+    ao_post(&g_blinky.super, &pause_evt);
+    run_ticks(20);
+    EXPECT_EQ(g_blinky.toggles, 8u);
+    EXPECT_FALSE(g_blinky.led_on);
+    EXPECT_EQ(g_beats.size(), 2u);  // Beats dropped while paused
+    EXPECT_EQ(g_heartbeat.count, 3u);
+
+    ao_post(&g_blinky.super, &resume_evt);
+    run_ticks(5);
+    EXPECT_EQ(g_blinky.toggles, 9u);
+    EXPECT_TRUE(g_blinky.led_on);
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+extern "C" {
+#include "adc_stream.h"
+}
+
+namespace {
+
+std::vector<adc_block_t> blocks;
+void collect(void*, const adc_block_t* block) {
+    blocks.push_back(*block);
+}
+
+// Result of channel c in scan s: easy to recognize after deinterleaving
+uint16_t result(uint32_t s, uint8_t c) {
+    return static_cast<uint16_t>(c * 1000u + s % 1000u);
+}
+
+}  // namespace
+
+class AdcStreamTest : public ::testing::Test {
+protected:
+    static constexpr uint8_t kChannels = 3;
+    static constexpr uint16_t kFrames = 16;
+
+    void SetUp() override {
+        blocks.clear();
+        ASSERT_EQ(adc_stream_init(&stream, dma, kChannels, kFrames, collect, nullptr), 0);
+    }
+
+    // What the circular DMA does: store one scan, raising HT and TC at the halves
+    void scan() {
+        const uint32_t s = scans_++;
+        uint16_t* slot = dma + pos_ * kChannels;
+        for (uint8_t c = 0; c < kChannels; c++) {
+            slot[c] = result(s, c);
+        }
+        pos_ = (pos_ + 1) % (2 * kFrames);
+        if (pos_ == kFrames) {
+            adc_stream_half_done(&stream, 0);
+        } else if (pos_ == 0) {
+            adc_stream_half_done(&stream, 1);
+        }
+    }
+
+    void scans(uint32_t n) {
+        for (uint32_t i = 0; i < n; i++) {
+            scan();
+        }
+    }
+
+    void expect_block(const adc_block_t& block, uint32_t first_scan) {
+        ASSERT_EQ(block.frames, kFrames);
+        ASSERT_EQ(block.channels, kChannels);
+        for (uint16_t f = 0; f < kFrames; f++) {
+            for (uint8_t c = 0; c < kChannels; c++) {
+                ASSERT_EQ(block.ch[c][f], result(first_scan + f, c)) << "frame " << f << " ch " << +c;
+            }
+        }
+    }
+
+    uint16_t dma[2 * kFrames * kChannels] = {};
+    adc_stream_t stream;
+    uint32_t scans_ = 0;
+    uint32_t pos_ = 0;
+};
+
+TEST_F(AdcStreamTest, DeinterleavesScansIntoChannelArrays) {
+    const uint16_t interleaved[] = {1, 2, 3, 4, 5, 6};
+    adc_block_t out = {};
+    adc_stream_deinterleave(interleaved, 2, 3, &out);
+    EXPECT_EQ(out.frames, 3u);
+    EXPECT_EQ(out.channels, 2u);
+    EXPECT_EQ(out.ch[0][0], 1u);
+    EXPECT_EQ(out.ch[0][2], 5u);
+    EXPECT_EQ(out.ch[1][0], 2u);
+    EXPECT_EQ(out.ch[1][2], 6u);
+}
+
+TEST_F(AdcStreamTest, DeliversEachHalfInTurn) {
+    EXPECT_FALSE(adc_stream_service(&stream));
+
+    for (uint32_t half = 0; half < 6; half++) {
+        scans(kFrames - 1);
+        EXPECT_FALSE(adc_stream_service(&stream));
+        scan();
+        EXPECT_TRUE(adc_stream_service(&stream));
+    }
+
+    ASSERT_EQ(blocks.size(), 6u);
+    for (uint32_t b = 0; b < blocks.size(); b++) {
+        expect_block(blocks[b], b * kFrames);
+        EXPECT_EQ(blocks[b].seq, b + 1);
+    }
+
+    adc_stream_stats_t stats;
+    adc_stream_get_stats(&stream, &stats);
+    EXPECT_EQ(stats.halves, 6u);
+    EXPECT_EQ(stats.blocks, 6u);
+    EXPECT_EQ(stats.missed, 0u);
+}
+
+TEST_F(AdcStreamTest, LateConsumerGetsOnlyTheNewestHalf) {
+    scans(3 * kFrames);     // Halves 0, 1 and 0 again
+
+    EXPECT_TRUE(adc_stream_service(&stream));
+    EXPECT_FALSE(adc_stream_service(&stream));
+
+    ASSERT_EQ(blocks.size(), 1u);
+    expect_block(blocks[0], 2 * kFrames);
+    EXPECT_EQ(blocks[0].seq, 3u);
+
+    adc_stream_stats_t stats;
+    adc_stream_get_stats(&stream, &stats);
+    EXPECT_EQ(stats.halves, 3u);
+    EXPECT_EQ(stats.missed, 2u);
+}
+
+TEST_F(AdcStreamTest, RejectsInvalidGeometry) {
+    adc_stream_t s;
+    EXPECT_EQ(adc_stream_init(&s, dma, 0, kFrames, collect, nullptr), -1);
+    EXPECT_EQ(adc_stream_init(&s, dma, ADC_STREAM_MAX_CHANNELS + 1, kFrames, collect, nullptr), -1);
+    EXPECT_EQ(adc_stream_init(&s, dma, 1, ADC_STREAM_MAX_FRAMES + 1, collect, nullptr), -1);
+    EXPECT_EQ(adc_stream_init(&s, nullptr, 1, 1, collect, nullptr), -1);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <thread>
+
+extern "C" {
+#include "arena.h"
+}
+#include "arena.hpp"
+
+class ArenaTest : public ::testing::Test {
+protected:
+    alignas(ARENA_ALIGN) uint8_t storage[256];
+    arena_t arena;
+
+    void SetUp() override {
+        ASSERT_EQ(arena_init(&arena, storage, sizeof(storage)), 0);
+    }
+
+    void TearDown() override {
+        arena_bind(nullptr);
+    }
+};
+
+TEST_F(ArenaTest, InitRejectsBadArguments) {
+    arena_t other;
+    EXPECT_LT(arena_init(&other, nullptr, 64), 0);
+    EXPECT_LT(arena_init(&other, storage, 0), 0);
+    EXPECT_LT(arena_init(&other, storage + 1, 64), 0);
+}
+
+TEST_F(ArenaTest, AllocationsAreAlignedAndContiguous) {
+    auto* a = static_cast<uint8_t*>(arena_alloc(&arena, 3));
+    auto* b = static_cast<uint8_t*>(arena_alloc(&arena, 10));
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(a, storage);
+    EXPECT_EQ(b, storage + ARENA_ALIGN);
+
+    void* c = arena_alloc_aligned(&arena, 4, 64);
+    ASSERT_NE(c, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(c) % 64, 0u);
+    EXPECT_EQ(arena_alloc_aligned(&arena, 4, 3), nullptr);
+}
+
+TEST_F(ArenaTest, ExhaustionFailsCleanlyAndIsCounted) {
+    EXPECT_NE(arena_alloc(&arena, 200), nullptr);
+    EXPECT_EQ(arena_alloc(&arena, 64), nullptr);
+    EXPECT_EQ(arena_alloc(&arena, SIZE_MAX), nullptr);
+    EXPECT_NE(arena_alloc(&arena, 56), nullptr);   // Exactly fills the arena
+    EXPECT_EQ(arena_alloc(&arena, 1), nullptr);
+
+    arena_stats_t stats;
+    arena_get_stats(&arena, &stats);
+    EXPECT_EQ(stats.used, 256u);
+    EXPECT_EQ(stats.failures, 3u);
+}
+
+TEST_F(ArenaTest, ReleaseRollsBackToMarkAndKeepsHighWater) {
+    arena_alloc(&arena, 16);
+    const arena_mark_t mark = arena_mark(&arena);
+    void* first = arena_alloc(&arena, 100);
+    arena_release(&arena, mark);
+
+    // Memory after the mark is handed out again
+    EXPECT_EQ(arena_alloc(&arena, 8), first);
+
+    arena_reset(&arena);
+    arena_stats_t stats;
+    arena_get_stats(&arena, &stats);
+    EXPECT_EQ(stats.used, 0u);
+    EXPECT_EQ(stats.high_water, 116u);
+}
+
+TEST_F(ArenaTest, ScopesReleaseInnermostFirst) {
+    {
+        ArenaScope outer(&arena);
+        uint32_t* samples = outer.alloc<uint32_t>(8);
+        ASSERT_NE(samples, nullptr);
+        {
+            ArenaScope inner(&arena);
+            EXPECT_NE(inner.alloc<char>(100), nullptr);
+            EXPECT_EQ(arena.used, 132u);
+        }
+        EXPECT_EQ(arena.used, 32u);
+
+        struct Header { uint16_t type; uint16_t len; };
+        Header* h = outer.make<Header>(Header{7, 40});
+        ASSERT_NE(h, nullptr);
+        EXPECT_EQ(h->len, 40);
+    }
+    EXPECT_EQ(arena.used, 0u);
+}
+
+TEST_F(ArenaTest, DefaultScopeUsesTheTaskArena) {
+    {
+        ArenaScope unbound;
+        EXPECT_EQ(unbound.alloc<int>(), nullptr);
+    }
+
+    arena_bind(&arena);
+    EXPECT_EQ(arena_task(), &arena);
+
+    // Each thread (task) sees only its own binding
+    arena_t* seen = &arena;
+    std::thread other([&seen] { seen = arena_task(); });
+    other.join();
+    EXPECT_EQ(seen, nullptr);
+
+    {
+        ArenaScope scope;
+        EXPECT_EQ(scope.arena(), &arena);
+        EXPECT_NE(scope.alloc<uint8_t>(10), nullptr);
+    }
+    EXPECT_EQ(arena.used, 0u);
+}
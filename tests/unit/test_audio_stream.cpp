@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "wav_file.h"
+
+extern "C" {
+#include "audio_stream.h"
+}
+
+namespace {
+
+// Runs a stream the way the SAI does, with a WAV file as the receive side
+// and another as the transmit side: each source block is written into the
+// receive half the DMA would have filled, and each processed transmit half
+// is appended to the sink.
+class FilePipeline {
+public:
+    FilePipeline(audio_format_t format, uint8_t channels, uint16_t block_frames, audio_process_t process,
+                 void* arg) {
+        cfg_ = {format, channels, block_frames, process, arg};
+        rx_.resize(audio_stream_dma_bytes(&cfg_));
+        tx_.resize(audio_stream_dma_bytes(&cfg_));
+    }
+
+    bool run(const std::string& source, const std::string& sink) {
+        WavData in;
+        if (!wav_read(source, in) || in.channels != cfg_.channels) {
+            return false;
+        }
+        if (audio_stream_init(&stream_, &cfg_, rx_.data(), tx_.data()) != 0) {
+            return false;
+        }
+
+        WavData out;
+        out.sample_rate = in.sample_rate;
+        out.channels = in.channels;
+        const size_t block = static_cast<size_t>(cfg_.block_frames) * cfg_.channels;
+        const size_t bytes = audio_format_bytes(cfg_.format);
+        std::vector<int32_t> q31(block);
+        std::vector<int16_t> s16(block);
+        uint8_t half = 0;
+
+        for (size_t at = 0; at + block <= in.samples.size(); at += block, half ^= 1) {
+            // The codec side of the link carries 16-bit samples
+            audio_s16_to_q31(in.samples.data() + at, q31.data(), block);
+            audio_from_q31(cfg_.format, q31.data(), rx_.data() + half * block * bytes, block);
+
+            audio_stream_half_done(&stream_, half);
+
+            audio_to_q31(cfg_.format, tx_.data() + half * block * bytes, q31.data(), block);
+            audio_q31_to_s16(q31.data(), s16.data(), block);
+            out.samples.insert(out.samples.end(), s16.begin(), s16.end());
+        }
+        return wav_write(sink, out);
+    }
+
+    const audio_stream_t& stream() const { return stream_; }
+
+private:
+    audio_stream_config_t cfg_;
+    audio_stream_t stream_;
+    std::vector<uint8_t> rx_;
+    std::vector<uint8_t> tx_;
+};
+
+// Halve every sample (-6 dB)
+void half_gain(void*, int32_t* block, uint16_t frames, uint8_t channels) {
+    for (size_t i = 0; i < static_cast<size_t>(frames) * channels; i++) {
+        block[i] >>= 1;
+    }
+}
+
+// Swap the two slots of each frame, checking the block layout
+void swap_slots(void*, int32_t* block, uint16_t frames, uint8_t channels) {
+    for (uint16_t f = 0; f < frames; f++) {
+        std::swap(block[f * channels], block[f * channels + 1]);
+    }
+}
+
+WavData tone(uint8_t channels, size_t frames) {
+    WavData wav;
+    wav.sample_rate = 48000;
+    wav.channels = channels;
+    for (size_t f = 0; f < frames; f++) {
+        for (uint8_t c = 0; c < channels; c++) {
+            const double v = std::sin(2 * 3.14159265358979 * (440.0 * (c + 1)) * f / 48000.0);
+            wav.samples.push_back(static_cast<int16_t>(std::lround(v * (32767 - 1000 * c))));
+        }
+    }
+    return wav;
+}
+
+}  // namespace
+
+TEST(AudioFormatTest, Q31ToS16RoundsAndSaturates) {
+    const int32_t in[] = {0x7FFFFFFF, static_cast<int32_t>(0x80000000), 0x00008000, 0x00007FFF,
+                          -0x00008000, -0x00008001, 0x12345678};
+    int16_t out[7];
+    audio_q31_to_s16(in, out, 7);
+    EXPECT_EQ(out[0], 32767);
+    EXPECT_EQ(out[1], -32768);
+    EXPECT_EQ(out[2], 1);
+    EXPECT_EQ(out[3], 0);
+    EXPECT_EQ(out[4], 0);
+    EXPECT_EQ(out[5], -1);
+    EXPECT_EQ(out[6], 0x1234);
+}
+
+TEST(AudioFormatTest, S16AndS24RoundTripThroughQ31) {
+    const int16_t s16[] = {0, 1, -1, 32767, -32768};
+    int32_t q31[5];
+    int16_t back16[5];
+    audio_s16_to_q31(s16, q31, 5);
+    EXPECT_EQ(q31[1], 0x10000);
+    EXPECT_EQ(q31[4], static_cast<int32_t>(0x80000000));
+    audio_q31_to_s16(q31, back16, 5);
+    EXPECT_EQ(0, std::memcmp(s16, back16, sizeof(s16)));
+
+    // 24-bit slot words: only the low 24 bits count
+    const int32_t s24[] = {0x7FFFFF, 0x800000, 0x000001, static_cast<int32_t>(0xFFFFFFFF)};
+    int32_t back24[4];
+    audio_s24_to_q31(s24, q31, 4);
+    EXPECT_EQ(q31[0], 0x7FFFFF00);
+    EXPECT_EQ(q31[1], static_cast<int32_t>(0x80000000));
+    EXPECT_EQ(q31[3], -0x100);
+    audio_q31_to_s24(q31, back24, 4);
+    EXPECT_EQ(back24[0], 0x7FFFFF);
+    EXPECT_EQ(back24[1], -0x800000);
+    EXPECT_EQ(back24[2], 1);
+    EXPECT_EQ(back24[3], -1);
+}
+
+TEST(AudioStreamTest, FilePipelineAppliesBlockProcessing) {
+    const std::string dir = ::testing::TempDir();
+    const WavData source = tone(2, 48 * 20);
+    ASSERT_TRUE(wav_write(dir + "audio_src.wav", source));
+
+    FilePipeline pipe(AUDIO_FMT_S16, 2, 48, half_gain, nullptr);
+    ASSERT_TRUE(pipe.run(dir + "audio_src.wav", dir + "audio_sink.wav"));
+
+    WavData sink;
+    ASSERT_TRUE(wav_read(dir + "audio_sink.wav", sink));
+    ASSERT_EQ(sink.samples.size(), source.samples.size());
+    EXPECT_EQ(sink.sample_rate, 48000u);
+    for (size_t i = 0; i < sink.samples.size(); i++) {
+        // Arithmetic shift of the Q31 value, then rounding back to 16 bits
+        ASSERT_EQ(sink.samples[i], (source.samples[i] + (source.samples[i] & 1)) >> 1) << "sample " << i;
+    }
+
+    audio_stream_stats_t stats;
+    audio_stream_get_stats(&pipe.stream(), &stats);
+    EXPECT_EQ(stats.blocks, 20u);
+    EXPECT_EQ(stats.slips, 0u);
+}
+
+TEST(AudioStreamTest, Slots24BitKeepInterleavingThroughProcessing) {
+    const std::string dir = ::testing::TempDir();
+    const WavData source = tone(2, 32 * 8);
+    ASSERT_TRUE(wav_write(dir + "audio_src24.wav", source));
+
+    FilePipeline pipe(AUDIO_FMT_S24, 2, 32, swap_slots, nullptr);
+    ASSERT_TRUE(pipe.run(dir + "audio_src24.wav", dir + "audio_sink24.wav"));
+
+    WavData sink;
+    ASSERT_TRUE(wav_read(dir + "audio_sink24.wav", sink));
+    ASSERT_EQ(sink.samples.size(), source.samples.size());
+    for (size_t f = 0; f < sink.samples.size() / 2; f++) {
+        ASSERT_EQ(sink.samples[2 * f], source.samples[2 * f + 1]);
+        ASSERT_EQ(sink.samples[2 * f + 1], source.samples[2 * f]);
+    }
+}
+
+TEST(AudioStreamTest, PlaybackOnlyStartsSilentAndCountsSlips) {
+    audio_stream_config_t cfg = {AUDIO_FMT_S16, 4, 8, nullptr, nullptr};
+    std::vector<int16_t> tx(2 * 8 * 4, 0x5555);
+    audio_stream_t stream;
+    ASSERT_EQ(audio_stream_init(&stream, &cfg, nullptr, tx.data()), 0);
+    for (int16_t s : tx) {
+        ASSERT_EQ(s, 0);
+    }
+
+    audio_stream_half_done(&stream, 0);
+    audio_stream_half_done(&stream, 0);     // Half 1 was missed
+    audio_stream_stats_t stats;
+    audio_stream_get_stats(&stream, &stats);
+    EXPECT_EQ(stats.blocks, 2u);
+    EXPECT_EQ(stats.slips, 1u);
+
+    cfg.block_frames = AUDIO_STREAM_MAX_SAMPLES;
+    EXPECT_EQ(audio_stream_init(&stream, &cfg, nullptr, tx.data()), -1);
+    cfg.block_frames = 8;
+    EXPECT_EQ(audio_stream_init(&stream, &cfg, nullptr, nullptr), -1);
+}
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+extern "C" {
+#include "block_pool.h"
+}
+#include "pool_allocator.hpp"
+
+BLOCK_POOL_DEFINE(small, 16, 4);
+BLOCK_POOL_DEFINE(large, 64, 2);
+
+class BlockPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        mem_reset_pools();
+        ASSERT_EQ(block_pool_init(&small, small_storage, 16, 4), 0);
+        ASSERT_EQ(block_pool_init(&large, large_storage, 64, 2), 0);
+    }
+
+    void TearDown() override {
+        mem_reset_pools();
+    }
+};
+
+TEST_F(BlockPoolTest, InitRejectsBadArguments) {
+    block_pool_t pool;
+    EXPECT_LT(block_pool_init(&pool, nullptr, 16, 4), 0);
+    EXPECT_LT(block_pool_init(&pool, small_storage, 16, 0), 0);
+    EXPECT_LT(block_pool_init(&pool, small_storage + 1, 16, 2), 0);
+}
+
+TEST_F(BlockPoolTest, AllocatesDistinctAlignedBlocksUntilEmpty) {
+    std::set<void*> seen;
+    for (int i = 0; i < 4; i++) {
+        void* b = block_pool_alloc(&small);
+        ASSERT_NE(b, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % BLOCK_POOL_ALIGN, 0u);
+        EXPECT_TRUE(block_pool_owns(&small, b));
+        seen.insert(b);
+    }
+    EXPECT_EQ(seen.size(), 4u);
+    EXPECT_EQ(block_pool_alloc(&small), nullptr);
+
+    block_pool_stats_t stats;
+    block_pool_get_stats(&small, &stats);
+    EXPECT_EQ(stats.used, 4);
+    EXPECT_EQ(stats.failures, 1u);
+}
+
+TEST_F(BlockPoolTest, FreedBlockIsReusedAndPeakIsKept) {
+    void* a = block_pool_alloc(&small);
+    void* b = block_pool_alloc(&small);
+    block_pool_free(&small, b);
+    EXPECT_EQ(block_pool_alloc(&small), b);
+    block_pool_free(&small, a);
+    block_pool_free(&small, b);
+
+    block_pool_stats_t stats;
+    block_pool_get_stats(&small, &stats);
+    EXPECT_EQ(stats.used, 0);
+    EXPECT_EQ(stats.peak_used, 2);
+    EXPECT_EQ(stats.block_size, 16);
+}
+
+TEST_F(BlockPoolTest, SizeClassesPickSmallestFitAndSpillOver) {
+    // Registered out of order: the classes are sorted by block size
+    ASSERT_EQ(mem_register_pool(&large), 0);
+    ASSERT_EQ(mem_register_pool(&small), 0);
+    EXPECT_EQ(mem_class_count(), 2u);
+
+    void* blocks[4];
+    for (auto& b : blocks) {
+        b = mem_alloc(12);
+        EXPECT_TRUE(block_pool_owns(&small, b));
+    }
+
+    // Small class exhausted: the next request spills into the large class
+    void* spill = mem_alloc(12);
+    EXPECT_TRUE(block_pool_owns(&large, spill));
+    EXPECT_EQ(mem_alloc(100), nullptr);
+
+    block_pool_stats_t stats;
+    ASSERT_EQ(mem_get_class_stats(0, &stats), 0);
+    EXPECT_EQ(stats.block_size, 16);
+    EXPECT_EQ(stats.used, 4);
+    EXPECT_EQ(stats.failures, 1u);
+
+    for (auto b : blocks) {
+        EXPECT_EQ(mem_free(b), 0);
+    }
+    EXPECT_EQ(mem_free(spill), 0);
+    int outside;
+    EXPECT_LT(mem_free(&outside), 0);
+
+    ASSERT_EQ(mem_get_class_stats(1, &stats), 0);
+    EXPECT_EQ(stats.used, 0);
+    EXPECT_EQ(stats.peak_used, 1);
+}
+
+TEST_F(BlockPoolTest, AllocatorAdaptorBacksContainersAndObjects) {
+    mem_register_pool(&small);
+    mem_register_pool(&large);
+
+    std::vector<uint32_t, PoolAllocator<uint32_t>> values;
+    values.reserve(10);
+    for (uint32_t i = 0; i < 10; i++) {
+        values.push_back(i);
+    }
+    EXPECT_TRUE(block_pool_owns(&large, values.data()));
+
+    struct Descriptor {
+        explicit Descriptor(int ch) : channel(ch) {}
+        int channel;
+    };
+    Descriptor* d = pool_new<Descriptor>(3);
+    ASSERT_NE(d, nullptr);
+    EXPECT_TRUE(block_pool_owns(&small, d));
+    EXPECT_EQ(d->channel, 3);
+    pool_delete(d);
+
+    // Nothing fits 512 bytes
+    EXPECT_THROW(values.reserve(128), std::bad_alloc);
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "coro.hpp"
+
+namespace {
+
+std::vector<int> g_log;
+
+coro::Task ticker(int id, uint32_t period, int repeats) {
+    for (int i = 0; i < repeats; i++) {
+        co_await coro::delay(period);
+        g_log.push_back(id);
+    }
+}
+
+coro::Task waiter(coro::Notification& notification, uint32_t& received, uint32_t until) {
+    while (received < until) {
+        received += co_await notification;
+    }
+}
+
+coro::Task transfer(coro::Completion<int>& done, int& result) {
+    done.reset();
+    result = co_await done;
+}
+
+coro::Task edge_counter(coro::GpioEdge& edge, int& edges, int until) {
+    while (edges < until) {
+        co_await edge;
+        edges++;
+    }
+}
+
+} // namespace
+
+// Test fixture for the coroutine executor
+class CoroTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        g_log.clear();
+    }
+};
+
+TEST_F(CoroTest, DelaysInterleaveOnOneExecutor) {
+    coro::Executor executor;
+    ASSERT_TRUE(executor.spawn(ticker(1, 10, 3)));
+    ASSERT_TRUE(executor.spawn(ticker(2, 15, 2)));
+
+    EXPECT_EQ(executor.run_once(0), 10u);
+    EXPECT_EQ(executor.run_once(10), 5u);
+    EXPECT_EQ(executor.run_once(15), 5u);
+    EXPECT_EQ(executor.run_once(20), 10u);
+    EXPECT_EQ(executor.run_once(30), CORO_WAIT_FOREVER);
+
+    EXPECT_EQ(g_log, (std::vector<int>{1, 2, 1, 2, 1}));
+    EXPECT_EQ(executor.live_tasks(), 0u);
+    EXPECT_EQ(coro::frame_pool_stats().in_use, 0u);
+}
+
+TEST_F(CoroTest, NotificationAccumulatesWhileNotWaiting) {
+    coro::Executor executor;
+    coro::Notification notification;
+    uint32_t received = 0;
+    executor.spawn(waiter(notification, received, 4));
+
+    executor.run_once(0);
+    EXPECT_EQ(received, 0u);
+
+    notification.notify();
+    notification.notify();
+    notification.notify();
+    executor.run_once(1);
+    EXPECT_EQ(received, 3u);
+    EXPECT_EQ(notification.pending(), 0u);
+
+    // Nothing to do without a new notification
+    executor.run_once(2);
+    EXPECT_EQ(received, 3u);
+
+    notification.notify();
+    executor.run_once(3);
+    EXPECT_EQ(executor.live_tasks(), 0u);
+}
+
+TEST_F(CoroTest, CompletionDeliversDriverResult) {
+    coro::Executor executor;
+    coro::Completion<int> done;
+    int result = 0;
+    executor.spawn(transfer(done, result));
+
+    executor.run_once(0);
+    EXPECT_EQ(executor.live_tasks(), 1u);
+
+    done.complete(42);  // e.g. from a DMA transfer-complete ISR
+    executor.run_once(1);
+    EXPECT_EQ(result, 42);
+    EXPECT_EQ(executor.live_tasks(), 0u);
+}
+
+TEST_F(CoroTest, GpioEdgeDispatchByPinMask) {
+    coro::Executor executor;
+    coro::GpioEdge button(1U << 13);
+    int edges = 0;
+    executor.spawn(edge_counter(button, edges, 1));
+    executor.run_once(0);
+
+    coro::GpioEdge::dispatch(1U << 4);   // Other line
+    executor.run_once(1);
+    EXPECT_EQ(edges, 0);
+
+    coro::GpioEdge::dispatch(1U << 13);
+    executor.run_once(2);
+    EXPECT_EQ(edges, 1);
+    EXPECT_EQ(executor.live_tasks(), 0u);
+}
+
+TEST_F(CoroTest, FramePoolExhaustionYieldsEmptyTask) {
+    coro::Executor executor;
+    static coro::Completion<int> done[CORO_MAX_FRAMES + 1];
+    static int results[CORO_MAX_FRAMES + 1];
+
+    const uint32_t failures = coro::frame_pool_stats().failures;
+    for (int i = 0; i < CORO_MAX_FRAMES; i++) {
+        ASSERT_TRUE(executor.spawn(transfer(done[i], results[i])));
+    }
+    EXPECT_FALSE(executor.spawn(transfer(done[CORO_MAX_FRAMES], results[CORO_MAX_FRAMES])));
+    EXPECT_EQ(coro::frame_pool_stats().failures, failures + 1);
+    EXPECT_EQ(coro::frame_pool_stats().high_water, (uint32_t)CORO_MAX_FRAMES);
+
+    executor.run_once(0);
+    for (int i = 0; i < CORO_MAX_FRAMES; i++) {
+        done[i].complete(i);
+    }
+    executor.run_once(1);
+    EXPECT_EQ(results[CORO_MAX_FRAMES - 1], CORO_MAX_FRAMES - 1);
+    EXPECT_EQ(coro::frame_pool_stats().in_use, 0u);
+}
+
+TEST_F(CoroTest, UnspawnedTaskReleasesItsFrame) {
+    coro::Completion<int> done;
+    int result = 0;
+    {
+        coro::Task task = transfer(done, result);
+        EXPECT_TRUE(task.valid());
+        EXPECT_EQ(coro::frame_pool_stats().in_use, 1u);
+    }
+    EXPECT_EQ(coro::frame_pool_stats().in_use, 0u);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "hal_irq_fake.h"
+#include "hal_irq.hpp"
+
+namespace {
+
+constexpr int kUartIrq = 38;
+constexpr int kTimerIrq = 28;
+
+struct Counter {
+    int hits = 0;
+    int ticks = 0;
+    void onIrq() { hits++; }
+    void onTick() noexcept { ticks++; }
+};
+
+int freeCalls = 0;
+void freeHandler() {
+    freeCalls++;
+}
+
+}  // namespace
+
+class HalIrqTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        hal_irq_fake_reset();
+        freeCalls = 0;
+    }
+};
+
+TEST_F(HalIrqTest, BindRequiresRelocatedTable) {
+    EXPECT_EQ(hal_irq_bind(kUartIrq, freeHandler), -1);
+    ASSERT_EQ(hal_irq_vectors_init(), 0);
+    EXPECT_TRUE(hal_irq_vectors_relocated());
+    EXPECT_EQ(hal_irq_bind(kUartIrq, freeHandler), 0);
+
+    hal_irq_fake_raise(kUartIrq);
+    EXPECT_EQ(freeCalls, 1);
+    EXPECT_EQ(hal_irq_fake_default_calls(), 0u);
+}
+
+TEST_F(HalIrqTest, RejectsKernelVectorsAndBadArguments) {
+    hal_irq_vectors_init();
+    EXPECT_EQ(hal_irq_bind(-5, freeHandler), -2);   // SVCall
+    EXPECT_EQ(hal_irq_bind(-2, freeHandler), -2);   // PendSV
+    EXPECT_EQ(hal_irq_bind(-15, freeHandler), -2);  // Reset
+    EXPECT_EQ(hal_irq_bind(HAL_IRQ_FAKE_IRQS, freeHandler), -2);
+    EXPECT_EQ(hal_irq_bind(kUartIrq, nullptr), -3);
+    EXPECT_EQ(hal_irq_get(HAL_IRQ_FAKE_IRQS), nullptr);
+}
+
+TEST_F(HalIrqTest, UnbindRestoresFlashHandler) {
+    hal_irq_vectors_init();
+    const hal_irq_handler_t original = hal_irq_get(kUartIrq);
+    hal::irq_bind<kUartIrq>(freeHandler);
+    EXPECT_EQ(hal_irq_get(kUartIrq), &freeHandler);
+
+    EXPECT_EQ(hal_irq_unbind(kUartIrq), 0);
+    EXPECT_EQ(hal_irq_get(kUartIrq), original);
+    hal_irq_fake_raise(kUartIrq);
+    EXPECT_EQ(hal_irq_fake_default_calls(), 1u);
+}
+
+TEST_F(HalIrqTest, MemberTrampolinesDispatchToTheirObject) {
+    hal_irq_vectors_init();
+    Counter uart;
+    Counter timer;
+
+    using UartBinding = hal::IrqBinding<kUartIrq, &Counter::onIrq>;
+    using TimerBinding = hal::IrqBinding<kTimerIrq, &Counter::onTick>;
+    ASSERT_EQ(UartBinding::bind(uart), 0);
+    ASSERT_EQ(TimerBinding::bind(timer), 0);
+    EXPECT_EQ(hal_irq_get(kUartIrq), &UartBinding::handler);
+
+    hal_irq_fake_raise(kUartIrq);
+    hal_irq_fake_raise(kUartIrq);
+    hal_irq_fake_raise(kTimerIrq);
+    EXPECT_EQ(uart.hits, 2);
+    EXPECT_EQ(uart.ticks, 0);
+    EXPECT_EQ(timer.ticks, 1);
+
+    EXPECT_EQ(UartBinding::unbind(), 0);
+    hal_irq_fake_raise(kUartIrq);
+    EXPECT_EQ(uart.hits, 2);
+    EXPECT_EQ(hal_irq_fake_default_calls(), 1u);
+}
+
+TEST_F(HalIrqTest, ReadsLinkedTableUntilRelocated) {
+    // Before relocation the linked table is what the core dispatches from
+    ASSERT_NE(hal_irq_get(kUartIrq), nullptr);
+    hal_irq_fake_raise(kUartIrq);
+    EXPECT_EQ(hal_irq_fake_default_calls(), 1u);
+    EXPECT_FALSE(hal_irq_vectors_relocated());
+
+    ASSERT_EQ(hal_irq_vectors_init(), 0);
+    EXPECT_EQ(hal_irq_get(kUartIrq), hal_irq_get(kTimerIrq));   // Copied
+    EXPECT_EQ(hal_irq_vectors_init(), 0);
+    EXPECT_TRUE(hal_irq_vectors_relocated());
+}
+
+TEST_F(HalIrqTest, CoreExceptionsOtherThanKernelOnesCanBeBound) {
+    hal_irq_vectors_init();
+    EXPECT_EQ(hal_irq_bind(-14, freeHandler), 0);   // NMI
+    EXPECT_EQ(hal_irq_bind(-1, freeHandler), 0);    // SysTick
+    EXPECT_EQ(hal_irq_bind(HAL_IRQ_FAKE_IRQS - 1, freeHandler), 0);
+    EXPECT_EQ(hal_irq_get(-14), &freeHandler);
+    EXPECT_EQ(hal_irq_get(-16), nullptr);           // Initial SP is not a handler
+}
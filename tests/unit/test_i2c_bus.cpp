@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "i2c_bus.h"
+}
+
+namespace {
+
+// Logs every hardware operation as a short string
+std::vector<std::string> ops_log;
+
+void fake_set_speed(void*, uint32_t speed_hz) {
+    ops_log.push_back("speed" + std::to_string(speed_hz / 1000) + "k");
+}
+
+void fake_start_write(void*, uint8_t address, const uint8_t*, uint16_t len, bool stop) {
+    ops_log.push_back("w" + std::to_string(address) + ":" + std::to_string(len) + (stop ? "+stop" : ""));
+}
+
+void fake_start_read(void*, uint8_t address, uint8_t* data, uint16_t len) {
+    ops_log.push_back("r" + std::to_string(address) + ":" + std::to_string(len));
+    for (uint16_t i = 0; i < len; i++) {
+        data[i] = static_cast<uint8_t>(0x50 + i);
+    }
+}
+
+void fake_abort(void*) {
+    ops_log.push_back("abort");
+}
+
+void fake_recover(void*) {
+    ops_log.push_back("recover");
+}
+
+const i2c_bus_ops_t fake_ops = {fake_set_speed, fake_start_write, fake_start_read, fake_abort, fake_recover};
+
+std::vector<i2c_xfer_t*> finished;
+void record_done(i2c_xfer_t* xfer, int status) {
+    EXPECT_EQ(xfer->status, status);
+    finished.push_back(xfer);
+}
+
+const i2c_device_t imu = {0x6A, 400000};
+const i2c_device_t eeprom = {0x50, 100000};
+
+}  // namespace
+
+class I2cBusTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ops_log.clear();
+        finished.clear();
+        ASSERT_EQ(i2c_bus_init(&bus, &fake_ops, nullptr), 0);
+    }
+
+    i2c_xfer_t make(const i2c_device_t* dev, const uint8_t* tx, uint16_t tx_len, uint8_t* rx, uint16_t rx_len) {
+        i2c_xfer_t x = {};
+        x.device = dev;
+        x.tx = tx;
+        x.tx_len = tx_len;
+        x.rx = rx;
+        x.rx_len = rx_len;
+        x.done = record_done;
+        return x;
+    }
+
+    i2c_bus_t bus;
+};
+
+TEST_F(I2cBusTest, RegisterWriteEndsWithStop) {
+    const uint8_t cmd[] = {0x10, 0x60};
+    i2c_xfer_t x = make(&imu, cmd, sizeof(cmd), nullptr, 0);
+
+    ASSERT_EQ(i2c_bus_submit(&bus, &x), 0);
+    EXPECT_EQ(x.status, I2C_XFER_PENDING);
+    i2c_bus_event(&bus, I2C_EVT_PHASE_DONE);
+
+    EXPECT_EQ(ops_log, (std::vector<std::string>{"speed400k", "w106:2+stop"}));
+    EXPECT_EQ(x.status, I2C_OK);
+    ASSERT_EQ(finished.size(), 1u);
+    EXPECT_FALSE(i2c_bus_busy(&bus));
+}
+
+TEST_F(I2cBusTest, RegisterReadUsesRepeatedStart) {
+    const uint8_t reg = 0x0F;
+    uint8_t who_am_i = 0;
+    i2c_xfer_t x = make(&imu, &reg, 1, &who_am_i, 1);
+
+    ASSERT_EQ(i2c_bus_submit(&bus, &x), 0);
+    i2c_bus_event(&bus, I2C_EVT_PHASE_DONE);  // TC after the address byte
+    EXPECT_TRUE(finished.empty());
+    i2c_bus_event(&bus, I2C_EVT_PHASE_DONE);  // STOP after the read
+
+    // No STOP between the phases
+    EXPECT_EQ(ops_log, (std::vector<std::string>{"speed400k", "w106:1", "r106:1"}));
+    EXPECT_EQ(who_am_i, 0x50);
+    EXPECT_EQ(x.status, I2C_OK);
+}
+
+TEST_F(I2cBusTest, BurstReadSkipsWritePhase) {
+    uint8_t fifo[12] = {};
+    i2c_xfer_t x = make(&imu, nullptr, 0, fifo, sizeof(fifo));
+
+    ASSERT_EQ(i2c_bus_submit(&bus, &x), 0);
+    i2c_bus_event(&bus, I2C_EVT_PHASE_DONE);
+
+    EXPECT_EQ(ops_log, (std::vector<std::string>{"speed400k", "r106:12"}));
+    EXPECT_EQ(fifo[11], 0x5B);
+    EXPECT_EQ(x.status, I2C_OK);
+}
+
+TEST_F(I2cBusTest, QueuedTransactionsRunInOrderAndSwitchSpeed) {
+    const uint8_t reg = 0x00;
+    uint8_t a[2], b[2], c[2];
+    i2c_xfer_t x1 = make(&imu, nullptr, 0, a, 2);
+    i2c_xfer_t x2 = make(&imu, nullptr, 0, b, 2);
+    i2c_xfer_t x3 = make(&eeprom, &reg, 1, c, 2);
+
+    ASSERT_EQ(i2c_bus_submit(&bus, &x1), 0);
+    ASSERT_EQ(i2c_bus_submit(&bus, &x2), 0);
+    ASSERT_EQ(i2c_bus_submit(&bus, &x3), 0);
+    EXPECT_EQ(i2c_bus_submit(&bus, &x2), -3);
+
+    while (i2c_bus_busy(&bus)) {
+        i2c_bus_event(&bus, I2C_EVT_PHASE_DONE);
+    }
+
+    EXPECT_EQ(finished, (std::vector<i2c_xfer_t*>{&x1, &x2, &x3}));
+    EXPECT_EQ(ops_log, (std::vector<std::string>{"speed400k", "r106:2", "r106:2", "speed100k", "w80:1", "r80:2"}));
+
+    i2c_bus_stats_t stats;
+    i2c_bus_get_stats(&bus, &stats);
+    EXPECT_EQ(stats.transfers, 3u);
+    EXPECT_EQ(stats.speed_changes, 2u);
+}
+
+TEST_F(I2cBusTest, NackCompletesAndStartsTheNext) {
+    const uint8_t reg = 0x20;
+    uint8_t data[4];
+    i2c_xfer_t absent = make(&eeprom, &reg, 1, data, 4);
+    i2c_xfer_t next = make(&imu, nullptr, 0, data, 4);
+
+    ASSERT_EQ(i2c_bus_submit(&bus, &absent), 0);
+    ASSERT_EQ(i2c_bus_submit(&bus, &next), 0);
+    i2c_bus_event(&bus, I2C_EVT_NACK);
+
+    EXPECT_EQ(absent.status, I2C_ERR_NACK);
+    EXPECT_EQ(next.status, I2C_XFER_PENDING);
+    EXPECT_EQ(ops_log.back(), "r106:4");
+
+    i2c_bus_stats_t stats;
+    i2c_bus_get_stats(&bus, &stats);
+    EXPECT_EQ(stats.nacks, 1u);
+}
+
+TEST_F(I2cBusTest, BusErrorAbortsAndReprogramsTiming) {
+    uint8_t data[2];
+    i2c_xfer_t x1 = make(&imu, nullptr, 0, data, 2);
+    i2c_xfer_t x2 = make(&imu, nullptr, 0, data, 2);
+
+    ASSERT_EQ(i2c_bus_submit(&bus, &x1), 0);
+    ASSERT_EQ(i2c_bus_submit(&bus, &x2), 0);
+    i2c_bus_event(&bus, I2C_EVT_ERROR);
+
+    EXPECT_EQ(x1.status, I2C_ERR_BUS);
+    EXPECT_EQ(ops_log, (std::vector<std::string>{"speed400k", "r106:2", "abort", "speed400k", "r106:2"}));
+}
+
+TEST_F(I2cBusTest, PollTimesOutAndRecoversTheBus) {
+    uint8_t data[6];
+    i2c_xfer_t stuck = make(&imu, nullptr, 0, data, 6);
+    stuck.timeout_ms = 20;
+    i2c_xfer_t next = make(&eeprom, nullptr, 0, data, 1);
+
+    EXPECT_FALSE(i2c_bus_poll(&bus, 0));
+    ASSERT_EQ(i2c_bus_submit(&bus, &stuck), 0);
+    ASSERT_EQ(i2c_bus_submit(&bus, &next), 0);
+
+    EXPECT_FALSE(i2c_bus_poll(&bus, 10));   // First sighting starts the clock
+    EXPECT_FALSE(i2c_bus_poll(&bus, 25));
+    EXPECT_TRUE(i2c_bus_poll(&bus, 30));
+
+    EXPECT_EQ(stuck.status, I2C_ERR_TIMEOUT);
+    EXPECT_EQ(ops_log, (std::vector<std::string>{"speed400k", "r106:6", "abort", "recover", "speed100k", "r80:1"}));
+
+    // The next transaction gets its own clock and no timeout
+    EXPECT_FALSE(i2c_bus_poll(&bus, 1000));
+    EXPECT_FALSE(i2c_bus_poll(&bus, 5000));
+    i2c_bus_event(&bus, I2C_EVT_PHASE_DONE);
+    EXPECT_EQ(next.status, I2C_OK);
+
+    i2c_bus_stats_t stats;
+    i2c_bus_get_stats(&bus, &stats);
+    EXPECT_EQ(stats.timeouts, 1u);
+    EXPECT_EQ(stats.recoveries, 1u);
+}
+
+TEST_F(I2cBusTest, LateEventAfterTimeoutIsIgnored) {
+    uint8_t data[2];
+    i2c_xfer_t x = make(&imu, nullptr, 0, data, 2);
+    x.timeout_ms = 5;
+
+    ASSERT_EQ(i2c_bus_submit(&bus, &x), 0);
+    i2c_bus_poll(&bus, 100);
+    ASSERT_TRUE(i2c_bus_poll(&bus, 105));
+
+    i2c_bus_event(&bus, I2C_EVT_PHASE_DONE);
+    EXPECT_EQ(finished.size(), 1u);
+    EXPECT_EQ(x.status, I2C_ERR_TIMEOUT);
+}
+
+TEST_F(I2cBusTest, RejectsInvalidTransactions) {
+    uint8_t data[1];
+    i2c_xfer_t empty = make(&imu, nullptr, 0, nullptr, 0);
+    i2c_xfer_t no_buffer = make(&imu, nullptr, 0, nullptr, 4);
+    i2c_xfer_t too_long = make(&imu, nullptr, 0, data, I2C_MAX_PHASE_BYTES + 1);
+
+    EXPECT_EQ(i2c_bus_submit(&bus, &empty), -1);
+    EXPECT_EQ(i2c_bus_submit(&bus, &no_buffer), -1);
+    EXPECT_EQ(i2c_bus_submit(&bus, &too_long), -1);
+    EXPECT_TRUE(ops_log.empty());
+}
@@ -0,0 +1,236 @@
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <vector>
+#include "imu_fake_device.h"
+
+extern "C" {
+#include "imu_fifo.h"
+}
+
+namespace {
+
+FakeImu* device = nullptr;
+std::vector<uint8_t> regs_written;
+
+// I2C and SPI buses whose reads come from the fake device
+void i2c_set_speed(void*, uint32_t) {}
+void i2c_start_write(void*, uint8_t, const uint8_t* data, uint16_t len, bool) {
+    regs_written.insert(regs_written.end(), data, data + len);
+}
+void i2c_start_read(void*, uint8_t, uint8_t* data, uint16_t len) {
+    device->read(data, len);
+}
+void i2c_abort(void*) {}
+void i2c_recover(void*) {}
+const i2c_bus_ops_t i2c_ops = {i2c_set_speed, i2c_start_write, i2c_start_read, i2c_abort, i2c_recover};
+
+void spi_configure(void*, uint8_t, uint32_t) {}
+void spi_chip_select(void*, const spi_device_t*, bool) {}
+void spi_start(void*, const uint8_t* tx, uint8_t* rx, uint16_t len) {
+    if (tx) {
+        regs_written.insert(regs_written.end(), tx, tx + len);
+    }
+    if (rx) {
+        device->read(rx, len);
+    }
+}
+const spi_bus_ops_t spi_ops = {spi_configure, spi_chip_select, spi_start};
+
+std::vector<imu_batch_t> batches;
+void collect(void*, const imu_batch_t* batch) {
+    batches.push_back(*batch);
+}
+
+const i2c_device_t i2c_imu = {0x6A, 400000};
+const spi_device_t spi_imu = {nullptr, 1, 3, 10000000};
+
+constexpr uint32_t kIrqLatencyUs = 30;
+
+}  // namespace
+
+class ImuFifoTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        regs_written.clear();
+        batches.clear();
+        ASSERT_EQ(i2c_bus_init(&i2c, &i2c_ops, nullptr), 0);
+        ASSERT_EQ(spi_bus_init(&spi, &spi_ops, nullptr), 0);
+    }
+
+    void TearDown() override { device = nullptr; }
+
+    void setup(FakeImu& imu, const imu_fifo_format_t& fmt, bool use_spi) {
+        device = &imu;
+        ASSERT_EQ(imu_fifo_init(&reader, &fmt, collect, nullptr), 0);
+        if (use_spi) {
+            ASSERT_EQ(imu_fifo_attach_spi(&reader, &spi, &spi_imu, 0x80 | 0x30), 0);
+        } else {
+            ASSERT_EQ(imu_fifo_attach_i2c(&reader, &i2c, &i2c_imu, 0x3E), 0);
+        }
+    }
+
+    void finish_bus() {
+        while (i2c_bus_busy(&i2c)) {
+            i2c_bus_event(&i2c, I2C_EVT_PHASE_DONE);
+        }
+        while (spi_bus_busy(&spi)) {
+            spi_bus_complete(&spi, 0);
+        }
+    }
+
+    // Run the sensor; each watermark interrupt is served before the next sample
+    void run(FakeImu& imu, uint32_t samples) {
+        for (uint32_t i = 0; i < samples; i++) {
+            const uint32_t k = imu.produced();
+            if (imu.step()) {
+                ASSERT_EQ(imu_fifo_on_watermark(&reader, imu.sample_time(k) + kIrqLatencyUs), 0);
+                finish_bus();
+            }
+        }
+    }
+
+    void expect_samples(const imu_batch_t& batch, uint32_t first_k, uint8_t channels) {
+        for (uint16_t i = 0; i < batch.count; i++) {
+            for (uint8_t c = 0; c < channels; c++) {
+                ASSERT_EQ(batch.ch[c][i], FakeImu::sample_value(first_k + i, c)) << "sample " << i << " ch " << +c;
+            }
+        }
+    }
+
+    // Largest distance between the stamped and the real sample times
+    uint32_t time_error(const FakeImu& imu, const imu_batch_t& batch, uint32_t first_k) {
+        uint32_t worst = 0;
+        for (uint16_t i = 0; i < batch.count; i++) {
+            const int64_t real = imu.sample_time(first_k + i) + kIrqLatencyUs;
+            const auto err = static_cast<uint32_t>(std::llabs(static_cast<int64_t>(batch.t_us[i]) - real));
+            worst = err > worst ? err : worst;
+        }
+        return worst;
+    }
+
+    i2c_bus_t i2c;
+    spi_bus_t spi;
+    imu_fifo_t reader;
+};
+
+TEST_F(ImuFifoTest, DecodesLittleAndBigEndianFramesWithHeaders) {
+    const imu_fifo_format_t le = {3, 1, false, 2, 1000};
+    const uint8_t raw_le[] = {0xAA, 0x01, 0x00, 0xFF, 0xFF, 0x00, 0x80,
+                              0xBB, 0x34, 0x12, 0xFE, 0xFF, 0xFF, 0x7F};
+    imu_batch_t out = {};
+    imu_fifo_decode(&le, raw_le, 2, &out);
+    EXPECT_EQ(out.count, 2u);
+    EXPECT_EQ(out.ch[0][0], 1);
+    EXPECT_EQ(out.ch[1][0], -1);
+    EXPECT_EQ(out.ch[2][0], -32768);
+    EXPECT_EQ(out.ch[0][1], 0x1234);
+    EXPECT_EQ(out.ch[1][1], -2);
+    EXPECT_EQ(out.ch[2][1], 32767);
+
+    const imu_fifo_format_t be = {2, 0, true, 1, 1000};
+    const uint8_t raw_be[] = {0x12, 0x34, 0xFF, 0xFE};
+    imu_fifo_decode(&be, raw_be, 1, &out);
+    EXPECT_EQ(out.ch[0][0], 0x1234);
+    EXPECT_EQ(out.ch[1][0], -2);
+}
+
+TEST_F(ImuFifoTest, I2cBurstsTrackTheRealOutputRate) {
+    // Nominal 1 kHz, but the sensor oscillator runs 1% slow
+    FakeImu imu(6, 0, false, 10, 1010);
+    setup(imu, {6, 0, false, 10, 1000}, false);
+
+    run(imu, 50);
+
+    ASSERT_EQ(batches.size(), 5u);
+    EXPECT_EQ(regs_written, std::vector<uint8_t>(5, 0x3E));  // One transaction per batch
+    for (uint32_t b = 0; b < batches.size(); b++) {
+        expect_samples(batches[b], b * 10, 6);
+    }
+
+    // First batch: nominal period backwards from the interrupt; later ones
+    // are interpolated between interrupts and follow the real rate
+    EXPECT_LE(time_error(imu, batches[0], 0), 9u * 10u);
+    for (uint32_t b = 1; b < batches.size(); b++) {
+        EXPECT_LE(time_error(imu, batches[b], b * 10), 1u) << "batch " << b;
+    }
+
+    imu_fifo_stats_t stats;
+    imu_fifo_get_stats(&reader, &stats);
+    EXPECT_EQ(stats.batches, 5u);
+    EXPECT_EQ(stats.samples, 50u);
+    EXPECT_EQ(stats.resyncs, 1u);
+}
+
+TEST_F(ImuFifoTest, SpiBurstSkipsTagBytesOfBigEndianFrames) {
+    FakeImu imu(7, 1, true, 16, 2500);
+    setup(imu, {7, 1, true, 16, 2500}, true);
+
+    run(imu, 48);
+
+    ASSERT_EQ(batches.size(), 3u);
+    EXPECT_EQ(regs_written, std::vector<uint8_t>(3, 0xB0));
+    for (uint32_t b = 0; b < batches.size(); b++) {
+        expect_samples(batches[b], b * 16, 7);
+        EXPECT_LE(time_error(imu, batches[b], b * 16), 1u);
+    }
+}
+
+TEST_F(ImuFifoTest, WatermarkDuringReadIsServedAfterIt) {
+    FakeImu imu(3, 0, false, 4, 1000);
+    setup(imu, {3, 0, false, 4, 1000}, false);
+
+    // The first read waits on the bus while a second watermark fills up
+    uint32_t k = 0;
+    for (; k < 4; k++) {
+        imu.step();
+    }
+    ASSERT_EQ(imu_fifo_on_watermark(&reader, imu.sample_time(3) + kIrqLatencyUs), 0);
+    for (; k < 8; k++) {
+        imu.step();
+    }
+    ASSERT_EQ(imu_fifo_on_watermark(&reader, imu.sample_time(7) + kIrqLatencyUs), 0);
+    EXPECT_TRUE(batches.empty());
+
+    finish_bus();
+
+    ASSERT_EQ(batches.size(), 2u);
+    expect_samples(batches[0], 0, 3);
+    expect_samples(batches[1], 4, 3);
+    EXPECT_LE(time_error(imu, batches[1], 4), 1u);
+
+    imu_fifo_stats_t stats;
+    imu_fifo_get_stats(&reader, &stats);
+    EXPECT_EQ(stats.deferred, 1u);
+}
+
+TEST_F(ImuFifoTest, ReadErrorRestartsTheTimeBase) {
+    FakeImu imu(3, 0, false, 4, 1000);
+    setup(imu, {3, 0, false, 4, 1000}, false);
+    run(imu, 4);
+
+    for (uint32_t k = 4; k < 8; k++) {
+        imu.step();
+    }
+    ASSERT_EQ(imu_fifo_on_watermark(&reader, imu.sample_time(7) + kIrqLatencyUs), 0);
+    i2c_bus_event(&i2c, I2C_EVT_NACK);
+    run(imu, 4);
+
+    // The NACK came before any byte was read, so the frames were still queued
+    ASSERT_EQ(batches.size(), 2u);
+    expect_samples(batches[1], 4, 3);
+
+    imu_fifo_stats_t stats;
+    imu_fifo_get_stats(&reader, &stats);
+    EXPECT_EQ(stats.read_errors, 1u);
+    EXPECT_EQ(stats.resyncs, 2u);
+}
+
+TEST_F(ImuFifoTest, RejectsBurstsTooLongForOneI2cRead) {
+    imu_fifo_format_t fmt = {6, 0, false, 32, 1000};   // 384 bytes
+    ASSERT_EQ(imu_fifo_init(&reader, &fmt, collect, nullptr), 0);
+    EXPECT_EQ(imu_fifo_attach_i2c(&reader, &i2c, &i2c_imu, 0x3E), -2);
+    EXPECT_EQ(imu_fifo_on_watermark(&reader, 0), -1);
+
+    fmt.channels = IMU_FIFO_MAX_CHANNELS + 1;
+    EXPECT_EQ(imu_fifo_init(&reader, &fmt, collect, nullptr), -1);
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include "hal_dwt_fake.h"
+
+extern "C" {
+#include "irq_profiler.h"
+}
+
+// Test fixture for the interrupt-masking profiler
+class IrqProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_EQ(irqprof_init(), 0);
+        hal_dwt_fake_set_cycles(0);
+    }
+
+    void section(uintptr_t pc, uint32_t cycles) {
+        irqprof_enter_at(pc);
+        hal_dwt_fake_advance(cycles);
+        irqprof_exit();
+    }
+};
+
+TEST_F(IrqProfilerTest, BucketsAreLog2) {
+    EXPECT_EQ(irqprof_bucket(0), 0u);
+    EXPECT_EQ(irqprof_bucket(1), 0u);
+    EXPECT_EQ(irqprof_bucket(2), 1u);
+    EXPECT_EQ(irqprof_bucket(3), 1u);
+    EXPECT_EQ(irqprof_bucket(1024), 10u);
+    EXPECT_EQ(irqprof_bucket(UINT32_MAX), IRQPROF_HISTOGRAM_BUCKETS - 1u);
+}
+
+TEST_F(IrqProfilerTest, OnlyOutermostSectionIsTimed) {
+    irqprof_enter_at(0x1000);
+    hal_dwt_fake_advance(100);
+    irqprof_enter_at(0x2000);
+    hal_dwt_fake_advance(50);
+    irqprof_exit();
+    hal_dwt_fake_advance(10);
+    irqprof_exit();
+
+    EXPECT_EQ(g_irqprof_stats.sections, 1u);
+    EXPECT_EQ(g_irqprof_stats.max_cycles, 160u);
+    EXPECT_EQ(g_irqprof_stats.max_pc, 0x1000u);
+    EXPECT_EQ(g_irqprof_stats.histogram[irqprof_bucket(160)], 1u);
+}
+
+TEST_F(IrqProfilerTest, TracksLongestSectionAndTotals) {
+    section(0x1000, 40);
+    section(0x2000, 900);
+    section(0x3000, 70);
+
+    EXPECT_EQ(g_irqprof_stats.sections, 3u);
+    EXPECT_EQ(g_irqprof_stats.total_cycles, 1010u);
+    EXPECT_EQ(g_irqprof_stats.max_cycles, 900u);
+    EXPECT_EQ(g_irqprof_stats.max_pc, 0x2000u);
+}
+
+TEST_F(IrqProfilerTest, WorstTableKeepsLongestDistinctSites) {
+    for (uint32_t i = 1; i <= IRQPROF_WORST_SITES + 4; ++i) {
+        section(0x1000 * i, 100 * i);
+    }
+    section(0x1000 * (IRQPROF_WORST_SITES + 4), 5);  // Repeat of a kept site, shorter
+
+    uint32_t shortest = UINT32_MAX;
+    for (const auto& site : g_irqprof_stats.worst) {
+        EXPECT_NE(site.pc, 0x1000u);  // The shortest sites were evicted
+        shortest = std::min(shortest, site.max_cycles);
+    }
+    EXPECT_EQ(shortest, 500u);
+}
+
+TEST_F(IrqProfilerTest, WorstTableIsSortedLongestFirst) {
+    section(0x1000, 300);
+    section(0x2000, 900);
+    section(0x3000, 600);
+    section(0x1000, 1200);     // Known site grows past the others
+
+    const auto& worst = g_irqprof_stats.worst;
+    EXPECT_EQ(worst[0].pc, 0x1000u);
+    EXPECT_EQ(worst[0].max_cycles, 1200u);
+    EXPECT_EQ(worst[0].count, 2u);
+    EXPECT_EQ(worst[1].pc, 0x2000u);
+    EXPECT_EQ(worst[2].pc, 0x3000u);
+    for (uint32_t i = 1; i < IRQPROF_WORST_SITES; i++) {
+        EXPECT_LE(worst[i].max_cycles, worst[i - 1].max_cycles);
+    }
+}
+
+TEST_F(IrqProfilerTest, UnbalancedExitIsIgnored) {
+    irqprof_exit();
+    EXPECT_EQ(g_irqprof_stats.sections, 0u);
+}
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+extern "C" {
+#include "job_scheduler.h"
+}
+
+namespace {
+
+std::vector<int> g_order;
+uint32_t g_now = 0;
+
+uint32_t fake_clock() {
+    return g_now;
+}
+
+uint32_t run_at(uint32_t now) {
+    g_now = now;
+    return job_scheduler_run_due(fake_clock);
+}
+
+void record(void* arg) {
+    g_order.push_back(*static_cast<int*>(arg));
+}
+
+} // namespace
+
+// Test fixture for the single-task job scheduler
+class JobSchedulerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_EQ(job_scheduler_init(), 0);
+        g_order.clear();
+        for (int i = 0; i < 4; i++) {
+            ids[i] = i;
+            job_init(&jobs[i], "job", record, &ids[i]);
+        }
+    }
+
+    job_t jobs[4];
+    int ids[4];
+};
+
+TEST_F(JobSchedulerTest, RunsJobsInDeadlineOrder) {
+    job_start(&jobs[0], 0, 30, 0);
+    job_start(&jobs[1], 0, 10, 0);
+    job_start(&jobs[2], 0, 20, 0);
+
+    EXPECT_EQ(run_at(5), 5u);
+    EXPECT_TRUE(g_order.empty());
+
+    EXPECT_EQ(run_at(30), JOB_SCHED_FOREVER);
+    EXPECT_EQ(g_order, (std::vector<int>{1, 2, 0}));
+    EXPECT_EQ(jobs[0].state, JOB_IDLE);
+}
+
+TEST_F(JobSchedulerTest, PeriodicJobDoesNotDrift) {
+    job_start(&jobs[0], 0, 100, 100);
+
+    // Late wake-ups do not shift later releases
+    EXPECT_EQ(run_at(103), 97u);
+    EXPECT_EQ(jobs[0].deadline, 200u);
+    EXPECT_EQ(run_at(250), 50u);
+    EXPECT_EQ(jobs[0].deadline, 300u);
+
+    EXPECT_EQ(jobs[0].runs, 2u);
+    EXPECT_EQ(jobs[0].overruns, 0u);
+    EXPECT_EQ(jobs[0].max_late, 50u);
+}
+
+TEST_F(JobSchedulerTest, FallingBehindCountsOverruns) {
+    job_start(&jobs[0], 0, 10, 10);
+
+    // Releases at 10, 20, 30 and 40 have passed; only one run happens
+    EXPECT_EQ(run_at(45), 5u);
+    EXPECT_EQ(jobs[0].runs, 1u);
+    EXPECT_EQ(jobs[0].overruns, 3u);
+    EXPECT_EQ(jobs[0].deadline, 50u);
+}
+
+TEST_F(JobSchedulerTest, CancelRemovesFromMiddleOfHeap) {
+    job_start(&jobs[0], 0, 10, 0);
+    job_start(&jobs[1], 0, 20, 0);
+    job_start(&jobs[2], 0, 30, 0);
+    job_start(&jobs[3], 0, 40, 0);
+
+    job_cancel(&jobs[1]);
+    EXPECT_EQ(job_scheduler_count(), 3u);
+
+    run_at(100);
+    EXPECT_EQ(g_order, (std::vector<int>{0, 2, 3}));
+}
+
+TEST_F(JobSchedulerTest, RestartReplacesDeadline) {
+    job_start(&jobs[0], 0, 10, 0);
+    job_start(&jobs[1], 0, 20, 0);
+    job_start(&jobs[0], 0, 30, 0);
+
+    EXPECT_EQ(job_scheduler_count(), 2u);
+    run_at(100);
+    EXPECT_EQ(g_order, (std::vector<int>{1, 0}));
+}
+
+TEST_F(JobSchedulerTest, DeadlinesSurviveTickWrap) {
+    const uint32_t now = 0xFFFFFFF0u;
+    job_start(&jobs[0], now, 0x20, 0);  // Wraps to 0x10
+    job_start(&jobs[1], now, 0x08, 0);
+
+    EXPECT_EQ(run_at(now), 0x08u);
+    run_at(0x10);
+    EXPECT_EQ(g_order, (std::vector<int>{1, 0}));
+}
+
+namespace {
+
+job_t* g_self = nullptr;
+
+void cancel_self(void*) {
+    job_cancel(g_self);
+}
+
+} // namespace
+
+TEST_F(JobSchedulerTest, PeriodicJobCanCancelItself) {
+    job_init(&jobs[0], "self", cancel_self, nullptr);
+    g_self = &jobs[0];
+    job_start(&jobs[0], 0, 0, 10);
+
+    EXPECT_EQ(run_at(0), JOB_SCHED_FOREVER);
+    EXPECT_EQ(jobs[0].runs, 1u);
+    EXPECT_EQ(jobs[0].state, JOB_IDLE);
+}
+
+TEST_F(JobSchedulerTest, RejectsWhenFull) {
+    static job_t many[JOB_SCHED_MAX_JOBS + 1];
+    static int id = 0;
+    for (int i = 0; i < JOB_SCHED_MAX_JOBS; i++) {
+        job_init(&many[i], "many", record, &id);
+        ASSERT_EQ(job_start(&many[i], 0, (uint32_t)(JOB_SCHED_MAX_JOBS - i), 0), 0);
+    }
+    job_init(&many[JOB_SCHED_MAX_JOBS], "extra", record, &id);
+    EXPECT_EQ(job_start(&many[JOB_SCHED_MAX_JOBS], 0, 1, 0), -2);
+
+    EXPECT_EQ(run_at(JOB_SCHED_MAX_JOBS), JOB_SCHED_FOREVER);
+    EXPECT_EQ(g_order.size(), (size_t)JOB_SCHED_MAX_JOBS);
+}
+
+namespace {
+
+// Takes 25 ticks of the fake clock
+void slow(void* arg) {
+    record(arg);
+    g_now += 25;
+}
+
+} // namespace
+
+TEST_F(JobSchedulerTest, ClockIsReadAgainAfterEachCallback) {
+    job_init(&jobs[0], "slow", slow, &ids[0]);
+    job_start(&jobs[0], 0, 10, 0);
+    job_start(&jobs[1], 0, 30, 0);     // Due while the slow job runs
+    job_start(&jobs[2], 0, 50, 0);
+
+    // 10 + 25 = 35: job 1 runs in the same pass, job 2 is 15 ticks away
+    EXPECT_EQ(run_at(10), 15u);
+    EXPECT_EQ(g_order, (std::vector<int>{0, 1}));
+    EXPECT_EQ(jobs[1].max_late, 5u);
+}
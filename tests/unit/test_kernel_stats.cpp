@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "hal_dwt_fake.h"
+
+extern "C" {
+#include "kernel_stats.h"
+}
+
+// Test fixture for the kernel contention counters
+class KernelStatsTest : public ::testing::Test {
+protected:
+    static constexpr uint32_t kMutex = 1;
+    static constexpr uint32_t kQueue = 2;
+    static constexpr uint32_t kTaskA = 3;
+    static constexpr uint32_t kTaskB = 4;
+
+    void SetUp() override {
+        kstats_init(80000000);
+        kstats_reset();
+        kstats_object_create(kMutex, 1, 1);
+        kstats_object_name(kMutex, "bus_mutex");
+        kstats_object_create(kQueue, 0, 4);
+        hal_dwt_fake_set_cycles(0);
+    }
+
+    kstats_object_t get(uint32_t object) {
+        kstats_object_t stats{};
+        EXPECT_EQ(kstats_get(object, &stats), 0);
+        return stats;
+    }
+};
+
+TEST_F(KernelStatsTest, BlockedWaitAccumulatesTime) {
+    kstats_block(kMutex, kTaskA);
+    hal_dwt_fake_advance(800);
+    kstats_receive(kMutex, kTaskA);
+
+    kstats_block(kMutex, kTaskA);
+    hal_dwt_fake_advance(200);
+    kstats_receive(kMutex, kTaskA);
+
+    auto stats = get(kMutex);
+    EXPECT_STREQ(stats.name, "bus_mutex");
+    EXPECT_EQ(stats.block_count, 2u);
+    EXPECT_EQ(stats.receive_count, 2u);
+    EXPECT_EQ(stats.total_blocked_cycles, 1000u);
+    EXPECT_EQ(stats.max_blocked_cycles, 800u);
+    EXPECT_EQ(kstats_cycles_to_us(stats.total_blocked_cycles), 12u);
+}
+
+TEST_F(KernelStatsTest, ReblockAfterSpuriousWakeCountsOnce) {
+    kstats_block(kQueue, kTaskA);
+    kstats_block(kQueue, kTaskA);
+
+    EXPECT_EQ(get(kQueue).block_count, 1u);
+}
+
+TEST_F(KernelStatsTest, TimeoutOnlyCountedForBlockingWaits) {
+    kstats_failed(kQueue, kTaskA);  // Non-blocking poll on an empty queue
+    EXPECT_EQ(get(kQueue).timeout_count, 0u);
+
+    kstats_block(kQueue, kTaskA);
+    hal_dwt_fake_advance(500);
+    kstats_failed(kQueue, kTaskA);
+
+    auto stats = get(kQueue);
+    EXPECT_EQ(stats.timeout_count, 1u);
+    EXPECT_EQ(stats.total_blocked_cycles, 500u);
+}
+
+TEST_F(KernelStatsTest, PeakDepthIsClampedToLength) {
+    kstats_send(kQueue, 0, 1);
+    kstats_send(kQueue, 0, 3);
+    kstats_send(kQueue, kTaskB, 2);
+    EXPECT_EQ(get(kQueue).peak_depth, 3u);
+
+    kstats_send(kQueue, 0, 9);  // Overwrite on a full queue
+    EXPECT_EQ(get(kQueue).peak_depth, 4u);
+    EXPECT_EQ(get(kQueue).send_count, 4u);
+}
+
+TEST_F(KernelStatsTest, PriorityInheritanceAttributedToAwaitedMutex) {
+    kstats_block(kMutex, kTaskB);
+    kstats_priority_inherit(kTaskB);
+
+    EXPECT_EQ(get(kMutex).inherit_count, 1u);
+    EXPECT_EQ(get(kQueue).inherit_count, 0u);
+}
+
+TEST_F(KernelStatsTest, MostContendedObject) {
+    EXPECT_EQ(kstats_most_contended(), 0u);
+
+    kstats_block(kQueue, kTaskA);
+    hal_dwt_fake_advance(100);
+    kstats_receive(kQueue, kTaskA);
+    kstats_block(kMutex, kTaskB);
+    hal_dwt_fake_advance(5000);
+    kstats_receive(kMutex, kTaskB);
+
+    EXPECT_EQ(kstats_most_contended(), kMutex);
+}
+
+TEST_F(KernelStatsTest, UntrackedObjectsAreRejected) {
+    kstats_object_t stats{};
+    EXPECT_LT(kstats_get(0, &stats), 0);
+    EXPECT_LT(kstats_get(KSTATS_MAX_OBJECTS + 1, &stats), 0);
+    EXPECT_LT(kstats_get(5, &stats), 0);
+}
+
+TEST_F(KernelStatsTest, CyclesToMicrosecondsBelowOneMegahertz) {
+    kstats_init(100000);    // MSI range 0
+    EXPECT_EQ(kstats_cycles_to_us(1), 10u);
+    EXPECT_EQ(kstats_cycles_to_us(250000), 2500000u);
+
+    kstats_init(80000000);
+    EXPECT_EQ(kstats_cycles_to_us(80000000ULL * 3000U + 40), 3000000000u);
+}
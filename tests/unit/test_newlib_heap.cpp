@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include "rtos_heap_fake.h"
+
+extern "C" {
+#include "newlib_heap.h"
+}
+
+class NewlibHeapTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        rtos_heap_fake_reset();
+    }
+
+    void TearDown() override {
+        EXPECT_EQ(rtos_heap_fake_live_blocks(), 0u);
+    }
+};
+
+TEST_F(NewlibHeapTest, MallocPrefixesSizeAndKeepsAlignment) {
+    void* p = newlib_heap_malloc(13);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(rtos_heap_fake_last_request(), 13u + NEWLIB_HEAP_HEADER);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 8, 0u);
+    EXPECT_EQ(newlib_heap_usable_size(p), 13u);
+    newlib_heap_free(p);
+    newlib_heap_free(nullptr);
+}
+
+TEST_F(NewlibHeapTest, ReallocGrowsByMovingAndShrinksInPlace) {
+    auto* p = static_cast<char*>(newlib_heap_malloc(8));
+    std::memcpy(p, "abcdefg", 8);
+
+    EXPECT_EQ(newlib_heap_realloc(p, 4), p);
+
+    auto* grown = static_cast<char*>(newlib_heap_realloc(p, 64));
+    ASSERT_NE(grown, nullptr);
+    EXPECT_STREQ(grown, "abcdefg");
+    EXPECT_EQ(newlib_heap_usable_size(grown), 64u);
+    EXPECT_EQ(rtos_heap_fake_live_blocks(), 1u);
+
+    EXPECT_EQ(newlib_heap_realloc(grown, 0), nullptr);
+}
+
+TEST_F(NewlibHeapTest, FailedReallocKeepsTheOriginalBlock) {
+    auto* p = static_cast<char*>(newlib_heap_realloc(nullptr, 4));
+    ASSERT_NE(p, nullptr);
+    std::memcpy(p, "xyz", 4);
+
+    rtos_heap_fake_fail_after(0);
+    EXPECT_EQ(newlib_heap_realloc(p, 128), nullptr);
+    EXPECT_STREQ(p, "xyz");
+    newlib_heap_free(p);
+}
+
+TEST_F(NewlibHeapTest, CallocZeroesAndRejectsOverflow) {
+    auto* p = static_cast<uint32_t*>(newlib_heap_calloc(16, sizeof(uint32_t)));
+    ASSERT_NE(p, nullptr);
+    for (int i = 0; i < 16; i++) {
+        EXPECT_EQ(p[i], 0u);
+    }
+    newlib_heap_free(p);
+
+    EXPECT_EQ(newlib_heap_calloc(SIZE_MAX / 2, 4), nullptr);
+    EXPECT_EQ(newlib_heap_malloc(SIZE_MAX - 2), nullptr);
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "nor_flash_fake.h"
+
+class QspiFlashTest : public ::testing::Test {
+protected:
+    static constexpr uint32_t kSize = 1024u * 1024u;
+
+    void SetUp() override {
+        part = QSPI_FLASH_PART_W25Q128;
+        part.size = kSize;
+        ASSERT_EQ(qspi_flash_init(&flash, FakeNorFlash::ops(), &nor, &part), 0);
+        nor.clear_log();
+        nor.wait_calls = 0;
+    }
+
+    std::vector<uint8_t> pattern(uint32_t len, uint8_t seed) {
+        std::vector<uint8_t> v(len);
+        for (uint32_t i = 0; i < len; i++) {
+            v[i] = static_cast<uint8_t>(seed + i * 7u);
+        }
+        return v;
+    }
+
+    FakeNorFlash nor{kSize};
+    qspi_flash_part_t part;
+    qspi_flash_t flash;
+};
+
+TEST_F(QspiFlashTest, InitSetsQuadEnableOnce) {
+    EXPECT_EQ(nor.status2 & 0x02, 0x02);
+    EXPECT_EQ(nor.violations, 0);
+
+    // Already set: read back only, no status write
+    qspi_flash_t again;
+    ASSERT_EQ(qspi_flash_init(&again, FakeNorFlash::ops(), &nor, &part), 0);
+    ASSERT_EQ(nor.log().size(), 1u);
+    EXPECT_EQ(nor.log()[0].instruction, QSPI_CMD_READ_STATUS2);
+}
+
+TEST_F(QspiFlashTest, InitRejectsBadParts) {
+    qspi_flash_t f;
+    qspi_flash_part_t bad = part;
+    bad.size = 3u * 1024u * 1024u;
+    EXPECT_EQ(qspi_flash_init(&f, FakeNorFlash::ops(), &nor, &bad), -1);
+    bad = part;
+    bad.size = 32u * 1024u * 1024u;
+    EXPECT_EQ(qspi_flash_init(&f, FakeNorFlash::ops(), &nor, &bad), -1);
+    bad = part;
+    bad.page_size = 100;
+    EXPECT_EQ(qspi_flash_init(&f, FakeNorFlash::ops(), &nor, &bad), -1);
+}
+
+TEST_F(QspiFlashTest, ReadsId) {
+    uint8_t id[3] = {};
+    ASSERT_EQ(qspi_flash_read_id(&flash, id), 0);
+    EXPECT_EQ(id[0], 0xEF);
+    EXPECT_EQ(id[2], 0x18);
+}
+
+TEST_F(QspiFlashTest, ProgramSplitsAtPageBoundaries) {
+    const auto data = pattern(700, 3);
+    ASSERT_EQ(qspi_flash_program(&flash, 200, data.data(), 700), 0);
+    EXPECT_EQ(nor.violations, 0);
+
+    // 200..255, 256..511, 512..767, 768..899: one WREN + program per page
+    std::vector<uint32_t> programs;
+    for (const auto& cmd : nor.log()) {
+        if (cmd.instruction == QSPI_CMD_PAGE_PROGRAM_QUAD) {
+            programs.push_back(cmd.address);
+            EXPECT_EQ(cmd.data_lines, 4);
+        }
+    }
+    EXPECT_EQ(programs, (std::vector<uint32_t>{200, 256, 512, 768}));
+    EXPECT_EQ(nor.wait_calls, 4);
+
+    std::vector<uint8_t> back(700);
+    ASSERT_EQ(qspi_flash_read(&flash, 200, back.data(), 700), 0);
+    EXPECT_EQ(back, data);
+}
+
+TEST_F(QspiFlashTest, ReadUsesQuadOutputWithDummyCycles) {
+    uint8_t byte;
+    ASSERT_EQ(qspi_flash_read(&flash, 0x1234, &byte, 1), 0);
+    ASSERT_EQ(nor.log().size(), 1u);
+    const qspi_command_t& cmd = nor.log()[0];
+    EXPECT_EQ(cmd.instruction, QSPI_CMD_FAST_READ_QUAD);
+    EXPECT_EQ(cmd.address, 0x1234u);
+    EXPECT_EQ(cmd.address_lines, 1);
+    EXPECT_EQ(cmd.dummy_cycles, 8);
+    EXPECT_EQ(cmd.data_lines, 4);
+}
+
+TEST_F(QspiFlashTest, EraseUsesBlocksWhereAligned) {
+    // Sector at 60K, block at 64K, sectors at 128K, 132K and 136K
+    ASSERT_EQ(qspi_flash_erase(&flash, 60u * 1024u, 80u * 1024u), 0);
+
+    std::vector<std::pair<uint8_t, uint32_t>> erases;
+    for (const auto& cmd : nor.log()) {
+        if (cmd.instruction != QSPI_CMD_WRITE_ENABLE) {
+            erases.emplace_back(cmd.instruction, cmd.address);
+        }
+    }
+    const std::vector<std::pair<uint8_t, uint32_t>> expected = {
+        {QSPI_CMD_SECTOR_ERASE, 60u * 1024u},
+        {QSPI_CMD_BLOCK_ERASE, 64u * 1024u},
+        {QSPI_CMD_SECTOR_ERASE, 128u * 1024u},
+        {QSPI_CMD_SECTOR_ERASE, 132u * 1024u},
+        {QSPI_CMD_SECTOR_ERASE, 136u * 1024u},
+    };
+    EXPECT_EQ(erases, expected);
+    EXPECT_EQ(nor.violations, 0);
+}
+
+TEST_F(QspiFlashTest, ReprogramNeedsErase) {
+    const auto first = pattern(256, 1);
+    const auto second = pattern(256, 90);
+    ASSERT_EQ(qspi_flash_program(&flash, 4096, first.data(), 256), 0);
+    ASSERT_EQ(qspi_flash_program(&flash, 4096, second.data(), 256), 0);
+
+    std::vector<uint8_t> back(256);
+    ASSERT_EQ(qspi_flash_read(&flash, 4096, back.data(), 256), 0);
+    EXPECT_NE(back, second);
+
+    ASSERT_EQ(qspi_flash_erase(&flash, 4096, QSPI_FLASH_SECTOR), 0);
+    ASSERT_EQ(qspi_flash_program(&flash, 4096, second.data(), 256), 0);
+    ASSERT_EQ(qspi_flash_read(&flash, 4096, back.data(), 256), 0);
+    EXPECT_EQ(back, second);
+}
+
+TEST_F(QspiFlashTest, RejectsBadRanges) {
+    uint8_t buf[16] = {};
+    EXPECT_EQ(qspi_flash_read(&flash, kSize - 8, buf, 16), -2);
+    EXPECT_EQ(qspi_flash_program(&flash, kSize, buf, 1), -2);
+    EXPECT_EQ(qspi_flash_erase(&flash, 100, QSPI_FLASH_SECTOR), -1);
+    EXPECT_EQ(qspi_flash_erase(&flash, 0, 100), -1);
+    EXPECT_EQ(qspi_flash_erase(&flash, kSize, QSPI_FLASH_SECTOR), -2);
+    EXPECT_EQ(qspi_flash_read(&flash, 0, buf, 0), -1);
+    EXPECT_TRUE(nor.log().empty());
+}
+
+TEST_F(QspiFlashTest, MemoryMappedBlocksIndirectAccess) {
+    ASSERT_EQ(qspi_flash_memory_map(&flash), 0);
+    EXPECT_TRUE(nor.mapped);
+    EXPECT_EQ(nor.log().back().instruction, QSPI_CMD_FAST_READ_QUAD);
+
+    uint8_t buf[4] = {};
+    EXPECT_EQ(qspi_flash_read(&flash, 0, buf, 4), -4);
+    EXPECT_EQ(qspi_flash_program(&flash, 0, buf, 4), -4);
+    EXPECT_EQ(qspi_flash_erase(&flash, 0, QSPI_FLASH_SECTOR), -4);
+
+    ASSERT_EQ(qspi_flash_memory_unmap(&flash), 0);
+    EXPECT_FALSE(nor.mapped);
+    EXPECT_EQ(qspi_flash_read(&flash, 0, buf, 4), 0);
+    EXPECT_EQ(nor.violations, 0);
+}
+
+TEST_F(QspiFlashTest, BusyTimeoutIsHardwareError) {
+    nor.fail_wait = true;
+    const uint8_t byte = 0;
+    EXPECT_EQ(qspi_flash_program(&flash, 0, &byte, 1), -3);
+    EXPECT_EQ(qspi_flash_erase(&flash, 0, QSPI_FLASH_SECTOR), -3);
+}
@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "spi_bus.h"
+}
+
+namespace {
+
+// Logs every hardware operation as a short string
+std::vector<std::string> ops_log;
+
+void fake_configure(void*, uint8_t mode, uint32_t max_hz) {
+    ops_log.push_back("cfg" + std::to_string(mode) + "@" + std::to_string(max_hz));
+}
+
+void fake_chip_select(void*, const spi_device_t* device, bool asserted) {
+    ops_log.push_back(std::string(asserted ? "cs" : "/cs") + std::to_string(device->cs_pin));
+}
+
+void fake_start(void*, const uint8_t*, uint8_t* rx, uint16_t len) {
+    ops_log.push_back("xfer" + std::to_string(len));
+    if (rx) {
+        for (uint16_t i = 0; i < len; i++) {
+            rx[i] = static_cast<uint8_t>(0xA0 + i);
+        }
+    }
+}
+
+const spi_bus_ops_t fake_ops = {fake_configure, fake_chip_select, fake_start};
+
+std::vector<spi_transfer_t*> finished;
+void record_done(spi_transfer_t* xfer, int status) {
+    EXPECT_EQ(xfer->status, status);
+    finished.push_back(xfer);
+}
+
+}  // namespace
+
+class SpiBusTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ops_log.clear();
+        finished.clear();
+        ASSERT_EQ(spi_bus_init(&bus, &fake_ops, nullptr), 0);
+    }
+
+    spi_transfer_t make(const spi_device_t* dev, uint16_t len, uint8_t priority = 0) {
+        spi_transfer_t t = {};
+        t.device = dev;
+        t.len = len;
+        t.priority = priority;
+        t.done = record_done;
+        return t;
+    }
+
+    void complete_all() {
+        while (spi_bus_busy(&bus)) {
+            spi_bus_complete(&bus, 0);
+        }
+    }
+
+    spi_bus_t bus;
+    spi_device_t imu = {nullptr, 1, 3, 8000000};
+    spi_device_t flash = {nullptr, 2, 0, 20000000};
+    spi_device_t baro = {nullptr, 4, 3, 8000000};
+};
+
+TEST_F(SpiBusTest, IdleBusStartsTransferAtOnce) {
+    uint8_t rx[3];
+    spi_transfer_t t = make(&imu, 3);
+    t.rx = rx;
+    ASSERT_EQ(spi_bus_submit(&bus, &t), 0);
+    EXPECT_TRUE(spi_bus_busy(&bus));
+    EXPECT_EQ(t.status, SPI_XFER_PENDING);
+    EXPECT_EQ(ops_log, (std::vector<std::string>{"cfg3@8000000", "cs1", "xfer3"}));
+
+    spi_bus_complete(&bus, 0);
+    EXPECT_FALSE(spi_bus_busy(&bus));
+    EXPECT_EQ(t.status, 0);
+    EXPECT_EQ(rx[2], 0xA2);
+    EXPECT_EQ(ops_log.back(), "/cs1");
+    ASSERT_EQ(finished.size(), 1u);
+}
+
+TEST_F(SpiBusTest, QueuedTransfersRunByPriorityThenFifo) {
+    spi_transfer_t first = make(&flash, 1);
+    spi_transfer_t low = make(&imu, 2, 1);
+    spi_transfer_t high = make(&baro, 3, 5);
+    spi_transfer_t low2 = make(&imu, 4, 1);
+
+    spi_bus_submit(&bus, &first);
+    spi_bus_submit(&bus, &low);
+    spi_bus_submit(&bus, &high);
+    spi_bus_submit(&bus, &low2);
+    complete_all();
+
+    EXPECT_EQ(finished, (std::vector<spi_transfer_t*>{&first, &high, &low, &low2}));
+    spi_bus_stats_t stats;
+    spi_bus_get_stats(&bus, &stats);
+    EXPECT_EQ(stats.transfers, 4u);
+    EXPECT_EQ(stats.queue_peak, 3u);
+}
+
+TEST_F(SpiBusTest, ReconfiguresOnlyWhenSettingsChange) {
+    spi_transfer_t a = make(&imu, 1);
+    spi_transfer_t b = make(&baro, 1);     // Same mode and speed as the IMU
+    spi_transfer_t c = make(&flash, 1);
+    spi_transfer_t d = make(&flash, 1);
+
+    spi_bus_submit(&bus, &a);
+    spi_bus_submit(&bus, &b);
+    spi_bus_submit(&bus, &c);
+    spi_bus_submit(&bus, &d);
+    complete_all();
+
+    spi_bus_stats_t stats;
+    spi_bus_get_stats(&bus, &stats);
+    EXPECT_EQ(stats.reconfigurations, 2u);
+    EXPECT_EQ(ops_log, (std::vector<std::string>{
+        "cfg3@8000000", "cs1", "xfer1", "/cs1",
+        "cs4", "xfer1", "/cs4",
+        "cfg0@20000000", "cs2", "xfer1", "/cs2",
+        "cs2", "xfer1", "/cs2"}));
+}
+
+TEST_F(SpiBusTest, ChainedSegmentsShareOneChipSelect) {
+    const uint8_t cmd[] = {0x03, 0x00, 0x10, 0x00};
+    uint8_t data[8];
+    spi_transfer_t payload = make(&flash, sizeof(data));
+    payload.rx = data;
+    spi_transfer_t command = make(&flash, sizeof(cmd));
+    command.tx = cmd;
+    command.next = &payload;
+
+    spi_bus_submit(&bus, &command);
+    spi_bus_complete(&bus, 0);
+    EXPECT_TRUE(finished.empty());
+    spi_bus_complete(&bus, 0);
+
+    ASSERT_EQ(finished, std::vector<spi_transfer_t*>{&command});
+    EXPECT_EQ(ops_log, (std::vector<std::string>{"cfg0@20000000", "cs2", "xfer4", "xfer8", "/cs2"}));
+}
+
+TEST_F(SpiBusTest, ErrorEndsChainAndIsCounted) {
+    spi_transfer_t tail = make(&flash, 2);
+    spi_transfer_t head = make(&flash, 1);
+    head.next = &tail;
+
+    spi_bus_submit(&bus, &head);
+    spi_bus_complete(&bus, -1);
+    EXPECT_EQ(head.status, -1);
+    EXPECT_EQ(ops_log.back(), "/cs2");
+
+    spi_bus_stats_t stats;
+    spi_bus_get_stats(&bus, &stats);
+    EXPECT_EQ(stats.errors, 1u);
+}
+
+TEST_F(SpiBusTest, RejectsInvalidDuplicateAndOverflow) {
+    spi_transfer_t empty = make(&imu, 0);
+    EXPECT_EQ(spi_bus_submit(&bus, &empty), -1);
+
+    spi_transfer_t running = make(&imu, 1);
+    spi_bus_submit(&bus, &running);
+    EXPECT_EQ(spi_bus_submit(&bus, &running), -3);
+
+    std::vector<spi_transfer_t> queued(SPI_BUS_MAX_QUEUED + 1, make(&imu, 1));
+    for (int i = 0; i < SPI_BUS_MAX_QUEUED; i++) {
+        EXPECT_EQ(spi_bus_submit(&bus, &queued[i]), 0);
+    }
+    EXPECT_EQ(spi_bus_submit(&bus, &queued[SPI_BUS_MAX_QUEUED]), -2);
+
+    spi_bus_stats_t stats;
+    spi_bus_get_stats(&bus, &stats);
+    EXPECT_EQ(stats.rejected, 1u);
+    complete_all();
+    EXPECT_EQ(finished.size(), SPI_BUS_MAX_QUEUED + 1u);
+}
+
+TEST_F(SpiBusTest, CallbackMaySubmitFollowUp) {
+    static spi_transfer_t follow_up;
+    static spi_bus_t* the_bus;
+    the_bus = &bus;
+    follow_up = make(&imu, 6);
+
+    spi_transfer_t first = make(&imu, 1);
+    first.done = [](spi_transfer_t* xfer, int status) {
+        record_done(xfer, status);
+        spi_bus_submit(the_bus, &follow_up);
+    };
+    spi_bus_submit(&bus, &first);
+    spi_bus_complete(&bus, 0);
+    EXPECT_TRUE(spi_bus_busy(&bus));
+    EXPECT_EQ(ops_log.back(), "xfer6");
+    complete_all();
+    EXPECT_EQ(finished, (std::vector<spi_transfer_t*>{&first, &follow_up}));
+}
@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "spsc_ring.hpp"
+
+// Single-threaded behaviour
+
+TEST(SpscRingTest, PushPopUntilFullAndEmpty) {
+    SpscRing<uint16_t, 4> ring;
+    EXPECT_TRUE(ring.empty());
+
+    for (uint16_t i = 0; i < 4; i++) {
+        EXPECT_TRUE(ring.push(i));
+    }
+    EXPECT_TRUE(ring.full());
+    EXPECT_FALSE(ring.push(99));
+
+    uint16_t value = 0;
+    for (uint16_t i = 0; i < 4; i++) {
+        ASSERT_TRUE(ring.pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(ring.pop(value));
+}
+
+TEST(SpscRingTest, BulkCopiesWrapAround) {
+    SpscRing<uint8_t, 8> ring;
+    const uint8_t in[] = {1, 2, 3, 4, 5, 6};
+    uint8_t out[8] = {};
+
+    EXPECT_EQ(ring.write(in, 6), 6u);
+    EXPECT_EQ(ring.read(out, 4), 4u);
+
+    // Write index now at 6: the next write wraps
+    EXPECT_EQ(ring.write(in, 6), 6u);
+    EXPECT_EQ(ring.size(), 8u);
+    EXPECT_EQ(ring.write(in, 1), 0u);
+
+    EXPECT_EQ(ring.read(out, 8), 8u);
+    EXPECT_EQ(std::vector<uint8_t>(out, out + 8), (std::vector<uint8_t>{5, 6, 1, 2, 3, 4, 5, 6}));
+}
+
+TEST(SpscRingTest, SpansAreContiguousUpToTheEnd) {
+    SpscRing<uint8_t, 8> ring;
+    uint8_t scratch[8];
+
+    ring.write(scratch, 5);
+    ring.read(scratch, 5);
+
+    // Free space is 8, but only 3 slots until the end of storage
+    auto span = ring.write_span();
+    ASSERT_EQ(span.size(), 3u);
+    span[0] = 10;
+    span[1] = 11;
+    span[2] = 12;
+    ring.commit_write(3);
+
+    span = ring.write_span();
+    ASSERT_EQ(span.size(), 5u);
+    span[0] = 13;
+    ring.commit_write(1);
+
+    auto readable = ring.read_span();
+    ASSERT_EQ(readable.size(), 3u);
+    EXPECT_EQ(readable[2], 12);
+    ring.commit_read(3);
+
+    readable = ring.read_span();
+    ASSERT_EQ(readable.size(), 1u);
+    EXPECT_EQ(readable[0], 13);
+}
+
+// Concurrent behaviour: one producer thread, one consumer thread. Run the
+// tsan_tests target to check the ordering with ThreadSanitizer.
+
+TEST(SpscRingTest, ThreadedElementStreamKeepsOrder) {
+    constexpr uint32_t kCount = 50000;
+    static SpscRing<uint32_t, 64> ring;
+    ring.reset();
+
+    std::thread producer([] {
+        for (uint32_t i = 0; i < kCount;) {
+            if (ring.push(i)) {
+                i++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    bool ordered = true;
+    while (expected < kCount) {
+        uint32_t value;
+        if (ring.pop(value)) {
+            ordered &= (value == expected);
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(SpscRingTest, ThreadedSpanProducerBulkConsumer) {
+    constexpr uint32_t kCount = 50000;
+    static SpscRing<uint8_t, 128> ring;
+    ring.reset();
+
+    // Producer fills spans in place, like a DMA engine would
+    std::thread producer([] {
+        uint32_t sent = 0;
+        while (sent < kCount) {
+            auto span = ring.write_span();
+            size_t n = span.size();
+            if (n > kCount - sent) {
+                n = kCount - sent;
+            }
+            for (size_t i = 0; i < n; i++) {
+                span[i] = static_cast<uint8_t>(sent + i);
+            }
+            ring.commit_write(n);
+            sent += static_cast<uint32_t>(n);
+            if (n == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t received = 0;
+    bool ordered = true;
+    uint8_t buf[48];
+    while (received < kCount) {
+        const size_t n = ring.read(buf, sizeof(buf));
+        for (size_t i = 0; i < n; i++) {
+            ordered &= (buf[i] == static_cast<uint8_t>(received + i));
+        }
+        received += static_cast<uint32_t>(n);
+        if (n == 0) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(received, kCount);
+}
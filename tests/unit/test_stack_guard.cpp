@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include <cstring>
+
+extern "C" {
+#include "stack_guard.h"
+}
+
+TEST(StackGuardTest, RbarAlignsGuardUpInsideTheStack) {
+    EXPECT_EQ(stack_guard_rbar(0x20001000), 0x20001000u | STACK_GUARD_RBAR_VALID | STACK_GUARD_REGION);
+    EXPECT_EQ(stack_guard_rbar(0x20001004), 0x20001020u | STACK_GUARD_RBAR_VALID | STACK_GUARD_REGION);
+    EXPECT_EQ(stack_guard_rbar(0x2000101F), 0x20001020u | STACK_GUARD_RBAR_VALID | STACK_GUARD_REGION);
+}
+
+TEST(StackGuardTest, RasrIsReadOnlyNeverExecute32Bytes) {
+    EXPECT_EQ((STACK_GUARD_RASR >> 1) & 0x1F, 4u);      // 2^(4+1) bytes
+    EXPECT_EQ((STACK_GUARD_RASR >> 24) & 0x7, 5u);      // Privileged RO
+    EXPECT_NE(STACK_GUARD_RASR & (1UL << 28), 0u);      // XN
+    EXPECT_NE(STACK_GUARD_RASR & 1UL, 0u);
+}
+
+TEST(StackGuardTest, FaultRecordSurvivesIntoNextBoot) {
+    ASSERT_EQ(stack_guard_init(), 0);
+    ASSERT_EQ(stack_guard_init(), 0);
+    EXPECT_FALSE(stack_guard_get_fault_record(nullptr));
+
+    const uint32_t cfsr = STACK_GUARD_CFSR_DACCVIOL | STACK_GUARD_CFSR_MMARVALID;
+    EXPECT_TRUE(stack_guard_record_fault("Comms", cfsr, 0x20001024, 0x20001020));
+
+    // Next boot
+    ASSERT_EQ(stack_guard_init(), 0);
+    stack_guard_fault_record_t record;
+    ASSERT_TRUE(stack_guard_get_fault_record(&record));
+    EXPECT_STREQ(record.task_name, "Comms");
+    EXPECT_EQ(record.fault_address, 0x20001024u);
+    EXPECT_EQ(record.guard_base, 0x20001020u);
+    EXPECT_TRUE(record.overflow);
+    EXPECT_EQ(record.faults, 1u);
+
+    // A clean boot after that leaves no record
+    ASSERT_EQ(stack_guard_init(), 0);
+    EXPECT_FALSE(stack_guard_get_fault_record(&record));
+}
+
+TEST(StackGuardTest, ClassifiesStackingAndUnrelatedFaults) {
+    ASSERT_EQ(stack_guard_init(), 0);
+    ASSERT_EQ(stack_guard_init(), 0);
+
+    // Exception entry hit the guard: no address, but MSTKERR
+    EXPECT_TRUE(stack_guard_record_fault("Worker", STACK_GUARD_CFSR_MSTKERR, 0, 0x20002000));
+
+    // Access outside the guard is some other MPU violation
+    const uint32_t cfsr = STACK_GUARD_CFSR_DACCVIOL | STACK_GUARD_CFSR_MMARVALID;
+    EXPECT_FALSE(stack_guard_record_fault("Worker", cfsr, 0x20002020, 0x20002000));
+    EXPECT_FALSE(stack_guard_record_fault(nullptr, cfsr, 0x20001FFC, 0x20002000));
+
+    ASSERT_EQ(stack_guard_init(), 0);
+    stack_guard_fault_record_t record;
+    ASSERT_TRUE(stack_guard_get_fault_record(&record));
+    EXPECT_STREQ(record.task_name, "");
+    EXPECT_FALSE(record.overflow);
+    EXPECT_EQ(record.faults, 3u);
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <cstring>
+
+extern "C" {
+#include "supervisor.h"
+}
+
+// Test fixture for the liveness supervisor
+class SupervisorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_EQ(supervisor_init(), 0);
+        led = supervisor_register("LED_Task", 1000);
+        comms = supervisor_register("Comms_Task", 300);
+        ASSERT_EQ(led, 0);
+        ASSERT_EQ(comms, 1);
+    }
+
+    int led = -1;
+    int comms = -1;
+};
+
+TEST_F(SupervisorTest, FeedsOnlyAfterEveryTaskReported) {
+    // Registration counts as the first check-in
+    EXPECT_EQ(supervisor_poll(0), SUPERVISOR_FEED);
+
+    supervisor_checkin(led);
+    EXPECT_EQ(supervisor_poll(100), SUPERVISOR_WAIT);
+
+    supervisor_checkin(comms);
+    EXPECT_EQ(supervisor_poll(200), SUPERVISOR_FEED);
+
+    EXPECT_EQ(supervisor_poll(300), SUPERVISOR_WAIT);
+}
+
+TEST_F(SupervisorTest, MissedDeadlineStallsAndLatches) {
+    EXPECT_EQ(supervisor_poll(0), SUPERVISOR_FEED);
+
+    for (uint32_t t = 100; t <= 300; t += 100) {
+        supervisor_checkin(led);
+        EXPECT_NE(supervisor_poll(t), SUPERVISOR_STALLED);
+    }
+
+    supervisor_checkin(led);
+    EXPECT_EQ(supervisor_poll(400), SUPERVISOR_STALLED);
+
+    // Late check-ins do not recover: the watchdog must be allowed to expire
+    supervisor_checkin(led);
+    supervisor_checkin(comms);
+    EXPECT_EQ(supervisor_poll(500), SUPERVISOR_STALLED);
+}
+
+TEST_F(SupervisorTest, PausedTaskIsNotMonitored) {
+    supervisor_set_live(comms, false);
+
+    for (uint32_t t = 0; t <= 2000; t += 100) {
+        supervisor_checkin(led);
+        EXPECT_EQ(supervisor_poll(t), SUPERVISOR_FEED);
+    }
+
+    // Resuming restarts the deadline from the next poll
+    supervisor_set_live(comms, true);
+    supervisor_checkin(led);
+    EXPECT_EQ(supervisor_poll(2100), SUPERVISOR_FEED);
+}
+
+TEST_F(SupervisorTest, StallRecordSurvivesReinit) {
+    supervisor_reset_record_t record;
+    EXPECT_FALSE(supervisor_get_reset_record(&record));
+
+    supervisor_poll(0);
+    supervisor_checkin(comms);
+    EXPECT_EQ(supervisor_poll(1500), SUPERVISOR_STALLED);
+
+    // Simulated reboot: .noinit contents are kept
+    ASSERT_EQ(supervisor_init(), 0);
+    ASSERT_TRUE(supervisor_get_reset_record(&record));
+    EXPECT_STREQ(record.task_name, "LED_Task");
+    EXPECT_EQ(record.stalled_mask, 1u << 0);
+    EXPECT_EQ(record.uptime_ms, 1500u);
+    EXPECT_EQ(record.watchdog_resets, 1u);
+
+    // A clean boot afterwards reports nothing
+    ASSERT_EQ(supervisor_init(), 0);
+    EXPECT_FALSE(supervisor_get_reset_record(&record));
+}
+
+TEST_F(SupervisorTest, RegistrationLimits) {
+    EXPECT_EQ(supervisor_register("Zero", 0), -2);
+    for (int i = 2; i < SUPERVISOR_MAX_TASKS; i++) {
+        EXPECT_EQ(supervisor_register("Task", 100), i);
+    }
+    EXPECT_EQ(supervisor_register("Overflow", 100), -1);
+}
+
+TEST_F(SupervisorTest, CheckinIgnoresInvalidIds) {
+    g_supervisor_checkins = 0;
+    supervisor_checkin(-1);
+    supervisor_checkin(SUPERVISOR_MAX_TASKS);
+    EXPECT_EQ(g_supervisor_checkins, 0u);
+}
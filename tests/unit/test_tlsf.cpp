@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+extern "C" {
+#include "tlsf.h"
+}
+
+class TlsfTest : public ::testing::Test {
+protected:
+    alignas(8) uint8_t region_a[4096];
+    alignas(8) uint8_t region_b[2048];
+    tlsf_t tlsf;
+
+    void SetUp() override {
+        tlsf_init(&tlsf);
+        ASSERT_EQ(tlsf_add_pool(&tlsf, region_a, sizeof(region_a)), 0);
+    }
+
+    bool inside(const void* p, const uint8_t* region, size_t size) {
+        auto* b = static_cast<const uint8_t*>(p);
+        return b >= region && b < region + size;
+    }
+};
+
+TEST_F(TlsfTest, AddPoolRejectsBadRegions) {
+    uint8_t tiny[8];
+    static uint8_t huge[1 << 17];
+    EXPECT_LT(tlsf_add_pool(&tlsf, nullptr, 1024), 0);
+    EXPECT_LT(tlsf_add_pool(&tlsf, tiny, sizeof(tiny)), 0);
+    EXPECT_LT(tlsf_add_pool(&tlsf, huge, sizeof(huge)), 0);
+}
+
+TEST_F(TlsfTest, AllocationsAreAlignedAndUsable) {
+    std::vector<void*> blocks;
+    for (size_t size : {1u, 7u, 24u, 100u, 129u, 500u}) {
+        void* p = tlsf_malloc(&tlsf, size);
+        ASSERT_NE(p, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % TLSF_ALIGN, 0u);
+        EXPECT_GE(tlsf_block_size(p), size);
+        std::memset(p, 0xA5, size);
+        blocks.push_back(p);
+    }
+    EXPECT_EQ(tlsf_check(&tlsf), 0);
+
+    for (void* p : blocks) {
+        tlsf_free(&tlsf, p);
+    }
+    EXPECT_EQ(tlsf_check(&tlsf), 0);
+    EXPECT_EQ(tlsf_malloc(&tlsf, 0), nullptr);
+}
+
+TEST_F(TlsfTest, FreeMergesNeighboursBackIntoOneBlock) {
+    tlsf_stats_t before;
+    tlsf_get_stats(&tlsf, &before);
+    EXPECT_EQ(before.free_blocks, 1u);
+
+    void* a = tlsf_malloc(&tlsf, 64);
+    void* b = tlsf_malloc(&tlsf, 64);
+    void* c = tlsf_malloc(&tlsf, 64);
+
+    // Free the outer blocks first, then the middle one bridges them
+    tlsf_free(&tlsf, a);
+    tlsf_free(&tlsf, c);
+    EXPECT_EQ(tlsf_check(&tlsf), 0);
+    tlsf_free(&tlsf, b);
+    EXPECT_EQ(tlsf_check(&tlsf), 0);
+
+    tlsf_stats_t after;
+    tlsf_get_stats(&tlsf, &after);
+    EXPECT_EQ(after.free_blocks, 1u);
+    EXPECT_EQ(after.free_bytes, before.free_bytes);
+    EXPECT_EQ(after.largest_free, before.largest_free);
+    EXPECT_EQ(after.fragmentation_pct, 0u);
+    EXPECT_EQ(after.allocs, 3u);
+    EXPECT_EQ(after.frees, 3u);
+}
+
+TEST_F(TlsfTest, SecondRegionServesRequestsAfterTheFirstIsFull) {
+    ASSERT_EQ(tlsf_add_pool(&tlsf, region_b, sizeof(region_b)), 0);
+
+    std::vector<void*> blocks;
+    bool used_a = false;
+    bool used_b = false;
+    while (void* p = tlsf_malloc(&tlsf, 256)) {
+        used_a |= inside(p, region_a, sizeof(region_a));
+        used_b |= inside(p, region_b, sizeof(region_b));
+        blocks.push_back(p);
+    }
+    EXPECT_TRUE(used_a);
+    EXPECT_TRUE(used_b);
+    EXPECT_GE(blocks.size(), (sizeof(region_a) + sizeof(region_b)) / 256 - 4);
+
+    tlsf_stats_t stats;
+    tlsf_get_stats(&tlsf, &stats);
+    EXPECT_EQ(stats.failures, 1u);
+    EXPECT_LT(stats.min_free_bytes, 256u + 64u);
+
+    for (void* p : blocks) {
+        tlsf_free(&tlsf, p);
+    }
+    EXPECT_EQ(tlsf_check(&tlsf), 0);
+    tlsf_get_stats(&tlsf, &stats);
+    EXPECT_EQ(stats.free_blocks, 2u);   // Regions never merge with each other
+}
+
+TEST_F(TlsfTest, ReportsFragmentation) {
+    // Alternate keep/release so free space is split into separate holes
+    std::vector<void*> keep;
+    std::vector<void*> release;
+    for (int i = 0; i < 8; i++) {
+        keep.push_back(tlsf_malloc(&tlsf, 128));
+        release.push_back(tlsf_malloc(&tlsf, 128));
+    }
+    for (void* p : release) {
+        tlsf_free(&tlsf, p);
+    }
+
+    tlsf_stats_t stats;
+    tlsf_get_stats(&tlsf, &stats);
+    EXPECT_EQ(stats.used_blocks, 8u);
+    EXPECT_EQ(stats.free_blocks, 8u);   // Seven holes; the last one merged into the tail
+    EXPECT_EQ(stats.smallest_free, 128u);
+    EXPECT_GT(stats.fragmentation_pct, 0u);
+    EXPECT_EQ(stats.fragmentation_pct,
+              100u - stats.largest_free * 100u / stats.free_bytes);
+}
+
+TEST_F(TlsfTest, RandomWorkloadKeepsHeapConsistent) {
+    std::mt19937 rng(42);
+    std::vector<std::pair<uint8_t*, size_t>> live;
+
+    for (int i = 0; i < 5000; i++) {
+        if (live.empty() || (live.size() < 40 && rng() % 2)) {
+            const size_t size = 1 + rng() % 300;
+            auto* p = static_cast<uint8_t*>(tlsf_malloc(&tlsf, size));
+            if (p) {
+                std::memset(p, static_cast<int>(size & 0xFF), size);
+                live.emplace_back(p, size);
+            }
+        } else {
+            const size_t k = rng() % live.size();
+            auto [p, size] = live[k];
+            // Neighbouring blocks must not have overwritten this one
+            for (size_t j = 0; j < size; j++) {
+                ASSERT_EQ(p[j], static_cast<uint8_t>(size & 0xFF));
+            }
+            tlsf_free(&tlsf, p);
+            live[k] = live.back();
+            live.pop_back();
+        }
+        if (i % 250 == 0) {
+            ASSERT_EQ(tlsf_check(&tlsf), 0) << "after operation " << i;
+        }
+    }
+
+    for (auto& [p, size] : live) {
+        tlsf_free(&tlsf, p);
+    }
+    tlsf_stats_t stats;
+    tlsf_get_stats(&tlsf, &stats);
+    EXPECT_EQ(stats.free_blocks, 1u);
+    EXPECT_EQ(stats.free_bytes, stats.total_bytes);
+}
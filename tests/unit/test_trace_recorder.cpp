@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "hal_dwt_fake.h"
+
+extern "C" {
+#include "trace_recorder.h"
+}
+
+// Test fixture for the kernel trace recorder
+class TraceRecorderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_EQ(trace_init(80000000), 0);
+    }
+
+    const trace_event_t& slot(uint32_t index) {
+        return g_trace_buffer.events[index & (TRACE_BUFFER_EVENTS - 1)];
+    }
+};
+
+TEST_F(TraceRecorderTest, HeaderDescribesLayout) {
+    EXPECT_EQ(g_trace_buffer.magic, TRACE_MAGIC);
+    EXPECT_EQ(g_trace_buffer.event_size, sizeof(trace_event_t));
+    EXPECT_EQ(g_trace_buffer.capacity, static_cast<uint32_t>(TRACE_BUFFER_EVENTS));
+    EXPECT_EQ(g_trace_buffer.cpu_hz, 80000000u);
+    EXPECT_EQ(g_trace_buffer.trigger_index, UINT32_MAX);
+}
+
+TEST_F(TraceRecorderTest, RecordsTimestampedEvents) {
+    hal_dwt_fake_set_cycles(1000);
+    trace_record(TRACE_EVT_TASK_SWITCHED_IN, 3, 2);
+    hal_dwt_fake_set_cycles(1500);
+    trace_record(TRACE_EVT_TASK_SWITCHED_OUT, 3, 2);
+
+    ASSERT_EQ(trace_event_count(), 2u);
+    EXPECT_EQ(slot(0).timestamp, 1000u);
+    EXPECT_EQ(slot(0).type, TRACE_EVT_TASK_SWITCHED_IN);
+    EXPECT_EQ(slot(0).id, 3);
+    EXPECT_EQ(slot(0).data, 2);
+    EXPECT_EQ(slot(1).timestamp, 1500u);
+    EXPECT_EQ(slot(1).type, TRACE_EVT_TASK_SWITCHED_OUT);
+}
+
+TEST_F(TraceRecorderTest, RingOverwritesOldestEvents) {
+    for (uint32_t i = 0; i < TRACE_BUFFER_EVENTS + 10; ++i) {
+        trace_user_event(0, static_cast<uint16_t>(i));
+    }
+
+    EXPECT_EQ(trace_event_count(), static_cast<uint32_t>(TRACE_BUFFER_EVENTS));
+    EXPECT_EQ(g_trace_buffer.head, TRACE_BUFFER_EVENTS + 10u);
+    EXPECT_EQ(slot(TRACE_BUFFER_EVENTS + 9).data, TRACE_BUFFER_EVENTS + 9);
+    EXPECT_EQ(slot(10).data, 10);  // Oldest retained event
+}
+
+TEST_F(TraceRecorderTest, TriggerFreezesAfterPostEvents) {
+    trace_arm_trigger(TRACE_EVT_QUEUE_SEND_FAILED, 4, 3);
+
+    trace_record(TRACE_EVT_QUEUE_SEND_FAILED, 5, 0);  // Different object, ignored
+    trace_record(TRACE_EVT_QUEUE_SEND_FAILED, 4, 0);  // Trigger at index 1
+    EXPECT_EQ(g_trace_buffer.trigger_index, 1u);
+    EXPECT_FALSE(trace_is_frozen());
+
+    for (int i = 0; i < 10; ++i) {
+        trace_user_event(1, static_cast<uint16_t>(i));
+    }
+
+    EXPECT_TRUE(trace_is_frozen());
+    EXPECT_EQ(g_trace_buffer.head, 5u);  // Trigger plus three post-trigger events
+}
+
+TEST_F(TraceRecorderTest, ManualTriggerWithoutPostEventsFreezesImmediately) {
+    trace_user_event(0, 1);
+    trace_trigger(0);
+
+    EXPECT_TRUE(trace_is_frozen());
+    trace_user_event(0, 2);
+    EXPECT_EQ(trace_event_count(), 1u);
+}
+
+TEST_F(TraceRecorderTest, ResetResumesRecording) {
+    trace_freeze();
+    trace_user_event(0, 1);
+    EXPECT_EQ(trace_event_count(), 0u);
+
+    trace_reset();
+    trace_user_event(0, 1);
+    EXPECT_EQ(trace_event_count(), 1u);
+}
+
+TEST_F(TraceRecorderTest, StoresTaskAndObjectNames) {
+    trace_task_create(2, "LED_Task", 1);
+    trace_object_name(1, "uart_tx_queue_with_long_name");
+
+    EXPECT_STREQ(g_trace_buffer.task_names[1], "LED_Task");
+    EXPECT_STREQ(g_trace_buffer.object_names[0], "uart_tx_queue_w");
+    EXPECT_EQ(slot(0).type, TRACE_EVT_TASK_CREATE);
+}
@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "uart_rx.hpp"
+#include "uart_dma_model.h"
+
+namespace {
+
+// Consumer side: a bounded stream buffer
+struct SinkPort {
+    static inline std::vector<uint8_t> received;
+    static inline std::size_t capacity = SIZE_MAX;
+    static inline unsigned calls = 0;
+
+    static std::size_t deliver(const uint8_t* data, std::size_t len) {
+        calls++;
+        const std::size_t room = capacity - received.size();
+        const std::size_t n = len < room ? len : room;
+        received.insert(received.end(), data, data + n);
+        return n;
+    }
+
+    static void reset() {
+        received.clear();
+        capacity = SIZE_MAX;
+        calls = 0;
+    }
+};
+
+using Rx = UartRx<64, SinkPort>;
+
+std::vector<uint8_t> bytes(const std::string& s) {
+    return std::vector<uint8_t>(s.begin(), s.end());
+}
+
+// GNSS receiver at 1 Hz, captured as one burst per sentence group
+const std::vector<std::vector<uint8_t>> kNmeaRecording = {
+    bytes("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n"),
+    bytes("$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A\r\n"
+          "$GPVTG,054.7,T,034.4,M,005.5,N,010.2,K*48\r\n"),
+    bytes("$GPGSA,A,3,04,05,,09,12,,,24,,,,,2.5,1.3,2.1*39\r\n"),
+    bytes("$GPGGA,123520,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*4E\r\n"),
+};
+
+// Short command/response frames from a host tool
+const std::vector<std::vector<uint8_t>> kCommandRecording = {
+    {0x7E, 0x01, 0x00, 0x7E},
+    {0x7E, 0x02, 0x10, 0x20, 0x30, 0x7E},
+    {0x7E},
+    {0x7E, 0x03, 0x7D, 0x5E, 0x7E},
+};
+
+std::vector<uint8_t> concat(const std::vector<std::vector<uint8_t>>& bursts) {
+    std::vector<uint8_t> all;
+    for (const auto& b : bursts) {
+        all.insert(all.end(), b.begin(), b.end());
+    }
+    return all;
+}
+
+}  // namespace
+
+class UartRxTest : public ::testing::Test {
+protected:
+    void SetUp() override { SinkPort::reset(); }
+
+    Rx rx;
+    UartDmaModel<Rx> line{rx};
+};
+
+TEST_F(UartRxTest, ShortBurstIsDeliveredByOneIdleInterrupt) {
+    line.replay({bytes("ping\r\n")});
+    EXPECT_EQ(line.interrupts(), 1u);
+    EXPECT_EQ(SinkPort::received, bytes("ping\r\n"));
+    EXPECT_EQ(rx.stats().events, 1u);
+    EXPECT_EQ(rx.stats().bytes_received, 6u);
+}
+
+TEST_F(UartRxTest, ReplaysRecordedNmeaStreamAcrossWraps) {
+    line.replay(kNmeaRecording);
+    EXPECT_EQ(SinkPort::received, concat(kNmeaRecording));
+    EXPECT_EQ(rx.stats().bytes_dropped, 0u);
+
+    // Far fewer interrupts than bytes
+    EXPECT_LT(line.interrupts(), SinkPort::received.size() / 16);
+}
+
+TEST_F(UartRxTest, ReplaysRecordedCommandFrames) {
+    for (int repeat = 0; repeat < 20; repeat++) {
+        line.replay(kCommandRecording);
+    }
+    std::vector<uint8_t> expected;
+    for (int repeat = 0; repeat < 20; repeat++) {
+        const auto once = concat(kCommandRecording);
+        expected.insert(expected.end(), once.begin(), once.end());
+    }
+    EXPECT_EQ(SinkPort::received, expected);
+}
+
+TEST_F(UartRxTest, IdleRightAfterHalfTransferFindsNothingNew) {
+    const std::vector<uint8_t> half(32, 0xA5);
+    line.receive(half.data(), half.size());
+    line.idle();
+    EXPECT_EQ(line.interrupts(), 2u);
+    EXPECT_EQ(rx.stats().events, 1u);
+    EXPECT_EQ(SinkPort::calls, 1u);
+}
+
+TEST_F(UartRxTest, WrappedSpanIsDeliveredInTwoPieces) {
+    const std::vector<uint8_t> first(60, 1);
+    line.replay({first});
+    SinkPort::calls = 0;
+
+    // 60..63 then 0..5 in one idle event
+    const std::vector<uint8_t> second = {2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+    line.receive(second.data(), 3);
+    line.receive(second.data() + 3, 7);
+    line.idle();
+    EXPECT_EQ(SinkPort::calls, 2u);
+    EXPECT_EQ(std::vector<uint8_t>(SinkPort::received.end() - 10, SinkPort::received.end()), second);
+}
+
+TEST_F(UartRxTest, FullConsumerDropsAndCounts) {
+    SinkPort::capacity = 10;
+    line.replay({bytes("0123456789abcdef")});
+    EXPECT_EQ(rx.stats().bytes_received, 10u);
+    EXPECT_EQ(rx.stats().bytes_dropped, 6u);
+}
+
+TEST_F(UartRxTest, LineErrorsAreCounted) {
+    line.line_error(UART_RX_ERR_OVERRUN);
+    line.line_error(UART_RX_ERR_FRAMING | UART_RX_ERR_NOISE);
+    line.line_error(UART_RX_ERR_FRAMING);
+    EXPECT_EQ(rx.stats().overruns, 1u);
+    EXPECT_EQ(rx.stats().framing_errors, 2u);
+    EXPECT_EQ(rx.stats().noise_errors, 1u);
+}
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "uart_tx.hpp"
+
+namespace {
+
+// Records DMA transfers; completing one copies its bytes to the "line"
+struct FakePort {
+    static inline bool lock_ok = true;
+    static inline int waits = 0;
+    static inline int complete_on_wait = 0;     // DMA completions per wait_space()
+    static inline int critical_depth = 0;
+    static inline const uint8_t* dma_data = nullptr;
+    static inline std::size_t dma_len = 0;
+    static inline std::vector<std::size_t> transfers;
+    static inline void (*complete)() = nullptr;
+
+    static bool lock() { return lock_ok; }
+    static void unlock() {}
+    static bool wait_space(uint32_t) {
+        waits++;
+        if (complete_on_wait == 0) {
+            return false;
+        }
+        complete_on_wait--;
+        complete();
+        return true;
+    }
+    static void signal_space() {}
+    static void enter_critical() { critical_depth++; }
+    static void exit_critical() { critical_depth--; }
+    static void start_dma(const uint8_t* data, std::size_t len) {
+        EXPECT_EQ(dma_len, 0u) << "transfer started while one is in flight";
+        dma_data = data;
+        dma_len = len;
+        transfers.push_back(len);
+    }
+
+    static void reset() {
+        lock_ok = true;
+        waits = 0;
+        complete_on_wait = 0;
+        critical_depth = 0;
+        dma_data = nullptr;
+        dma_len = 0;
+        transfers.clear();
+    }
+};
+
+using Tx = UartTx<16, FakePort>;
+
+}  // namespace
+
+class UartTxTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        FakePort::reset();
+        current = &tx;
+        FakePort::complete = [] { current->finish(); };
+    }
+
+    struct Harness {
+        Tx uart;
+        std::string line;
+
+        // Emulate the DMA transfer-complete interrupt
+        void finish() {
+            line.append(reinterpret_cast<const char*>(FakePort::dma_data), FakePort::dma_len);
+            FakePort::dma_len = 0;
+            uart.on_dma_complete();
+        }
+
+        std::size_t write(const char* s) {
+            return uart.write(reinterpret_cast<const uint8_t*>(s), std::strlen(s));
+        }
+    };
+
+    void drain() {
+        while (FakePort::dma_len != 0) {
+            tx.finish();
+        }
+    }
+
+    Harness tx;
+    static inline Harness* current = nullptr;
+};
+
+TEST_F(UartTxTest, WriteStartsDmaAndReturnsImmediately) {
+    EXPECT_EQ(tx.write("hello"), 5u);
+    EXPECT_TRUE(tx.uart.busy());
+    EXPECT_EQ(FakePort::transfers, std::vector<std::size_t>{5});
+    EXPECT_EQ(FakePort::critical_depth, 0);
+
+    // Written while the first transfer is in flight: queued, not started
+    EXPECT_EQ(tx.write(" world"), 6u);
+    EXPECT_EQ(FakePort::transfers.size(), 1u);
+
+    drain();
+    EXPECT_EQ(tx.line, "hello world");
+    EXPECT_FALSE(tx.uart.busy());
+    EXPECT_EQ(tx.uart.pending(), 0u);
+    EXPECT_EQ(tx.uart.stats().dma_transfers, 2u);
+    EXPECT_EQ(tx.uart.stats().bytes_queued, 11u);
+}
+
+TEST_F(UartTxTest, WrappedDataIsSentAsTwoContiguousChunks) {
+    tx.write("0123456789");
+    drain();
+
+    // Ring positions 10..15 then 0..3
+    tx.write("abcdefghij");
+    EXPECT_EQ(FakePort::transfers.back(), 6u);
+    drain();
+    EXPECT_EQ(FakePort::transfers.back(), 4u);
+    EXPECT_EQ(tx.line, "0123456789abcdefghij");
+}
+
+TEST_F(UartTxTest, DropNewestKeepsWhatFitsAndCounts) {
+    EXPECT_EQ(tx.write("0123456789ABCDEFxyz"), 16u);
+    const UartTxStats& stats = tx.uart.stats();
+    EXPECT_EQ(stats.bytes_dropped, 3u);
+    EXPECT_EQ(stats.overflows, 1u);
+    EXPECT_EQ(stats.peak_used, 16u);
+    EXPECT_EQ(FakePort::waits, 0);
+
+    drain();
+    EXPECT_EQ(tx.line, "0123456789ABCDEF");
+}
+
+TEST_F(UartTxTest, BlockWaitsForSpaceAndTimesOut) {
+    tx.uart.set_policy(UartTxPolicy::Block, 10);
+
+    // One completion frees the 16 in-flight bytes; the rest then fits
+    FakePort::complete_on_wait = 1;
+    EXPECT_EQ(tx.write("0123456789ABCDEFxyz"), 19u);
+    EXPECT_EQ(tx.uart.stats().bytes_dropped, 0u);
+    drain();
+    EXPECT_EQ(tx.line, "0123456789ABCDEFxyz");
+
+    // The line stalls: the wait times out and the remainder is dropped
+    tx.line.clear();
+    FakePort::complete_on_wait = 0;
+    EXPECT_EQ(tx.write("0123456789ABCDEFxyz"), 16u);
+    EXPECT_EQ(tx.uart.stats().bytes_dropped, 3u);
+    EXPECT_EQ(tx.uart.stats().overflows, 1u);
+}
+
+TEST_F(UartTxTest, WriteWithoutLockIsDropped) {
+    FakePort::lock_ok = false;
+    EXPECT_EQ(tx.write("isr"), 0u);
+    EXPECT_EQ(tx.uart.stats().bytes_dropped, 3u);
+    EXPECT_TRUE(FakePort::transfers.empty());
+}
@@ -0,0 +1,351 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "usb_cdc.hpp"
+#include "usb_host_sim.h"
+
+namespace {
+
+struct FakePort {
+    static inline int critical_depth = 0;
+    static inline int space_signals = 0;
+    static inline int data_signals = 0;
+
+    static void enter_critical() { critical_depth++; }
+    static void exit_critical() { critical_depth--; }
+    static void signal_space() { space_signals++; }
+    static void signal_data() { data_signals++; }
+
+    static void reset() {
+        critical_depth = 0;
+        space_signals = 0;
+        data_signals = 0;
+    }
+};
+
+constexpr std::size_t kTxRing = 4096;
+constexpr std::size_t kRxRing = 512;
+using Cdc = UsbCdc<kTxRing, kRxRing, FakePort>;
+
+// Standard and class request types (host-to-device; the simulator sets the
+// direction bit for control_in)
+constexpr uint8_t kStandard = 0x00;
+constexpr uint8_t kClassInterface = 0x21;
+constexpr uint8_t kVendor = 0x40;
+
+// Full-speed bulk: at most 19 packets of 64 bytes per 1 ms frame
+constexpr int kPacketsPerFrame = 19;
+
+uint8_t pattern(uint32_t i) {
+    return static_cast<uint8_t>(i * 31u + (i >> 8));
+}
+
+}  // namespace
+
+class UsbCdcTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        FakePort::reset();
+        host.attach(&dev);
+        ASSERT_EQ(cdc.init(&dev, UsbHostSim::ops(), &host, &desc), 0);
+    }
+
+    void enumerate() {
+        host.bus_reset();
+        ASSERT_TRUE(host.control_in(kStandard, 6, 0x0100, 0, 64).has_value());
+        ASSERT_TRUE(host.control_out(kStandard, 5, 7, 0));
+        ASSERT_TRUE(host.control_in(kStandard, 6, 0x0200, 0, 255).has_value());
+        ASSERT_TRUE(host.control_out(kStandard, 9, 1, 0));
+        ASSERT_TRUE(host.control_out(kClassInterface, 0x22, 0x0001, 0));   // DTR
+    }
+
+    // Host reads one frame's worth of IN packets
+    int host_read(std::vector<uint8_t>& out, int packets = kPacketsPerFrame) {
+        return host.bulk_in(USB_CDC_EP_IN, packets, out);
+    }
+
+    std::size_t write(const std::vector<uint8_t>& data) { return cdc.write(data.data(), data.size()); }
+
+    const char* strings[3] = {"Example", "Telemetry Port", "0123456789AB"};
+    usb_descriptors_t desc = {usb_cdc_device_descriptor, usb_cdc_config_descriptor, strings, 3};
+    usb_device_t dev;
+    UsbHostSim host;
+    Cdc cdc;
+};
+
+TEST_F(UsbCdcTest, EnumeratesAsCdcAcm) {
+    host.bus_reset();
+    EXPECT_TRUE(host.ep(0x00).open);
+    EXPECT_TRUE(host.ep(0x80).open);
+
+    const auto device = host.control_in(kStandard, 6, 0x0100, 0, 64);
+    ASSERT_TRUE(device.has_value());
+    ASSERT_EQ(device->size(), 18u);
+    EXPECT_EQ((*device)[4], 0x02);     // Communications class
+    EXPECT_EQ((*device)[8] | ((*device)[9] << 8), USB_CDC_VID);
+
+    // The new address applies after the status stage
+    ASSERT_TRUE(host.control_out(kStandard, 5, 7, 0));
+    EXPECT_EQ(host.address, 7);
+
+    const auto head = host.control_in(kStandard, 6, 0x0200, 0, 9);
+    ASSERT_TRUE(head.has_value());
+    ASSERT_EQ(head->size(), 9u);
+    const uint16_t total = static_cast<uint16_t>((*head)[2] | ((*head)[3] << 8));
+    EXPECT_EQ(total, sizeof(usb_cdc_config_descriptor));
+    const auto config = host.control_in(kStandard, 6, 0x0200, 0, total);
+    ASSERT_TRUE(config.has_value());
+    EXPECT_EQ(config->size(), total);
+
+    const auto product = host.control_in(kStandard, 6, 0x0302, 0x0409, 255);
+    ASSERT_TRUE(product.has_value());
+    std::string name;
+    for (std::size_t i = 2; i < product->size(); i += 2) {
+        name += static_cast<char>((*product)[i]);
+    }
+    EXPECT_EQ(name, "Telemetry Port");
+
+    EXPECT_FALSE(cdc.configured());
+    ASSERT_TRUE(host.control_out(kStandard, 9, 1, 0));
+    EXPECT_TRUE(cdc.configured());
+    const auto cfg = host.control_in(kStandard, 8, 0, 0, 1);
+    ASSERT_TRUE(cfg.has_value());
+    EXPECT_EQ((*cfg)[0], 1);
+
+    // Double-buffered bulk pair plus the notification endpoint
+    EXPECT_EQ(host.ep(USB_CDC_EP_OUT).type, USB_EP_TYPE_BULK);
+    EXPECT_TRUE(host.ep(USB_CDC_EP_OUT).double_buffered);
+    EXPECT_EQ(host.ep(USB_CDC_EP_IN).type, USB_EP_TYPE_BULK);
+    EXPECT_TRUE(host.ep(USB_CDC_EP_IN).double_buffered);
+    EXPECT_EQ(host.ep(USB_CDC_EP_NOTIFY).type, USB_EP_TYPE_INTERRUPT);
+    EXPECT_TRUE(host.ep(USB_CDC_EP_OUT).out_armed);
+}
+
+TEST_F(UsbCdcTest, ControlDataEndingOnPacketBoundaryGetsZlp) {
+    // 31 characters: a 64-byte string descriptor, shorter than requested
+    strings[2] = "0123456789012345678901234567890";
+    host.bus_reset();
+    const auto serial = host.control_in(kStandard, 6, 0x0303, 0x0409, 255);
+    ASSERT_TRUE(serial.has_value());
+    EXPECT_EQ(serial->size(), 64u);
+    EXPECT_EQ(host.zlps, 1);
+}
+
+TEST_F(UsbCdcTest, LineCodingAndControlLineState) {
+    enumerate();
+    EXPECT_TRUE(cdc.dtr());
+
+    // 921600 baud, 2 stop bits, even parity, 7 data bits
+    const std::vector<uint8_t> coding = {0x00, 0x10, 0x0E, 0x00, 2, 2, 7};
+    ASSERT_TRUE(host.control_out(kClassInterface, 0x20, 0, 0, coding));
+    const UsbCdcLineCoding lc = cdc.line_coding();
+    EXPECT_EQ(lc.baud, 921600u);
+    EXPECT_EQ(lc.stop_bits, 2);
+    EXPECT_EQ(lc.parity, 2);
+    EXPECT_EQ(lc.data_bits, 7);
+
+    const auto back = host.control_in(kClassInterface, 0x21, 0, 0, 7);
+    ASSERT_TRUE(back.has_value());
+    EXPECT_EQ(*back, coding);
+
+    ASSERT_TRUE(host.control_out(kClassInterface, 0x22, 0x0000, 0));
+    EXPECT_FALSE(cdc.dtr());
+}
+
+TEST_F(UsbCdcTest, UnsupportedRequestsStall) {
+    enumerate();
+    EXPECT_FALSE(host.control_in(kVendor, 0x01, 0, 0, 4).has_value());
+    EXPECT_FALSE(host.control_in(kStandard, 6, 0x0600, 0, 10).has_value());    // Device qualifier
+    EXPECT_FALSE(host.control_out(kStandard, 9, 2, 0));                          // No configuration 2
+    EXPECT_FALSE(host.control_out(kClassInterface, 0x20, 0, 0, {1, 2, 3}));      // Short line coding
+
+    // Endpoint 0 recovers at the next SETUP
+    EXPECT_TRUE(host.control_in(kStandard, 8, 0, 0, 1).has_value());
+}
+
+TEST_F(UsbCdcTest, LoopbackThroughSimulatedEndpoints) {
+    enumerate();
+
+    std::vector<uint8_t> sent(20000);
+    for (uint32_t i = 0; i < sent.size(); i++) {
+        sent[i] = pattern(i);
+    }
+
+    // Each frame: the host sends what the device accepts, the application
+    // echoes what it received, the host reads what is ready
+    std::vector<uint8_t> echoed;
+    std::size_t offset = 0;
+    for (int frame = 0; frame < 1000 && echoed.size() < sent.size(); frame++) {
+        for (int p = 0; p < kPacketsPerFrame && offset < sent.size(); p++) {
+            const auto n = static_cast<uint16_t>(std::min<std::size_t>(USB_CDC_PACKET, sent.size() - offset));
+            if (!host.bulk_out(USB_CDC_EP_OUT, sent.data() + offset, n)) {
+                break;
+            }
+            offset += n;
+        }
+
+        uint8_t buf[256];
+        std::size_t n;
+        while ((n = cdc.read(buf, sizeof(buf))) > 0) {
+            ASSERT_EQ(cdc.write(buf, n), n);
+        }
+        host_read(echoed);
+    }
+
+    EXPECT_EQ(echoed, sent);
+    EXPECT_EQ(cdc.stats().bytes_received, sent.size());
+    EXPECT_EQ(cdc.stats().bytes_sent, sent.size());
+    EXPECT_EQ(FakePort::critical_depth, 0);
+}
+
+TEST_F(UsbCdcTest, WritesWaitForConfiguration) {
+    const std::vector<uint8_t> early = {1, 2, 3};
+    EXPECT_EQ(write(early), 3u);
+    EXPECT_TRUE(host.in_transfers.empty());
+
+    enumerate();
+    std::vector<uint8_t> got;
+    host_read(got);
+    EXPECT_EQ(got, early);
+}
+
+TEST_F(UsbCdcTest, BackPressureWhenHostStopsReading) {
+    enumerate();
+
+    // The host reads nothing: only what fits the ring is accepted
+    std::vector<uint8_t> chunk(1000);
+    uint32_t produced = 0;
+    std::size_t accepted = 0;
+    for (int i = 0; i < 10; i++) {
+        for (auto& b : chunk) {
+            b = pattern(produced++);
+        }
+        accepted += write(chunk);
+    }
+    EXPECT_EQ(accepted, kTxRing);
+    EXPECT_GT(cdc.stats().tx_full, 0u);
+    EXPECT_EQ(cdc.tx_pending(), kTxRing);
+
+    // Once the host reads again, completions free space and nothing is lost
+    std::vector<uint8_t> got;
+    while (host_read(got) > 0) {
+    }
+    ASSERT_EQ(got.size(), kTxRing);
+    for (uint32_t i = 0; i < got.size(); i++) {
+        ASSERT_EQ(got[i], pattern(i)) << "byte " << i;
+    }
+    EXPECT_GT(FakePort::space_signals, 0);
+    EXPECT_EQ(cdc.tx_pending(), 0u);
+}
+
+TEST_F(UsbCdcTest, OutNaksWhileReceiveRingIsFull) {
+    enumerate();
+
+    uint8_t packet[USB_CDC_PACKET];
+    uint32_t sent = 0;
+    int accepted = 0;
+    for (int i = 0; i < 20; i++) {
+        for (auto& b : packet) {
+            b = pattern(sent++);
+        }
+        if (!host.bulk_out(USB_CDC_EP_OUT, packet, sizeof(packet))) {
+            sent -= sizeof(packet);
+            break;
+        }
+        accepted++;
+    }
+    EXPECT_EQ(accepted, static_cast<int>(kRxRing / USB_CDC_PACKET));
+    EXPECT_GT(cdc.stats().rx_throttled, 0u);
+    EXPECT_FALSE(host.ep(USB_CDC_EP_OUT).out_armed);
+
+    // Reading re-arms the endpoint and the host's retry goes through
+    std::vector<uint8_t> got(kRxRing);
+    ASSERT_EQ(cdc.read(got.data(), 100), 100u);
+    EXPECT_TRUE(host.ep(USB_CDC_EP_OUT).out_armed);
+    for (auto& b : packet) {
+        b = pattern(sent++);
+    }
+    ASSERT_TRUE(host.bulk_out(USB_CDC_EP_OUT, packet, sizeof(packet)));
+
+    std::size_t total = 100;
+    total += cdc.read(got.data() + 100, got.size() - 100);
+    std::vector<uint8_t> rest(USB_CDC_PACKET);
+    total += cdc.read(rest.data(), rest.size());
+    EXPECT_EQ(total, sent);
+    for (uint32_t i = 0; i < kRxRing; i++) {
+        ASSERT_EQ(got[i], pattern(i)) << "byte " << i;
+    }
+}
+
+TEST_F(UsbCdcTest, ZlpEndsTransferOnPacketBoundary) {
+    enumerate();
+    const int zlps_before = host.zlps;
+
+    std::vector<uint8_t> got;
+    write(std::vector<uint8_t>(128, 0x55));
+    host_read(got);
+    EXPECT_EQ(got.size(), 128u);
+    EXPECT_EQ(host.zlps - zlps_before, 1);
+
+    got.clear();
+    write(std::vector<uint8_t>(100, 0x66));
+    host_read(got);
+    EXPECT_EQ(got.size(), 100u);
+    EXPECT_EQ(host.zlps - zlps_before, 1);
+    EXPECT_EQ(cdc.stats().zlps, 1u);
+}
+
+TEST_F(UsbCdcTest, InTransfersPointIntoTheRing) {
+    enumerate();
+
+    auto span = cdc.write_span();
+    ASSERT_GE(span.size(), 200u);
+    for (std::size_t i = 0; i < 200; i++) {
+        span[i] = pattern(static_cast<uint32_t>(i));
+    }
+    cdc.commit(200);
+
+    ASSERT_EQ(host.in_transfers.size(), 1u);
+    EXPECT_EQ(host.in_transfers[0], span.data());
+
+    std::vector<uint8_t> got;
+    host_read(got);
+    ASSERT_EQ(got.size(), 200u);
+    EXPECT_EQ(got[199], pattern(199));
+}
+
+TEST_F(UsbCdcTest, SustainsFullSpeedBulkRate) {
+    enumerate();
+
+    // The producer tops the ring up once per frame; the host polls every
+    // frame at the full-speed packet limit
+    constexpr int kFrames = 1000;
+    std::vector<uint8_t> got;
+    uint32_t produced = 0;
+    int starved = 0;
+    for (int frame = 0; frame < kFrames; frame++) {
+        while (true) {
+            auto span = cdc.write_span();
+            if (span.empty()) {
+                break;
+            }
+            for (auto& b : span) {
+                b = pattern(produced++);
+            }
+            cdc.commit(span.size());
+        }
+        if (host_read(got) < kPacketsPerFrame) {
+            starved++;
+        }
+    }
+
+    // 19 x 64 bytes per millisecond is 1.216 MB/s; the endpoint may only go
+    // short at a ring wrap, where a transfer ends early
+    const double mb_per_s = static_cast<double>(got.size()) / kFrames / 1000.0;
+    EXPECT_GT(mb_per_s, 1.0);
+    EXPECT_LT(starved, kFrames / 20);
+    for (uint32_t i = 0; i < got.size(); i++) {
+        ASSERT_EQ(got[i], pattern(i)) << "byte " << i;
+    }
+}
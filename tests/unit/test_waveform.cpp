@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+extern "C" {
+#include "waveform.h"
+}
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+uint16_t ideal_code(double value, uint16_t amplitude, uint16_t offset) {
+    return static_cast<uint16_t>(std::lround(offset + amplitude * value));
+}
+
+}  // namespace
+
+TEST(WaveformTest, SineMatchesTheReferenceWithinOneCode) {
+    waveform_t w;
+    ASSERT_EQ(waveform_init(&w, WAVEFORM_SINE, 2047, 2048), 0);
+
+    std::vector<uint16_t> out(1000);
+    waveform_render_period(&w, out.data(), out.size());
+
+    for (size_t i = 0; i < out.size(); i++) {
+        const uint16_t ideal = ideal_code(std::sin(2 * kPi * i / out.size()), 2047, 2048);
+        ASSERT_NEAR(out[i], ideal, 1) << "sample " << i;
+    }
+}
+
+TEST(WaveformTest, SineQ15IsSymmetric) {
+    waveform_t w;
+    ASSERT_EQ(waveform_init(&w, WAVEFORM_SINE, 0, 0), 0);
+    EXPECT_EQ(waveform_sample(&w, 0), 0);
+    EXPECT_EQ(waveform_sample(&w, 0x40000000u), 32767);
+    EXPECT_EQ(waveform_sample(&w, 0x80000000u), 0);
+    EXPECT_EQ(waveform_sample(&w, 0xC0000000u), -32767);
+    for (uint32_t phase = 0x01234567u; phase < 0x80000000u; phase += 0x07654321u) {
+        ASSERT_EQ(waveform_sample(&w, phase), -waveform_sample(&w, phase + 0x80000000u));
+    }
+}
+
+TEST(WaveformTest, TriangleIsPiecewiseLinear) {
+    waveform_t w;
+    ASSERT_EQ(waveform_init(&w, WAVEFORM_TRIANGLE, 2000, 2048), 0);
+
+    uint16_t out[8];
+    waveform_render_period(&w, out, 8);
+    EXPECT_EQ(out[0], 2048);
+    EXPECT_EQ(out[1], 3048);
+    EXPECT_EQ(out[2], 4048);
+    EXPECT_EQ(out[3], 3048);
+    EXPECT_EQ(out[4], 2048);
+    EXPECT_EQ(out[5], 1048);
+    EXPECT_EQ(out[6], 48);
+    EXPECT_EQ(out[7], 1048);
+}
+
+TEST(WaveformTest, TableInterpolatesAndWraps) {
+    static const int16_t steps[4] = {0, 32767, 0, -32767};
+    waveform_t w;
+    ASSERT_EQ(waveform_init(&w, WAVEFORM_TABLE, 1000, 2000), 0);
+    ASSERT_EQ(waveform_set_table(&w, steps, 2), 0);
+
+    uint16_t out[8];
+    waveform_render_period(&w, out, 8);
+    // Entries at even samples, midpoints between them at odd ones
+    const uint16_t expected[8] = {2000, 2500, 3000, 2500, 2000, 1500, 1000, 1500};
+    for (int i = 0; i < 8; i++) {
+        EXPECT_NEAR(out[i], expected[i], 1) << "sample " << i;
+    }
+}
+
+TEST(WaveformTest, RefillsContinueThePhase) {
+    waveform_t whole;
+    waveform_t halves;
+    ASSERT_EQ(waveform_init(&whole, WAVEFORM_SINE, 1500, 2048), 0);
+    ASSERT_EQ(waveform_init(&halves, WAVEFORM_SINE, 1500, 2048), 0);
+    ASSERT_EQ(waveform_set_frequency(&whole, 1234, 48000), 0);
+    ASSERT_EQ(waveform_set_frequency(&halves, 1234, 48000), 0);
+
+    std::vector<uint16_t> expected(600);
+    waveform_fill(&whole, expected.data(), expected.size());
+
+    // The same stream produced one half buffer at a time
+    std::vector<uint16_t> streamed(600);
+    for (size_t at = 0; at < streamed.size(); at += 50) {
+        waveform_refill(&halves, streamed.data() + at, 50);
+    }
+    EXPECT_EQ(streamed, expected);
+    EXPECT_EQ(halves.phase, whole.phase);
+
+    // 1234 cycles of phase per 48000 samples
+    EXPECT_NEAR(whole.step * 48000.0 / 4294967296.0, 1234.0, 1e-4);
+}
+
+TEST(WaveformTest, ClampsToTheDacRange) {
+    waveform_t w;
+    ASSERT_EQ(waveform_init(&w, WAVEFORM_SINE, 3000, 2048), 0);
+    uint16_t out[4];
+    waveform_render_period(&w, out, 4);
+    EXPECT_EQ(out[1], WAVEFORM_DAC_MAX);
+    EXPECT_EQ(out[3], 0);
+}
+
+TEST(WaveformTest, RejectsInvalidSettings) {
+    waveform_t w;
+    static const int16_t table[2] = {0, 0};
+    ASSERT_EQ(waveform_init(&w, WAVEFORM_TABLE, 100, 2048), 0);
+    EXPECT_EQ(waveform_set_table(&w, table, 0), -1);
+    EXPECT_EQ(waveform_set_table(&w, nullptr, 1), -1);
+    EXPECT_EQ(waveform_set_frequency(&w, 24000, 48000), -1);
+    EXPECT_EQ(waveform_init(&w, WAVEFORM_SINE, 100, 5000), -1);
+}
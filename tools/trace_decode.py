@@ -0,0 +1,254 @@
+#!/usr/bin/env python3
+"""Decode a trace_recorder ring dump into a Chrome/Perfetto JSON timeline.
+
+Capture the ring from a halted target with GDB:
+
+    (gdb) dump binary value trace.bin g_trace_buffer
+
+then convert it and open the result in https://ui.perfetto.dev or
+chrome://tracing:
+
+    ./tools/trace_decode.py trace.bin -o trace.json --summary
+
+The dump layout is described by trace_buffer_t in src/rtos/trace_recorder.h.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+TRACE_MAGIC = 0x52545246
+HEADER_FORMAT = "<IHHIIIIIHHHH"
+EVENT_FORMAT = "<IBBH"
+
+EVENT_NAMES = [
+    "NONE",
+    "TASK_SWITCHED_IN",
+    "TASK_SWITCHED_OUT",
+    "TASK_READY",
+    "TASK_DELAY",
+    "TASK_CREATE",
+    "PRIORITY_INHERIT",
+    "PRIORITY_DISINHERIT",
+    "ISR_ENTER",
+    "ISR_EXIT",
+    "QUEUE_CREATE",
+    "QUEUE_SEND",
+    "QUEUE_SEND_FAILED",
+    "QUEUE_SEND_FROM_ISR",
+    "QUEUE_RECEIVE",
+    "QUEUE_RECEIVE_FAILED",
+    "QUEUE_RECEIVE_FROM_ISR",
+    "QUEUE_BLOCK_SEND",
+    "QUEUE_BLOCK_RECEIVE",
+    "USER",
+]
+EVT = {name: index for index, name in enumerate(EVENT_NAMES)}
+
+QUEUE_EVENTS = {
+    EVT["QUEUE_SEND"], EVT["QUEUE_SEND_FAILED"], EVT["QUEUE_SEND_FROM_ISR"],
+    EVT["QUEUE_RECEIVE"], EVT["QUEUE_RECEIVE_FAILED"], EVT["QUEUE_RECEIVE_FROM_ISR"],
+    EVT["QUEUE_BLOCK_SEND"], EVT["QUEUE_BLOCK_RECEIVE"],
+}
+BLOCKING_EVENTS = {EVT["TASK_DELAY"], EVT["QUEUE_BLOCK_SEND"], EVT["QUEUE_BLOCK_RECEIVE"]}
+
+EXCEPTION_NAMES = {2: "NMI", 3: "HardFault", 4: "MemManage", 5: "BusFault",
+                   6: "UsageFault", 11: "SVCall", 12: "DebugMon", 14: "PendSV",
+                   15: "SysTick"}
+
+PID_TASKS = 1
+PID_ISRS = 2
+PID_OBJECTS = 3
+
+
+def parse_dump(data):
+    offset = data.find(struct.pack("<I", TRACE_MAGIC))
+    if offset < 0:
+        raise ValueError("trace magic not found in dump")
+
+    header_size = struct.calcsize(HEADER_FORMAT)
+    (magic, version, event_size, capacity, cpu_hz, head, frozen, trigger_index,
+     max_tasks, max_objects, name_len, _reserved) = struct.unpack_from(HEADER_FORMAT, data, offset)
+
+    if event_size != struct.calcsize(EVENT_FORMAT):
+        raise ValueError(f"unsupported event size {event_size}")
+
+    pos = offset + header_size
+
+    def read_names(count):
+        nonlocal pos
+        names = []
+        for _ in range(count):
+            raw = data[pos:pos + name_len]
+            names.append(raw.split(b"\0", 1)[0].decode("ascii", "replace"))
+            pos += name_len
+        return names
+
+    task_names = read_names(max_tasks)
+    object_names = read_names(max_objects)
+    pos = (pos + 3) & ~3
+
+    raw_events = [struct.unpack_from(EVENT_FORMAT, data, pos + i * event_size) for i in range(capacity)]
+
+    count = min(head, capacity)
+    first = head - count
+    events = [(first + n, raw_events[(first + n) & (capacity - 1)]) for n in range(count)]
+
+    return {
+        "version": version,
+        "cpu_hz": cpu_hz,
+        "head": head,
+        "frozen": bool(frozen),
+        "trigger_index": None if trigger_index == 0xFFFFFFFF else trigger_index,
+        "task_names": task_names,
+        "object_names": object_names,
+        "events": events,
+    }
+
+
+def name_of(names, number, prefix):
+    if 1 <= number <= len(names) and names[number - 1]:
+        return names[number - 1]
+    return f"{prefix} {number}"
+
+
+def exception_name(number):
+    if number >= 16:
+        return f"IRQ{number - 16}"
+    return EXCEPTION_NAMES.get(number, f"EXC{number}")
+
+
+def decode(trace, cpu_hz_override=None):
+    cpu_hz = cpu_hz_override or trace["cpu_hz"]
+    if not cpu_hz:
+        print("warning: cpu_hz not recorded, assuming 80 MHz", file=sys.stderr)
+        cpu_hz = 80_000_000
+
+    out = []
+    stats = {}
+    inversions = 0
+
+    def meta(pid, tid, name):
+        out.append({"ph": "M", "name": "thread_name", "pid": pid, "tid": tid, "args": {"name": name}})
+
+    for pid, name in ((PID_TASKS, "Tasks"), (PID_ISRS, "Interrupts"), (PID_OBJECTS, "Kernel objects")):
+        out.append({"ph": "M", "name": "process_name", "pid": pid, "args": {"name": name}})
+
+    seen_tasks, seen_isrs, seen_objects = set(), set(), set()
+    running = None          # (task, start_us, priority, ready_latency_us)
+    ready = {}              # task -> (ready_since_us, priority)
+    blocking = set()        # tasks that recorded a blocking call before switching out
+    isr_stack = []
+    cycles = 0
+    previous = None
+
+    for index, (timestamp, etype, obj, value) in trace["events"]:
+        if previous is not None:
+            delta = (timestamp - previous) & 0xFFFFFFFF
+            if delta >= 0x80000000:
+                delta -= 0x100000000  # slot claimed out of order by a nested writer
+            cycles += delta
+        previous = timestamp
+        ts = cycles * 1e6 / cpu_hz
+
+        if trace["trigger_index"] == index:
+            out.append({"ph": "i", "s": "g", "name": "TRIGGER", "ts": ts, "pid": PID_TASKS, "tid": 0})
+
+        if etype in (EVT["TASK_SWITCHED_IN"], EVT["TASK_SWITCHED_OUT"], EVT["TASK_READY"],
+                     EVT["TASK_CREATE"], EVT["TASK_DELAY"]) and obj not in seen_tasks:
+            seen_tasks.add(obj)
+            meta(PID_TASKS, obj, name_of(trace["task_names"], obj, "task"))
+
+        if etype == EVT["TASK_READY"]:
+            ready.setdefault(obj, (ts, value))
+        elif etype == EVT["TASK_SWITCHED_IN"]:
+            since, _ = ready.pop(obj, (ts, value))
+            latency = ts - since
+            waiting = [(task, prio) for task, (_, prio) in ready.items() if prio > value]
+            if waiting:
+                inversions += 1
+                out.append({"ph": "i", "s": "t", "name": "priority inversion", "ts": ts,
+                            "pid": PID_TASKS, "tid": obj,
+                            "args": {"running_priority": value,
+                                     "waiting": [name_of(trace["task_names"], t, "task") for t, _ in waiting]}})
+            running = (obj, ts, value, latency)
+            task_stats = stats.setdefault(obj, {"runs": 0, "run_us": 0.0, "max_latency_us": 0.0})
+            task_stats["runs"] += 1
+            task_stats["max_latency_us"] = max(task_stats["max_latency_us"], latency)
+        elif etype == EVT["TASK_SWITCHED_OUT"]:
+            if running and running[0] == obj:
+                _, start, prio, latency = running
+                out.append({"ph": "X", "name": name_of(trace["task_names"], obj, "task"),
+                            "ts": start, "dur": ts - start, "pid": PID_TASKS, "tid": obj,
+                            "args": {"priority": prio, "ready_latency_us": round(latency, 3)}})
+                stats[obj]["run_us"] += ts - start
+            running = None
+            if obj in blocking:
+                blocking.discard(obj)
+            else:
+                ready.setdefault(obj, (ts, value))  # preempted or yielded, still ready
+        elif etype in BLOCKING_EVENTS and running is not None:
+            blocking.add(running[0])
+        elif etype in (EVT["PRIORITY_INHERIT"], EVT["PRIORITY_DISINHERIT"]):
+            out.append({"ph": "i", "s": "t", "name": EVENT_NAMES[etype].lower(), "ts": ts,
+                        "pid": PID_TASKS, "tid": obj, "args": {"priority": value}})
+        elif etype == EVT["ISR_ENTER"]:
+            if obj not in seen_isrs:
+                seen_isrs.add(obj)
+                meta(PID_ISRS, obj, exception_name(obj))
+            isr_stack.append((obj, ts))
+        elif etype == EVT["ISR_EXIT"]:
+            if isr_stack and isr_stack[-1][0] == obj:
+                _, start = isr_stack.pop()
+                out.append({"ph": "X", "name": exception_name(obj), "ts": start, "dur": ts - start,
+                            "pid": PID_ISRS, "tid": obj})
+
+        if etype in QUEUE_EVENTS or etype == EVT["QUEUE_CREATE"]:
+            object_name = name_of(trace["object_names"], obj, "queue")
+            if obj not in seen_objects:
+                seen_objects.add(obj)
+                meta(PID_OBJECTS, obj, object_name)
+            out.append({"ph": "i", "s": "t", "name": EVENT_NAMES[etype].lower(), "ts": ts,
+                        "pid": PID_OBJECTS, "tid": obj, "args": {"items": value}})
+            if etype != EVT["QUEUE_CREATE"]:
+                out.append({"ph": "C", "name": f"{object_name} depth", "ts": ts,
+                            "pid": PID_OBJECTS, "args": {"items": value}})
+        elif etype == EVT["USER"]:
+            out.append({"ph": "i", "s": "p", "name": f"user {obj}", "ts": ts,
+                        "pid": PID_TASKS, "tid": 0, "args": {"value": value}})
+
+    return {"traceEvents": out, "displayTimeUnit": "ns"}, stats, inversions
+
+
+def print_summary(trace, stats, inversions):
+    print(f"events: {len(trace['events'])} (head {trace['head']}, "
+          f"{'frozen' if trace['frozen'] else 'running'})")
+    print(f"{'task':<16} {'runs':>8} {'run ms':>10} {'max ready->run us':>18}")
+    for task, task_stats in sorted(stats.items()):
+        print(f"{name_of(trace['task_names'], task, 'task'):<16} {task_stats['runs']:>8} "
+              f"{task_stats['run_us'] / 1000:>10.3f} {task_stats['max_latency_us']:>18.2f}")
+    print(f"priority inversion candidates: {inversions}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("dump", help="binary dump of g_trace_buffer")
+    parser.add_argument("-o", "--output", default="trace.json", help="Chrome trace JSON output")
+    parser.add_argument("--cpu-hz", type=int, help="override the recorded timestamp frequency")
+    parser.add_argument("--summary", action="store_true", help="print per-task latency summary")
+    args = parser.parse_args()
+
+    with open(args.dump, "rb") as f:
+        trace = parse_dump(f.read())
+
+    timeline, stats, inversions = decode(trace, args.cpu_hz)
+    with open(args.output, "w") as f:
+        json.dump(timeline, f)
+
+    if args.summary:
+        print_summary(trace, stats, inversions)
+
+
+if __name__ == "__main__":
+    main()